@@ -0,0 +1,86 @@
+#include "backlight.h"
+
+#include <stdbool.h>
+
+#include "driver/ledc.h"
+#include "esp_check.h"
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#ifndef CONFIG_LVGL_DISPLAY_BL
+#define CONFIG_LVGL_DISPLAY_BL 27
+#endif
+#ifndef CONFIG_LVGL_BACKLIGHT_PWM_HZ
+#define CONFIG_LVGL_BACKLIGHT_PWM_HZ 5000
+#endif
+
+#define BACKLIGHT_SPEED_MODE LEDC_LOW_SPEED_MODE
+#define BACKLIGHT_TIMER LEDC_TIMER_0
+#define BACKLIGHT_CHANNEL LEDC_CHANNEL_0
+#define BACKLIGHT_RESOLUTION LEDC_TIMER_10_BIT
+#define BACKLIGHT_DUTY_MAX ((1u << BACKLIGHT_RESOLUTION) - 1)
+
+static const char *TAG = "backlight";
+
+static bool s_ready = false;
+static uint8_t s_percent = 0;
+
+esp_err_t backlight_init(void)
+{
+    const ledc_timer_config_t timer_conf = {
+        .speed_mode = BACKLIGHT_SPEED_MODE,
+        .duty_resolution = BACKLIGHT_RESOLUTION,
+        .timer_num = BACKLIGHT_TIMER,
+        .freq_hz = CONFIG_LVGL_BACKLIGHT_PWM_HZ,
+        .clk_cfg = LEDC_AUTO_CLK,
+    };
+    ESP_RETURN_ON_ERROR(ledc_timer_config(&timer_conf), TAG, "timer config failed");
+
+    const ledc_channel_config_t channel_conf = {
+        .gpio_num = CONFIG_LVGL_DISPLAY_BL,
+        .speed_mode = BACKLIGHT_SPEED_MODE,
+        .channel = BACKLIGHT_CHANNEL,
+        .intr_type = LEDC_INTR_DISABLE,
+        .timer_sel = BACKLIGHT_TIMER,
+        .duty = 0,
+        .hpoint = 0,
+    };
+    ESP_RETURN_ON_ERROR(ledc_channel_config(&channel_conf), TAG, "channel config failed");
+    ESP_RETURN_ON_ERROR(ledc_fade_func_install(0), TAG, "fade install failed");
+
+    s_ready = true;
+    s_percent = 0;
+    ESP_LOGI(TAG, "Backlight PWM on GPIO %d at %d Hz", CONFIG_LVGL_DISPLAY_BL, CONFIG_LVGL_BACKLIGHT_PWM_HZ);
+    return ESP_OK;
+}
+
+esp_err_t backlight_set_percent(uint8_t percent, uint32_t fade_ms)
+{
+    ESP_RETURN_ON_FALSE(s_ready, ESP_ERR_INVALID_STATE, TAG, "not initialised");
+    if (percent > 100) {
+        percent = 100;
+    }
+    if (percent == s_percent) {
+        return ESP_OK;
+    }
+
+    const uint32_t duty = (BACKLIGHT_DUTY_MAX * percent + 50) / 100;
+    if (fade_ms > 0) {
+        ESP_RETURN_ON_ERROR(ledc_set_fade_with_time(BACKLIGHT_SPEED_MODE, BACKLIGHT_CHANNEL, duty, (int)fade_ms),
+                            TAG, "fade setup failed");
+        ESP_RETURN_ON_ERROR(ledc_fade_start(BACKLIGHT_SPEED_MODE, BACKLIGHT_CHANNEL, LEDC_FADE_NO_WAIT), TAG,
+                            "fade start failed");
+    } else {
+        ESP_RETURN_ON_ERROR(ledc_set_duty(BACKLIGHT_SPEED_MODE, BACKLIGHT_CHANNEL, duty), TAG, "set duty failed");
+        ESP_RETURN_ON_ERROR(ledc_update_duty(BACKLIGHT_SPEED_MODE, BACKLIGHT_CHANNEL), TAG, "update duty failed");
+    }
+
+    ESP_LOGD(TAG, "Backlight %u%% -> %u%% over %u ms", s_percent, percent, (unsigned)fade_ms);
+    s_percent = percent;
+    return ESP_OK;
+}
+
+uint8_t backlight_get_percent(void)
+{
+    return s_percent;
+}
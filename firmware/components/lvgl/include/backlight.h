@@ -0,0 +1,23 @@
+#pragma once
+
+#include <stdint.h>
+
+#include "esp_err.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** Drives the panel backlight GPIO (CONFIG_LVGL_DISPLAY_BL) from a LEDC PWM channel. */
+esp_err_t backlight_init(void);
+
+/**
+ * Moves the backlight to percent (0-100). A non-zero fade_ms uses the LEDC hardware
+ * fade so no CPU time or redraw is spent on the transition.
+ */
+esp_err_t backlight_set_percent(uint8_t percent, uint32_t fade_ms);
+uint8_t backlight_get_percent(void);
+
+#ifdef __cplusplus
+}
+#endif
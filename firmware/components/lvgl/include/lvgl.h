@@ -30,6 +30,29 @@ extern "C" {
 #define LV_OPA_90 230
 
 typedef uint8_t lv_opa_t;
+typedef int16_t lv_coord_t;
+
+/** Inclusive screen rectangle, as in LVGL. */
+typedef struct {
+    lv_coord_t x1;
+    lv_coord_t y1;
+    lv_coord_t x2;
+    lv_coord_t y2;
+} lv_area_t;
+
+/** Maximum number of invalidated areas buffered between two refreshes. */
+#define LV_INV_BUF_SIZE 32
+/** Minimum time between two refresh passes of lv_task_handler(). */
+#define LV_DISP_DEF_REFR_PERIOD 30
+/** Returned by lv_timer_handler()/lv_task_handler() when nothing is scheduled. */
+#define LV_NO_TIMER_READY 0xFFFFFFFFu
+
+/** Calls lv_async_call() can queue before the UI task drains them. */
+#define LV_ASYNC_QUEUE_LEN 8
+
+/** Size value that makes the object fit its content (labels measure their text). */
+#define LV_SIZE_CONTENT 0x7d1
+#define LV_PCT_FLAG 0x4000
 
 typedef enum {
     LV_ALIGN_DEFAULT = 0,
@@ -92,8 +115,21 @@ typedef struct {
 
 static inline lv_color_t lv_color_hex(uint32_t hex)
 {
-    (void)hex;
-    return (lv_color_t){0};
+    uint16_t r = (uint16_t)((hex >> 19) & 0x1f);
+    uint16_t g = (uint16_t)((hex >> 10) & 0x3f);
+    uint16_t b = (uint16_t)((hex >> 3) & 0x1f);
+    return (lv_color_t){(uint16_t)((r << 11) | (g << 5) | b)};
+}
+
+static inline lv_color_t lv_color_mix(lv_color_t c1, lv_color_t c2, lv_opa_t mix)
+{
+    // Blends RGB565 channels; mix = 255 gives c1, 0 gives c2.
+    uint32_t r1 = (c1.full >> 11) & 0x1f, g1 = (c1.full >> 5) & 0x3f, b1 = c1.full & 0x1f;
+    uint32_t r2 = (c2.full >> 11) & 0x1f, g2 = (c2.full >> 5) & 0x3f, b2 = c2.full & 0x1f;
+    uint32_t r = (r1 * mix + r2 * (255 - mix) + 127) / 255;
+    uint32_t g = (g1 * mix + g2 * (255 - mix) + 127) / 255;
+    uint32_t b = (b1 * mix + b2 * (255 - mix) + 127) / 255;
+    return (lv_color_t){(uint16_t)((r << 11) | (g << 5) | b)};
 }
 
 static inline lv_color_t lv_color_white(void)
@@ -107,7 +143,9 @@ static inline lv_color_t lv_color_black(void)
 }
 
 typedef struct lv_font_t {
-    uint8_t dummy;
+    uint8_t line_height;  // Distance between text lines in pixels
+    uint8_t glyph_width;  // Average advance used to measure text
+    void *glyph_cache;    // Pre-rasterized cells, see lv_font_cache_glyphs()
 } lv_font_t;
 
 extern lv_font_t lv_font_montserrat_14;
@@ -118,12 +156,49 @@ extern lv_font_t lv_font_montserrat_28;
 extern lv_font_t lv_font_montserrat_34;
 extern lv_font_t lv_font_montserrat_48;
 
+/**
+ * Rasterizes the given letters of the font once into an A8 atlas so later draws of
+ * those letters are a copy/blend of the cached cell. Other letters still go through
+ * the rasterizer. Calling it again replaces the font's atlas.
+ */
+bool lv_font_cache_glyphs(lv_font_t *font, const char *letters);
+
+#define LV_LABEL_TEXT_MAX 64
+
+typedef enum {
+    LV_OBJ_TYPE_BASE = 0,
+    LV_OBJ_TYPE_LABEL,
+    LV_OBJ_TYPE_BAR,
+    LV_OBJ_TYPE_SWITCH,
+} lv_obj_type_t;
+
 typedef struct lv_obj_t {
-    lv_state_t state;
-    lv_align_t align;
-    lv_color_t color;
-    lv_opa_t opa;
     struct lv_obj_t *parent;
+    struct lv_obj_t *child_head;
+    struct lv_obj_t *child_tail;
+    struct lv_obj_t *next_sibling;
+    lv_area_t coords;      // Absolute screen area, kept current by the layout pass
+    int32_t w_spec;        // Requested width: pixels, lv_pct() or LV_SIZE_CONTENT
+    int32_t h_spec;
+    int32_t x_ofs;
+    int32_t y_ofs;
+    lv_align_t align;
+    lv_flex_flow_t flex_flow;
+    bool flex;
+    lv_obj_type_t type;
+    lv_state_t state;
+    uint8_t flags;
+    int16_t pad_all;
+    int16_t pad_row;
+    int16_t pad_column;
+    lv_color_t bg_color;
+    lv_color_t bg_grad_color;
+    lv_grad_dir_t bg_grad_dir;
+    lv_opa_t bg_opa;
+    lv_color_t text_color;
+    lv_opa_t text_opa;
+    const lv_font_t *font;
+    char text[LV_LABEL_TEXT_MAX];
     void *user_data;
 } lv_obj_t;
 
@@ -134,6 +209,9 @@ typedef struct lv_event_t {
 
 typedef struct lv_style_t {
     int initialized;
+    lv_color_t bg_color;
+    lv_color_t bg_grad_color;
+    lv_grad_dir_t bg_grad_dir;
 } lv_style_t;
 
 typedef struct lv_timer_t lv_timer_t;
@@ -144,21 +222,161 @@ struct lv_timer_t {
     lv_timer_cb_t cb;
     void *user_data;
     uint32_t period_ms;
+    uint32_t last_run;
+    struct lv_timer_t *next;
 };
 
+/** Per-refresh invalidation counters, see lv_refr_get_stats(). */
+typedef struct {
+    uint32_t frames;         // Refresh passes that redrew at least one area
+    uint32_t inv_requests;   // Invalidations requested before the last pass
+    uint32_t dirty_rects;    // Rectangles redrawn by the last pass, after merging
+    uint32_t dirty_px;       // Pixels redrawn by the last pass
+    uint32_t drawn_objs;     // Object draws issued by the last pass
+    uint32_t flushed_bands;  // Draw-buffer bands handed to the display by the last pass
+    uint32_t flush_overlaps; // Bands rendered while the previous band was still being sent
+    uint32_t render_us;      // Time spent drawing into the buffers by the last pass
+    uint32_t glyphs_cached;  // Glyph draws served from a font atlas by the last pass
+    uint32_t glyphs_raster;  // Glyph draws that ran the rasterizer in the last pass
+    uint32_t stack_free_min; // High-water mark of the task running refreshes, bytes never used
+    uint64_t total_dirty_px; // Pixels redrawn since lv_init()
+} lv_refr_stats_t;
+
+#define LV_FRAME_HIST_BUCKETS 8
+
+/** Upper bounds (us) of all but the last, open-ended, histogram bucket. */
+extern const uint32_t lv_frame_hist_bounds_us[LV_FRAME_HIST_BUCKETS - 1];
+
+typedef struct {
+    uint32_t count;
+    uint32_t buckets[LV_FRAME_HIST_BUCKETS];
+    uint32_t max_us;
+    uint64_t sum_us;
+} lv_frame_hist_t;
+
+/** Phase durations of one frame, i.e. one refresh pass that redrew something. */
+typedef struct {
+    uint32_t timer_us;  // Timers and animations of the lv_task_handler() call that refreshed
+    uint32_t layout_us;
+    uint32_t render_us;
+    uint32_t flush_us;  // First band handed to the driver until the last one was done
+    uint32_t total_us;  // Layout start until the last band was done
+} lv_frame_sample_t;
+
+/** Cumulative frame timing, see lv_frame_get_stats(). */
+typedef struct {
+    lv_frame_hist_t timer; // Per lv_task_handler() call, whether or not it refreshed
+    lv_frame_hist_t layout;
+    lv_frame_hist_t render;
+    lv_frame_hist_t flush;
+    lv_frame_hist_t total;
+    uint32_t frames;
+    uint32_t dropped;         // Refresh periods missed by frames that ran over one
+    lv_frame_sample_t worst;  // Frame with the largest total_us
+} lv_frame_stats_t;
+
+/** Draw buffers the refresh renders into, in LVGL 8 form. */
+typedef struct {
+    void *buf1;
+    void *buf2;            // Optional; enables rendering while buf1 is being flushed
+    void *buf_act;
+    uint32_t size;         // Capacity of each buffer in pixels
+    volatile int flushing; // Set while the display driver owns buf_act's predecessor
+} lv_disp_draw_buf_t;
+
+typedef struct _lv_disp_drv_t lv_disp_drv_t;
+
+struct _lv_disp_drv_t {
+    lv_coord_t hor_res;
+    lv_coord_t ver_res;
+    lv_disp_draw_buf_t *draw_buf;
+    /** Starts sending area/color_p to the panel; call lv_disp_flush_ready() when done. */
+    void (*flush_cb)(lv_disp_drv_t *disp_drv, const lv_area_t *area, lv_color_t *color_p);
+    /** Called repeatedly while LVGL waits for a flush; may block on the completion. */
+    void (*wait_cb)(lv_disp_drv_t *disp_drv);
+    void *user_data;
+};
+
+typedef struct {
+    lv_disp_drv_t *driver;
+} lv_disp_t;
+
+void lv_disp_draw_buf_init(lv_disp_draw_buf_t *draw_buf, void *buf1, void *buf2, uint32_t size_in_px_cnt);
+void lv_disp_drv_init(lv_disp_drv_t *driver);
+lv_disp_t *lv_disp_drv_register(lv_disp_drv_t *driver);
+/** Completion callback for flush_cb; in IRAM and safe to call from an ISR. */
+void lv_disp_flush_ready(lv_disp_drv_t *disp_drv);
+
+struct lv_anim_t;
 typedef void (*lv_anim_exec_xcb_t)(void *var, int32_t value);
+/** Maps the animation's progress (act_time / time) to a value between start and end. */
+typedef int32_t (*lv_anim_path_cb_t)(const struct lv_anim_t *a);
+typedef void (*lv_anim_ready_cb_t)(struct lv_anim_t *a);
 
 typedef struct lv_anim_t {
     void *var;
     lv_anim_exec_xcb_t exec_cb;
+    lv_anim_path_cb_t path_cb;   // NULL means lv_anim_path_linear
+    lv_anim_ready_cb_t ready_cb; // Called once the last repeat has finished
     int32_t start;
     int32_t end;
-    int32_t repeat;
+    int32_t current;        // Last value passed to exec_cb
+    int32_t act_time;       // ms into the current run; negative while a delay is pending
+    uint32_t time;          // Duration of the current direction
+    uint32_t playback_time; // Duration of the way back, 0 for none
+    uint32_t playback_delay;
+    uint32_t repeat_delay;
+    int32_t repeat;         // Runs left including the current one, or LV_ANIM_REPEAT_INFINITE
+    bool playback_now;      // Running from end back to start
 } lv_anim_t;
 
+/** Running-animation counters, see lv_anim_get_stats(). */
+typedef struct {
+    uint32_t passes;          // Animation passes run by lv_task_handler()
+    uint32_t dropped_frames;  // Frame periods skipped because a pass ran late
+    uint32_t budget_overruns; // Passes cut short by CONFIG_LVGL_ANIM_FRAME_BUDGET_US
+    uint16_t running;         // Animations currently started
+} lv_anim_stats_t;
+
 void lv_init(void);
+/** Kept for API compatibility; the tick is derived from esp_timer_get_time(). */
 void lv_tick_inc(uint32_t ms);
-void lv_task_handler(void);
+uint32_t lv_tick_get(void);
+/**
+ * Runs due timers, a due animation pass and, at most every LV_DISP_DEF_REFR_PERIOD
+ * ms, a pending refresh.
+ * Returns the ms until the next timer or pending refresh is due, or
+ * LV_NO_TIMER_READY when only an invalidation from outside can create work.
+ */
+uint32_t lv_task_handler(void);
+uint32_t lv_timer_handler(void);
+/** While paused, invalidations accumulate and no refresh is run or scheduled. */
+void lv_refr_set_paused(bool paused);
+
+void lv_obj_invalidate(const lv_obj_t *obj);
+void lv_inv_area(const lv_area_t *area);
+void lv_refr_now(void);
+void lv_refr_get_stats(lv_refr_stats_t *stats);
+/** The last frame is included once its final band has been flushed. */
+void lv_frame_get_stats(lv_frame_stats_t *stats);
+void lv_frame_reset_stats(void);
+/** Upper bound of the bucket holding the given percentile (max_us for the last one). */
+uint32_t lv_frame_hist_percentile(const lv_frame_hist_t *hist, uint32_t percent);
+
+static inline int32_t lv_area_get_width(const lv_area_t *area)
+{
+    return (int32_t)area->x2 - area->x1 + 1;
+}
+
+static inline int32_t lv_area_get_height(const lv_area_t *area)
+{
+    return (int32_t)area->y2 - area->y1 + 1;
+}
+
+static inline uint32_t lv_area_get_size(const lv_area_t *area)
+{
+    return (uint32_t)(lv_area_get_width(area) * lv_area_get_height(area));
+}
 
 lv_obj_t *lv_scr_act(void);
 
@@ -184,7 +402,6 @@ void lv_obj_set_style_border_color(lv_obj_t *obj, lv_color_t color, uint32_t sel
 void lv_obj_set_style_pad_all(lv_obj_t *obj, int32_t pad, uint32_t sel_part);
 void lv_obj_set_style_pad_row(lv_obj_t *obj, int32_t pad, uint32_t sel_part);
 void lv_obj_set_style_pad_column(lv_obj_t *obj, int32_t pad, uint32_t sel_part);
-void lv_obj_set_style_transform_zoom(lv_obj_t *obj, int32_t zoom, uint32_t sel_part);
 void lv_obj_set_flex_flow(lv_obj_t *obj, lv_flex_flow_t flow);
 void lv_obj_clear_flag(lv_obj_t *obj, lv_obj_flag_t flag);
 void lv_obj_add_flag(lv_obj_t *obj, lv_obj_flag_t flag);
@@ -207,23 +424,77 @@ void *lv_event_get_user_data(const lv_event_t *e);
 lv_obj_t *lv_event_get_target(const lv_event_t *e);
 
 lv_timer_t *lv_timer_create(lv_timer_cb_t cb, uint32_t period, void *user_data);
+void lv_timer_del(lv_timer_t *timer);
+/** Next run period ms after the last one; from a timer's own callback, after this run. */
+void lv_timer_set_period(lv_timer_t *timer, uint32_t period);
+/** Runs the timer on the next lv_timer_handler() call. */
+void lv_timer_ready(lv_timer_t *timer);
+
+typedef void (*lv_async_cb_t)(void *user_data);
+/**
+ * Queues cb(user_data) to run on the UI task at the start of the next
+ * lv_task_handler(). Call with the LVGL lock held; returns false when the queue
+ * is full.
+ */
+bool lv_async_call(lv_async_cb_t cb, void *user_data);
 
 void lv_style_init(lv_style_t *style);
 void lv_style_set_bg_color(lv_style_t *style, lv_color_t color);
 void lv_style_set_bg_grad_color(lv_style_t *style, lv_color_t color);
 void lv_style_set_bg_grad_dir(lv_style_t *style, lv_grad_dir_t dir);
 
+/** Deletes the running animations of var (all of them when exec_cb is NULL). */
+bool lv_anim_del(void *var, lv_anim_exec_xcb_t exec_cb);
+
+/** Occupancy of one of the fixed-capacity pools behind objects, timers and anims. */
+typedef struct {
+    uint16_t capacity;
+    uint16_t used;
+    uint16_t high_water; // Most slots ever in use at once
+    uint32_t failures;   // Allocations refused because the pool was full
+} lv_mem_pool_stats_t;
+
+typedef struct {
+    lv_mem_pool_stats_t obj;
+    lv_mem_pool_stats_t timer;
+    lv_mem_pool_stats_t anim;
+} lv_mem_stats_t;
+
+void lv_mem_get_stats(lv_mem_stats_t *stats);
+
 void lv_anim_init(lv_anim_t *a);
 void lv_anim_set_var(lv_anim_t *a, void *var);
 void lv_anim_set_values(lv_anim_t *a, int32_t start, int32_t end);
 void lv_anim_set_exec_cb(lv_anim_t *a, lv_anim_exec_xcb_t exec_cb);
 void lv_anim_set_time(lv_anim_t *a, uint32_t duration);
+void lv_anim_set_delay(lv_anim_t *a, uint32_t delay);
+void lv_anim_set_path_cb(lv_anim_t *a, lv_anim_path_cb_t path_cb);
+void lv_anim_set_ready_cb(lv_anim_t *a, lv_anim_ready_cb_t ready_cb);
+void lv_anim_set_playback_time(lv_anim_t *a, uint32_t time);
+void lv_anim_set_playback_delay(lv_anim_t *a, uint32_t delay);
+/** Total number of runs (1 by default), or LV_ANIM_REPEAT_INFINITE. */
 void lv_anim_set_repeat_count(lv_anim_t *a, int32_t cnt);
+void lv_anim_set_repeat_delay(lv_anim_t *a, uint32_t delay);
+/** Copies a into the animation pool and applies its start value immediately. */
 void lv_anim_start(lv_anim_t *a);
+uint16_t lv_anim_count_running(void);
+/**
+ * While paused, running animations keep their state but are not stepped and do not
+ * schedule wakeups; on resume they continue from where they stopped.
+ */
+void lv_anim_set_paused(bool paused);
+void lv_anim_get_stats(lv_anim_stats_t *stats);
+
+// Easing curves, evaluated in Q16 fixed point.
+int32_t lv_anim_path_linear(const lv_anim_t *a);
+int32_t lv_anim_path_ease_in(const lv_anim_t *a);
+int32_t lv_anim_path_ease_out(const lv_anim_t *a);
+int32_t lv_anim_path_ease_in_out(const lv_anim_t *a);
+int32_t lv_anim_path_step(const lv_anim_t *a);
 
 static inline int32_t lv_pct(int32_t percent)
 {
-    return percent;
+    return LV_PCT_FLAG | percent;
 }
 
 #ifdef __cplusplus
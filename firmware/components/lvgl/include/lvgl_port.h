@@ -2,6 +2,9 @@
 
 #include "lvgl.h"
 #include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -9,7 +12,29 @@ extern "C" {
 
 esp_err_t lvgl_port_init(void);
 
+/**
+ * Starts the single UI task. It runs lv_task_handler() and then blocks until the
+ * returned deadline, a lvgl_port_unlock() from another task, or lvgl_port_wake().
+ * Its stack is CONFIG_LVGL_TASK_STACK_SIZE bytes.
+ */
+esp_err_t lvgl_port_start_task(UBaseType_t priority);
+
+/** Wakes the UI task early, e.g. from an input driver. */
+void lvgl_port_wake(void);
+void lvgl_port_wake_from_isr(void);
+
+/** Number of times the UI task has woken up since it started. */
+uint32_t lvgl_port_get_wakeups(void);
+
+/**
+ * Serialises access to LVGL objects. Every task other than the one running
+ * lv_task_handler() must hold the lock while touching widgets. Recursive, so timer
+ * callbacks running inside lv_task_handler() may call locking helpers again.
+ * Unlocking from another task wakes the UI task so the change is drawn promptly.
+ */
+bool lvgl_port_lock(uint32_t timeout_ms);
+void lvgl_port_unlock(void);
+
 #ifdef __cplusplus
 }
 #endif
-
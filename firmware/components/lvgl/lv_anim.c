@@ -0,0 +1,433 @@
+#include "lvgl.h"
+#include "lv_internal.h"
+
+#include <string.h>
+
+#include "esp_timer.h"
+#include "sdkconfig.h"
+
+#ifndef CONFIG_LVGL_ANIM_FRAME_BUDGET_US
+#define CONFIG_LVGL_ANIM_FRAME_BUDGET_US 4000
+#endif
+
+// Animations are stepped once per display refresh period. Values are derived from
+// the elapsed tick time, not from the number of passes, so a late pass jumps to where
+// the animation should be (dropping the intermediate frames) instead of slowing it.
+#define ANIM_PERIOD_MS LV_DISP_DEF_REFR_PERIOD
+#define ANIM_Q16_ONE (1 << 16)
+#define EASE_SEGMENTS 32
+#define EASE_SEGMENT_SHIFT 11 // Q16 progress / EASE_SEGMENTS
+
+// cubic-bezier(0.42, 0, 1, 1) and cubic-bezier(0.42, 0, 0.58, 1) sampled at 33 points
+// in Q16; ease-out is ease-in mirrored.
+static const int32_t s_ease_in[EASE_SEGMENTS + 1] = {
+    0,     117,   452,   987,   1703,  2587,  3625,  4808,  6125,  7569,  9130,
+    10804, 12584, 14465, 16442, 18511, 20667, 22909, 25231, 27633, 30112, 32664,
+    35290, 37987, 40754, 43591, 46498, 49474, 52522, 55643, 58843, 62130, 65536,
+};
+static const int32_t s_ease_in_out[EASE_SEGMENTS + 1] = {
+    0,     123,   497,   1133,  2039,  3222,  4686,  6435,  8465,  10770, 13339,
+    16153, 19187, 22408, 25776, 29246, 32768, 36290, 39760, 43128, 46349, 49383,
+    52197, 54766, 57071, 59101, 60850, 62314, 63497, 64403, 65039, 65413, 65536,
+};
+
+static _lv_anim_rec_t *s_anims = NULL;
+static bool s_list_changed = false;
+static bool s_paused = false;
+static uint32_t s_pass = 0;
+static uint32_t s_last_pass = 0;
+static uint32_t s_next_in = 0; // ms after s_last_pass at which the next pass is due
+static lv_anim_stats_t s_stats;
+
+void _lv_anim_core_init(void)
+{
+    s_anims = NULL;
+    s_list_changed = false;
+    s_paused = false;
+    s_pass = 0;
+    s_last_pass = lv_tick_get();
+    s_next_in = 0;
+    memset(&s_stats, 0, sizeof(s_stats));
+}
+
+// ---- Easing -----------------------------------------------------------------
+
+static int32_t anim_progress_q16(const lv_anim_t *a)
+{
+    if (a->time == 0 || a->act_time >= (int32_t)a->time) {
+        return ANIM_Q16_ONE;
+    }
+    if (a->act_time <= 0) {
+        return 0;
+    }
+    return (int32_t)(((int64_t)a->act_time << 16) / a->time);
+}
+
+static int32_t anim_map(const lv_anim_t *a, int32_t q16)
+{
+    int64_t delta = (int64_t)(a->end - a->start) * q16;
+    return a->start + (int32_t)((delta + ANIM_Q16_ONE / 2) >> 16);
+}
+
+static int32_t ease_lookup(const int32_t *table, int32_t t)
+{
+    int32_t i = t >> EASE_SEGMENT_SHIFT;
+    if (i >= EASE_SEGMENTS) {
+        return ANIM_Q16_ONE;
+    }
+    int32_t frac = t & ((1 << EASE_SEGMENT_SHIFT) - 1);
+    return table[i] + (((table[i + 1] - table[i]) * frac) >> EASE_SEGMENT_SHIFT);
+}
+
+int32_t lv_anim_path_linear(const lv_anim_t *a)
+{
+    return anim_map(a, anim_progress_q16(a));
+}
+
+int32_t lv_anim_path_ease_in(const lv_anim_t *a)
+{
+    return anim_map(a, ease_lookup(s_ease_in, anim_progress_q16(a)));
+}
+
+int32_t lv_anim_path_ease_out(const lv_anim_t *a)
+{
+    return anim_map(a, ANIM_Q16_ONE - ease_lookup(s_ease_in, ANIM_Q16_ONE - anim_progress_q16(a)));
+}
+
+int32_t lv_anim_path_ease_in_out(const lv_anim_t *a)
+{
+    return anim_map(a, ease_lookup(s_ease_in_out, anim_progress_q16(a)));
+}
+
+int32_t lv_anim_path_step(const lv_anim_t *a)
+{
+    return anim_progress_q16(a) >= ANIM_Q16_ONE ? a->end : a->start;
+}
+
+// ---- Descriptor setters -----------------------------------------------------
+
+void lv_anim_init(lv_anim_t *a)
+{
+    if (a) {
+        memset(a, 0, sizeof(*a));
+        a->time = 500;
+        a->repeat = 1;
+    }
+}
+
+void lv_anim_set_var(lv_anim_t *a, void *var)
+{
+    if (a) {
+        a->var = var;
+    }
+}
+
+void lv_anim_set_values(lv_anim_t *a, int32_t start, int32_t end)
+{
+    if (a) {
+        a->start = start;
+        a->end = end;
+    }
+}
+
+void lv_anim_set_exec_cb(lv_anim_t *a, lv_anim_exec_xcb_t exec_cb)
+{
+    if (a) {
+        a->exec_cb = exec_cb;
+    }
+}
+
+void lv_anim_set_time(lv_anim_t *a, uint32_t duration)
+{
+    if (a) {
+        a->time = duration;
+    }
+}
+
+void lv_anim_set_delay(lv_anim_t *a, uint32_t delay)
+{
+    if (a) {
+        a->act_time = -(int32_t)delay;
+    }
+}
+
+void lv_anim_set_path_cb(lv_anim_t *a, lv_anim_path_cb_t path_cb)
+{
+    if (a) {
+        a->path_cb = path_cb;
+    }
+}
+
+void lv_anim_set_ready_cb(lv_anim_t *a, lv_anim_ready_cb_t ready_cb)
+{
+    if (a) {
+        a->ready_cb = ready_cb;
+    }
+}
+
+void lv_anim_set_playback_time(lv_anim_t *a, uint32_t time)
+{
+    if (a) {
+        a->playback_time = time;
+    }
+}
+
+void lv_anim_set_playback_delay(lv_anim_t *a, uint32_t delay)
+{
+    if (a) {
+        a->playback_delay = delay;
+    }
+}
+
+void lv_anim_set_repeat_count(lv_anim_t *a, int32_t cnt)
+{
+    if (a) {
+        a->repeat = cnt;
+    }
+}
+
+void lv_anim_set_repeat_delay(lv_anim_t *a, uint32_t delay)
+{
+    if (a) {
+        a->repeat_delay = delay;
+    }
+}
+
+// ---- Running animations -----------------------------------------------------
+
+void lv_anim_start(lv_anim_t *a)
+{
+    if (!a || !a->exec_cb) {
+        return;
+    }
+
+    // Like LVGL, starting an animation replaces a running one on the same var/exec_cb.
+    lv_anim_del(a->var, a->exec_cb);
+    _lv_anim_rec_t *rec = _lv_anim_alloc();
+    if (!rec) {
+        return;
+    }
+
+    uint32_t now = lv_tick_get();
+    if (!s_anims) {
+        s_last_pass = now;
+        s_next_in = ANIM_PERIOD_MS;
+    } else if (now - s_last_pass + ANIM_PERIOD_MS < s_next_in) {
+        s_next_in = now - s_last_pass + ANIM_PERIOD_MS;
+    }
+
+    if (_lv_obj_in_pool(a->var)) {
+        ((lv_obj_t *)a->var)->flags |= LV_OBJ_FLAG_HAS_ANIM;
+    }
+
+    rec->anim = *a;
+    rec->anim.current = a->start;
+    rec->last_tick = now;
+    rec->pass = s_pass; // Not stepped again by a pass that is already running
+    rec->next = s_anims;
+    s_anims = rec;
+    s_list_changed = true;
+
+    a->exec_cb(a->var, a->start);
+}
+
+bool lv_anim_del(void *var, lv_anim_exec_xcb_t exec_cb)
+{
+    bool deleted = false;
+    _lv_anim_rec_t **link = &s_anims;
+    while (*link) {
+        _lv_anim_rec_t *rec = *link;
+        if (rec->anim.var == var && (!exec_cb || rec->anim.exec_cb == exec_cb)) {
+            *link = rec->next;
+            _lv_anim_free(rec);
+            deleted = true;
+        } else {
+            link = &rec->next;
+        }
+    }
+    if (deleted) {
+        s_list_changed = true;
+    }
+    return deleted;
+}
+
+uint16_t lv_anim_count_running(void)
+{
+    uint16_t count = 0;
+    for (const _lv_anim_rec_t *rec = s_anims; rec; rec = rec->next) {
+        count++;
+    }
+    return count;
+}
+
+void lv_anim_set_paused(bool paused)
+{
+    if (paused == s_paused) {
+        return;
+    }
+    s_paused = paused;
+    if (!paused) {
+        // Resume from the frozen state rather than jumping over the paused time.
+        uint32_t now = lv_tick_get();
+        for (_lv_anim_rec_t *rec = s_anims; rec; rec = rec->next) {
+            rec->last_tick = now;
+        }
+        s_last_pass = now;
+        s_next_in = 0;
+    }
+}
+
+void lv_anim_get_stats(lv_anim_stats_t *stats)
+{
+    if (stats) {
+        *stats = s_stats;
+        stats->running = lv_anim_count_running();
+    }
+}
+
+static void anim_reverse(lv_anim_t *a)
+{
+    int32_t start = a->start;
+    a->start = a->end;
+    a->end = start;
+    uint32_t time = a->time;
+    a->time = a->playback_time;
+    a->playback_time = time;
+    a->playback_now = !a->playback_now;
+}
+
+static void anim_finish(_lv_anim_rec_t *rec)
+{
+    for (_lv_anim_rec_t **link = &s_anims; *link; link = &(*link)->next) {
+        if (*link == rec) {
+            *link = rec->next;
+            break;
+        }
+    }
+    s_list_changed = true;
+
+    lv_anim_t done = rec->anim;
+    _lv_anim_free(rec);
+    if (done.ready_cb) {
+        done.ready_cb(&done);
+    }
+}
+
+static void anim_step(_lv_anim_rec_t *rec, uint32_t now)
+{
+    lv_anim_t *a = &rec->anim;
+    a->act_time += (int32_t)(now - rec->last_tick);
+    rec->last_tick = now;
+    if (a->act_time < 0) {
+        return;
+    }
+
+    int32_t value = (a->path_cb ? a->path_cb : lv_anim_path_linear)(a);
+    if (value != a->current) {
+        a->current = value;
+        a->exec_cb(a->var, value);
+        if (s_list_changed) {
+            return; // exec_cb may have deleted this record; finish on the next pass
+        }
+    }
+    if (a->act_time < (int32_t)a->time) {
+        return;
+    }
+
+    // Carry any lateness into the next run so repeats keep their phase.
+    int32_t over = a->act_time - (int32_t)a->time;
+    if (a->playback_time && !a->playback_now) {
+        anim_reverse(a);
+        a->act_time = over - (int32_t)a->playback_delay;
+        return;
+    }
+    if (a->playback_now) {
+        anim_reverse(a);
+    }
+    if (a->repeat == LV_ANIM_REPEAT_INFINITE || a->repeat > 1) {
+        if (a->repeat != LV_ANIM_REPEAT_INFINITE) {
+            a->repeat--;
+        }
+        a->act_time = over - (int32_t)a->repeat_delay;
+        return;
+    }
+    anim_finish(rec);
+}
+
+// Moves rec and everything after it to the front so the next pass starts with the
+// animations this one had no budget left for.
+static void anim_rotate_to_head(_lv_anim_rec_t *rec)
+{
+    if (rec == s_anims) {
+        return;
+    }
+    _lv_anim_rec_t *prev = s_anims;
+    while (prev->next != rec) {
+        prev = prev->next;
+    }
+    _lv_anim_rec_t *tail = rec;
+    while (tail->next) {
+        tail = tail->next;
+    }
+    tail->next = s_anims;
+    prev->next = NULL;
+    s_anims = rec;
+}
+
+uint32_t _lv_anim_handler(void)
+{
+    if (s_paused || !s_anims) {
+        return LV_NO_TIMER_READY;
+    }
+
+    uint32_t now = lv_tick_get();
+    uint32_t since = now - s_last_pass;
+    if (since < s_next_in) {
+        return s_next_in - since;
+    }
+
+    uint32_t late = since - s_next_in;
+    if (late >= ANIM_PERIOD_MS) {
+        s_stats.dropped_frames += late / ANIM_PERIOD_MS;
+    }
+    s_stats.passes++;
+    s_last_pass = now;
+    s_pass++;
+
+    // Step each record once. Callbacks may start or delete animations, in which case
+    // the walk restarts from the head and skips records already stepped.
+    bool over_budget = false;
+    int64_t start_us = esp_timer_get_time();
+    s_list_changed = false;
+    _lv_anim_rec_t *rec = s_anims;
+    while (rec) {
+        if (rec->pass != s_pass) {
+            if (esp_timer_get_time() - start_us > CONFIG_LVGL_ANIM_FRAME_BUDGET_US) {
+                s_stats.budget_overruns++;
+                anim_rotate_to_head(rec);
+                over_budget = true;
+                break;
+            }
+            rec->pass = s_pass;
+            anim_step(rec, now);
+            if (s_list_changed) {
+                s_list_changed = false;
+                rec = s_anims;
+                continue;
+            }
+        }
+        rec = rec->next;
+    }
+
+    // Sleep through delays; otherwise come back next frame period. After an overrun
+    // the rest runs right after this frame's refresh instead of holding it back.
+    uint32_t next = over_budget ? 0 : LV_NO_TIMER_READY;
+    for (rec = s_anims; rec && next; rec = rec->next) {
+        uint32_t due = rec->anim.act_time < 0 ? (uint32_t)-rec->anim.act_time : ANIM_PERIOD_MS;
+        if (due < next) {
+            next = due;
+        }
+    }
+    s_next_in = next;
+    return next;
+}
@@ -0,0 +1,128 @@
+#include "lvgl.h"
+#include "lv_internal.h"
+
+#include <stdint.h>
+
+// Software renderer for the objects the stub supports: filled (optionally vertical
+// gradient) backgrounds and label text, blended into an RGB565 draw buffer.
+
+#define LV_GLYPH_CELL_MAX (64 * 64)
+
+// Glyphs missing from the atlas are rasterized here. Drawing only happens on the UI
+// task under the port lock, so one buffer serves every label; on the stack it would
+// be the UI task's whole budget.
+static uint8_t s_glyph_scratch[LV_GLYPH_CELL_MAX];
+
+static void draw_bg(const lv_obj_t *obj, const lv_area_t *clip, lv_color_t *buf, const lv_area_t *buf_area)
+{
+    if (obj->bg_opa <= 2) {
+        return;
+    }
+
+    const int32_t buf_w = lv_area_get_width(buf_area);
+    const int32_t obj_h = lv_area_get_height(&obj->coords);
+    const bool grad = obj->bg_grad_dir == LV_GRAD_DIR_VER && obj_h > 1;
+
+    for (int32_t y = clip->y1; y <= clip->y2; y++) {
+        lv_color_t color = obj->bg_color;
+        if (grad) {
+            lv_opa_t mix = (lv_opa_t)(255 - ((y - obj->coords.y1) * 255) / (obj_h - 1));
+            color = lv_color_mix(obj->bg_color, obj->bg_grad_color, mix);
+        }
+
+        lv_color_t *row = buf + (y - buf_area->y1) * buf_w + (clip->x1 - buf_area->x1);
+        int32_t len = lv_area_get_width(clip);
+        if (obj->bg_opa >= LV_OPA_COVER - 2) {
+            for (int32_t i = 0; i < len; i++) {
+                row[i] = color;
+            }
+        } else {
+            for (int32_t i = 0; i < len; i++) {
+                row[i] = lv_color_mix(color, row[i], obj->bg_opa);
+            }
+        }
+    }
+}
+
+// Blends the inked part of an A8 cell; ink is relative to the cell's top-left corner.
+static void draw_glyph(const uint8_t *a8, const lv_area_t *cell, const lv_area_t *ink, const lv_area_t *clip,
+                       lv_color_t color, lv_opa_t opa, lv_color_t *buf, const lv_area_t *buf_area)
+{
+    const lv_area_t inked = {(lv_coord_t)(cell->x1 + ink->x1), (lv_coord_t)(cell->y1 + ink->y1),
+                             (lv_coord_t)(cell->x1 + ink->x2), (lv_coord_t)(cell->y1 + ink->y2)};
+    lv_area_t vis;
+    if (!_lv_area_intersect(&vis, &inked, clip)) {
+        return;
+    }
+
+    const int32_t buf_w = lv_area_get_width(buf_area);
+    const int32_t cell_w = lv_area_get_width(cell);
+    for (int32_t y = vis.y1; y <= vis.y2; y++) {
+        const uint8_t *src = a8 + (y - cell->y1) * cell_w + (vis.x1 - cell->x1);
+        lv_color_t *dst = buf + (y - buf_area->y1) * buf_w + (vis.x1 - buf_area->x1);
+        for (int32_t x = vis.x1; x <= vis.x2; x++, src++, dst++) {
+            uint32_t cov = *src;
+            if (cov == 0) {
+                continue;
+            }
+            if (opa < LV_OPA_COVER) {
+                cov = (cov * opa) >> 8;
+            }
+            *dst = cov >= 255 ? color : lv_color_mix(color, *dst, (lv_opa_t)cov);
+        }
+    }
+}
+
+static void draw_label(const lv_obj_t *obj, const lv_area_t *clip, lv_color_t *buf, const lv_area_t *buf_area)
+{
+    if (obj->text_opa <= 2 || obj->text[0] == '\0') {
+        return;
+    }
+
+    const lv_font_t *font = obj->font;
+    for (const lv_obj_t *o = obj; !font && o; o = o->parent) {
+        font = o->font;
+    }
+    if (!font) {
+        font = &lv_font_montserrat_14;
+    }
+
+    const int32_t gw = font->glyph_width;
+    const int32_t lh = font->line_height;
+    if (gw * lh > LV_GLYPH_CELL_MAX) {
+        return;
+    }
+
+    int32_t pen_x = obj->coords.x1;
+    int32_t pen_y = obj->coords.y1;
+    const char *txt = obj->text;
+    uint32_t letter;
+
+    while ((letter = _lv_txt_next_letter(&txt)) != 0) {
+        if (letter == '\n') {
+            pen_x = obj->coords.x1;
+            pen_y += lh;
+            continue;
+        }
+
+        lv_area_t cell = {(lv_coord_t)pen_x, (lv_coord_t)pen_y, (lv_coord_t)(pen_x + gw - 1),
+                          (lv_coord_t)(pen_y + lh - 1)};
+        lv_area_t vis;
+        if (_lv_area_intersect(&vis, &cell, clip)) {
+            lv_area_t ink;
+            const uint8_t *a8 = _lv_font_get_glyph(font, letter, s_glyph_scratch, &ink);
+            if (a8) {
+                draw_glyph(a8, &cell, &ink, clip, obj->text_color, obj->text_opa, buf, buf_area);
+            }
+        }
+        pen_x += gw;
+    }
+}
+
+void _lv_draw_obj(const lv_obj_t *obj, const lv_area_t *clip, lv_color_t *buf, const lv_area_t *buf_area)
+{
+    draw_bg(obj, clip, buf, buf_area);
+    if (obj->type == LV_OBJ_TYPE_LABEL) {
+        draw_label(obj, clip, buf, buf_area);
+    }
+}
@@ -0,0 +1,257 @@
+#include "lvgl.h"
+#include "lv_internal.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Stand-in for LVGL's font engine. Glyphs are built from anti-aliased strokes on a
+// seven-segment skeleton, so every draw costs a real per-pixel coverage pass the way
+// outline fonts do, without shipping bitmap font tables.
+
+enum {
+    SEG_A = 1 << 0, // top
+    SEG_B = 1 << 1, // upper right
+    SEG_C = 1 << 2, // lower right
+    SEG_D = 1 << 3, // bottom
+    SEG_E = 1 << 4, // lower left
+    SEG_F = 1 << 5, // upper left
+    SEG_G = 1 << 6, // middle
+};
+
+static const uint8_t k_digit_segments[10] = {
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F,
+    SEG_B | SEG_C,
+    SEG_A | SEG_B | SEG_D | SEG_E | SEG_G,
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_G,
+    SEG_B | SEG_C | SEG_F | SEG_G,
+    SEG_A | SEG_C | SEG_D | SEG_F | SEG_G,
+    SEG_A | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,
+    SEG_A | SEG_B | SEG_C,
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_E | SEG_F | SEG_G,
+    SEG_A | SEG_B | SEG_C | SEG_D | SEG_F | SEG_G,
+};
+
+typedef struct {
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+} stroke_t;
+
+uint32_t _lv_txt_next_letter(const char **txt)
+{
+    const unsigned char *p = (const unsigned char *)*txt;
+    uint32_t c = *p;
+    int extra = 0;
+
+    if (c == 0) {
+        return 0;
+    }
+    if (c >= 0xf0) {
+        c &= 0x07;
+        extra = 3;
+    } else if (c >= 0xe0) {
+        c &= 0x0f;
+        extra = 2;
+    } else if (c >= 0xc0) {
+        c &= 0x1f;
+        extra = 1;
+    }
+    p++;
+    for (int i = 0; i < extra && (*p & 0xc0) == 0x80; i++, p++) {
+        c = (c << 6) | (*p & 0x3f);
+    }
+
+    *txt = (const char *)p;
+    return c;
+}
+
+static uint8_t letter_segments(uint32_t letter)
+{
+    if (letter >= '0' && letter <= '9') {
+        return k_digit_segments[letter - '0'];
+    }
+    // Any other printable letter gets a stable, distinct-looking segment pattern.
+    uint8_t mask = (uint8_t)((letter * 37u) & 0x7f);
+    return mask ? mask : SEG_G;
+}
+
+static float dist_to_stroke(float px, float py, const stroke_t *s)
+{
+    float dx = s->x1 - s->x0;
+    float dy = s->y1 - s->y0;
+    float len2 = dx * dx + dy * dy;
+    float t = 0.0f;
+    if (len2 > 0.0f) {
+        t = ((px - s->x0) * dx + (py - s->y0) * dy) / len2;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+    }
+    float cx = s->x0 + t * dx - px;
+    float cy = s->y0 + t * dy - py;
+    return sqrtf(cx * cx + cy * cy);
+}
+
+bool _lv_font_rasterize(const lv_font_t *font, uint32_t letter, uint8_t *a8)
+{
+    const int w = font->glyph_width;
+    const int h = font->line_height;
+    memset(a8, 0, (size_t)(w * h));
+
+    if (letter == ' ' || letter == '\n' || letter == 0) {
+        return false;
+    }
+
+    const float l = w * 0.18f;
+    const float r = w * 0.82f;
+    const float t = h * 0.18f;
+    const float b = h * 0.82f;
+    const float m = (t + b) * 0.5f;
+    const float half = w * 0.07f > 0.75f ? w * 0.07f : 0.75f;
+
+    stroke_t strokes[7];
+    int count = 0;
+
+    if (letter == ':' || letter == '.') {
+        float cx = w * 0.5f;
+        if (letter == ':') {
+            strokes[count++] = (stroke_t){cx, (t + m) * 0.5f, cx, (t + m) * 0.5f};
+        }
+        strokes[count++] = (stroke_t){cx, (m + b) * 0.5f, cx, (m + b) * 0.5f};
+    } else if (letter > 0x7f) {
+        // Symbols outside ASCII (degree sign, bullet, weather icons) render as a dot.
+        strokes[count++] = (stroke_t){w * 0.5f, t + (m - t) * 0.5f, w * 0.5f, t + (m - t) * 0.5f};
+    } else {
+        uint8_t seg = letter_segments(letter);
+        if (seg & SEG_A) strokes[count++] = (stroke_t){l, t, r, t};
+        if (seg & SEG_B) strokes[count++] = (stroke_t){r, t, r, m};
+        if (seg & SEG_C) strokes[count++] = (stroke_t){r, m, r, b};
+        if (seg & SEG_D) strokes[count++] = (stroke_t){l, b, r, b};
+        if (seg & SEG_E) strokes[count++] = (stroke_t){l, m, l, b};
+        if (seg & SEG_F) strokes[count++] = (stroke_t){l, t, l, m};
+        if (seg & SEG_G) strokes[count++] = (stroke_t){l, m, r, m};
+    }
+
+    const float dot_half = (letter == ':' || letter == '.' || letter > 0x7f) ? half * 1.6f : half;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            float px = (float)x + 0.5f;
+            float py = (float)y + 0.5f;
+            float d = 1e9f;
+            for (int i = 0; i < count; i++) {
+                float di = dist_to_stroke(px, py, &strokes[i]);
+                if (di < d) {
+                    d = di;
+                }
+            }
+            float cov = dot_half + 0.5f - d;
+            if (cov > 0.0f) {
+                a8[y * w + x] = cov >= 1.0f ? 255 : (uint8_t)(cov * 255.0f);
+            }
+        }
+    }
+    return true;
+}
+
+// ---- Glyph atlas ----------------------------------------------------------------
+
+#define LV_FONT_CACHE_MAX_GLYPHS 16
+
+typedef struct {
+    uint32_t count;
+    uint32_t letters[LV_FONT_CACHE_MAX_GLYPHS];
+    lv_area_t ink[LV_FONT_CACHE_MAX_GLYPHS];
+    bool inked[LV_FONT_CACHE_MAX_GLYPHS];
+    uint8_t cells[]; // count cells of glyph_width x line_height
+} lv_font_glyph_cache_t;
+
+static uint32_t s_glyphs_cached = 0;
+static uint32_t s_glyphs_rasterized = 0;
+
+static bool ink_bounds(const uint8_t *a8, int w, int h, lv_area_t *ink)
+{
+    int x1 = w, y1 = h, x2 = -1, y2 = -1;
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            if (a8[y * w + x]) {
+                x1 = x < x1 ? x : x1;
+                x2 = x > x2 ? x : x2;
+                y1 = y < y1 ? y : y1;
+                y2 = y > y2 ? y : y2;
+            }
+        }
+    }
+    *ink = (lv_area_t){(lv_coord_t)x1, (lv_coord_t)y1, (lv_coord_t)x2, (lv_coord_t)y2};
+    return x2 >= 0;
+}
+
+bool lv_font_cache_glyphs(lv_font_t *font, const char *letters)
+{
+    if (!font || !letters) {
+        return false;
+    }
+
+    uint32_t unique[LV_FONT_CACHE_MAX_GLYPHS];
+    uint32_t count = 0;
+    uint32_t letter;
+    while ((letter = _lv_txt_next_letter(&letters)) != 0) {
+        bool seen = false;
+        for (uint32_t i = 0; i < count; i++) {
+            seen |= unique[i] == letter;
+        }
+        if (seen) {
+            continue;
+        }
+        if (count == LV_FONT_CACHE_MAX_GLYPHS) {
+            return false;
+        }
+        unique[count++] = letter;
+    }
+
+    const size_t cell = (size_t)font->glyph_width * font->line_height;
+    lv_font_glyph_cache_t *cache = malloc(sizeof(*cache) + cell * count);
+    if (!cache) {
+        return false;
+    }
+    cache->count = count;
+    for (uint32_t i = 0; i < count; i++) {
+        uint8_t *a8 = cache->cells + cell * i;
+        cache->letters[i] = unique[i];
+        cache->inked[i] = _lv_font_rasterize(font, unique[i], a8) &&
+                          ink_bounds(a8, font->glyph_width, font->line_height, &cache->ink[i]);
+    }
+
+    free(font->glyph_cache);
+    font->glyph_cache = cache;
+    return true;
+}
+
+const uint8_t *_lv_font_get_glyph(const lv_font_t *font, uint32_t letter, uint8_t *scratch, lv_area_t *ink)
+{
+    const lv_font_glyph_cache_t *cache = font->glyph_cache;
+    if (cache) {
+        for (uint32_t i = 0; i < cache->count; i++) {
+            if (cache->letters[i] == letter) {
+                s_glyphs_cached++;
+                if (!cache->inked[i]) {
+                    return NULL;
+                }
+                *ink = cache->ink[i];
+                return cache->cells + (size_t)font->glyph_width * font->line_height * i;
+            }
+        }
+    }
+
+    s_glyphs_rasterized++;
+    if (!_lv_font_rasterize(font, letter, scratch)) {
+        return NULL;
+    }
+    *ink = (lv_area_t){0, 0, (lv_coord_t)(font->glyph_width - 1), (lv_coord_t)(font->line_height - 1)};
+    return scratch;
+}
+
+void _lv_font_get_counters(uint32_t *cached, uint32_t *rasterized)
+{
+    *cached = s_glyphs_cached;
+    *rasterized = s_glyphs_rasterized;
+}
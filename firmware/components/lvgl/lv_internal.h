@@ -0,0 +1,93 @@
+#pragma once
+
+// Interfaces shared between the translation units of the LVGL component. Not part of
+// the public lvgl.h API.
+
+#include "lvgl.h"
+
+#define LV_OBJ_FLAG_COORDS_VALID (1 << 7)
+// An animation was started on the object; lv_obj_del() only searches the animation
+// list for objects carrying it. Not cleared when the animation ends.
+#define LV_OBJ_FLAG_HAS_ANIM (1 << 6)
+
+/** A started animation: the caller's descriptor copied into a pool slot. */
+typedef struct _lv_anim_rec_t {
+    lv_anim_t anim;
+    struct _lv_anim_rec_t *next;
+    uint32_t last_tick; // Tick the record was last stepped at
+    uint32_t pass;      // Last animation pass that stepped it
+} _lv_anim_rec_t;
+
+void _lv_refr_init(void);
+void _lv_anim_core_init(void);
+
+/**
+ * Steps running animations when a frame period has elapsed. Returns the ms until the
+ * next step is due, or LV_NO_TIMER_READY when none is running or they are paused.
+ */
+uint32_t _lv_anim_handler(void);
+
+// Slab pools sized by CONFIG_LVGL_*_POOL_SIZE; allocations come back zeroed.
+void _lv_mem_init(void);
+lv_obj_t *_lv_obj_alloc(void);
+void _lv_obj_free(lv_obj_t *obj);
+/** True when ptr is a slot of the object pool, i.e. a deletable lv_obj_t. */
+bool _lv_obj_in_pool(const void *ptr);
+lv_timer_t *_lv_timer_alloc(void);
+void _lv_timer_free(lv_timer_t *timer);
+_lv_anim_rec_t *_lv_anim_alloc(void);
+void _lv_anim_free(_lv_anim_rec_t *rec);
+void _lv_obj_update_layout(void);
+lv_obj_t *_lv_obj_get_screen(void);
+
+static inline bool _lv_area_intersect(lv_area_t *res, const lv_area_t *a, const lv_area_t *b)
+{
+    res->x1 = a->x1 > b->x1 ? a->x1 : b->x1;
+    res->y1 = a->y1 > b->y1 ? a->y1 : b->y1;
+    res->x2 = a->x2 < b->x2 ? a->x2 : b->x2;
+    res->y2 = a->y2 < b->y2 ? a->y2 : b->y2;
+    return res->x1 <= res->x2 && res->y1 <= res->y2;
+}
+
+static inline bool _lv_area_is_in(const lv_area_t *inner, const lv_area_t *outer)
+{
+    return inner->x1 >= outer->x1 && inner->y1 >= outer->y1 && inner->x2 <= outer->x2 && inner->y2 <= outer->y2;
+}
+
+static inline void _lv_area_join(lv_area_t *res, const lv_area_t *a, const lv_area_t *b)
+{
+    res->x1 = a->x1 < b->x1 ? a->x1 : b->x1;
+    res->y1 = a->y1 < b->y1 ? a->y1 : b->y1;
+    res->x2 = a->x2 > b->x2 ? a->x2 : b->x2;
+    res->y2 = a->y2 > b->y2 ? a->y2 : b->y2;
+}
+
+lv_disp_drv_t *_lv_disp_get_drv(void);
+
+/** Records the timer/animation phase of one lv_task_handler() call. */
+void _lv_frame_record_timer(uint32_t us);
+
+/** True when invalidated areas are waiting for the next refresh. */
+bool _lv_refr_pending(void);
+
+/** Decodes the UTF-8 codepoint at *txt and advances past it; 0 at the end. */
+uint32_t _lv_txt_next_letter(const char **txt);
+
+/**
+ * Rasterizes one glyph cell (glyph_width x line_height) of the font into an A8
+ * coverage map. Returns false for letters with no ink (e.g. space).
+ */
+bool _lv_font_rasterize(const lv_font_t *font, uint32_t letter, uint8_t *a8);
+
+/**
+ * Returns the A8 cell for the letter: the font's atlas entry when cached, otherwise
+ * rasterized into scratch. ink is set to the inked bounding box relative to the
+ * cell. NULL for letters with no ink.
+ */
+const uint8_t *_lv_font_get_glyph(const lv_font_t *font, uint32_t letter, uint8_t *scratch, lv_area_t *ink);
+
+/** Cumulative glyph lookups served from an atlas and by the rasterizer. */
+void _lv_font_get_counters(uint32_t *cached, uint32_t *rasterized);
+
+/** Draws obj (not its children) into buf, which covers buf_area, clipped to clip. */
+void _lv_draw_obj(const lv_obj_t *obj, const lv_area_t *clip, lv_color_t *buf, const lv_area_t *buf_area);
@@ -0,0 +1,161 @@
+#include "lvgl.h"
+#include "lv_internal.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "sdkconfig.h"
+
+#ifndef CONFIG_LVGL_OBJ_POOL_SIZE
+#define CONFIG_LVGL_OBJ_POOL_SIZE 96
+#endif
+#ifndef CONFIG_LVGL_TIMER_POOL_SIZE
+#define CONFIG_LVGL_TIMER_POOL_SIZE 8
+#endif
+#ifndef CONFIG_LVGL_ANIM_POOL_SIZE
+#define CONFIG_LVGL_ANIM_POOL_SIZE 16
+#endif
+
+// Fixed-capacity slabs for the objects LVGL creates and deletes at runtime. Each slab
+// is one arena of equal-sized slots threaded onto a free list, so allocation and
+// release are O(1) and never fragment the heap. With CONFIG_LVGL_POOL_STATIC the
+// arenas live in .bss; otherwise they are allocated once by lv_init().
+
+static const char *TAG = "lv_mem";
+
+typedef struct lv_slab_slot_t {
+    struct lv_slab_slot_t *next;
+} lv_slab_slot_t;
+
+typedef struct {
+    const char *name;
+    size_t slot_size;
+    uint16_t capacity;
+    uint8_t *arena;
+    lv_slab_slot_t *free_list;
+    lv_mem_pool_stats_t stats;
+} lv_slab_t;
+
+#if CONFIG_LVGL_POOL_STATIC
+static lv_obj_t s_obj_arena[CONFIG_LVGL_OBJ_POOL_SIZE];
+static lv_timer_t s_timer_arena[CONFIG_LVGL_TIMER_POOL_SIZE];
+static _lv_anim_rec_t s_anim_arena[CONFIG_LVGL_ANIM_POOL_SIZE];
+#endif
+
+static lv_slab_t s_obj_slab = {.name = "obj", .slot_size = sizeof(lv_obj_t), .capacity = CONFIG_LVGL_OBJ_POOL_SIZE};
+static lv_slab_t s_timer_slab = {
+    .name = "timer", .slot_size = sizeof(lv_timer_t), .capacity = CONFIG_LVGL_TIMER_POOL_SIZE};
+static lv_slab_t s_anim_slab = {
+    .name = "anim", .slot_size = sizeof(_lv_anim_rec_t), .capacity = CONFIG_LVGL_ANIM_POOL_SIZE};
+
+static void slab_init(lv_slab_t *slab, void *static_arena)
+{
+    if (!slab->arena) {
+        slab->arena = static_arena ? static_arena : malloc(slab->slot_size * slab->capacity);
+        if (!slab->arena) {
+            ESP_LOGE(TAG, "%s pool: cannot allocate %u slots", slab->name, slab->capacity);
+            slab->capacity = 0;
+        }
+    }
+
+    slab->free_list = NULL;
+    for (int i = (int)slab->capacity - 1; i >= 0; i--) {
+        lv_slab_slot_t *slot = (lv_slab_slot_t *)(slab->arena + slab->slot_size * (size_t)i);
+        slot->next = slab->free_list;
+        slab->free_list = slot;
+    }
+    slab->stats = (lv_mem_pool_stats_t){.capacity = slab->capacity};
+}
+
+static void *slab_alloc(lv_slab_t *slab)
+{
+    lv_slab_slot_t *slot = slab->free_list;
+    if (!slot) {
+        slab->stats.failures++;
+        ESP_LOGW(TAG, "%s pool exhausted (%u slots)", slab->name, slab->capacity);
+        return NULL;
+    }
+    slab->free_list = slot->next;
+    memset(slot, 0, slab->slot_size);
+
+    slab->stats.used++;
+    if (slab->stats.used > slab->stats.high_water) {
+        slab->stats.high_water = slab->stats.used;
+    }
+    return slot;
+}
+
+static void slab_free(lv_slab_t *slab, void *ptr)
+{
+    uint8_t *p = ptr;
+    if (!p || p < slab->arena || p >= slab->arena + slab->slot_size * slab->capacity ||
+        (size_t)(p - slab->arena) % slab->slot_size != 0) {
+        ESP_LOGE(TAG, "%s pool: bad free %p", slab->name, ptr);
+        return;
+    }
+    lv_slab_slot_t *slot = ptr;
+    slot->next = slab->free_list;
+    slab->free_list = slot;
+    slab->stats.used--;
+}
+
+void _lv_mem_init(void)
+{
+#if CONFIG_LVGL_POOL_STATIC
+    slab_init(&s_obj_slab, s_obj_arena);
+    slab_init(&s_timer_slab, s_timer_arena);
+    slab_init(&s_anim_slab, s_anim_arena);
+#else
+    slab_init(&s_obj_slab, NULL);
+    slab_init(&s_timer_slab, NULL);
+    slab_init(&s_anim_slab, NULL);
+#endif
+}
+
+lv_obj_t *_lv_obj_alloc(void)
+{
+    return slab_alloc(&s_obj_slab);
+}
+
+void _lv_obj_free(lv_obj_t *obj)
+{
+    slab_free(&s_obj_slab, obj);
+}
+
+bool _lv_obj_in_pool(const void *ptr)
+{
+    const uint8_t *p = ptr;
+    return p && s_obj_slab.arena && p >= s_obj_slab.arena &&
+           p < s_obj_slab.arena + s_obj_slab.slot_size * s_obj_slab.capacity &&
+           (size_t)(p - s_obj_slab.arena) % s_obj_slab.slot_size == 0;
+}
+
+lv_timer_t *_lv_timer_alloc(void)
+{
+    return slab_alloc(&s_timer_slab);
+}
+
+void _lv_timer_free(lv_timer_t *timer)
+{
+    slab_free(&s_timer_slab, timer);
+}
+
+_lv_anim_rec_t *_lv_anim_alloc(void)
+{
+    return slab_alloc(&s_anim_slab);
+}
+
+void _lv_anim_free(_lv_anim_rec_t *rec)
+{
+    slab_free(&s_anim_slab, rec);
+}
+
+void lv_mem_get_stats(lv_mem_stats_t *stats)
+{
+    if (stats) {
+        stats->obj = s_obj_slab.stats;
+        stats->timer = s_timer_slab.stats;
+        stats->anim = s_anim_slab.stats;
+    }
+}
@@ -0,0 +1,366 @@
+#include "lvgl.h"
+#include "lv_internal.h"
+
+#include <string.h>
+
+#include "esp_attr.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+// Invalidated areas collected since the last refresh. Like LVGL's inv_areas buffer,
+// an overflow degrades to a single full-screen area rather than dropping updates.
+static lv_area_t s_inv_areas[LV_INV_BUF_SIZE];
+static uint32_t s_inv_count = 0;
+static uint32_t s_inv_requests = 0;
+static lv_refr_stats_t s_stats;
+static lv_disp_t s_disp;
+static lv_disp_drv_t *s_drv = NULL;
+static uint32_t s_bands = 0;
+static uint32_t s_overlaps = 0;
+static int64_t s_render_us = 0;
+static TaskHandle_t s_refr_task = NULL; // Ran the last refresh; its stack is reported
+
+const uint32_t lv_frame_hist_bounds_us[LV_FRAME_HIST_BUCKETS - 1] = {1000, 2000, 4000, 8000, 16000, 33000, 66000};
+
+// A frame stays open after lv_refr_now() returns until the driver reports its last
+// band done; it is committed by the next poll that sees the bus idle.
+static lv_frame_stats_t s_frame_stats;
+static lv_frame_sample_t s_open_frame;
+static bool s_frame_open = false;
+static int64_t s_frame_start_us = 0;
+static int64_t s_flush_start_us = 0;
+// Stored from the driver's SPI ISR, so kept to one 32-bit word the task reads in a
+// single load; frame durations are taken as wrapping differences.
+static volatile uint32_t s_flush_done_us = 0;
+static uint32_t s_last_timer_us = 0;
+
+void _lv_refr_init(void)
+{
+    s_inv_count = 0;
+    s_inv_requests = 0;
+    memset(&s_stats, 0, sizeof(s_stats));
+    memset(&s_frame_stats, 0, sizeof(s_frame_stats));
+    s_frame_open = false;
+}
+
+void lv_inv_area(const lv_area_t *area)
+{
+    if (!area) {
+        return;
+    }
+
+    const lv_area_t screen = {0, 0, LV_HOR_RES - 1, LV_VER_RES - 1};
+    lv_area_t clipped;
+    if (!_lv_area_intersect(&clipped, area, &screen)) {
+        return;
+    }
+
+    s_inv_requests++;
+
+    for (uint32_t i = 0; i < s_inv_count; i++) {
+        if (_lv_area_is_in(&clipped, &s_inv_areas[i])) {
+            return;
+        }
+    }
+
+    if (s_inv_count == LV_INV_BUF_SIZE) {
+        s_inv_areas[0] = screen;
+        s_inv_count = 1;
+        return;
+    }
+
+    s_inv_areas[s_inv_count++] = clipped;
+}
+
+// Replaces every pair of overlapping areas by their bounding box until the remaining
+// areas are disjoint, so no pixel is drawn twice in one pass.
+static void join_areas(void)
+{
+    bool joined = true;
+    while (joined) {
+        joined = false;
+        for (uint32_t i = 0; i < s_inv_count; i++) {
+            for (uint32_t j = i + 1; j < s_inv_count; j++) {
+                lv_area_t overlap;
+                if (!_lv_area_intersect(&overlap, &s_inv_areas[i], &s_inv_areas[j])) {
+                    continue;
+                }
+                _lv_area_join(&s_inv_areas[i], &s_inv_areas[i], &s_inv_areas[j]);
+                s_inv_areas[j] = s_inv_areas[--s_inv_count];
+                joined = true;
+                j = i;
+            }
+        }
+    }
+}
+
+// ---- Display driver -----------------------------------------------------------
+
+void lv_disp_draw_buf_init(lv_disp_draw_buf_t *draw_buf, void *buf1, void *buf2, uint32_t size_in_px_cnt)
+{
+    memset(draw_buf, 0, sizeof(*draw_buf));
+    draw_buf->buf1 = buf1;
+    draw_buf->buf2 = buf2;
+    draw_buf->buf_act = buf1;
+    draw_buf->size = size_in_px_cnt;
+}
+
+void lv_disp_drv_init(lv_disp_drv_t *driver)
+{
+    memset(driver, 0, sizeof(*driver));
+    driver->hor_res = LV_HOR_RES;
+    driver->ver_res = LV_VER_RES;
+}
+
+lv_disp_t *lv_disp_drv_register(lv_disp_drv_t *driver)
+{
+    if (!driver || !driver->draw_buf || !driver->draw_buf->buf1 || !driver->flush_cb) {
+        return NULL;
+    }
+    s_drv = driver;
+    s_disp.driver = driver;
+    lv_obj_invalidate(_lv_obj_get_screen());
+    return &s_disp;
+}
+
+// In IRAM with everything it calls (esp_timer_get_time() is), since drivers call it
+// from their transfer-done ISR.
+void IRAM_ATTR lv_disp_flush_ready(lv_disp_drv_t *disp_drv)
+{
+    s_flush_done_us = (uint32_t)esp_timer_get_time();
+    disp_drv->draw_buf->flushing = 0;
+}
+
+lv_disp_drv_t *_lv_disp_get_drv(void)
+{
+    return s_drv;
+}
+
+static void wait_flush(lv_disp_drv_t *drv)
+{
+    while (drv->draw_buf->flushing) {
+        if (drv->wait_cb) {
+            drv->wait_cb(drv);
+        }
+    }
+}
+
+// ---- Frame timing ---------------------------------------------------------------
+
+static void hist_add(lv_frame_hist_t *hist, uint32_t us)
+{
+    uint32_t i = 0;
+    while (i < LV_FRAME_HIST_BUCKETS - 1 && us > lv_frame_hist_bounds_us[i]) {
+        i++;
+    }
+    hist->buckets[i]++;
+    hist->count++;
+    hist->sum_us += us;
+    if (us > hist->max_us) {
+        hist->max_us = us;
+    }
+}
+
+void _lv_frame_record_timer(uint32_t us)
+{
+    hist_add(&s_frame_stats.timer, us);
+    s_last_timer_us = us;
+}
+
+static void frame_commit(uint32_t done_us)
+{
+    lv_frame_sample_t *f = &s_open_frame;
+    f->flush_us = s_flush_start_us ? done_us - (uint32_t)s_flush_start_us : 0;
+    f->total_us = done_us - (uint32_t)s_frame_start_us;
+
+    lv_frame_stats_t *st = &s_frame_stats;
+    hist_add(&st->layout, f->layout_us);
+    hist_add(&st->render, f->render_us);
+    hist_add(&st->flush, f->flush_us);
+    hist_add(&st->total, f->total_us);
+    st->frames++;
+    st->dropped += f->total_us / (LV_DISP_DEF_REFR_PERIOD * 1000);
+    if (f->total_us > st->worst.total_us) {
+        st->worst = *f;
+    }
+    s_frame_open = false;
+}
+
+// Commits the open frame once the driver has finished with its last band.
+static void frame_poll(void)
+{
+    if (s_frame_open && (!s_drv || !s_drv->draw_buf->flushing)) {
+        frame_commit(s_drv ? s_flush_done_us : (uint32_t)esp_timer_get_time());
+    }
+}
+
+void lv_frame_get_stats(lv_frame_stats_t *stats)
+{
+    frame_poll();
+    if (stats) {
+        *stats = s_frame_stats;
+    }
+}
+
+void lv_frame_reset_stats(void)
+{
+    frame_poll();
+    memset(&s_frame_stats, 0, sizeof(s_frame_stats));
+}
+
+uint32_t lv_frame_hist_percentile(const lv_frame_hist_t *hist, uint32_t percent)
+{
+    if (!hist || hist->count == 0) {
+        return 0;
+    }
+    uint64_t rank = ((uint64_t)hist->count * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (uint32_t i = 0; i < LV_FRAME_HIST_BUCKETS - 1; i++) {
+        seen += hist->buckets[i];
+        if (seen >= rank && seen > 0) {
+            return lv_frame_hist_bounds_us[i] < hist->max_us ? lv_frame_hist_bounds_us[i] : hist->max_us;
+        }
+    }
+    return hist->max_us;
+}
+
+// ---- Rendering ------------------------------------------------------------------
+
+// Draws the objects covering the area in z-order, each clipped to its parent.
+static void refr_obj(const lv_obj_t *obj, const lv_area_t *area, lv_color_t *buf, const lv_area_t *buf_area,
+                     uint32_t *drawn)
+{
+    lv_area_t clip;
+    if (!_lv_area_intersect(&clip, &obj->coords, area)) {
+        return;
+    }
+    (*drawn)++;
+    if (buf) {
+        _lv_draw_obj(obj, &clip, buf, buf_area);
+    }
+    for (const lv_obj_t *child = obj->child_head; child; child = child->next_sibling) {
+        if (child->flags & LV_OBJ_FLAG_COORDS_VALID) {
+            refr_obj(child, &clip, buf, buf_area, drawn);
+        }
+    }
+}
+
+// Renders the area in horizontal bands that fit the draw buffer. With two buffers the
+// next band is rendered while the driver is still sending the previous one; the wait
+// for the driver happens only when that band is ready to go out.
+static uint32_t refr_area(const lv_area_t *area)
+{
+    uint32_t drawn = 0;
+    lv_obj_t *screen = _lv_obj_get_screen();
+
+    if (!s_drv) {
+        refr_obj(screen, area, NULL, NULL, &drawn);
+        return drawn;
+    }
+
+    lv_disp_draw_buf_t *draw_buf = s_drv->draw_buf;
+    const int32_t w = lv_area_get_width(area);
+    int32_t max_rows = (int32_t)draw_buf->size / w;
+    if (max_rows < 1) {
+        max_rows = 1;
+    }
+
+    for (int32_t y = area->y1; y <= area->y2; y += max_rows) {
+        lv_area_t band = *area;
+        band.y1 = (lv_coord_t)y;
+        band.y2 = (lv_coord_t)(y + max_rows - 1 < area->y2 ? y + max_rows - 1 : area->y2);
+
+        if (!draw_buf->buf2) {
+            wait_flush(s_drv);
+        }
+
+        lv_color_t *buf = draw_buf->buf_act;
+        const int64_t render_start = esp_timer_get_time();
+        refr_obj(screen, &band, buf, &band, &drawn);
+        s_render_us += esp_timer_get_time() - render_start;
+
+        if (draw_buf->flushing) {
+            s_overlaps++;
+            wait_flush(s_drv);
+        }
+        if (s_bands == 0) {
+            frame_poll(); // The previous frame's last band is done by now
+            s_flush_start_us = esp_timer_get_time();
+        }
+        draw_buf->flushing = 1;
+        s_drv->flush_cb(s_drv, &band, buf);
+        s_bands++;
+
+        if (draw_buf->buf2) {
+            draw_buf->buf_act = draw_buf->buf_act == draw_buf->buf1 ? draw_buf->buf2 : draw_buf->buf1;
+        }
+    }
+    return drawn;
+}
+
+void lv_refr_now(void)
+{
+    s_refr_task = xTaskGetCurrentTaskHandle();
+    frame_poll();
+    const int64_t start_us = esp_timer_get_time();
+    _lv_obj_update_layout();
+
+    if (s_inv_count == 0) {
+        return;
+    }
+    const int64_t layout_us = esp_timer_get_time() - start_us;
+
+    join_areas();
+
+    uint32_t px = 0;
+    uint32_t drawn = 0;
+    s_bands = 0;
+    s_overlaps = 0;
+    s_render_us = 0;
+    uint32_t cached_before, raster_before;
+    _lv_font_get_counters(&cached_before, &raster_before);
+    for (uint32_t i = 0; i < s_inv_count; i++) {
+        drawn += refr_area(&s_inv_areas[i]);
+        px += lv_area_get_size(&s_inv_areas[i]);
+    }
+
+    s_stats.frames++;
+    s_stats.inv_requests = s_inv_requests;
+    s_stats.dirty_rects = s_inv_count;
+    s_stats.dirty_px = px;
+    s_stats.drawn_objs = drawn;
+    s_stats.flushed_bands = s_bands;
+    s_stats.flush_overlaps = s_overlaps;
+    s_stats.render_us = (uint32_t)s_render_us;
+    uint32_t cached_after, raster_after;
+    _lv_font_get_counters(&cached_after, &raster_after);
+    s_stats.glyphs_cached = cached_after - cached_before;
+    s_stats.glyphs_raster = raster_after - raster_before;
+    s_stats.total_dirty_px += px;
+
+    s_inv_count = 0;
+    s_inv_requests = 0;
+
+    s_open_frame = (lv_frame_sample_t){
+        .timer_us = s_last_timer_us, .layout_us = (uint32_t)layout_us, .render_us = (uint32_t)s_render_us};
+    s_frame_start_us = start_us;
+    s_frame_open = true;
+    if (!s_drv) {
+        frame_commit((uint32_t)esp_timer_get_time());
+    }
+}
+
+bool _lv_refr_pending(void)
+{
+    return s_inv_count > 0;
+}
+
+void lv_refr_get_stats(lv_refr_stats_t *stats)
+{
+    if (stats) {
+        *stats = s_stats;
+        // Scans the stack for untouched bytes, so only on request rather than per frame.
+        stats->stack_free_min = s_refr_task ? (uint32_t)uxTaskGetStackHighWaterMark(s_refr_task) : 0;
+    }
+}
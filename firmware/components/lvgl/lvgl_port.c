@@ -4,11 +4,25 @@
 
 #include "esp_log.h"
 #include "esp_check.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+
+#ifndef CONFIG_LVGL_TASK_STACK_SIZE
+#define CONFIG_LVGL_TASK_STACK_SIZE 6144
+#endif
 
 static const char *TAG = "lvgl_port";
 
+static SemaphoreHandle_t s_lvgl_mutex = NULL;
+static TaskHandle_t s_ui_task = NULL;
+static volatile uint32_t s_wakeups = 0;
+
 esp_err_t lvgl_port_init(void)
 {
+    s_lvgl_mutex = xSemaphoreCreateRecursiveMutex();
+    ESP_RETURN_ON_FALSE(s_lvgl_mutex, ESP_ERR_NO_MEM, TAG, "mutex alloc failed");
+
     ESP_LOGI(TAG, "Initializing LVGL core");
     lv_init();
 
@@ -21,3 +35,75 @@ esp_err_t lvgl_port_init(void)
     return ESP_OK;
 }
 
+// Sleeps until the next LVGL deadline (timer or pending refresh) or until another
+// task changes widgets or an input arrives. There is no periodic tick.
+static void lvgl_port_task(void *arg)
+{
+    (void)arg;
+    while (true) {
+        uint32_t wait_ms = LV_NO_TIMER_READY;
+        if (lvgl_port_lock(0)) {
+            wait_ms = lv_task_handler();
+            lvgl_port_unlock();
+        }
+
+        TickType_t ticks = portMAX_DELAY;
+        if (wait_ms != LV_NO_TIMER_READY) {
+            // Round up so a short wait never becomes a zero-tick busy loop.
+            ticks = (TickType_t)((wait_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+        }
+        ulTaskNotifyTake(pdTRUE, ticks);
+        s_wakeups++;
+    }
+}
+
+esp_err_t lvgl_port_start_task(UBaseType_t priority)
+{
+    ESP_RETURN_ON_FALSE(s_lvgl_mutex, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    ESP_RETURN_ON_FALSE(!s_ui_task, ESP_ERR_INVALID_STATE, TAG, "already started");
+    ESP_RETURN_ON_FALSE(xTaskCreate(lvgl_port_task, "lv_ui", CONFIG_LVGL_TASK_STACK_SIZE, NULL, priority, &s_ui_task) == pdPASS,
+                        ESP_ERR_NO_MEM, TAG, "task create failed");
+    return ESP_OK;
+}
+
+void lvgl_port_wake(void)
+{
+    if (s_ui_task) {
+        xTaskNotifyGive(s_ui_task);
+    }
+}
+
+void lvgl_port_wake_from_isr(void)
+{
+    if (s_ui_task) {
+        BaseType_t woken = pdFALSE;
+        vTaskNotifyGiveFromISR(s_ui_task, &woken);
+        portYIELD_FROM_ISR(woken);
+    }
+}
+
+uint32_t lvgl_port_get_wakeups(void)
+{
+    return s_wakeups;
+}
+
+bool lvgl_port_lock(uint32_t timeout_ms)
+{
+    if (!s_lvgl_mutex) {
+        return false;
+    }
+    const TickType_t ticks = timeout_ms == 0 ? portMAX_DELAY : pdMS_TO_TICKS(timeout_ms);
+    return xSemaphoreTakeRecursive(s_lvgl_mutex, ticks) == pdTRUE;
+}
+
+void lvgl_port_unlock(void)
+{
+    if (s_lvgl_mutex) {
+        xSemaphoreGiveRecursive(s_lvgl_mutex);
+        // Whatever another task changed may have created work before the UI task's
+        // current deadline; let it recompute.
+        if (s_ui_task && xTaskGetCurrentTaskHandle() != s_ui_task) {
+            xTaskNotifyGive(s_ui_task);
+        }
+    }
+}
@@ -1,77 +1,561 @@
 #include "lvgl.h"
+#include "lv_internal.h"
 
 #include <stdio.h>
 #include <string.h>
 
-lv_font_t lv_font_montserrat_14 = {0};
-lv_font_t lv_font_montserrat_18 = {0};
-lv_font_t lv_font_montserrat_20 = {0};
-lv_font_t lv_font_montserrat_26 = {0};
-lv_font_t lv_font_montserrat_28 = {0};
-lv_font_t lv_font_montserrat_34 = {0};
-lv_font_t lv_font_montserrat_48 = {0};
+#include "esp_timer.h"
 
-static lv_obj_t s_screen = {0};
+lv_font_t lv_font_montserrat_14 = {.line_height = 16, .glyph_width = 8};
+lv_font_t lv_font_montserrat_18 = {.line_height = 20, .glyph_width = 10};
+lv_font_t lv_font_montserrat_20 = {.line_height = 22, .glyph_width = 11};
+lv_font_t lv_font_montserrat_26 = {.line_height = 29, .glyph_width = 15};
+lv_font_t lv_font_montserrat_28 = {.line_height = 30, .glyph_width = 16};
+lv_font_t lv_font_montserrat_34 = {.line_height = 37, .glyph_width = 19};
+lv_font_t lv_font_montserrat_48 = {.line_height = 49, .glyph_width = 28};
 
-void lv_init(void) {}
+static lv_obj_t s_screen = {0};
+static uint32_t s_last_refr = 0;
+static bool s_refr_paused = false;
+static lv_timer_t *s_timers = NULL;
+static bool s_timer_deleted = false; // Set by lv_timer_del() for lv_timer_handler()
+static bool s_layout_dirty = false;
+
+typedef struct {
+    lv_async_cb_t cb;
+    void *user_data;
+} lv_async_entry_t;
+
+static lv_async_entry_t s_async[LV_ASYNC_QUEUE_LEN];
+static uint8_t s_async_head = 0;
+static uint8_t s_async_count = 0;
+
+void lv_init(void)
+{
+    memset(&s_screen, 0, sizeof(s_screen));
+    s_screen.w_spec = LV_HOR_RES;
+    s_screen.h_spec = LV_VER_RES;
+    s_screen.coords = (lv_area_t){0, 0, LV_HOR_RES - 1, LV_VER_RES - 1};
+    s_screen.flags = LV_OBJ_FLAG_COORDS_VALID;
+    s_screen.bg_opa = LV_OPA_COVER;
+    s_screen.text_color = lv_color_white();
+    s_screen.text_opa = LV_OPA_COVER;
+    s_screen.font = &lv_font_montserrat_14;
+
+    _lv_mem_init();
+    _lv_anim_core_init();
+    s_timers = NULL;
+    s_async_head = 0;
+    s_async_count = 0;
+    _lv_refr_init();
+    lv_obj_invalidate(&s_screen);
+}
 
 void lv_tick_inc(uint32_t ms)
 {
     (void)ms;
 }
 
-void lv_task_handler(void) {}
+uint32_t lv_tick_get(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+uint32_t lv_timer_handler(void)
+{
+    uint32_t next;
+    bool restart;
+    do {
+        // A callback may delete timers, its own included, so the walk starts over
+        // when one did; timers that already ran this pass are not due again.
+        next = LV_NO_TIMER_READY;
+        restart = false;
+        for (lv_timer_t *t = s_timers; t; t = t->next) {
+            uint32_t now = lv_tick_get();
+            uint32_t elapsed = now - t->last_run;
+            if (elapsed >= t->period_ms) {
+                t->last_run = now;
+                if (t->cb) {
+                    s_timer_deleted = false;
+                    t->cb(t);
+                    if (s_timer_deleted) {
+                        restart = true;
+                        break;
+                    }
+                }
+                // The callback may have changed the period or made the timer ready.
+                elapsed = lv_tick_get() - t->last_run;
+            }
+            uint32_t remaining = elapsed >= t->period_ms ? 0 : t->period_ms - elapsed;
+            if (remaining < next) {
+                next = remaining;
+            }
+        }
+    } while (restart);
+    return next;
+}
+
+bool lv_async_call(lv_async_cb_t cb, void *user_data)
+{
+    if (!cb || s_async_count >= LV_ASYNC_QUEUE_LEN) {
+        return false;
+    }
+    s_async[(s_async_head + s_async_count) % LV_ASYNC_QUEUE_LEN] = (lv_async_entry_t){cb, user_data};
+    s_async_count++;
+    return true;
+}
+
+// Runs the calls queued before this pass; ones they queue wait for the next pass.
+static void async_run(void)
+{
+    for (uint8_t n = s_async_count; n > 0; n--) {
+        lv_async_entry_t e = s_async[s_async_head];
+        s_async_head = (uint8_t)((s_async_head + 1) % LV_ASYNC_QUEUE_LEN);
+        s_async_count--;
+        e.cb(e.user_data);
+    }
+}
+
+uint32_t lv_task_handler(void)
+{
+    const int64_t start_us = esp_timer_get_time();
+    async_run();
+    uint32_t next = lv_timer_handler();
+    if (s_async_count > 0) {
+        next = 0;
+    }
+    uint32_t anim_in = _lv_anim_handler();
+    if (anim_in < next) {
+        next = anim_in;
+    }
+    _lv_frame_record_timer((uint32_t)(esp_timer_get_time() - start_us));
+
+    if (s_refr_paused || !(s_layout_dirty || _lv_refr_pending())) {
+        return next;
+    }
+
+    uint32_t now = lv_tick_get();
+    uint32_t since = now - s_last_refr;
+    if (since >= LV_DISP_DEF_REFR_PERIOD) {
+        s_last_refr = now;
+        lv_refr_now();
+        return next;
+    }
+    uint32_t refr_in = LV_DISP_DEF_REFR_PERIOD - since;
+    return refr_in < next ? refr_in : next;
+}
+
+void lv_refr_set_paused(bool paused)
+{
+    s_refr_paused = paused;
+}
 
 lv_obj_t *lv_scr_act(void)
 {
     return &s_screen;
 }
 
-static lv_obj_t *allocate_obj(lv_obj_t *parent)
+lv_obj_t *_lv_obj_get_screen(void)
 {
-    lv_obj_t *obj = calloc(1, sizeof(lv_obj_t));
-    if (obj) {
-        obj->parent = parent ? parent : &s_screen;
+    return &s_screen;
+}
+
+// ---- Layout -----------------------------------------------------------------
+
+static const lv_font_t *obj_get_font(const lv_obj_t *obj)
+{
+    for (const lv_obj_t *o = obj; o; o = o->parent) {
+        if (o->font) {
+            return o->font;
+        }
+    }
+    return &lv_font_montserrat_14;
+}
+
+static void text_measure(const lv_font_t *font, const char *txt, int32_t *w, int32_t *h)
+{
+    int32_t line_w = 0;
+    int32_t max_w = 0;
+    int32_t lines = 1;
+
+    for (const unsigned char *p = (const unsigned char *)txt; *p; p++) {
+        if (*p == '\n') {
+            lines++;
+            line_w = 0;
+            continue;
+        }
+        if ((*p & 0xc0) == 0x80) {
+            continue; // UTF-8 continuation byte
+        }
+        line_w += font->glyph_width;
+        if (line_w > max_w) {
+            max_w = line_w;
+        }
+    }
+
+    *w = max_w;
+    *h = lines * font->line_height;
+}
+
+static void label_measure(const lv_obj_t *obj, int32_t *w, int32_t *h)
+{
+    text_measure(obj_get_font(obj), obj->text, w, h);
+}
+
+static int32_t resolve_len(int32_t spec, int32_t parent_len, int32_t content_len)
+{
+    if (spec == LV_SIZE_CONTENT) {
+        return content_len;
+    }
+    if (spec & LV_PCT_FLAG) {
+        return parent_len * (spec & ~LV_PCT_FLAG) / 100;
+    }
+    return spec;
+}
+
+static void align_in(lv_align_t align, const lv_area_t *box, int32_t w, int32_t h, int32_t *x, int32_t *y)
+{
+    int32_t bw = lv_area_get_width(box);
+    int32_t bh = lv_area_get_height(box);
+    int32_t left = box->x1;
+    int32_t mid_x = box->x1 + (bw - w) / 2;
+    int32_t right = box->x2 - w + 1;
+    int32_t top = box->y1;
+    int32_t mid_y = box->y1 + (bh - h) / 2;
+    int32_t bottom = box->y2 - h + 1;
+
+    switch (align) {
+    case LV_ALIGN_TOP_MID:
+        *x = mid_x;
+        *y = top;
+        break;
+    case LV_ALIGN_TOP_RIGHT:
+        *x = right;
+        *y = top;
+        break;
+    case LV_ALIGN_BOTTOM_LEFT:
+        *x = left;
+        *y = bottom;
+        break;
+    case LV_ALIGN_BOTTOM_MID:
+        *x = mid_x;
+        *y = bottom;
+        break;
+    case LV_ALIGN_BOTTOM_RIGHT:
+        *x = right;
+        *y = bottom;
+        break;
+    case LV_ALIGN_LEFT_MID:
+        *x = left;
+        *y = mid_y;
+        break;
+    case LV_ALIGN_RIGHT_MID:
+        *x = right;
+        *y = mid_y;
+        break;
+    case LV_ALIGN_CENTER:
+        *x = mid_x;
+        *y = mid_y;
+        break;
+    case LV_ALIGN_DEFAULT:
+    case LV_ALIGN_TOP_LEFT:
+    default:
+        *x = left;
+        *y = top;
+        break;
     }
+}
+
+static void align_out(lv_align_t align, const lv_area_t *base, int32_t w, int32_t h, int32_t *x, int32_t *y)
+{
+    int32_t bw = lv_area_get_width(base);
+    int32_t bh = lv_area_get_height(base);
+
+    switch (align) {
+    case LV_ALIGN_OUT_TOP_LEFT:
+    case LV_ALIGN_OUT_TOP_MID:
+    case LV_ALIGN_OUT_TOP_RIGHT:
+        *y = base->y1 - h;
+        break;
+    case LV_ALIGN_OUT_BOTTOM_LEFT:
+    case LV_ALIGN_OUT_BOTTOM_MID:
+    case LV_ALIGN_OUT_BOTTOM_RIGHT:
+        *y = base->y2 + 1;
+        break;
+    case LV_ALIGN_OUT_LEFT_TOP:
+    case LV_ALIGN_OUT_RIGHT_TOP:
+        *y = base->y1;
+        break;
+    case LV_ALIGN_OUT_LEFT_BOTTOM:
+    case LV_ALIGN_OUT_RIGHT_BOTTOM:
+        *y = base->y2 - h + 1;
+        break;
+    default:
+        *y = base->y1 + (bh - h) / 2;
+        break;
+    }
+
+    switch (align) {
+    case LV_ALIGN_OUT_TOP_LEFT:
+    case LV_ALIGN_OUT_BOTTOM_LEFT:
+        *x = base->x1;
+        break;
+    case LV_ALIGN_OUT_TOP_RIGHT:
+    case LV_ALIGN_OUT_BOTTOM_RIGHT:
+        *x = base->x2 - w + 1;
+        break;
+    case LV_ALIGN_OUT_LEFT_TOP:
+    case LV_ALIGN_OUT_LEFT_MID:
+    case LV_ALIGN_OUT_LEFT_BOTTOM:
+        *x = base->x1 - w;
+        break;
+    case LV_ALIGN_OUT_RIGHT_TOP:
+    case LV_ALIGN_OUT_RIGHT_MID:
+    case LV_ALIGN_OUT_RIGHT_BOTTOM:
+        *x = base->x2 + 1;
+        break;
+    default:
+        *x = base->x1 + (bw - w) / 2;
+        break;
+    }
+}
+
+static void content_box(const lv_obj_t *obj, lv_area_t *box)
+{
+    *box = obj->coords;
+    box->x1 += obj->pad_all;
+    box->y1 += obj->pad_all;
+    box->x2 -= obj->pad_all;
+    box->y2 -= obj->pad_all;
+}
+
+static void obj_get_size(const lv_obj_t *obj, const lv_area_t *parent_box, int32_t *w, int32_t *h)
+{
+    int32_t content_w = 0;
+    int32_t content_h = 0;
+    if (obj->type == LV_OBJ_TYPE_LABEL) {
+        label_measure(obj, &content_w, &content_h);
+    }
+    *w = resolve_len(obj->w_spec, lv_area_get_width(parent_box), content_w);
+    *h = resolve_len(obj->h_spec, lv_area_get_height(parent_box), content_h);
+}
+
+// Moving or resizing an object redraws both where it was and where it lands.
+static void obj_set_coords(lv_obj_t *obj, const lv_area_t *next)
+{
+    bool valid = (obj->flags & LV_OBJ_FLAG_COORDS_VALID) != 0;
+    if (valid && memcmp(&obj->coords, next, sizeof(*next)) == 0) {
+        return;
+    }
+    if (valid) {
+        lv_obj_invalidate(obj);
+    }
+    obj->coords = *next;
+    obj->flags |= LV_OBJ_FLAG_COORDS_VALID;
+    lv_obj_invalidate(obj);
+}
+
+static void layout_children(lv_obj_t *parent)
+{
+    lv_area_t box;
+    content_box(parent, &box);
+    int32_t flow_pos = 0;
+
+    for (lv_obj_t *child = parent->child_head; child; child = child->next_sibling) {
+        int32_t w;
+        int32_t h;
+        int32_t x;
+        int32_t y;
+        obj_get_size(child, &box, &w, &h);
+
+        if (parent->flex) {
+            if (parent->flex_flow == LV_FLEX_FLOW_COLUMN) {
+                x = box.x1;
+                y = box.y1 + flow_pos;
+                flow_pos += h + parent->pad_row;
+            } else {
+                x = box.x1 + flow_pos;
+                y = box.y1;
+                flow_pos += w + parent->pad_column;
+            }
+        } else {
+            align_in(child->align, &box, w, h, &x, &y);
+            x += child->x_ofs;
+            y += child->y_ofs;
+        }
+
+        lv_area_t next = {(lv_coord_t)x, (lv_coord_t)y, (lv_coord_t)(x + w - 1), (lv_coord_t)(y + h - 1)};
+        obj_set_coords(child, &next);
+        layout_children(child);
+    }
+}
+
+void _lv_obj_update_layout(void)
+{
+    if (!s_layout_dirty) {
+        return;
+    }
+    s_layout_dirty = false;
+    layout_children(&s_screen);
+}
+
+static void mark_layout_dirty(void)
+{
+    s_layout_dirty = true;
+}
+
+// ---- Objects ----------------------------------------------------------------
+
+static lv_obj_t *allocate_obj(lv_obj_t *parent, lv_obj_type_t type)
+{
+    lv_obj_t *obj = _lv_obj_alloc();
+    if (!obj) {
+        return NULL;
+    }
+
+    obj->parent = parent ? parent : &s_screen;
+    if (obj->parent->child_tail) {
+        obj->parent->child_tail->next_sibling = obj;
+    } else {
+        obj->parent->child_head = obj;
+    }
+    obj->parent->child_tail = obj;
+
+    obj->type = type;
+    obj->text_opa = LV_OPA_COVER;
+    obj->text_color = lv_color_white();
+    switch (type) {
+    case LV_OBJ_TYPE_LABEL:
+        obj->w_spec = LV_SIZE_CONTENT;
+        obj->h_spec = LV_SIZE_CONTENT;
+        obj->bg_opa = LV_OPA_TRANSP;
+        strlcpy(obj->text, "Text", sizeof(obj->text));
+        break;
+    case LV_OBJ_TYPE_BAR:
+        obj->w_spec = 200;
+        obj->h_spec = 10;
+        obj->bg_opa = LV_OPA_COVER;
+        break;
+    case LV_OBJ_TYPE_SWITCH:
+        obj->w_spec = 50;
+        obj->h_spec = 25;
+        obj->bg_opa = LV_OPA_COVER;
+        break;
+    case LV_OBJ_TYPE_BASE:
+    default:
+        obj->w_spec = 100;
+        obj->h_spec = 50;
+        obj->bg_opa = LV_OPA_COVER;
+        obj->bg_color = lv_color_white();
+        break;
+    }
+
+    mark_layout_dirty();
     return obj;
 }
 
 lv_obj_t *lv_obj_create(lv_obj_t *parent)
 {
-    return allocate_obj(parent);
+    return allocate_obj(parent, LV_OBJ_TYPE_BASE);
 }
 
 lv_obj_t *lv_label_create(lv_obj_t *parent)
 {
-    return allocate_obj(parent);
+    return allocate_obj(parent, LV_OBJ_TYPE_LABEL);
 }
 
 lv_obj_t *lv_bar_create(lv_obj_t *parent)
 {
-    return allocate_obj(parent);
+    return allocate_obj(parent, LV_OBJ_TYPE_BAR);
 }
 
 lv_obj_t *lv_switch_create(lv_obj_t *parent)
 {
-    return allocate_obj(parent);
+    return allocate_obj(parent, LV_OBJ_TYPE_SWITCH);
+}
+
+// Returns every object of the subtree to the pool, children before parents. Walks
+// down to a leaf, frees it and climbs back to its parent, so each node is visited a
+// constant number of times and no recursion depth is needed. Only objects that had
+// an animation started on them cost a search of the animation list.
+static void free_subtree(lv_obj_t *root)
+{
+    lv_obj_t *node = root;
+    while (true) {
+        while (node->child_head) {
+            node = node->child_head;
+        }
+        lv_obj_t *parent = node->parent;
+        lv_obj_t *next_sibling = node->next_sibling;
+        if (node->flags & LV_OBJ_FLAG_HAS_ANIM) {
+            lv_anim_del(node, NULL);
+        }
+        _lv_obj_free(node);
+        if (node == root) {
+            return;
+        }
+        parent->child_head = next_sibling;
+        if (!parent->child_head) {
+            parent->child_tail = NULL;
+        }
+        node = parent;
+    }
 }
 
 void lv_obj_del(lv_obj_t *obj)
 {
-    free(obj);
+    if (!obj || obj == &s_screen) {
+        return;
+    }
+
+    // Children are drawn inside their parent's area, so this covers the subtree.
+    lv_obj_invalidate(obj);
+
+    lv_obj_t *parent = obj->parent;
+    lv_obj_t *prev = NULL;
+    for (lv_obj_t *c = parent->child_head; c; prev = c, c = c->next_sibling) {
+        if (c == obj) {
+            if (prev) {
+                prev->next_sibling = c->next_sibling;
+            } else {
+                parent->child_head = c->next_sibling;
+            }
+            if (parent->child_tail == c) {
+                parent->child_tail = prev;
+            }
+            break;
+        }
+    }
+
+    free_subtree(obj);
+    mark_layout_dirty();
+}
+
+void lv_obj_invalidate(const lv_obj_t *obj)
+{
+    if (!obj || !(obj->flags & LV_OBJ_FLAG_COORDS_VALID)) {
+        return;
+    }
+    lv_inv_area(&obj->coords);
 }
 
 void lv_obj_set_size(lv_obj_t *obj, int32_t w, int32_t h)
 {
-    (void)obj;
-    (void)w;
-    (void)h;
+    if (!obj) {
+        return;
+    }
+    obj->w_spec = w;
+    obj->h_spec = h;
+    mark_layout_dirty();
 }
 
 void lv_obj_set_width(lv_obj_t *obj, int32_t w)
 {
-    (void)obj;
-    (void)w;
+    if (!obj) {
+        return;
+    }
+    obj->w_spec = w;
+    mark_layout_dirty();
 }
 
 void lv_obj_align(lv_obj_t *obj, lv_align_t align, int32_t x_ofs, int32_t y_ofs)
@@ -83,14 +567,38 @@ void lv_obj_align(lv_obj_t *obj, lv_align_t align, int32_t x_ofs, int32_t y_ofs)
         align = LV_ALIGN_CENTER;
     }
     obj->align = align;
-    (void)x_ofs;
-    (void)y_ofs;
+    obj->x_ofs = x_ofs;
+    obj->y_ofs = y_ofs;
+    mark_layout_dirty();
 }
 
+// Like LVGL, aligning to another object is a one-shot placement: the resulting
+// position is stored relative to the parent and does not follow the base later.
 void lv_obj_align_to(lv_obj_t *obj, const lv_obj_t *base, lv_align_t align, int32_t x_ofs, int32_t y_ofs)
 {
-    (void)base;
-    lv_obj_align(obj, align, x_ofs, y_ofs);
+    if (!obj) {
+        return;
+    }
+    if (!base || align < LV_ALIGN_OUT_TOP_LEFT) {
+        lv_obj_align(obj, align, x_ofs, y_ofs);
+        return;
+    }
+
+    _lv_obj_update_layout();
+
+    lv_area_t parent_box;
+    content_box(obj->parent, &parent_box);
+    int32_t w;
+    int32_t h;
+    int32_t x;
+    int32_t y;
+    obj_get_size(obj, &parent_box, &w, &h);
+    align_out(align, &base->coords, w, h, &x, &y);
+
+    obj->align = LV_ALIGN_TOP_LEFT;
+    obj->x_ofs = x + x_ofs - parent_box.x1;
+    obj->y_ofs = y + y_ofs - parent_box.y1;
+    mark_layout_dirty();
 }
 
 void lv_obj_center(lv_obj_t *obj)
@@ -100,66 +608,85 @@ void lv_obj_center(lv_obj_t *obj)
 
 void lv_obj_add_style(lv_obj_t *obj, const lv_style_t *style, uint32_t sel_part)
 {
-    (void)obj;
-    (void)style;
     (void)sel_part;
+    if (!obj || !style) {
+        return;
+    }
+    obj->bg_color = style->bg_color;
+    obj->bg_grad_color = style->bg_grad_color;
+    obj->bg_grad_dir = style->bg_grad_dir;
+    lv_obj_invalidate(obj);
 }
 
 void lv_obj_set_style_bg_color(lv_obj_t *obj, lv_color_t color, uint32_t sel_part)
 {
-    if (!obj) {
+    (void)sel_part;
+    if (!obj || obj->bg_color.full == color.full) {
         return;
     }
-    obj->color = color;
-    (void)sel_part;
+    obj->bg_color = color;
+    lv_obj_invalidate(obj);
 }
 
 void lv_obj_set_style_bg_grad_color(lv_obj_t *obj, lv_color_t color, uint32_t sel_part)
 {
-    (void)obj;
-    (void)color;
     (void)sel_part;
+    if (!obj || obj->bg_grad_color.full == color.full) {
+        return;
+    }
+    obj->bg_grad_color = color;
+    lv_obj_invalidate(obj);
 }
 
 void lv_obj_set_style_bg_grad_dir(lv_obj_t *obj, lv_grad_dir_t dir, uint32_t sel_part)
 {
-    (void)obj;
-    (void)dir;
     (void)sel_part;
+    if (!obj || obj->bg_grad_dir == dir) {
+        return;
+    }
+    obj->bg_grad_dir = dir;
+    lv_obj_invalidate(obj);
 }
 
 void lv_obj_set_style_bg_opa(lv_obj_t *obj, lv_opa_t opa, uint32_t sel_part)
 {
-    if (!obj) {
+    (void)sel_part;
+    if (!obj || obj->bg_opa == opa) {
         return;
     }
-    obj->opa = opa;
-    (void)sel_part;
+    obj->bg_opa = opa;
+    lv_obj_invalidate(obj);
 }
 
 void lv_obj_set_style_text_font(lv_obj_t *obj, const lv_font_t *font, uint32_t sel_part)
 {
-    (void)obj;
-    (void)font;
     (void)sel_part;
+    if (!obj || obj->font == font) {
+        return;
+    }
+    obj->font = font;
+    lv_obj_invalidate(obj);
+    mark_layout_dirty();
 }
 
 void lv_obj_set_style_text_color(lv_obj_t *obj, lv_color_t color, uint32_t sel_part)
 {
-    if (!obj) {
+    (void)sel_part;
+    if (!obj || obj->text_color.full == color.full) {
         return;
     }
-    obj->color = color;
-    (void)sel_part;
+    obj->text_color = color;
+    lv_obj_invalidate(obj);
 }
 
 void lv_obj_set_style_text_opa(lv_obj_t *obj, lv_opa_t opa, uint32_t sel_part)
 {
-    if (!obj) {
+    (void)sel_part;
+    if (!obj || obj->text_opa == opa) {
         return;
     }
-    obj->opa = opa;
-    (void)sel_part;
+    obj->text_opa = opa;
+    lv_obj_invalidate(obj);
 }
 
 void lv_obj_set_style_radius(lv_obj_t *obj, int32_t radius, uint32_t sel_part)
@@ -185,60 +712,144 @@ void lv_obj_set_style_border_color(lv_obj_t *obj, lv_color_t color, uint32_t sel
 
 void lv_obj_set_style_pad_all(lv_obj_t *obj, int32_t pad, uint32_t sel_part)
 {
-    (void)obj;
-    (void)pad;
     (void)sel_part;
+    if (!obj) {
+        return;
+    }
+    obj->pad_all = (int16_t)pad;
+    mark_layout_dirty();
 }
 
 void lv_obj_set_style_pad_row(lv_obj_t *obj, int32_t pad, uint32_t sel_part)
 {
-    (void)obj;
-    (void)pad;
     (void)sel_part;
+    if (!obj) {
+        return;
+    }
+    obj->pad_row = (int16_t)pad;
+    mark_layout_dirty();
 }
 
 void lv_obj_set_style_pad_column(lv_obj_t *obj, int32_t pad, uint32_t sel_part)
 {
-    (void)obj;
-    (void)pad;
-    (void)sel_part;
-}
-
-void lv_obj_set_style_transform_zoom(lv_obj_t *obj, int32_t zoom, uint32_t sel_part)
-{
-    (void)obj;
-    (void)zoom;
     (void)sel_part;
+    if (!obj) {
+        return;
+    }
+    obj->pad_column = (int16_t)pad;
+    mark_layout_dirty();
 }
 
 void lv_obj_set_flex_flow(lv_obj_t *obj, lv_flex_flow_t flow)
 {
-    (void)obj;
-    (void)flow;
+    if (!obj) {
+        return;
+    }
+    obj->flex = true;
+    obj->flex_flow = flow;
+    mark_layout_dirty();
 }
 
 void lv_obj_clear_flag(lv_obj_t *obj, lv_obj_flag_t flag)
 {
-    (void)obj;
-    (void)flag;
+    if (obj) {
+        obj->flags &= (uint8_t)~flag;
+    }
 }
 
 void lv_obj_add_flag(lv_obj_t *obj, lv_obj_flag_t flag)
 {
-    (void)obj;
-    (void)flag;
+    if (obj) {
+        obj->flags |= (uint8_t)flag;
+    }
+}
+
+// Invalidates the glyph cells that differ between two texts laid out from the same
+// origin. Every glyph has the font's fixed advance, so cells line up on a grid.
+static void label_invalidate_changed_glyphs(const lv_obj_t *obj, const lv_font_t *font, const char *old_txt,
+                                            const char *new_txt)
+{
+    int32_t col = 0;
+    int32_t row = 0;
+    uint32_t a = _lv_txt_next_letter(&old_txt);
+    uint32_t b = _lv_txt_next_letter(&new_txt);
+
+    // Walk both texts a line at a time; a line that runs out early compares as blanks.
+    while (a || b) {
+        const bool a_eol = a == 0 || a == '\n';
+        const bool b_eol = b == 0 || b == '\n';
+        if (a_eol && b_eol) {
+            a = a ? _lv_txt_next_letter(&old_txt) : 0;
+            b = b ? _lv_txt_next_letter(&new_txt) : 0;
+            col = 0;
+            row++;
+            continue;
+        }
+
+        if (a_eol || b_eol || a != b) {
+            lv_area_t cell = {
+                (lv_coord_t)(obj->coords.x1 + col * font->glyph_width),
+                (lv_coord_t)(obj->coords.y1 + row * font->line_height),
+                (lv_coord_t)(obj->coords.x1 + (col + 1) * font->glyph_width - 1),
+                (lv_coord_t)(obj->coords.y1 + (row + 1) * font->line_height - 1),
+            };
+            lv_area_t clipped;
+            if (_lv_area_intersect(&clipped, &cell, &obj->coords)) {
+                lv_inv_area(&clipped);
+            }
+        }
+
+        col++;
+        if (!a_eol) {
+            a = _lv_txt_next_letter(&old_txt);
+        }
+        if (!b_eol) {
+            b = _lv_txt_next_letter(&new_txt);
+        }
+    }
 }
 
 void lv_label_set_text(lv_obj_t *obj, const char *txt)
 {
-    (void)obj;
-    (void)txt;
+    if (!obj || !txt) {
+        return;
+    }
+
+    char new_text[LV_LABEL_TEXT_MAX];
+    strlcpy(new_text, txt, sizeof(new_text));
+    if (strcmp(obj->text, new_text) == 0) {
+        return;
+    }
+
+    // Same measured size means the layout pass leaves the label where it is, so only
+    // the cells whose glyph changed need redrawing. Otherwise clear the old area and
+    // let the layout pass invalidate the new one.
+    const lv_font_t *font = obj_get_font(obj);
+    int32_t old_w, old_h, new_w, new_h;
+    text_measure(font, obj->text, &old_w, &old_h);
+    text_measure(font, new_text, &new_w, &new_h);
+    if ((obj->flags & LV_OBJ_FLAG_COORDS_VALID) && old_w == new_w && old_h == new_h) {
+        label_invalidate_changed_glyphs(obj, font, obj->text, new_text);
+        memcpy(obj->text, new_text, sizeof(obj->text));
+        return;
+    }
+
+    lv_obj_invalidate(obj);
+    memcpy(obj->text, new_text, sizeof(obj->text));
+    mark_layout_dirty();
 }
 
 void lv_label_set_text_fmt(lv_obj_t *obj, const char *fmt, ...)
 {
-    (void)obj;
-    (void)fmt;
+    if (!obj || !fmt) {
+        return;
+    }
+    char buf[LV_LABEL_TEXT_MAX];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buf, sizeof(buf), fmt, args);
+    va_end(args);
+    lv_label_set_text(obj, buf);
 }
 
 void lv_bar_set_range(lv_obj_t *bar, int32_t min, int32_t max)
@@ -250,9 +861,9 @@ void lv_bar_set_range(lv_obj_t *bar, int32_t min, int32_t max)
 
 void lv_bar_set_value(lv_obj_t *bar, int32_t val, lv_anim_repeat_t anim)
 {
-    (void)bar;
     (void)val;
     (void)anim;
+    lv_obj_invalidate(bar);
 }
 
 bool lv_obj_has_state(const lv_obj_t *obj, lv_state_t state)
@@ -265,18 +876,20 @@ bool lv_obj_has_state(const lv_obj_t *obj, lv_state_t state)
 
 void lv_obj_add_state(lv_obj_t *obj, lv_state_t state)
 {
-    if (!obj) {
+    if (!obj || (obj->state & state) == state) {
         return;
     }
     obj->state |= state;
+    lv_obj_invalidate(obj);
 }
 
 void lv_obj_clear_state(lv_obj_t *obj, lv_state_t state)
 {
-    if (!obj) {
+    if (!obj || (obj->state & state) == 0) {
         return;
     }
     obj->state &= ~state;
+    lv_obj_invalidate(obj);
 }
 
 void lv_obj_add_event_cb(lv_obj_t *obj, void (*cb)(lv_event_t *), lv_event_code_t code, void *user_data)
@@ -299,87 +912,69 @@ lv_obj_t *lv_event_get_target(const lv_event_t *e)
 
 lv_timer_t *lv_timer_create(lv_timer_cb_t cb, uint32_t period, void *user_data)
 {
-    lv_timer_t *t = calloc(1, sizeof(lv_timer_t));
+    lv_timer_t *t = _lv_timer_alloc();
     if (t) {
         t->cb = cb;
         t->period_ms = period;
         t->user_data = user_data;
+        t->last_run = lv_tick_get();
+        t->next = s_timers;
+        s_timers = t;
     }
     return t;
 }
 
-void lv_style_init(lv_style_t *style)
+void lv_timer_set_period(lv_timer_t *timer, uint32_t period)
 {
-    if (style) {
-        memset(style, 0, sizeof(*style));
-        style->initialized = 1;
+    if (timer) {
+        timer->period_ms = period;
     }
 }
 
-void lv_style_set_bg_color(lv_style_t *style, lv_color_t color)
+void lv_timer_ready(lv_timer_t *timer)
 {
-    (void)style;
-    (void)color;
-}
-
-void lv_style_set_bg_grad_color(lv_style_t *style, lv_color_t color)
-{
-    (void)style;
-    (void)color;
-}
-
-void lv_style_set_bg_grad_dir(lv_style_t *style, lv_grad_dir_t dir)
-{
-    (void)style;
-    (void)dir;
-}
-
-void lv_anim_init(lv_anim_t *a)
-{
-    if (a) {
-        memset(a, 0, sizeof(*a));
+    if (timer) {
+        timer->last_run = lv_tick_get() - timer->period_ms - 1;
     }
 }
 
-void lv_anim_set_var(lv_anim_t *a, void *var)
+void lv_timer_del(lv_timer_t *timer)
 {
-    if (a) {
-        a->var = var;
+    for (lv_timer_t **link = &s_timers; *link; link = &(*link)->next) {
+        if (*link == timer) {
+            *link = timer->next;
+            _lv_timer_free(timer);
+            s_timer_deleted = true;
+            return;
+        }
     }
 }
 
-void lv_anim_set_values(lv_anim_t *a, int32_t start, int32_t end)
+void lv_style_init(lv_style_t *style)
 {
-    if (a) {
-        a->start = start;
-        a->end = end;
+    if (style) {
+        memset(style, 0, sizeof(*style));
+        style->initialized = 1;
     }
 }
 
-void lv_anim_set_exec_cb(lv_anim_t *a, lv_anim_exec_xcb_t exec_cb)
+void lv_style_set_bg_color(lv_style_t *style, lv_color_t color)
 {
-    if (a) {
-        a->exec_cb = exec_cb;
+    if (style) {
+        style->bg_color = color;
     }
 }
 
-void lv_anim_set_time(lv_anim_t *a, uint32_t duration)
-{
-    (void)a;
-    (void)duration;
-}
-
-void lv_anim_set_repeat_count(lv_anim_t *a, int32_t cnt)
+void lv_style_set_bg_grad_color(lv_style_t *style, lv_color_t color)
 {
-    if (a) {
-        a->repeat = cnt;
+    if (style) {
+        style->bg_grad_color = color;
     }
 }
 
-void lv_anim_start(lv_anim_t *a)
+void lv_style_set_bg_grad_dir(lv_style_t *style, lv_grad_dir_t dir)
 {
-    if (a && a->exec_cb) {
-        a->exec_cb(a->var, a->start);
+    if (style) {
+        style->bg_grad_dir = dir;
     }
 }
-
@@ -1,13 +1,261 @@
 #include "st7796_display.h"
+#include "backlight.h"
 
+#include <stdint.h>
+
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+#include "esp_attr.h"
+#include "esp_check.h"
+#include "esp_heap_caps.h"
 #include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
+
+#ifndef CONFIG_LVGL_DISPLAY_SPI_HOST
+#define CONFIG_LVGL_DISPLAY_SPI_HOST 2
+#endif
+#ifndef CONFIG_LVGL_DISPLAY_SPI_MOSI
+#define CONFIG_LVGL_DISPLAY_SPI_MOSI 23
+#endif
+#ifndef CONFIG_LVGL_DISPLAY_SPI_SCK
+#define CONFIG_LVGL_DISPLAY_SPI_SCK 18
+#endif
+#ifndef CONFIG_LVGL_DISPLAY_SPI_CS
+#define CONFIG_LVGL_DISPLAY_SPI_CS 5
+#endif
+#ifndef CONFIG_LVGL_DISPLAY_DC
+#define CONFIG_LVGL_DISPLAY_DC 2
+#endif
+#ifndef CONFIG_LVGL_DISPLAY_RST
+#define CONFIG_LVGL_DISPLAY_RST -1
+#endif
+#ifndef CONFIG_LVGL_DISPLAY_BUF_LINES
+#define CONFIG_LVGL_DISPLAY_BUF_LINES 20
+#endif
+#ifndef CONFIG_LVGL_DISPLAY_SPI_CLOCK_HZ
+#define CONFIG_LVGL_DISPLAY_SPI_CLOCK_HZ 40000000
+#endif
+
+#define ST7796_CMD_SWRESET 0x01
+#define ST7796_CMD_SLPOUT 0x11
+#define ST7796_CMD_INVON 0x21
+#define ST7796_CMD_DISPON 0x29
+#define ST7796_CMD_CASET 0x2A
+#define ST7796_CMD_RASET 0x2B
+#define ST7796_CMD_RAMWR 0x2C
+#define ST7796_CMD_MADCTL 0x36
+#define ST7796_CMD_COLMOD 0x3A
+
+#define ST7796_MADCTL_LANDSCAPE_BGR 0x28
+#define ST7796_COLMOD_RGB565 0x55
+
+// Flags carried in spi_transaction_t.user for the pre/post transfer callbacks.
+#define TRANS_DC_DATA 0x1
+#define TRANS_FLUSH_LAST 0x2
+
+// CASET, its data, RASET, its data, RAMWR and the pixels.
+#define FLUSH_TRANS_COUNT 6
 
 static const char *TAG = "st7796";
 static lv_obj_t s_root = {0};
 
+static spi_device_handle_t s_spi = NULL;
+static lv_disp_draw_buf_t s_draw_buf;
+static lv_disp_drv_t s_disp_drv;
+static SemaphoreHandle_t s_flush_done = NULL;
+static spi_transaction_t s_flush_trans[FLUSH_TRANS_COUNT];
+static int s_trans_in_flight = 0;
+
+static void IRAM_ATTR spi_pre_transfer_cb(spi_transaction_t *trans)
+{
+    gpio_set_level(CONFIG_LVGL_DISPLAY_DC, ((uintptr_t)trans->user & TRANS_DC_DATA) ? 1 : 0);
+}
+
+// Runs from the SPI ISR once the last transaction of a flush is on the wire, so
+// LVGL may start filling the buffer again and the waiting task is woken. Everything
+// it calls is in IRAM, lv_disp_flush_ready() included.
+static void IRAM_ATTR spi_post_transfer_cb(spi_transaction_t *trans)
+{
+    if (!((uintptr_t)trans->user & TRANS_FLUSH_LAST)) {
+        return;
+    }
+    lv_disp_flush_ready(&s_disp_drv);
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(s_flush_done, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+static esp_err_t send_cmd(uint8_t cmd, const uint8_t *data, size_t len)
+{
+    spi_transaction_t trans = {
+        .flags = SPI_TRANS_USE_TXDATA,
+        .length = 8,
+        .user = (void *)0,
+        .tx_data = {cmd},
+    };
+    ESP_RETURN_ON_ERROR(spi_device_polling_transmit(s_spi, &trans), TAG, "cmd 0x%02x failed", cmd);
+    if (len == 0) {
+        return ESP_OK;
+    }
+    spi_transaction_t data_trans = {
+        .length = len * 8,
+        .user = (void *)TRANS_DC_DATA,
+        .tx_buffer = data,
+    };
+    return spi_device_polling_transmit(s_spi, &data_trans);
+}
+
+static void set_window_trans(spi_transaction_t *cmd, spi_transaction_t *data, uint8_t op, int32_t start,
+                             int32_t end)
+{
+    *cmd = (spi_transaction_t){
+        .flags = SPI_TRANS_USE_TXDATA,
+        .length = 8,
+        .user = (void *)0,
+        .tx_data = {op},
+    };
+    *data = (spi_transaction_t){
+        .flags = SPI_TRANS_USE_TXDATA,
+        .length = 32,
+        .user = (void *)TRANS_DC_DATA,
+        .tx_data = {(uint8_t)(start >> 8), (uint8_t)start, (uint8_t)(end >> 8), (uint8_t)end},
+    };
+}
+
+// Queues the band and returns immediately; the DMA engine sends it while LVGL renders
+// the next band into the other buffer. Completion is signalled from the post callback.
+static void st7796_flush_cb(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p)
+{
+    // Reclaim the previous flush's descriptors; they finished before flushing cleared.
+    spi_transaction_t *done;
+    while (s_trans_in_flight > 0 && spi_device_get_trans_result(s_spi, &done, portMAX_DELAY) == ESP_OK) {
+        s_trans_in_flight--;
+    }
+
+    // The panel expects big-endian RGB565.
+    const uint32_t px = lv_area_get_size(area);
+    uint16_t *p = (uint16_t *)color_p;
+    for (uint32_t i = 0; i < px; i++) {
+        p[i] = (uint16_t)((p[i] << 8) | (p[i] >> 8));
+    }
+
+    set_window_trans(&s_flush_trans[0], &s_flush_trans[1], ST7796_CMD_CASET, area->x1, area->x2);
+    set_window_trans(&s_flush_trans[2], &s_flush_trans[3], ST7796_CMD_RASET, area->y1, area->y2);
+    s_flush_trans[4] = (spi_transaction_t){
+        .flags = SPI_TRANS_USE_TXDATA,
+        .length = 8,
+        .user = (void *)0,
+        .tx_data = {ST7796_CMD_RAMWR},
+    };
+    s_flush_trans[5] = (spi_transaction_t){
+        .length = px * 16,
+        .user = (void *)(TRANS_DC_DATA | TRANS_FLUSH_LAST),
+        .tx_buffer = color_p,
+    };
+
+    for (int i = 0; i < FLUSH_TRANS_COUNT; i++) {
+        if (spi_device_queue_trans(s_spi, &s_flush_trans[i], portMAX_DELAY) != ESP_OK) {
+            ESP_LOGE(TAG, "queue_trans failed");
+            lv_disp_flush_ready(drv);
+            return;
+        }
+        s_trans_in_flight++;
+    }
+}
+
+// Blocks the LVGL task instead of spinning while the band is on the wire.
+static void st7796_wait_cb(lv_disp_drv_t *drv)
+{
+    (void)drv;
+    xSemaphoreTake(s_flush_done, pdMS_TO_TICKS(100));
+}
+
 esp_err_t st7796_display_init(void)
 {
     ESP_LOGI(TAG, "Configuring ST7796 display (%dx%d RGB565)", LV_HOR_RES, LV_VER_RES);
+
+    const size_t buf_px = (size_t)LV_HOR_RES * CONFIG_LVGL_DISPLAY_BUF_LINES;
+
+    uint64_t pins = 1ULL << CONFIG_LVGL_DISPLAY_DC;
+#if CONFIG_LVGL_DISPLAY_RST >= 0
+    pins |= 1ULL << CONFIG_LVGL_DISPLAY_RST;
+#endif
+    const gpio_config_t io_conf = {
+        .pin_bit_mask = pins,
+        .mode = GPIO_MODE_OUTPUT,
+    };
+    ESP_RETURN_ON_ERROR(gpio_config(&io_conf), TAG, "gpio config failed");
+
+    const spi_bus_config_t bus_conf = {
+        .mosi_io_num = CONFIG_LVGL_DISPLAY_SPI_MOSI,
+        .miso_io_num = -1,
+        .sclk_io_num = CONFIG_LVGL_DISPLAY_SPI_SCK,
+        .quadwp_io_num = -1,
+        .quadhd_io_num = -1,
+        .max_transfer_sz = (int)(buf_px * sizeof(lv_color_t)),
+    };
+    ESP_RETURN_ON_ERROR(spi_bus_initialize((spi_host_device_t)CONFIG_LVGL_DISPLAY_SPI_HOST, &bus_conf,
+                                           SPI_DMA_CH_AUTO),
+                        TAG, "spi bus init failed");
+
+    const spi_device_interface_config_t dev_conf = {
+        .mode = 0,
+        .clock_speed_hz = CONFIG_LVGL_DISPLAY_SPI_CLOCK_HZ,
+        .spics_io_num = CONFIG_LVGL_DISPLAY_SPI_CS,
+        .queue_size = FLUSH_TRANS_COUNT + 1,
+        .pre_cb = spi_pre_transfer_cb,
+        .post_cb = spi_post_transfer_cb,
+    };
+    ESP_RETURN_ON_ERROR(spi_bus_add_device((spi_host_device_t)CONFIG_LVGL_DISPLAY_SPI_HOST, &dev_conf, &s_spi),
+                        TAG, "spi add device failed");
+
+    s_flush_done = xSemaphoreCreateBinary();
+    ESP_RETURN_ON_FALSE(s_flush_done, ESP_ERR_NO_MEM, TAG, "semaphore alloc failed");
+
+    // Hardware reset, or a software one when the reset line is tied to EN; either
+    // way the panel needs 120 ms before it accepts SLPOUT.
+#if CONFIG_LVGL_DISPLAY_RST >= 0
+    gpio_set_level(CONFIG_LVGL_DISPLAY_RST, 0);
+    vTaskDelay(pdMS_TO_TICKS(10));
+    gpio_set_level(CONFIG_LVGL_DISPLAY_RST, 1);
+#else
+    ESP_RETURN_ON_ERROR(send_cmd(ST7796_CMD_SWRESET, NULL, 0), TAG, "SWRESET failed");
+#endif
+    vTaskDelay(pdMS_TO_TICKS(120));
+
+    const uint8_t colmod = ST7796_COLMOD_RGB565;
+    const uint8_t madctl = ST7796_MADCTL_LANDSCAPE_BGR;
+    ESP_RETURN_ON_ERROR(send_cmd(ST7796_CMD_SLPOUT, NULL, 0), TAG, "SLPOUT failed");
+    vTaskDelay(pdMS_TO_TICKS(5));
+    ESP_RETURN_ON_ERROR(send_cmd(ST7796_CMD_COLMOD, &colmod, 1), TAG, "COLMOD failed");
+    ESP_RETURN_ON_ERROR(send_cmd(ST7796_CMD_MADCTL, &madctl, 1), TAG, "MADCTL failed");
+    ESP_RETURN_ON_ERROR(send_cmd(ST7796_CMD_INVON, NULL, 0), TAG, "INVON failed");
+    ESP_RETURN_ON_ERROR(send_cmd(ST7796_CMD_DISPON, NULL, 0), TAG, "DISPON failed");
+
+    // Two DMA-capable band buffers: LVGL renders into one while the other is sent.
+    lv_color_t *buf1 = heap_caps_malloc(buf_px * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    lv_color_t *buf2 = heap_caps_malloc(buf_px * sizeof(lv_color_t), MALLOC_CAP_DMA);
+    if (!buf1 || !buf2) {
+        heap_caps_free(buf1);
+        heap_caps_free(buf2);
+        ESP_LOGE(TAG, "draw buffer alloc failed");
+        return ESP_ERR_NO_MEM;
+    }
+    lv_disp_draw_buf_init(&s_draw_buf, buf1, buf2, (uint32_t)buf_px);
+
+    lv_disp_drv_init(&s_disp_drv);
+    s_disp_drv.draw_buf = &s_draw_buf;
+    s_disp_drv.flush_cb = st7796_flush_cb;
+    s_disp_drv.wait_cb = st7796_wait_cb;
+    ESP_RETURN_ON_FALSE(lv_disp_drv_register(&s_disp_drv), ESP_FAIL, TAG, "display register failed");
+
+    ESP_RETURN_ON_ERROR(backlight_init(), TAG, "backlight init failed");
+    ESP_RETURN_ON_ERROR(backlight_set_percent(100, 0), TAG, "backlight on failed");
+    ESP_LOGI(TAG, "Flush pipeline: 2 x %u px buffers, SPI %d Hz", (unsigned)buf_px,
+             CONFIG_LVGL_DISPLAY_SPI_CLOCK_HZ);
     return ESP_OK;
 }
 
@@ -15,4 +263,3 @@ lv_obj_t *st7796_get_root(void)
 {
     return &s_root;
 }
-
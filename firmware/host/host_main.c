@@ -0,0 +1,499 @@
+// Host (Linux) entry point. Boots app_main() against the simulated peripherals in
+// shims/ and prints boot, frame and weather-fetch timings as BENCH lines on stdout.
+//
+// The frame and boot paths are timed by wrapping lv_task_handler() and
+// ui_shell_update_boot_status() at link time (see --wrap in CMakeLists.txt), so the
+// firmware sources build unmodified. Fetches run on the weather task; their timings
+// come from weather_service_get_stats().
+// lv_font_cache_glyphs() is wrapped the same way so --no-glyph-atlas can measure
+// the clock face without its digit atlas.
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "host_sim.h"
+#include "lvgl.h"
+#include "lvgl_port.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "time_service.h"
+#include "ui_shell.h"
+#include "weather_service.h"
+
+void app_main(void);
+
+// --require-time-restore: how far the first sync after the wake may find the restored
+// clock off. Both runs share the host's clocks, so only a bad restore gets near it.
+#define MAX_RESTORE_ERROR_US 50000
+
+typedef struct {
+    uint32_t count;
+    int64_t total_us;
+    int64_t min_us;
+    int64_t max_us;
+} host_timing_t;
+
+typedef struct {
+    uint32_t seconds;
+    uint32_t state_seconds;
+    const char *fixture_path;
+    const char *ssid;
+    uint32_t http_latency_ms;
+    uint32_t http_chunk;
+    uint32_t tls_handshake_ms;
+    uint32_t tls_resume_ms;
+    uint32_t http_idle_close_ms;
+    bool chunked;
+    bool quiet;
+    bool require_fetch;
+    bool require_time_restore;
+    bool deep_sleep;
+    const char *rtc_memory_path;
+    bool no_glyph_atlas;
+    int64_t max_boot_us;
+    int64_t max_frame_mean_us;
+    int64_t max_fetch_mean_us;
+} host_options_t;
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static host_timing_t s_frame;
+static host_timing_t s_render;
+static int64_t s_boot_us = -1;
+static lv_refr_stats_t s_refr;
+static uint64_t s_dirty_rects_total = 0;
+static uint64_t s_bands_total = 0;
+static uint64_t s_overlaps_total = 0;
+static uint64_t s_glyphs_cached_total = 0;
+static uint64_t s_glyphs_raster_total = 0;
+static bool s_no_glyph_atlas = false;
+static uint32_t s_forecasts = 0; // Weather updates that carried a parsed forecast
+
+static void timing_record(host_timing_t *t, int64_t us)
+{
+    pthread_mutex_lock(&s_lock);
+    if (t->count == 0 || us < t->min_us) {
+        t->min_us = us;
+    }
+    if (us > t->max_us) {
+        t->max_us = us;
+    }
+    t->count++;
+    t->total_us += us;
+    pthread_mutex_unlock(&s_lock);
+}
+
+static int64_t timing_mean(const host_timing_t *t)
+{
+    return t->count ? t->total_us / t->count : 0;
+}
+
+uint32_t __real_lv_task_handler(void);
+uint32_t __wrap_lv_task_handler(void)
+{
+    int64_t start = esp_timer_get_time();
+    uint32_t next = __real_lv_task_handler();
+    timing_record(&s_frame, esp_timer_get_time() - start);
+
+    lv_refr_stats_t refr;
+    lv_refr_get_stats(&refr);
+    pthread_mutex_lock(&s_lock);
+    const bool redrew = refr.frames != s_refr.frames;
+    if (redrew) {
+        s_dirty_rects_total += refr.dirty_rects;
+        s_bands_total += refr.flushed_bands;
+        s_overlaps_total += refr.flush_overlaps;
+        s_glyphs_cached_total += refr.glyphs_cached;
+        s_glyphs_raster_total += refr.glyphs_raster;
+    }
+    s_refr = refr;
+    pthread_mutex_unlock(&s_lock);
+
+    if (redrew) {
+        timing_record(&s_render, refr.render_us);
+    }
+    return next;
+}
+
+bool __real_lv_font_cache_glyphs(lv_font_t *font, const char *letters);
+bool __wrap_lv_font_cache_glyphs(lv_font_t *font, const char *letters)
+{
+    if (s_no_glyph_atlas) {
+        return false;
+    }
+    return __real_lv_font_cache_glyphs(font, letters);
+}
+
+void __real_ui_shell_update_boot_status(const char *module_name, uint8_t percent);
+void __wrap_ui_shell_update_boot_status(const char *module_name, uint8_t percent)
+{
+    __real_ui_shell_update_boot_status(module_name, percent);
+    if (percent >= 100) {
+        pthread_mutex_lock(&s_lock);
+        if (s_boot_us < 0) {
+            s_boot_us = esp_timer_get_time();
+        }
+        pthread_mutex_unlock(&s_lock);
+    }
+}
+
+void __real_ui_shell_update_weather_data(const weather_data_t *data);
+void __wrap_ui_shell_update_weather_data(const weather_data_t *data)
+{
+    if (data && strcmp(data->condition, "Offline") != 0) {
+        pthread_mutex_lock(&s_lock);
+        s_forecasts++;
+        pthread_mutex_unlock(&s_lock);
+    }
+    __real_ui_shell_update_weather_data(data);
+}
+
+static void run_for_us(int64_t duration_us)
+{
+    int64_t end = esp_timer_get_time() + duration_us;
+    while (esp_timer_get_time() < end) {
+        struct timespec ts = {.tv_sec = 0, .tv_nsec = 10 * 1000000L};
+        nanosleep(&ts, NULL);
+    }
+}
+
+static double wakeups_per_s(ui_brightness_state_t state, uint32_t seconds)
+{
+    ui_shell_set_brightness_state(state);
+    run_for_us(100 * 1000); // Not counting the wakeup caused by the switch itself
+    uint32_t before = lvgl_port_get_wakeups();
+    int64_t start = esp_timer_get_time();
+    run_for_us((int64_t)seconds * 1000000);
+    uint32_t wakeups = lvgl_port_get_wakeups() - before;
+    return wakeups * 1e6 / (double)(esp_timer_get_time() - start);
+}
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  --seconds N             run time after boot (default 3)\n"
+            "  --state-seconds N       time in each display state for the wakeup report (default 1)\n"
+            "  --fixture FILE          weather response body to serve\n"
+            "  --http-latency-ms N     delay before the first response byte\n"
+            "  --http-chunk N          bytes per HTTP_EVENT_ON_DATA (default 512)\n"
+            "  --chunked               serve the body with chunked transfer encoding\n"
+            "  --tls-handshake-ms N    cost of a full TLS handshake on a new connection\n"
+            "  --tls-resume-ms N       cost of a handshake resuming a saved TLS session\n"
+            "  --http-idle-close-ms N  server closes kept connections idle this long\n"
+            "  --ssid NAME             stored Wi-Fi credentials (\"\" boots into the portal)\n"
+            "  --quiet                 only log warnings and errors\n"
+            "  --require-fetch         fail unless a weather fetch delivered a parsed forecast\n"
+            "  --rtc-memory FILE       keep RTC memory in FILE across runs; a run that finds it wakes from deep sleep\n"
+            "  --deep-sleep            enter deep sleep at the end of the run instead of exiting\n"
+            "  --require-time-restore  fail unless the clock was restored from RTC memory before the clock screen\n"
+            "  --no-glyph-atlas        render the clock digits without the glyph atlas\n"
+            "  --max-boot-us N         fail if the clock screen takes longer to appear\n"
+            "  --max-frame-mean-us N   fail if the mean lv_task_handler time is higher\n"
+            "  --max-fetch-mean-us N   fail if the mean weather fetch time is higher\n",
+            argv0);
+}
+
+static bool parse_options(int argc, char **argv, host_options_t *opt)
+{
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool takes_value = true;
+
+        if (strcmp(arg, "--seconds") == 0 && val) {
+            opt->seconds = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "--state-seconds") == 0 && val) {
+            opt->state_seconds = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "--fixture") == 0 && val) {
+            opt->fixture_path = val;
+        } else if (strcmp(arg, "--http-latency-ms") == 0 && val) {
+            opt->http_latency_ms = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "--http-chunk") == 0 && val) {
+            opt->http_chunk = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "--tls-handshake-ms") == 0 && val) {
+            opt->tls_handshake_ms = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "--tls-resume-ms") == 0 && val) {
+            opt->tls_resume_ms = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "--http-idle-close-ms") == 0 && val) {
+            opt->http_idle_close_ms = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "--rtc-memory") == 0 && val) {
+            opt->rtc_memory_path = val;
+        } else if (strcmp(arg, "--ssid") == 0 && val) {
+            opt->ssid = val;
+        } else if (strcmp(arg, "--max-boot-us") == 0 && val) {
+            opt->max_boot_us = strtoll(val, NULL, 10);
+        } else if (strcmp(arg, "--max-frame-mean-us") == 0 && val) {
+            opt->max_frame_mean_us = strtoll(val, NULL, 10);
+        } else if (strcmp(arg, "--max-fetch-mean-us") == 0 && val) {
+            opt->max_fetch_mean_us = strtoll(val, NULL, 10);
+        } else {
+            takes_value = false;
+            if (strcmp(arg, "--chunked") == 0) {
+                opt->chunked = true;
+            } else if (strcmp(arg, "--quiet") == 0) {
+                opt->quiet = true;
+            } else if (strcmp(arg, "--require-fetch") == 0) {
+                opt->require_fetch = true;
+            } else if (strcmp(arg, "--require-time-restore") == 0) {
+                opt->require_time_restore = true;
+            } else if (strcmp(arg, "--deep-sleep") == 0) {
+                opt->deep_sleep = true;
+            } else if (strcmp(arg, "--no-glyph-atlas") == 0) {
+                opt->no_glyph_atlas = true;
+            } else {
+                return false;
+            }
+        }
+
+        if (takes_value) {
+            i++;
+        }
+    }
+    return true;
+}
+
+static char *read_file(const char *path, size_t *out_len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    long len = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc((size_t)len + 1);
+    if (buf && fread(buf, 1, (size_t)len, f) != (size_t)len) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    if (buf) {
+        buf[len] = '\0';
+        *out_len = (size_t)len;
+    }
+    return buf;
+}
+
+static void seed_wifi_credentials(const char *ssid)
+{
+    if (!ssid || ssid[0] == '\0') {
+        return;
+    }
+    nvs_handle_t handle;
+    nvs_flash_init();
+    if (nvs_open("wifi", NVS_READWRITE, &handle) == ESP_OK) {
+        nvs_set_str(handle, "ssid", ssid);
+        nvs_set_str(handle, "password", "host-bench");
+        nvs_commit(handle);
+        nvs_close(handle);
+    }
+}
+
+static void print_timing(const char *name, const host_timing_t *t)
+{
+    printf("BENCH %s count=%u mean_us=%lld min_us=%lld max_us=%lld\n", name, t->count,
+           (long long)timing_mean(t), (long long)t->min_us, (long long)t->max_us);
+}
+
+int main(int argc, char **argv)
+{
+    host_options_t opt = {
+        .seconds = 3,
+        .state_seconds = 1,
+        .ssid = "SmartClock-Bench",
+        .http_chunk = 512,
+        .max_boot_us = -1,
+        .max_frame_mean_us = -1,
+        .max_fetch_mean_us = -1,
+    };
+    if (!parse_options(argc, argv, &opt)) {
+        usage(argv[0]);
+        return 2;
+    }
+
+    if (opt.quiet) {
+        esp_log_level_set("*", ESP_LOG_WARN);
+    }
+
+    host_http_fixture_t fixture = {
+        .chunk_size = opt.http_chunk,
+        .chunked = opt.chunked,
+        .latency_ms = opt.http_latency_ms,
+        .tls_handshake_ms = opt.tls_handshake_ms,
+        .tls_resume_ms = opt.tls_resume_ms,
+        .idle_close_ms = opt.http_idle_close_ms,
+    };
+    char *fixture_body = NULL;
+    if (opt.fixture_path) {
+        fixture_body = read_file(opt.fixture_path, &fixture.body_len);
+        if (!fixture_body) {
+            fprintf(stderr, "cannot read fixture %s\n", opt.fixture_path);
+            return 2;
+        }
+        fixture.body = fixture_body;
+    }
+    host_http_set_fixture(&fixture);
+    seed_wifi_credentials(opt.ssid);
+    s_no_glyph_atlas = opt.no_glyph_atlas;
+    if (opt.rtc_memory_path && !host_rtc_memory_attach(opt.rtc_memory_path)) {
+        fprintf(stderr, "ignoring RTC memory in %s from another build: booting from power-on\n", opt.rtc_memory_path);
+    }
+
+    app_main();
+
+    // Let the UI loop, Wi-Fi connect and weather fetch run for the requested time.
+    run_for_us((int64_t)opt.seconds * 1000000);
+
+    pthread_mutex_lock(&s_lock);
+    host_timing_t frame = s_frame;
+    host_timing_t render = s_render;
+    int64_t boot_us = s_boot_us;
+    lv_refr_stats_t refr = s_refr;
+    uint64_t dirty_rects = s_dirty_rects_total;
+    uint64_t bands = s_bands_total;
+    uint64_t overlaps = s_overlaps_total;
+    uint64_t glyphs_cached = s_glyphs_cached_total;
+    uint64_t glyphs_raster = s_glyphs_raster_total;
+    pthread_mutex_unlock(&s_lock);
+
+    host_spi_stats_t spi;
+    host_spi_get_stats(&spi);
+
+    // Settled UI, one display state at a time.
+    double wakeups_active = 0, wakeups_dimmed = 0, wakeups_off = 0;
+    if (opt.state_seconds > 0) {
+        wakeups_active = wakeups_per_s(UI_BRIGHTNESS_ACTIVE, opt.state_seconds);
+        wakeups_dimmed = wakeups_per_s(UI_BRIGHTNESS_DIMMED, opt.state_seconds);
+        wakeups_off = wakeups_per_s(UI_BRIGHTNESS_OFF, opt.state_seconds);
+        ui_shell_set_brightness_state(UI_BRIGHTNESS_ACTIVE);
+    }
+
+    host_http_stats_t http;
+    host_http_get_stats(&http);
+    lv_mem_stats_t mem;
+    lv_mem_get_stats(&mem);
+    const size_t ui_stack_peak = host_task_stack_peak("lv_ui");
+    const size_t ui_stack_size = host_task_stack_size("lv_ui");
+    lv_anim_stats_t anim;
+    lv_anim_get_stats(&anim);
+    lv_frame_stats_t frames = {0};
+    ui_shell_get_frame_stats(&frames);
+    weather_service_stats_t weather = {0};
+    weather_service_get_stats(&weather);
+    time_service_stats_t sntp = {0};
+    time_service_get_stats(&sntp);
+    const int64_t fetch_mean_us = weather.fetches ? (int64_t)(weather.total_fetch_us / weather.fetches) : 0;
+
+    printf("BENCH boot clock_screen_us=%lld\n", (long long)boot_us);
+    print_timing("frame", &frame);
+    printf("BENCH fetch count=%u mean_us=%lld max_us=%u failures=%u\n", weather.fetches, (long long)fetch_mean_us,
+           weather.max_fetch_us, weather.failures);
+    printf("BENCH weather requests=%u coalesced=%u caller_max_us=%u caller_total_us=%llu cache_hits=%u "
+           "not_modified=%u served_stale=%u\n",
+           weather.requests, weather.coalesced, weather.caller_max_us, (unsigned long long)weather.caller_total_us,
+           weather.cache_hits, weather.not_modified, weather.served_stale);
+    printf("BENCH schedule scheduled=%u catch_ups=%u paused_skips=%u retry_level=%u next_fetch_in_ms=%lld\n",
+           weather.scheduled, weather.catch_ups, weather.paused_skips, weather.retry_level,
+           weather.next_fetch_us < 0 ? -1LL : (long long)((weather.next_fetch_us - esp_timer_get_time()) / 1000));
+    printf("BENCH time syncs=%u slews=%u steps=%u failed=%u answered=%u falsetickers=%u offset_us=%lld rtt_us=%d "
+           "drift_ppb=%d interval_s=%u restored=%d time_to_correct_us=%lld restore_error_us=%lld\n",
+           sntp.syncs, sntp.slews, sntp.steps, sntp.failed, sntp.last_answered, sntp.last_falsetickers,
+           (long long)sntp.last_offset_us, sntp.last_rtt_us, sntp.drift_ppb, sntp.interval_s, sntp.restored,
+           (long long)sntp.time_to_correct_us, (long long)sntp.restore_error_us);
+    print_timing("render", &render);
+    printf("BENCH glyphs cached=%llu rasterized=%llu\n", (unsigned long long)glyphs_cached,
+           (unsigned long long)glyphs_raster);
+    printf("BENCH dirty redraws=%u total_px=%llu px_per_redraw=%llu rects_per_redraw=%llu\n", refr.frames,
+           (unsigned long long)refr.total_dirty_px,
+           (unsigned long long)(refr.frames ? refr.total_dirty_px / refr.frames : 0),
+           (unsigned long long)(refr.frames ? dirty_rects / refr.frames : 0));
+    printf("BENCH flush bands=%llu overlapped=%llu spi_bytes=%llu spi_busy_us=%llu\n", (unsigned long long)bands,
+           (unsigned long long)overlaps, (unsigned long long)spi.bytes, (unsigned long long)spi.busy_us);
+    printf("BENCH wakeups active_per_s=%.1f dimmed_per_s=%.1f off_per_s=%.1f\n", wakeups_active, wakeups_dimmed,
+           wakeups_off);
+    printf("BENCH frames count=%u dropped=%u worst_us=%u timer_p95_us=%u layout_p95_us=%u render_p95_us=%u "
+           "flush_p95_us=%u total_p95_us=%u\n",
+           frames.frames, frames.dropped, frames.worst.total_us, lv_frame_hist_percentile(&frames.timer, 95),
+           lv_frame_hist_percentile(&frames.layout, 95), lv_frame_hist_percentile(&frames.render, 95),
+           lv_frame_hist_percentile(&frames.flush, 95), lv_frame_hist_percentile(&frames.total, 95));
+    printf("BENCH frame_hist total_us");
+    for (int i = 0; i < LV_FRAME_HIST_BUCKETS; i++) {
+        if (i < LV_FRAME_HIST_BUCKETS - 1) {
+            printf(" le%u=%u", lv_frame_hist_bounds_us[i], frames.total.buckets[i]);
+        } else {
+            printf(" gt%u=%u", lv_frame_hist_bounds_us[i - 1], frames.total.buckets[i]);
+        }
+    }
+    printf("\n");
+    printf("BENCH anim running=%u passes=%u dropped_frames=%u budget_overruns=%u\n", anim.running, anim.passes,
+           anim.dropped_frames, anim.budget_overruns);
+    printf("BENCH mem obj_used=%u obj_high_water=%u obj_capacity=%u timer_used=%u anim_high_water=%u "
+           "failures=%u\n",
+           mem.obj.used, mem.obj.high_water, mem.obj.capacity, mem.timer.used, mem.anim.high_water,
+           mem.obj.failures + mem.timer.failures + mem.anim.failures);
+    printf("BENCH ui_stack peak=%u size=%u free_min=%u\n", (unsigned)ui_stack_peak, (unsigned)ui_stack_size,
+           refr.stack_free_min);
+    printf("BENCH http requests=%u bytes=%llu\n", http.requests, (unsigned long long)http.bytes);
+    printf("BENCH tls handshakes=%u resumed=%u handshake_mean_us=%llu reused=%u reconnects=%u\n", weather.handshakes,
+           http.resumed,
+           (unsigned long long)(weather.handshakes ? weather.total_handshake_us / weather.handshakes : 0),
+           weather.reused, weather.reconnects);
+    fflush(stdout);
+
+    int rc = 0;
+    if (boot_us < 0) {
+        fprintf(stderr, "FAIL: clock screen never appeared\n");
+        rc = 1;
+    }
+    if (opt.max_boot_us >= 0 && boot_us > opt.max_boot_us) {
+        fprintf(stderr, "FAIL: boot %lld us > %lld us\n", (long long)boot_us, (long long)opt.max_boot_us);
+        rc = 1;
+    }
+    if (opt.max_frame_mean_us >= 0 && timing_mean(&frame) > opt.max_frame_mean_us) {
+        fprintf(stderr, "FAIL: frame mean %lld us > %lld us\n", (long long)timing_mean(&frame),
+                (long long)opt.max_frame_mean_us);
+        rc = 1;
+    }
+    if (ui_stack_peak > ui_stack_size) {
+        fprintf(stderr, "FAIL: UI task used %u stack bytes of %u\n", (unsigned)ui_stack_peak,
+                (unsigned)ui_stack_size);
+        rc = 1;
+    }
+    if (opt.require_fetch && weather.fetches == 0) {
+        fprintf(stderr, "FAIL: no weather fetch completed\n");
+        rc = 1;
+    } else if (opt.require_fetch && s_forecasts == 0) {
+        fprintf(stderr, "FAIL: no weather fetch produced a forecast\n");
+        rc = 1;
+    }
+    if (opt.require_time_restore && !sntp.restored) {
+        fprintf(stderr, "FAIL: clock not restored from RTC memory\n");
+        rc = 1;
+    } else if (opt.require_time_restore && sntp.time_to_correct_us > boot_us) {
+        fprintf(stderr, "FAIL: clock right at %lld us, after the clock screen at %lld us\n",
+                (long long)sntp.time_to_correct_us, (long long)boot_us);
+        rc = 1;
+    } else if (opt.require_time_restore && sntp.syncs > 0 && llabs(sntp.restore_error_us) > MAX_RESTORE_ERROR_US) {
+        fprintf(stderr, "FAIL: restored clock %lld us off\n", (long long)sntp.restore_error_us);
+        rc = 1;
+    }
+    if (opt.max_fetch_mean_us >= 0 && fetch_mean_us > opt.max_fetch_mean_us) {
+        fprintf(stderr, "FAIL: fetch mean %lld us > %lld us\n", (long long)fetch_mean_us,
+                (long long)opt.max_fetch_mean_us);
+        rc = 1;
+    }
+
+    free(fixture_body);
+    if (opt.deep_sleep && rc == 0) {
+        esp_deep_sleep_start(); // Saves RTC memory for the next run, then exits
+    }
+    // Firmware tasks never return; leave without joining them.
+    exit(rc);
+}
@@ -0,0 +1,101 @@
+// Compares what the clock's consumers spend turning the time into local time each
+// second: before, the clock screen and the power manager each called localtime_r(),
+// which re-evaluates the TZ rule every time; now both call local_time_get(), which
+// breaks the time down with integer arithmetic under the offset cached until the
+// next DST change, once per second for both. Runs a stretch of consecutive seconds
+// spanning a DST change and prints one BENCH line per implementation.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "local_time.h"
+
+#define CONSUMERS 2 // ui_shell_update_clock() and the power manager's is_night_time()
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static volatile uint32_t s_sink;
+
+static void run_legacy(time_t start, uint32_t seconds)
+{
+    const uint64_t start_ns = now_ns();
+    for (uint32_t i = 0; i < seconds; i++) {
+        const time_t t = start + (time_t)i;
+        for (int c = 0; c < CONSUMERS; c++) {
+            struct tm info;
+            localtime_r(&t, &info);
+            s_sink += (uint32_t)(info.tm_hour * 60 + info.tm_min);
+        }
+    }
+    const uint64_t ns = now_ns() - start_ns;
+    printf("BENCH local_time impl=localtime_r seconds=%u calls=%u ns_per_second=%.1f\n", seconds, seconds * CONSUMERS,
+           (double)ns / seconds);
+}
+
+static void run_cached(time_t start, uint32_t seconds)
+{
+    const uint64_t start_ns = now_ns();
+    for (uint32_t i = 0; i < seconds; i++) {
+        const time_t t = start + (time_t)i;
+        for (int c = 0; c < CONSUMERS; c++) {
+            local_time_t lt;
+            local_time_get(t, &lt);
+            s_sink += (uint32_t)(lt.hour * 60 + lt.minute);
+        }
+    }
+    const uint64_t ns = now_ns() - start_ns;
+    local_time_stats_t st;
+    local_time_get_stats(&st);
+    printf("BENCH local_time impl=cached seconds=%u calls=%u ns_per_second=%.1f shared=%u conversions=%u "
+           "transitions=%u\n",
+           seconds, st.calls, (double)ns / seconds, st.shared, st.conversions, st.transitions);
+}
+
+// Both must agree on every second, including the ones either side of the change.
+static bool identical(time_t start, uint32_t seconds)
+{
+    for (uint32_t i = 0; i < seconds; i += 61) {
+        const time_t t = start + (time_t)i;
+        struct tm info;
+        localtime_r(&t, &info);
+        local_time_t lt;
+        local_time_get(t, &lt);
+        if (lt.hour != info.tm_hour || lt.minute != info.tm_min || lt.second != info.tm_sec ||
+            lt.mday != info.tm_mday || lt.wday != info.tm_wday || lt.dst != (info.tm_isdst > 0)) {
+            fprintf(stderr, "mismatch at %lld\n", (long long)t);
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = 2 * 86400;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--seconds") == 0) {
+            seconds = (uint32_t)strtoul(argv[i + 1], NULL, 10);
+        }
+    }
+
+    if (local_time_init(TIMEZONE_STRING) != ESP_OK) {
+        return 1;
+    }
+    // From a day before the default zone's 2026 spring change.
+    const time_t start = 1772953200 - 86400;
+    if (!identical(start, seconds)) {
+        return 1;
+    }
+    run_legacy(start, seconds);
+    local_time_init(TIMEZONE_STRING); // Drops the cache the check filled
+    run_cached(start, seconds);
+    return 0;
+}
@@ -0,0 +1,152 @@
+#include "esp_event.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_log.h"
+
+static const char *TAG = "esp_event";
+
+#define MAX_HANDLERS 16
+
+typedef struct {
+    esp_event_base_t base;
+    int32_t id;
+    esp_event_handler_t handler;
+    void *arg;
+} handler_entry_t;
+
+typedef struct posted_event {
+    esp_event_base_t base;
+    int32_t id;
+    void *data;
+    struct posted_event *next;
+} posted_event_t;
+
+static handler_entry_t s_handlers[MAX_HANDLERS];
+static int s_handler_count = 0;
+static posted_event_t *s_head = NULL;
+static posted_event_t *s_tail = NULL;
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_cond = PTHREAD_COND_INITIALIZER;
+static bool s_loop_created = false;
+
+static void dispatch(const posted_event_t *event)
+{
+    handler_entry_t snapshot[MAX_HANDLERS];
+    pthread_mutex_lock(&s_lock);
+    int count = s_handler_count;
+    memcpy(snapshot, s_handlers, sizeof(handler_entry_t) * (size_t)count);
+    pthread_mutex_unlock(&s_lock);
+
+    for (int i = 0; i < count; i++) {
+        const handler_entry_t *entry = &snapshot[i];
+        if (entry->base != event->base) {
+            continue;
+        }
+        if (entry->id != ESP_EVENT_ANY_ID && entry->id != event->id) {
+            continue;
+        }
+        entry->handler(entry->arg, event->base, event->id, event->data);
+    }
+}
+
+static void *event_loop_task(void *arg)
+{
+    (void)arg;
+    while (true) {
+        pthread_mutex_lock(&s_lock);
+        while (!s_head) {
+            pthread_cond_wait(&s_cond, &s_lock);
+        }
+        posted_event_t *event = s_head;
+        s_head = event->next;
+        if (!s_head) {
+            s_tail = NULL;
+        }
+        pthread_mutex_unlock(&s_lock);
+
+        dispatch(event);
+        free(event->data);
+        free(event);
+    }
+    return NULL;
+}
+
+esp_err_t esp_event_loop_create_default(void)
+{
+    pthread_mutex_lock(&s_lock);
+    if (s_loop_created) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    s_loop_created = true;
+    pthread_mutex_unlock(&s_lock);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, event_loop_task, NULL) != 0) {
+        return ESP_FAIL;
+    }
+    pthread_detach(thread);
+    return ESP_OK;
+}
+
+esp_err_t esp_event_handler_register(esp_event_base_t event_base, int32_t event_id,
+                                     esp_event_handler_t event_handler, void *event_handler_arg)
+{
+    if (!event_handler) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (s_handler_count >= MAX_HANDLERS) {
+        pthread_mutex_unlock(&s_lock);
+        ESP_LOGE(TAG, "handler table full");
+        return ESP_ERR_NO_MEM;
+    }
+    s_handlers[s_handler_count++] = (handler_entry_t){
+        .base = event_base,
+        .id = event_id,
+        .handler = event_handler,
+        .arg = event_handler_arg,
+    };
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t esp_event_post(esp_event_base_t event_base, int32_t event_id, const void *event_data,
+                         size_t event_data_size, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (!s_loop_created) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    posted_event_t *event = calloc(1, sizeof(*event));
+    if (!event) {
+        return ESP_ERR_NO_MEM;
+    }
+    event->base = event_base;
+    event->id = event_id;
+    if (event_data && event_data_size > 0) {
+        event->data = malloc(event_data_size);
+        if (!event->data) {
+            free(event);
+            return ESP_ERR_NO_MEM;
+        }
+        memcpy(event->data, event_data, event_data_size);
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (s_tail) {
+        s_tail->next = event;
+    } else {
+        s_head = event;
+    }
+    s_tail = event;
+    pthread_cond_signal(&s_cond);
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
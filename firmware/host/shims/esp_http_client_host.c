@@ -0,0 +1,422 @@
+#include "esp_http_client.h"
+
+#include <pthread.h>
+#include <stdlib.h>
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+#include <string.h>
+#include <strings.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host_internal.h"
+#include "host_sim.h"
+
+static const char *TAG = "http_client";
+
+// Recorded Open-Meteo response for the compiled-in coordinates, used when the harness
+// does not supply a fixture.
+static const char k_sample_forecast[] =
+    "{\"latitude\":38.68,\"longitude\":-84.59,\"generationtime_ms\":0.0560283660888672,"
+    "\"utc_offset_seconds\":-18000,\"timezone\":\"America/New_York\",\"timezone_abbreviation\":\"EST\","
+    "\"elevation\":282.0,\"current_units\":{\"time\":\"iso8601\",\"interval\":\"seconds\","
+    "\"temperature_2m\":\"°F\",\"apparent_temperature\":\"°F\",\"weather_code\":\"wmo code\"},"
+    "\"current\":{\"time\":\"2026-01-04T14:30\",\"interval\":900,\"temperature_2m\":41.3,"
+    "\"apparent_temperature\":35.8,\"weather_code\":3},"
+    "\"daily_units\":{\"time\":\"iso8601\",\"temperature_2m_max\":\"°F\",\"temperature_2m_min\":\"°F\","
+    "\"sunrise\":\"iso8601\",\"sunset\":\"iso8601\"},"
+    "\"daily\":{\"time\":[\"2026-01-04\"],\"temperature_2m_max\":[44.6],\"temperature_2m_min\":[29.1],"
+    "\"sunrise\":[\"2026-01-04T07:56\"],\"sunset\":[\"2026-01-04T17:42\"]}}";
+
+#define MAX_HEADERS 8
+#define DEFAULT_TIMEOUT_MS 5000 // esp_http_client's default
+
+typedef struct {
+    char *key;
+    char *value;
+} host_header_t;
+
+struct esp_http_client {
+    char *url;
+    http_event_handle_cb event_handler;
+    void *user_data;
+    int status_code;
+    int64_t content_length;
+    bool chunked;
+    bool connected;
+    bool save_session;
+    bool has_session; // A ticket from an earlier handshake
+    int timeout_ms;
+    int64_t last_used_us;
+    size_t heap_base; // Heap in use when the current request started
+    host_header_t headers[MAX_HEADERS];
+};
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static host_http_fixture_t s_fixture = {
+    .body = NULL,
+    .body_len = 0,
+    .status_code = 200,
+    .chunk_size = 512,
+    .chunked = false,
+    .latency_ms = 0,
+};
+static host_http_stats_t s_stats;
+static char s_last_url[512];
+
+void host_http_set_fixture(const host_http_fixture_t *fixture)
+{
+    pthread_mutex_lock(&s_lock);
+    s_fixture = *fixture;
+    if (s_fixture.status_code == 0) {
+        s_fixture.status_code = 200;
+    }
+    if (s_fixture.chunk_size == 0) {
+        s_fixture.chunk_size = 512;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+void host_http_get_stats(host_http_stats_t *out)
+{
+    pthread_mutex_lock(&s_lock);
+    *out = s_stats;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void host_http_get_last_url(char *buf, size_t size)
+{
+    pthread_mutex_lock(&s_lock);
+    snprintf(buf, size, "%s", s_last_url);
+    pthread_mutex_unlock(&s_lock);
+}
+
+void host_http_reset_stats(void)
+{
+    pthread_mutex_lock(&s_lock);
+    memset(&s_stats, 0, sizeof(s_stats));
+    pthread_mutex_unlock(&s_lock);
+}
+
+// Process-wide, so only meaningful while the request path is the one allocating.
+static size_t heap_in_use(void)
+{
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 33)
+    const struct mallinfo2 mi = mallinfo2();
+    return mi.uordblks + mi.hblkhd;
+#else
+    return 0;
+#endif
+}
+
+static void note_heap(esp_http_client_handle_t client)
+{
+    const size_t now = heap_in_use();
+    const size_t above = now > client->heap_base ? now - client->heap_base : 0;
+    pthread_mutex_lock(&s_lock);
+    if (above > s_stats.heap_peak) {
+        s_stats.heap_peak = above;
+    }
+    pthread_mutex_unlock(&s_lock);
+}
+
+static void emit(esp_http_client_handle_t client, esp_http_client_event_id_t id, void *data, int data_len,
+                 char *key, char *value)
+{
+    if (!client->event_handler) {
+        return;
+    }
+    esp_http_client_event_t evt = {
+        .event_id = id,
+        .client = client,
+        .data = data,
+        .data_len = data_len,
+        .user_data = client->user_data,
+        .header_key = key,
+        .header_value = value,
+    };
+    client->event_handler(&evt);
+    note_heap(client);
+}
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    if (!config || !config->url) {
+        return NULL;
+    }
+
+    esp_http_client_handle_t client = calloc(1, sizeof(*client));
+    if (!client) {
+        return NULL;
+    }
+    client->url = strdup(config->url);
+    client->event_handler = config->event_handler;
+    client->user_data = config->user_data;
+    client->save_session = config->save_client_session;
+    client->timeout_ms = config->timeout_ms > 0 ? config->timeout_ms : DEFAULT_TIMEOUT_MS;
+    client->content_length = -1;
+    return client;
+}
+
+esp_err_t esp_http_client_set_user_data(esp_http_client_handle_t client, void *data)
+{
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    client->user_data = data;
+    return ESP_OK;
+}
+
+// Opens the connection if needed. Fails like the device does when the request goes
+// out on a kept connection that the server has closed in the meantime.
+static esp_err_t client_connect(esp_http_client_handle_t client, const host_http_fixture_t *fixture)
+{
+    const int64_t now = esp_timer_get_time();
+    if (client->connected) {
+        if (fixture->idle_close_ms == 0 || now - client->last_used_us < (int64_t)fixture->idle_close_ms * 1000) {
+            return ESP_OK;
+        }
+        client->connected = false;
+        pthread_mutex_lock(&s_lock);
+        s_stats.dropped++;
+        pthread_mutex_unlock(&s_lock);
+        emit(client, HTTP_EVENT_DISCONNECTED, NULL, 0, NULL, NULL);
+        return ESP_ERR_HTTP_CONNECTION_CLOSED;
+    }
+
+    const bool resume = client->save_session && client->has_session;
+    host_sleep_ms(resume ? fixture->tls_resume_ms : fixture->tls_handshake_ms);
+    client->connected = true;
+    client->has_session = client->save_session;
+    pthread_mutex_lock(&s_lock);
+    s_stats.handshakes++;
+    s_stats.resumed += resume ? 1 : 0;
+    pthread_mutex_unlock(&s_lock);
+    emit(client, HTTP_EVENT_ON_CONNECTED, NULL, 0, NULL, NULL);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url)
+{
+    if (!client || !url) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    free(client->url);
+    client->url = strdup(url);
+    return ESP_OK;
+}
+
+static host_header_t *find_header(esp_http_client_handle_t client, const char *key)
+{
+    for (int i = 0; i < MAX_HEADERS; i++) {
+        if (client->headers[i].key && strcasecmp(client->headers[i].key, key) == 0) {
+            return &client->headers[i];
+        }
+    }
+    return NULL;
+}
+
+static const char *header_value(esp_http_client_handle_t client, const char *key)
+{
+    host_header_t *h = find_header(client, key);
+    return h ? h->value : NULL;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value)
+{
+    if (!client || !key || !value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    host_header_t *h = find_header(client, key);
+    for (int i = 0; !h && i < MAX_HEADERS; i++) {
+        if (!client->headers[i].key) {
+            h = &client->headers[i];
+            h->key = strdup(key);
+        }
+    }
+    if (!h) {
+        return ESP_ERR_NO_MEM;
+    }
+    free(h->value);
+    h->value = strdup(value);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_delete_header(esp_http_client_handle_t client, const char *key)
+{
+    if (!client || !key) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    host_header_t *h = find_header(client, key);
+    if (h) {
+        free(h->key);
+        free(h->value);
+        *h = (host_header_t){0};
+    }
+    return ESP_OK;
+}
+
+// Drops the connection the way a reset or a client-side timeout does.
+static esp_err_t client_abort(esp_http_client_handle_t client, esp_err_t err, bool timeout)
+{
+    pthread_mutex_lock(&s_lock);
+    s_stats.timeouts += timeout ? 1 : 0;
+    pthread_mutex_unlock(&s_lock);
+    esp_http_client_close(client);
+    return err;
+}
+
+static void deliver(esp_http_client_handle_t client, const host_http_fixture_t *fixture, const char *data, size_t n)
+{
+    emit(client, HTTP_EVENT_ON_DATA, (void *)data, (int)n, NULL, NULL);
+    pthread_mutex_lock(&s_lock);
+    s_stats.bytes += n;
+    pthread_mutex_unlock(&s_lock);
+    if (fixture->bandwidth_bps) {
+        host_sleep_us((uint32_t)((uint64_t)n * 1000000 / fixture->bandwidth_bps));
+    }
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client)
+{
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    host_http_fixture_t fixture = s_fixture;
+    const uint32_t request = ++s_stats.requests;
+    pthread_mutex_unlock(&s_lock);
+    bool faulty = fixture.fault != HOST_HTTP_FAULT_NONE &&
+                  (fixture.fault_every <= 1 || request % fixture.fault_every == 0);
+
+    client->heap_base = heap_in_use();
+    esp_err_t err = client_connect(client, &fixture);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    const char *body = fixture.body ? fixture.body : k_sample_forecast;
+    size_t body_len = fixture.body ? fixture.body_len : sizeof(k_sample_forecast) - 1;
+
+    const char *if_none_match = header_value(client, "If-None-Match");
+    const char *if_modified_since = header_value(client, "If-Modified-Since");
+    const bool not_modified = fixture.status_code == 200 &&
+                              ((if_none_match && fixture.etag && strcmp(if_none_match, fixture.etag) == 0) ||
+                               (if_modified_since && fixture.last_modified &&
+                                strcmp(if_modified_since, fixture.last_modified) == 0));
+    if (not_modified) {
+        body_len = 0;
+    }
+    faulty &= fixture.fault_at <= body_len;
+    pthread_mutex_lock(&s_lock);
+    s_stats.conditional += (if_none_match || if_modified_since) ? 1 : 0;
+    s_stats.not_modified += not_modified ? 1 : 0;
+    s_stats.faults += faulty ? 1 : 0;
+    snprintf(s_last_url, sizeof(s_last_url), "%s", client->url);
+    pthread_mutex_unlock(&s_lock);
+
+    ESP_LOGD(TAG, "GET %s", client->url);
+    if (fixture.latency_ms >= (uint32_t)client->timeout_ms || (faulty && fixture.fault == HOST_HTTP_FAULT_NO_RESPONSE)) {
+        host_sleep_ms((uint32_t)client->timeout_ms);
+        return client_abort(client, ESP_ERR_HTTP_FETCH_HEADER, true);
+    }
+    host_sleep_ms(fixture.latency_ms);
+
+    client->status_code = not_modified ? 304 : fixture.status_code;
+    client->chunked = fixture.chunked;
+    client->content_length = fixture.chunked ? -1 : (int64_t)body_len;
+
+    emit(client, HTTP_EVENT_HEADERS_SENT, NULL, 0, NULL, NULL);
+    emit(client, HTTP_EVENT_ON_HEADER, NULL, 0, "Content-Type", "application/json; charset=utf-8");
+    if (fixture.chunked) {
+        emit(client, HTTP_EVENT_ON_HEADER, NULL, 0, "Transfer-Encoding", "chunked");
+    }
+    if (fixture.etag) {
+        emit(client, HTTP_EVENT_ON_HEADER, NULL, 0, "ETag", (char *)fixture.etag);
+    }
+    if (fixture.last_modified) {
+        emit(client, HTTP_EVENT_ON_HEADER, NULL, 0, "Last-Modified", (char *)fixture.last_modified);
+    }
+
+    for (size_t off = 0;;) {
+        if (faulty && off == fixture.fault_at) {
+            faulty = false;
+            if (fixture.fault == HOST_HTTP_FAULT_TRUNCATE) {
+                // A clean close mid-body: the request itself succeeds, short.
+                esp_http_client_close(client);
+                break;
+            }
+            if (fixture.fault == HOST_HTTP_FAULT_RESET) {
+                return client_abort(client, ESP_FAIL, false);
+            }
+            if (fixture.stall_ms >= (uint32_t)client->timeout_ms) {
+                host_sleep_ms((uint32_t)client->timeout_ms);
+                return client_abort(client, ESP_FAIL, true);
+            }
+            host_sleep_ms(fixture.stall_ms);
+        }
+        if (off >= body_len) {
+            break;
+        }
+        size_t n = body_len - off < fixture.chunk_size ? body_len - off : fixture.chunk_size;
+        if (faulty && off < fixture.fault_at && off + n > fixture.fault_at) {
+            n = fixture.fault_at - off;
+        }
+        deliver(client, &fixture, body + off, n);
+        off += n;
+    }
+    client->last_used_us = esp_timer_get_time();
+
+    emit(client, HTTP_EVENT_ON_FINISH, NULL, 0, NULL, NULL);
+    return ESP_OK;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client)
+{
+    return client ? client->status_code : -1;
+}
+
+int64_t esp_http_client_get_content_length(esp_http_client_handle_t client)
+{
+    return client ? client->content_length : -1;
+}
+
+bool esp_http_client_is_chunked_response(esp_http_client_handle_t client)
+{
+    return client ? client->chunked : false;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t client)
+{
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (client->connected) {
+        client->connected = false;
+        emit(client, HTTP_EVENT_DISCONNECTED, NULL, 0, NULL, NULL);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
+{
+    if (!client) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    esp_http_client_close(client);
+    for (int i = 0; i < MAX_HEADERS; i++) {
+        free(client->headers[i].key);
+        free(client->headers[i].value);
+    }
+    free(client->url);
+    free(client);
+    return ESP_OK;
+}
+
+esp_err_t esp_crt_bundle_attach(void *conf)
+{
+    (void)conf;
+    return ESP_OK;
+}
@@ -0,0 +1,111 @@
+#include "cJSON.h"
+#include "esp_http_server.h"
+
+#include <stddef.h>
+
+#include "esp_log.h"
+
+static const char *TAG = "httpd";
+
+static int s_server_token;
+
+esp_err_t httpd_start(httpd_handle_t *handle, const httpd_config_t *config)
+{
+    if (!handle || !config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    ESP_LOGI(TAG, "portal server registered on port %u (host build: no listener)", config->server_port);
+    *handle = &s_server_token;
+    return ESP_OK;
+}
+
+esp_err_t httpd_stop(httpd_handle_t handle)
+{
+    (void)handle;
+    return ESP_OK;
+}
+
+esp_err_t httpd_register_uri_handler(httpd_handle_t handle, const httpd_uri_t *uri_handler)
+{
+    return (handle && uri_handler) ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+int httpd_req_recv(httpd_req_t *r, char *buf, size_t buf_len)
+{
+    (void)r;
+    (void)buf;
+    (void)buf_len;
+    return -1;
+}
+
+esp_err_t httpd_resp_set_type(httpd_req_t *r, const char *type)
+{
+    (void)r;
+    (void)type;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send(httpd_req_t *r, const char *buf, ssize_t buf_len)
+{
+    (void)r;
+    (void)buf;
+    (void)buf_len;
+    return ESP_OK;
+}
+
+esp_err_t httpd_resp_send_err(httpd_req_t *req, httpd_err_code_t error, const char *msg)
+{
+    (void)req;
+    (void)error;
+    (void)msg;
+    return ESP_FAIL;
+}
+
+// ---- cJSON -------------------------------------------------------------------
+
+cJSON *cJSON_Parse(const char *value)
+{
+    (void)value;
+    return NULL;
+}
+
+cJSON *cJSON_GetObjectItem(const cJSON *object, const char *string)
+{
+    (void)object;
+    (void)string;
+    return NULL;
+}
+
+int cJSON_IsString(const cJSON *item)
+{
+    return item && item->valuestring;
+}
+
+cJSON *cJSON_CreateObject(void)
+{
+    return NULL;
+}
+
+cJSON *cJSON_AddStringToObject(cJSON *object, const char *name, const char *string)
+{
+    (void)object;
+    (void)name;
+    (void)string;
+    return NULL;
+}
+
+char *cJSON_PrintUnformatted(const cJSON *item)
+{
+    (void)item;
+    return NULL;
+}
+
+void cJSON_Delete(cJSON *item)
+{
+    (void)item;
+}
+
+void cJSON_free(void *object)
+{
+    (void)object;
+}
@@ -0,0 +1,283 @@
+#include "esp_err.h"
+#include "esp_log.h"
+#include "esp_private/esp_clk.h"
+#include "esp_random.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_http_client.h"
+#include "host_internal.h"
+#include "host_sim.h"
+#include "nvs.h"
+
+static const char *TAG = "host";
+
+static esp_log_level_t s_log_level = ESP_LOG_INFO;
+static pthread_mutex_t s_log_lock = PTHREAD_MUTEX_INITIALIZER;
+static int64_t s_boot_monotonic_us = 0;
+
+static int64_t monotonic_us(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (int64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+__attribute__((constructor)) static void host_boot_clock_init(void)
+{
+    s_boot_monotonic_us = monotonic_us();
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return monotonic_us() - s_boot_monotonic_us;
+}
+
+void host_deadline_from_esp_time(int64_t esp_time_us, struct timespec *out)
+{
+    int64_t abs_us = esp_time_us + s_boot_monotonic_us;
+    out->tv_sec = (time_t)(abs_us / 1000000);
+    out->tv_nsec = (long)((abs_us % 1000000) * 1000);
+}
+
+void host_cond_init_monotonic(pthread_cond_t *cond)
+{
+    pthread_condattr_t attr;
+    pthread_condattr_init(&attr);
+    pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+    pthread_cond_init(cond, &attr);
+    pthread_condattr_destroy(&attr);
+}
+
+void host_sleep_us(uint32_t us)
+{
+    struct timespec ts = {
+        .tv_sec = (time_t)(us / 1000000),
+        .tv_nsec = (long)((us % 1000000) * 1000L),
+    };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+void host_sleep_ms(uint32_t ms)
+{
+    struct timespec ts = {
+        .tv_sec = (time_t)(ms / 1000),
+        .tv_nsec = (long)((ms % 1000) * 1000000L),
+    };
+    while (nanosleep(&ts, &ts) != 0 && errno == EINTR) {
+    }
+}
+
+// ---- Logging ---------------------------------------------------------------
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    // Per-tag filtering is not needed on the host; any tag sets the global level.
+    (void)tag;
+    s_log_level = level;
+}
+
+uint32_t esp_log_timestamp(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
+
+void esp_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    if (level > s_log_level || level == ESP_LOG_NONE) {
+        return;
+    }
+
+    static const char letters[] = {'N', 'E', 'W', 'I', 'D', 'V'};
+    va_list args;
+    va_start(args, format);
+    pthread_mutex_lock(&s_log_lock);
+    fprintf(stderr, "%c (%u) %s: ", letters[level], esp_log_timestamp(), tag);
+    vfprintf(stderr, format, args);
+    fputc('\n', stderr);
+    pthread_mutex_unlock(&s_log_lock);
+    va_end(args);
+}
+
+// ---- Errors ----------------------------------------------------------------
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+    case ESP_OK:
+        return "ESP_OK";
+    case ESP_FAIL:
+        return "ESP_FAIL";
+    case ESP_ERR_NO_MEM:
+        return "ESP_ERR_NO_MEM";
+    case ESP_ERR_INVALID_ARG:
+        return "ESP_ERR_INVALID_ARG";
+    case ESP_ERR_INVALID_STATE:
+        return "ESP_ERR_INVALID_STATE";
+    case ESP_ERR_INVALID_SIZE:
+        return "ESP_ERR_INVALID_SIZE";
+    case ESP_ERR_NOT_FOUND:
+        return "ESP_ERR_NOT_FOUND";
+    case ESP_ERR_NOT_SUPPORTED:
+        return "ESP_ERR_NOT_SUPPORTED";
+    case ESP_ERR_TIMEOUT:
+        return "ESP_ERR_TIMEOUT";
+    case ESP_ERR_INVALID_RESPONSE:
+        return "ESP_ERR_INVALID_RESPONSE";
+    case ESP_ERR_NVS_NOT_FOUND:
+        return "ESP_ERR_NVS_NOT_FOUND";
+    case ESP_ERR_HTTP_CONNECT:
+        return "ESP_ERR_HTTP_CONNECT";
+    case ESP_ERR_HTTP_FETCH_HEADER:
+        return "ESP_ERR_HTTP_FETCH_HEADER";
+    case ESP_ERR_HTTP_CONNECTION_CLOSED:
+        return "ESP_ERR_HTTP_CONNECTION_CLOSED";
+    default:
+        return "UNKNOWN ERROR";
+    }
+}
+
+void esp_host_error_check_failed(esp_err_t rc, const char *file, int line, const char *function, const char *expression)
+{
+    fprintf(stderr, "ESP_ERROR_CHECK failed: esp_err_t 0x%x (%s) at %s:%d\nfunc: %s\nexpression: %s\n",
+            (unsigned)rc, esp_err_to_name(rc), file, line, function, expression);
+    abort();
+}
+
+// ---- Sleep -----------------------------------------------------------------
+
+// The RTC_DATA_ATTR variables of whatever was linked in; absent when there are none.
+extern char __start_rtc_data[] __attribute__((weak));
+extern char __stop_rtc_data[] __attribute__((weak));
+
+#define DEEP_SLEEP_HOOKS_MAX 4
+
+static const char *s_rtc_memory_path = NULL;
+static esp_sleep_wakeup_cause_t s_wakeup_cause = ESP_SLEEP_WAKEUP_UNDEFINED;
+static esp_deep_sleep_cb_t s_deep_sleep_hooks[DEEP_SLEEP_HOOKS_MAX];
+static size_t s_deep_sleep_hook_count = 0;
+
+static size_t rtc_memory_size(void)
+{
+    return __start_rtc_data ? (size_t)(__stop_rtc_data - __start_rtc_data) : 0;
+}
+
+bool host_rtc_memory_attach(const char *path)
+{
+    s_rtc_memory_path = path;
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return true; // Nothing saved yet: a power-on
+    }
+    const size_t size = rtc_memory_size();
+    char buf[4096];
+    const size_t got = fread(buf, 1, sizeof(buf), f);
+    fclose(f);
+    if (size == 0 || got != size) {
+        ESP_LOGE(TAG, "%s holds %u bytes of RTC memory, this build has %u", path, (unsigned)got, (unsigned)size);
+        return false;
+    }
+    memcpy(__start_rtc_data, buf, size);
+    s_wakeup_cause = ESP_SLEEP_WAKEUP_TIMER;
+    return true;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void)
+{
+    return s_wakeup_cause;
+}
+
+esp_err_t esp_deep_sleep_register_hook(esp_deep_sleep_cb_t new_dslp_cb)
+{
+    for (size_t i = 0; i < s_deep_sleep_hook_count; i++) {
+        if (s_deep_sleep_hooks[i] == new_dslp_cb) {
+            return ESP_OK;
+        }
+    }
+    if (s_deep_sleep_hook_count == DEEP_SLEEP_HOOKS_MAX) {
+        return ESP_ERR_NO_MEM;
+    }
+    s_deep_sleep_hooks[s_deep_sleep_hook_count++] = new_dslp_cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us)
+{
+    ESP_LOGI(TAG, "deep sleep wakeup timer armed for %llu us", (unsigned long long)time_in_us);
+    return ESP_OK;
+}
+
+void esp_deep_sleep_start(void)
+{
+    for (size_t i = 0; i < s_deep_sleep_hook_count; i++) {
+        s_deep_sleep_hooks[i]();
+    }
+    if (s_rtc_memory_path) {
+        FILE *f = fopen(s_rtc_memory_path, "wb");
+        if (!f || fwrite(__start_rtc_data, 1, rtc_memory_size(), f) != rtc_memory_size()) {
+            ESP_LOGE(TAG, "cannot save RTC memory to %s", s_rtc_memory_path);
+        }
+        if (f) {
+            fclose(f);
+        }
+    }
+    ESP_LOGW(TAG, "deep sleep requested, ending host process");
+    fflush(stdout);
+    exit(0);
+}
+
+uint64_t esp_clk_rtc_time(void)
+{
+    return (uint64_t)monotonic_us();
+}
+
+// ---- Random numbers ----------------------------------------------------------
+
+// The hardware RNG becomes a per-process xorshift; jitter only needs it to differ
+// between calls, not to be unpredictable.
+uint32_t esp_random(void)
+{
+    static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    static uint32_t state = 0;
+    pthread_mutex_lock(&lock);
+    if (state == 0) {
+        state = (uint32_t)monotonic_us() | 1u;
+    }
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    const uint32_t v = state;
+    pthread_mutex_unlock(&lock);
+    return v;
+}
+
+// ---- BSD string helpers ------------------------------------------------------
+
+size_t strlcpy(char *dst, const char *src, size_t size)
+{
+    size_t len = strlen(src);
+    if (size > 0) {
+        size_t n = len < size - 1 ? len : size - 1;
+        memcpy(dst, src, n);
+        dst[n] = '\0';
+    }
+    return len;
+}
+
+size_t strlcat(char *dst, const char *src, size_t size)
+{
+    size_t dst_len = strnlen(dst, size);
+    if (dst_len == size) {
+        return size + strlen(src);
+    }
+    return dst_len + strlcpy(dst + dst_len, src, size - dst_len);
+}
@@ -0,0 +1,132 @@
+#include "esp_netif.h"
+#include "esp_wifi.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/time.h>
+
+#include "esp_log.h"
+#include "host_internal.h"
+#include "host_sim.h"
+
+static const char *TAG = "wifi";
+
+ESP_EVENT_DEFINE_BASE(WIFI_EVENT);
+ESP_EVENT_DEFINE_BASE(IP_EVENT);
+
+struct esp_netif_obj {
+    int dummy;
+};
+
+static struct esp_netif_obj s_sta_netif;
+static struct esp_netif_obj s_ap_netif;
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static wifi_mode_t s_mode = WIFI_MODE_NULL;
+static wifi_config_t s_sta_config;
+static bool s_started = false;
+static bool s_connecting = false;
+static bool s_connected = false;
+static uint32_t s_connect_delay_ms = 50;
+
+void host_wifi_set_connect_delay_ms(uint32_t delay_ms)
+{
+    s_connect_delay_ms = delay_ms;
+}
+
+esp_err_t esp_netif_init(void)
+{
+    return ESP_OK;
+}
+
+esp_netif_t *esp_netif_create_default_wifi_sta(void)
+{
+    return &s_sta_netif;
+}
+
+esp_netif_t *esp_netif_create_default_wifi_ap(void)
+{
+    return &s_ap_netif;
+}
+
+esp_err_t esp_wifi_init(const wifi_init_config_t *config)
+{
+    return config ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode)
+{
+    s_mode = mode;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t *conf)
+{
+    if (!conf) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (interface == WIFI_IF_STA) {
+        pthread_mutex_lock(&s_lock);
+        s_sta_config = *conf;
+        pthread_mutex_unlock(&s_lock);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_start(void)
+{
+    s_started = true;
+    return esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_START, NULL, 0, portMAX_DELAY);
+}
+
+static void *connect_task(void *arg)
+{
+    (void)arg;
+    host_sleep_ms(s_connect_delay_ms);
+
+    pthread_mutex_lock(&s_lock);
+    s_connecting = false;
+    s_connected = true;
+    pthread_mutex_unlock(&s_lock);
+
+    ESP_LOGI(TAG, "associated with %s", (const char *)s_sta_config.sta.ssid);
+    esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_CONNECTED, NULL, 0, portMAX_DELAY);
+    esp_event_post(IP_EVENT, IP_EVENT_STA_GOT_IP, NULL, 0, portMAX_DELAY);
+    return NULL;
+}
+
+esp_err_t esp_wifi_connect(void)
+{
+    if (!s_started || s_mode == WIFI_MODE_AP || s_mode == WIFI_MODE_NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (s_connecting || s_connected || s_sta_config.sta.ssid[0] == '\0') {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_OK;
+    }
+    s_connecting = true;
+    pthread_mutex_unlock(&s_lock);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, connect_task, NULL) != 0) {
+        return ESP_FAIL;
+    }
+    pthread_detach(thread);
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_disconnect(void)
+{
+    pthread_mutex_lock(&s_lock);
+    bool was_connected = s_connected;
+    s_connected = false;
+    pthread_mutex_unlock(&s_lock);
+
+    if (was_connected) {
+        esp_event_post(WIFI_EVENT, WIFI_EVENT_STA_DISCONNECTED, NULL, 0, portMAX_DELAY);
+    }
+    return ESP_OK;
+}
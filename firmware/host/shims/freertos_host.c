@@ -0,0 +1,496 @@
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "freertos/timers.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_timer.h"
+#include "host_internal.h"
+
+// Task stacks get the requested size plus this much, since host frames are not
+// device frames, and are painted so the high-water mark can be read back.
+#define HOST_STACK_MARGIN (64 * 1024)
+#define HOST_STACK_PAINT 0xA5
+
+struct host_task {
+    struct host_task *next; // Created tasks, for host_task_stack_peak()
+    char name[16];
+    TaskFunction_t code;
+    void *arg;
+    pthread_t thread;
+    uint8_t *stack;
+    size_t stack_size;
+    uint32_t stack_depth; // As requested, in bytes like ESP-IDF
+    size_t stack_reserved; // Taken by glibc (thread control block, TLS) above the entry frame
+    pthread_mutex_t notify_lock;
+    pthread_cond_t notify_cond;
+    uint32_t notify_count;
+};
+
+static __thread struct host_task *s_current_task = NULL;
+static pthread_mutex_t s_tasks_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct host_task *s_tasks = NULL;
+
+static void task_init_notify(struct host_task *task)
+{
+    pthread_mutex_init(&task->notify_lock, NULL);
+    host_cond_init_monotonic(&task->notify_cond);
+}
+
+static void *task_trampoline(void *arg)
+{
+    struct host_task *task = (struct host_task *)arg;
+    uint8_t entry;
+    if (task->stack) {
+        task->stack_reserved = (size_t)(task->stack + task->stack_size - &entry);
+    }
+    s_current_task = task;
+    task->code(task->arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task_code, const char *name, uint32_t stack_depth, void *parameters,
+                       UBaseType_t priority, TaskHandle_t *created_task)
+{
+    (void)priority;
+
+    struct host_task *task = calloc(1, sizeof(*task));
+    if (!task) {
+        return pdFAIL;
+    }
+    snprintf(task->name, sizeof(task->name), "%s", name ? name : "");
+    task->code = task_code;
+    task->arg = parameters;
+    task->stack_depth = stack_depth;
+    task->stack_size = stack_depth + HOST_STACK_MARGIN;
+    task->stack = malloc(task->stack_size);
+    if (!task->stack) {
+        free(task);
+        return pdFAIL;
+    }
+    memset(task->stack, HOST_STACK_PAINT, task->stack_size);
+    task_init_notify(task);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, task->stack, task->stack_size);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    const int rc = pthread_create(&task->thread, &attr, task_trampoline, task);
+    pthread_attr_destroy(&attr);
+    if (rc != 0) {
+        free(task->stack);
+        free(task);
+        return pdFAIL;
+    }
+    pthread_mutex_lock(&s_tasks_lock);
+    task->next = s_tasks;
+    s_tasks = task;
+    pthread_mutex_unlock(&s_tasks_lock);
+
+    if (created_task) {
+        *created_task = task;
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL) {
+        pthread_exit(NULL);
+    }
+}
+
+void vTaskDelay(TickType_t ticks_to_delay)
+{
+    host_sleep_ms(ticks_to_delay * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(esp_timer_get_time() / (1000 * portTICK_PERIOD_MS));
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    // Threads not started through xTaskCreate (e.g. main) get a handle on first use.
+    if (!s_current_task) {
+        struct host_task *task = calloc(1, sizeof(*task));
+        if (task) {
+            task->thread = pthread_self();
+            task_init_notify(task);
+        }
+        s_current_task = task;
+    }
+    return s_current_task;
+}
+
+// The stack grows down from the top of the allocation; the bytes still painted at
+// the bottom were never touched. What glibc keeps at the top of a caller-provided
+// stack is not counted, so this is the task's own use (in host-sized frames).
+static size_t stack_used(const struct host_task *task)
+{
+    size_t untouched = 0;
+    while (untouched < task->stack_size && task->stack[untouched] == HOST_STACK_PAINT) {
+        untouched++;
+    }
+    const size_t used = task->stack_size - untouched;
+    return used > task->stack_reserved ? used - task->stack_reserved : 0;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task)
+{
+    if (!task) {
+        task = xTaskGetCurrentTaskHandle();
+    }
+    if (!task || !task->stack) {
+        return 0; // Not created through xTaskCreate
+    }
+    const size_t used = stack_used(task);
+    return used < task->stack_depth ? (UBaseType_t)(task->stack_depth - used) : 0;
+}
+
+size_t host_task_stack_peak(const char *name)
+{
+    size_t peak = 0;
+    pthread_mutex_lock(&s_tasks_lock);
+    for (struct host_task *task = s_tasks; task; task = task->next) {
+        if (strcmp(task->name, name) == 0) {
+            peak = stack_used(task);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_tasks_lock);
+    return peak;
+}
+
+size_t host_task_stack_size(const char *name)
+{
+    size_t size = 0;
+    pthread_mutex_lock(&s_tasks_lock);
+    for (struct host_task *task = s_tasks; task; task = task->next) {
+        if (strcmp(task->name, name) == 0) {
+            size = task->stack_depth;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_tasks_lock);
+    return size;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+    if (!task) {
+        return pdFAIL;
+    }
+    pthread_mutex_lock(&task->notify_lock);
+    task->notify_count++;
+    pthread_cond_signal(&task->notify_cond);
+    pthread_mutex_unlock(&task->notify_lock);
+    return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *higher_priority_task_woken)
+{
+    if (higher_priority_task_woken) {
+        *higher_priority_task_woken = pdFALSE;
+    }
+    xTaskNotifyGive(task);
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_count_on_exit, TickType_t ticks_to_wait)
+{
+    struct host_task *task = xTaskGetCurrentTaskHandle();
+    struct timespec deadline;
+    if (ticks_to_wait != portMAX_DELAY) {
+        host_deadline_from_esp_time(esp_timer_get_time() + (int64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000,
+                                    &deadline);
+    }
+
+    pthread_mutex_lock(&task->notify_lock);
+    int rc = 0;
+    while (task->notify_count == 0 && ticks_to_wait != 0 && rc == 0) {
+        if (ticks_to_wait == portMAX_DELAY) {
+            pthread_cond_wait(&task->notify_cond, &task->notify_lock);
+        } else {
+            rc = pthread_cond_timedwait(&task->notify_cond, &task->notify_lock, &deadline);
+        }
+    }
+    const uint32_t count = task->notify_count;
+    if (count > 0) {
+        task->notify_count = clear_count_on_exit ? 0 : count - 1;
+    }
+    pthread_mutex_unlock(&task->notify_lock);
+    return count;
+}
+
+// ---- Semaphores ------------------------------------------------------------
+
+// Mutexes map onto pthread mutexes; binary semaphores are a flag guarded by a
+// mutex and a monotonic condition variable so they can be given from any thread.
+struct host_semaphore {
+    pthread_mutex_t mutex;
+    pthread_cond_t cond;
+    bool binary;
+    bool available;
+};
+
+static SemaphoreHandle_t semaphore_create(int type)
+{
+    struct host_semaphore *sem = calloc(1, sizeof(*sem));
+    if (!sem) {
+        return NULL;
+    }
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr, type);
+    pthread_mutex_init(&sem->mutex, &attr);
+    pthread_mutexattr_destroy(&attr);
+    return sem;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    return semaphore_create(PTHREAD_MUTEX_NORMAL);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex(void)
+{
+    return semaphore_create(PTHREAD_MUTEX_RECURSIVE);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    struct host_semaphore *sem = semaphore_create(PTHREAD_MUTEX_NORMAL);
+    if (sem) {
+        sem->binary = true;
+        host_cond_init_monotonic(&sem->cond);
+    }
+    return sem;
+}
+
+static BaseType_t binary_take(struct host_semaphore *sem, TickType_t ticks_to_wait)
+{
+    struct timespec deadline;
+    if (ticks_to_wait != portMAX_DELAY) {
+        host_deadline_from_esp_time(esp_timer_get_time() + (int64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000,
+                                    &deadline);
+    }
+    pthread_mutex_lock(&sem->mutex);
+    int rc = 0;
+    while (!sem->available && rc == 0) {
+        if (ticks_to_wait == portMAX_DELAY) {
+            pthread_cond_wait(&sem->cond, &sem->mutex);
+        } else {
+            rc = pthread_cond_timedwait(&sem->cond, &sem->mutex, &deadline);
+        }
+    }
+    const bool taken = sem->available;
+    sem->available = false;
+    pthread_mutex_unlock(&sem->mutex);
+    return taken ? pdPASS : pdFAIL;
+}
+
+static BaseType_t binary_give(struct host_semaphore *sem)
+{
+    pthread_mutex_lock(&sem->mutex);
+    const bool was_available = sem->available;
+    sem->available = true;
+    pthread_cond_signal(&sem->cond);
+    pthread_mutex_unlock(&sem->mutex);
+    return was_available ? pdFAIL : pdPASS;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    if (!sem) {
+        return pdFAIL;
+    }
+    if (sem->binary) {
+        return binary_take(sem, ticks_to_wait);
+    }
+    if (ticks_to_wait == portMAX_DELAY) {
+        return pthread_mutex_lock(&sem->mutex) == 0 ? pdPASS : pdFAIL;
+    }
+
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    uint64_t ns = (uint64_t)deadline.tv_nsec + (uint64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000000ULL;
+    deadline.tv_sec += (time_t)(ns / 1000000000ULL);
+    deadline.tv_nsec = (long)(ns % 1000000000ULL);
+    return pthread_mutex_timedlock(&sem->mutex, &deadline) == 0 ? pdPASS : pdFAIL;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    if (!sem) {
+        return pdFAIL;
+    }
+    if (sem->binary) {
+        return binary_give(sem);
+    }
+    return pthread_mutex_unlock(&sem->mutex) == 0 ? pdPASS : pdFAIL;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t sem, BaseType_t *higher_priority_task_woken)
+{
+    if (higher_priority_task_woken) {
+        *higher_priority_task_woken = pdFALSE;
+    }
+    return xSemaphoreGive(sem);
+}
+
+BaseType_t xSemaphoreTakeRecursive(SemaphoreHandle_t sem, TickType_t ticks_to_wait)
+{
+    return xSemaphoreTake(sem, ticks_to_wait);
+}
+
+BaseType_t xSemaphoreGiveRecursive(SemaphoreHandle_t sem)
+{
+    return xSemaphoreGive(sem);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    if (sem) {
+        if (sem->binary) {
+            pthread_cond_destroy(&sem->cond);
+        }
+        pthread_mutex_destroy(&sem->mutex);
+        free(sem);
+    }
+}
+
+// ---- Software timers -------------------------------------------------------
+
+struct host_timer {
+    TimerCallbackFunction_t callback;
+    void *id;
+    TickType_t period;
+    bool auto_reload;
+    bool active;
+    int64_t expiry_us;
+    struct host_timer *next;
+};
+
+static pthread_mutex_t s_timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_timer_cond;
+static pthread_once_t s_timer_once = PTHREAD_ONCE_INIT;
+static struct host_timer *s_timers = NULL;
+
+static void *timer_service(void *arg)
+{
+    (void)arg;
+    pthread_mutex_lock(&s_timer_lock);
+    while (true) {
+        int64_t now = esp_timer_get_time();
+        int64_t next = INT64_MAX;
+        struct host_timer *due = NULL;
+
+        for (struct host_timer *t = s_timers; t; t = t->next) {
+            if (!t->active) {
+                continue;
+            }
+            if (t->expiry_us <= now) {
+                due = t;
+                break;
+            }
+            if (t->expiry_us < next) {
+                next = t->expiry_us;
+            }
+        }
+
+        if (due) {
+            if (due->auto_reload) {
+                due->expiry_us += (int64_t)due->period * portTICK_PERIOD_MS * 1000;
+            } else {
+                due->active = false;
+            }
+            pthread_mutex_unlock(&s_timer_lock);
+            due->callback(due);
+            pthread_mutex_lock(&s_timer_lock);
+            continue;
+        }
+
+        if (next == INT64_MAX) {
+            pthread_cond_wait(&s_timer_cond, &s_timer_lock);
+        } else {
+            struct timespec deadline;
+            host_deadline_from_esp_time(next, &deadline);
+            pthread_cond_timedwait(&s_timer_cond, &s_timer_lock, &deadline);
+        }
+    }
+    return NULL;
+}
+
+static void timer_service_start(void)
+{
+    host_cond_init_monotonic(&s_timer_cond);
+
+    pthread_t thread;
+    pthread_create(&thread, NULL, timer_service, NULL);
+    pthread_detach(thread);
+}
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t auto_reload, void *timer_id,
+                           TimerCallbackFunction_t callback)
+{
+    (void)name;
+    if (!callback || period == 0) {
+        return NULL;
+    }
+
+    pthread_once(&s_timer_once, timer_service_start);
+
+    struct host_timer *timer = calloc(1, sizeof(*timer));
+    if (!timer) {
+        return NULL;
+    }
+    timer->callback = callback;
+    timer->id = timer_id;
+    timer->period = period;
+    timer->auto_reload = auto_reload != 0;
+
+    pthread_mutex_lock(&s_timer_lock);
+    timer->next = s_timers;
+    s_timers = timer;
+    pthread_mutex_unlock(&s_timer_lock);
+    return timer;
+}
+
+BaseType_t xTimerStart(TimerHandle_t timer, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (!timer) {
+        return pdFAIL;
+    }
+    pthread_mutex_lock(&s_timer_lock);
+    timer->active = true;
+    timer->expiry_us = esp_timer_get_time() + (int64_t)timer->period * portTICK_PERIOD_MS * 1000;
+    pthread_cond_signal(&s_timer_cond);
+    pthread_mutex_unlock(&s_timer_lock);
+    return pdPASS;
+}
+
+BaseType_t xTimerStop(TimerHandle_t timer, TickType_t ticks_to_wait)
+{
+    (void)ticks_to_wait;
+    if (!timer) {
+        return pdFAIL;
+    }
+    pthread_mutex_lock(&s_timer_lock);
+    timer->active = false;
+    pthread_cond_signal(&s_timer_cond);
+    pthread_mutex_unlock(&s_timer_lock);
+    return pdPASS;
+}
+
+void *pvTimerGetTimerID(TimerHandle_t timer)
+{
+    return timer ? timer->id : NULL;
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Helpers shared between the host shim translation units.
+
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+// Converts an esp_timer_get_time() timestamp into an absolute CLOCK_MONOTONIC
+// deadline for pthread_cond_timedwait on a monotonic condition variable.
+void host_deadline_from_esp_time(int64_t esp_time_us, struct timespec *out);
+
+// Initialises a condition variable that waits against CLOCK_MONOTONIC.
+void host_cond_init_monotonic(pthread_cond_t *cond);
+
+void host_sleep_ms(uint32_t ms);
+void host_sleep_us(uint32_t us);
@@ -0,0 +1,29 @@
+#pragma once
+
+// Host (Linux) stand-in for the cJSON API used by the provisioning portal. Only
+// reached from HTTP handlers, which never run on the host, so parsing is a stub.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct cJSON {
+    struct cJSON *next;
+    struct cJSON *child;
+    int type;
+    char *valuestring;
+    char *string;
+} cJSON;
+
+cJSON *cJSON_Parse(const char *value);
+cJSON *cJSON_GetObjectItem(const cJSON *object, const char *string);
+int cJSON_IsString(const cJSON *item);
+cJSON *cJSON_CreateObject(void);
+cJSON *cJSON_AddStringToObject(cJSON *object, const char *name, const char *string);
+char *cJSON_PrintUnformatted(const cJSON *item);
+void cJSON_Delete(cJSON *item);
+void cJSON_free(void *object);
+
+#ifdef __cplusplus
+}
+#endif
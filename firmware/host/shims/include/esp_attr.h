@@ -0,0 +1,10 @@
+#pragma once
+
+// Host (Linux) stand-in for ESP-IDF's esp_attr.h. Placement attributes are no-ops,
+// except RTC_DATA_ATTR: its section is what host_rtc_memory_attach() carries over
+// a deep sleep.
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR __attribute__((section("rtc_data")))
+#define RTC_NOINIT_ATTR
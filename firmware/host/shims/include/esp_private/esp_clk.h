@@ -0,0 +1,17 @@
+#pragma once
+
+// Host (Linux) stand-in for ESP-IDF's esp_private/esp_clk.h. The RTC timer is
+// CLOCK_MONOTONIC: it keeps counting from one process (boot) to the next, as the
+// device's does through deep sleep.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint64_t esp_clk_rtc_time(void);
+
+#ifdef __cplusplus
+}
+#endif
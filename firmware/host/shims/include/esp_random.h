@@ -0,0 +1,15 @@
+#pragma once
+
+// Host (Linux) stand-in for ESP-IDF's esp_random.h.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+uint32_t esp_random(void);
+
+#ifdef __cplusplus
+}
+#endif
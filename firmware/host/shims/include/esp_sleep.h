@@ -0,0 +1,33 @@
+#pragma once
+
+// Host (Linux) stand-in for ESP-IDF's esp_sleep.h. Entering deep sleep ends the
+// process, since the device would reboot through app_main on wake. With
+// host_rtc_memory_attach() the RTC_DATA_ATTR variables are saved on the way out and
+// loaded by the next process, which then reports a timer wake.
+
+#include "esp_err.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    ESP_SLEEP_WAKEUP_UNDEFINED = 0, // Not a wake from sleep: power-on or reset
+    ESP_SLEEP_WAKEUP_ALL,
+    ESP_SLEEP_WAKEUP_EXT0,
+    ESP_SLEEP_WAKEUP_EXT1,
+    ESP_SLEEP_WAKEUP_TIMER,
+} esp_sleep_source_t;
+
+typedef esp_sleep_source_t esp_sleep_wakeup_cause_t;
+typedef void (*esp_deep_sleep_cb_t)(void);
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t time_in_us);
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause(void);
+esp_err_t esp_deep_sleep_register_hook(esp_deep_sleep_cb_t new_dslp_cb);
+void esp_deep_sleep_start(void) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
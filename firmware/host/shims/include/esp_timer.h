@@ -0,0 +1,16 @@
+#pragma once
+
+// Host (Linux) stand-in for ESP-IDF's esp_timer.h: microseconds since boot,
+// backed by CLOCK_MONOTONIC.
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int64_t esp_timer_get_time(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,18 @@
+#pragma once
+
+// Force-included into every host translation unit. Declares the BSD string helpers
+// that newlib provides on the ESP32 but glibc does not.
+
+#include <stddef.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+size_t strlcpy(char *dst, const char *src, size_t size);
+size_t strlcat(char *dst, const char *src, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,153 @@
+#pragma once
+
+// Knobs and counters for the simulated peripherals behind the host shims. Only the
+// host harness includes this; firmware code sees the plain ESP-IDF headers.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    HOST_HTTP_FAULT_NONE = 0,
+    HOST_HTTP_FAULT_NO_RESPONSE, // Request accepted, never answered (e.g. a dead NAT mapping)
+    HOST_HTTP_FAULT_TRUNCATE, // Server closes cleanly after fault_at body bytes
+    HOST_HTTP_FAULT_RESET,    // Connection reset after fault_at body bytes
+    HOST_HTTP_FAULT_STALL,    // Server goes quiet for stall_ms after fault_at body bytes
+} host_http_fault_t;
+
+typedef struct {
+    const char *body;    // Response body served for every request (NULL: built-in sample)
+    size_t body_len;
+    int status_code;
+    size_t chunk_size;   // Bytes delivered per HTTP_EVENT_ON_DATA
+    bool chunked;        // Report the response as Transfer-Encoding: chunked
+    uint32_t latency_ms; // Delay before the first byte arrives
+    // Connection model: a client keeps its connection between requests until the
+    // server drops it after idle_close_ms (0: never). Opening one costs a full TLS
+    // handshake, or the shorter resumption when the client saved a session.
+    uint32_t tls_handshake_ms;
+    uint32_t tls_resume_ms;
+    uint32_t idle_close_ms;
+    // Validators sent with the body. A request whose If-None-Match or
+    // If-Modified-Since matches is answered with an empty 304.
+    const char *etag;
+    const char *last_modified;
+    // Link and server faults. The client gives up on a request after its
+    // timeout_ms without a byte (latency or stall), like esp_http_client does.
+    uint32_t bandwidth_bps;  // Body delivery rate cap (0: unlimited)
+    host_http_fault_t fault;
+    size_t fault_at;
+    uint32_t stall_ms;
+    uint32_t fault_every;    // Fault every Nth request (0 or 1: every request)
+} host_http_fixture_t;
+
+typedef struct {
+    uint32_t requests;
+    uint64_t bytes;
+    uint32_t handshakes; // Connections opened, full and resumed
+    uint32_t resumed;    // Handshakes that reused a saved TLS session
+    uint32_t dropped;    // Requests sent on a connection the server had closed
+    uint32_t conditional;  // Requests carrying If-None-Match or If-Modified-Since
+    uint32_t not_modified; // Answered with 304
+    uint32_t faults;       // Requests the fixture's fault was applied to
+    uint32_t timeouts;     // Requests the client gave up on
+    size_t heap_peak;      // Most heap in use during a request, above its start (glibc only)
+} host_http_stats_t;
+
+void host_http_set_fixture(const host_http_fixture_t *fixture);
+void host_http_get_stats(host_http_stats_t *out);
+// URL of the most recent request.
+void host_http_get_last_url(char *buf, size_t size);
+void host_http_reset_stats(void);
+
+typedef struct {
+    uint32_t transactions;
+    uint64_t bytes;
+    uint64_t busy_us; // Simulated wire time at the device clock
+} host_spi_stats_t;
+
+void host_spi_get_stats(host_spi_stats_t *out);
+void host_spi_reset_stats(void);
+// Blocks until every queued transaction has been clocked out.
+void host_spi_wait_idle(void);
+
+// The simulated ST7796 panel decodes CASET/RASET/RAMWR from the SPI stream, using
+// the level of its D/C GPIO to tell commands from data.
+#define HOST_PANEL_DC_GPIO 2
+uint16_t host_panel_get_pixel(int x, int y);
+
+typedef struct {
+    int gpio_num;
+    uint32_t freq_hz;
+    uint32_t resolution_bits;
+    uint32_t duty;         // Output duty now, part-way through a fade if one is running
+    uint32_t target_duty;  // Where the last fade or duty update ends up
+    uint32_t last_fade_ms; // Duration of the last hardware fade (0: plain duty update)
+    uint32_t fades;
+    uint32_t duty_updates;
+} host_ledc_channel_stats_t;
+
+// Returns false for an unconfigured channel.
+bool host_ledc_get_channel(int speed_mode, int channel, host_ledc_channel_stats_t *out);
+
+// Deepest stack use so far of the task created with this name, in bytes of host
+// frames (which are larger than the device's). 0 for an unknown task.
+size_t host_task_stack_peak(const char *name);
+
+// Stack size the task with this name was created with, without the host margin. 0 for
+// an unknown task.
+size_t host_task_stack_size(const char *name);
+
+void host_wifi_set_connect_delay_ms(uint32_t delay_ms);
+
+// Backs RTC slow memory (the RTC_DATA_ATTR variables) with path. Call before
+// app_main(): when path holds memory saved by an earlier process entering deep sleep,
+// it is loaded and esp_sleep_get_wakeup_cause() reports a timer wake; otherwise the
+// boot is a power-on. esp_deep_sleep_start() runs the registered hooks, then saves.
+// False when path exists but does not match this build's RTC memory.
+bool host_rtc_memory_attach(const char *path);
+
+// getaddrinfo() is wrapped (-Wl,--wrap=getaddrinfo): every name the firmware looks
+// up resolves to a stand-in NTP server on 127.0.0.1. A name with no server added
+// below gets a well-behaved one on its first lookup.
+
+typedef enum {
+    HOST_NTP_FAULT_NONE = 0,
+    HOST_NTP_FAULT_SILENT,   // Never replies
+    HOST_NTP_FAULT_KISS,     // Kiss-o'-death: stratum 0, code "RATE"
+    HOST_NTP_FAULT_UNSYNCED, // Leap indicator 3: the server has lost its own time
+} host_ntp_fault_t;
+
+typedef struct {
+    // One-way delays. The client halves the round trip, so unequal ones shift the
+    // offset it measures by half the difference.
+    uint32_t request_delay_ms;
+    uint32_t reply_delay_ms;
+    int64_t error_us; // Added to the time served: a falseticker
+    host_ntp_fault_t fault;
+} host_ntp_server_config_t;
+
+// Starts a stand-in answering for name; returns its UDP port, 0 on failure.
+uint16_t host_ntp_server_add(const char *name, const host_ntp_server_config_t *config);
+// True time is offset_us ahead of the device clock now, and the device clock runs
+// drift_ppb fast from here on. Corrections the firmware applies through
+// settimeofday()/adjtime() (wrapped with -Wl,--wrap, so the real clock is never
+// touched) take effect on the device clock at once.
+void host_ntp_set_clock(int64_t offset_us, int32_t drift_ppb);
+
+typedef struct {
+    uint32_t requests;    // Received by all stand-ins, answered or not
+    uint32_t steps;       // settimeofday() calls
+    uint32_t slews;       // adjtime() calls that set an adjustment
+    int64_t corrected_us; // Total the device clock was moved by
+} host_ntp_stats_t;
+
+void host_ntp_get_stats(host_ntp_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,6 @@
+#pragma once
+
+// Host (Linux) stand-in for lwIP's netdb.h. Targets that resolve NTP servers link
+// with -Wl,--wrap=getaddrinfo so names reach the stand-ins in host_sim.h.
+
+#include <netdb.h>
@@ -0,0 +1,7 @@
+#pragma once
+
+// Host (Linux) stand-in for the generated sdkconfig.h. Components fall back to their
+// Kconfig defaults when a CONFIG_ symbol is missing, so this is intentionally empty.
+
+// ESP-IDF options that sdkconfig.defaults turns on and firmware code tests with #if.
+#define CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS 1
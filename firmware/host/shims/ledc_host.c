@@ -0,0 +1,203 @@
+#include "driver/ledc.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "esp_timer.h"
+#include "host_internal.h"
+#include "host_sim.h"
+
+typedef struct {
+    bool configured;
+    int gpio_num;
+    ledc_timer_t timer;
+    uint32_t duty;         // Latched by ledc_update_duty() or the start of a fade
+    uint32_t pending_duty; // Written by ledc_set_duty(), not yet latched
+    uint32_t fade_from;
+    uint32_t fade_to;
+    uint32_t fade_ms;
+    int64_t fade_start_us;
+    bool fade_armed;
+    uint32_t fades;
+    uint32_t duty_updates;
+} ledc_channel_state_t;
+
+typedef struct {
+    uint32_t freq_hz;
+    uint32_t resolution_bits;
+} ledc_timer_state_t;
+
+static pthread_mutex_t s_ledc_lock = PTHREAD_MUTEX_INITIALIZER;
+static ledc_timer_state_t s_timers[LEDC_SPEED_MODE_MAX][LEDC_TIMER_MAX];
+static ledc_channel_state_t s_channels[LEDC_SPEED_MODE_MAX][LEDC_CHANNEL_MAX];
+static bool s_fade_installed = false;
+
+static bool valid(ledc_mode_t mode, ledc_channel_t channel)
+{
+    return mode >= 0 && mode < LEDC_SPEED_MODE_MAX && channel >= 0 && channel < LEDC_CHANNEL_MAX &&
+           s_channels[mode][channel].configured;
+}
+
+// Output duty right now: the fade target once the fade time has elapsed.
+static uint32_t current_duty(const ledc_channel_state_t *ch, int64_t now_us)
+{
+    if (ch->fade_ms == 0 || ch->fade_start_us == 0) {
+        return ch->duty;
+    }
+    const int64_t elapsed_us = now_us - ch->fade_start_us;
+    const int64_t total_us = (int64_t)ch->fade_ms * 1000;
+    if (elapsed_us >= total_us) {
+        return ch->fade_to;
+    }
+    const int64_t delta = (int64_t)ch->fade_to - (int64_t)ch->fade_from;
+    return (uint32_t)((int64_t)ch->fade_from + delta * elapsed_us / total_us);
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_conf)
+{
+    if (!timer_conf || timer_conf->speed_mode >= LEDC_SPEED_MODE_MAX || timer_conf->timer_num >= LEDC_TIMER_MAX ||
+        timer_conf->freq_hz == 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&s_ledc_lock);
+    s_timers[timer_conf->speed_mode][timer_conf->timer_num] = (ledc_timer_state_t){
+        .freq_hz = timer_conf->freq_hz,
+        .resolution_bits = (uint32_t)timer_conf->duty_resolution,
+    };
+    pthread_mutex_unlock(&s_ledc_lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *ledc_conf)
+{
+    if (!ledc_conf || ledc_conf->speed_mode >= LEDC_SPEED_MODE_MAX || ledc_conf->channel >= LEDC_CHANNEL_MAX ||
+        ledc_conf->timer_sel >= LEDC_TIMER_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&s_ledc_lock);
+    s_channels[ledc_conf->speed_mode][ledc_conf->channel] = (ledc_channel_state_t){
+        .configured = true,
+        .gpio_num = ledc_conf->gpio_num,
+        .timer = ledc_conf->timer_sel,
+        .duty = ledc_conf->duty,
+        .pending_duty = ledc_conf->duty,
+    };
+    pthread_mutex_unlock(&s_ledc_lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty)
+{
+    pthread_mutex_lock(&s_ledc_lock);
+    if (!valid(speed_mode, channel)) {
+        pthread_mutex_unlock(&s_ledc_lock);
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_channels[speed_mode][channel].pending_duty = duty;
+    pthread_mutex_unlock(&s_ledc_lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    pthread_mutex_lock(&s_ledc_lock);
+    if (!valid(speed_mode, channel)) {
+        pthread_mutex_unlock(&s_ledc_lock);
+        return ESP_ERR_INVALID_ARG;
+    }
+    ledc_channel_state_t *ch = &s_channels[speed_mode][channel];
+    ch->duty = ch->pending_duty;
+    ch->fade_ms = 0;
+    ch->duty_updates++;
+    pthread_mutex_unlock(&s_ledc_lock);
+    return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel)
+{
+    pthread_mutex_lock(&s_ledc_lock);
+    uint32_t duty = valid(speed_mode, channel) ? current_duty(&s_channels[speed_mode][channel], esp_timer_get_time())
+                                               : 0;
+    pthread_mutex_unlock(&s_ledc_lock);
+    return duty;
+}
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags)
+{
+    (void)intr_alloc_flags;
+    pthread_mutex_lock(&s_ledc_lock);
+    const bool already = s_fade_installed;
+    s_fade_installed = true;
+    pthread_mutex_unlock(&s_ledc_lock);
+    return already ? ESP_ERR_INVALID_STATE : ESP_OK;
+}
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t target_duty,
+                                  int max_fade_time_ms)
+{
+    pthread_mutex_lock(&s_ledc_lock);
+    if (!s_fade_installed || !valid(speed_mode, channel) || max_fade_time_ms < 0) {
+        pthread_mutex_unlock(&s_ledc_lock);
+        return s_fade_installed ? ESP_ERR_INVALID_ARG : ESP_ERR_INVALID_STATE;
+    }
+    ledc_channel_state_t *ch = &s_channels[speed_mode][channel];
+    const int64_t now = esp_timer_get_time();
+    // A new fade starts from wherever the previous one has got to.
+    ch->duty = current_duty(ch, now);
+    ch->fade_from = ch->duty;
+    ch->fade_to = target_duty;
+    ch->fade_ms = (uint32_t)max_fade_time_ms;
+    ch->fade_start_us = 0;
+    ch->fade_armed = true;
+    pthread_mutex_unlock(&s_ledc_lock);
+    return ESP_OK;
+}
+
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_fade_mode_t fade_mode)
+{
+    pthread_mutex_lock(&s_ledc_lock);
+    if (!valid(speed_mode, channel) || !s_channels[speed_mode][channel].fade_armed) {
+        pthread_mutex_unlock(&s_ledc_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    ledc_channel_state_t *ch = &s_channels[speed_mode][channel];
+    ch->fade_armed = false;
+    ch->fade_start_us = esp_timer_get_time();
+    ch->fades++;
+    const uint32_t fade_ms = ch->fade_ms;
+    if (fade_ms == 0) {
+        ch->duty = ch->fade_to;
+    }
+    pthread_mutex_unlock(&s_ledc_lock);
+
+    if (fade_mode == LEDC_FADE_WAIT_DONE && fade_ms > 0) {
+        host_sleep_ms(fade_ms);
+    }
+    return ESP_OK;
+}
+
+bool host_ledc_get_channel(int speed_mode, int channel, host_ledc_channel_stats_t *out)
+{
+    if (!out) {
+        return false;
+    }
+    pthread_mutex_lock(&s_ledc_lock);
+    if (!valid((ledc_mode_t)speed_mode, (ledc_channel_t)channel)) {
+        pthread_mutex_unlock(&s_ledc_lock);
+        return false;
+    }
+    const ledc_channel_state_t *ch = &s_channels[speed_mode][channel];
+    const ledc_timer_state_t *timer = &s_timers[speed_mode][ch->timer];
+    *out = (host_ledc_channel_stats_t){
+        .gpio_num = ch->gpio_num,
+        .freq_hz = timer->freq_hz,
+        .resolution_bits = timer->resolution_bits,
+        .duty = current_duty(ch, esp_timer_get_time()),
+        .target_duty = ch->fade_ms ? ch->fade_to : ch->duty,
+        .last_fade_ms = ch->fade_ms,
+        .fades = ch->fades,
+        .duty_updates = ch->duty_updates,
+    };
+    pthread_mutex_unlock(&s_ledc_lock);
+    return true;
+}
@@ -0,0 +1,225 @@
+// Stand-in NTP servers on 127.0.0.1 and the simulated device clock they are
+// measured against. The firmware's NTP client runs unmodified over real UDP
+// sockets; only name lookup and the clock-setting calls are redirected here.
+
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "host_internal.h"
+#include "host_sim.h"
+
+static const char *TAG = "ntp_host";
+
+#define MAX_SERVERS 8
+#define MAX_NAME 64
+#define NTP_PACKET_SIZE 48
+#define NTP_UNIX_OFFSET 2208988800LL // 1900-01-01 to 1970-01-01, seconds
+
+typedef struct {
+    char name[MAX_NAME];
+    host_ntp_server_config_t config;
+    int fd;
+    uint16_t port;
+} server_t;
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static server_t s_servers[MAX_SERVERS];
+static size_t s_server_count = 0;
+// True time relative to the device clock: offset as of s_clock_set_us, drift since.
+static int64_t s_clock_offset_us = 0;
+static int32_t s_clock_drift_ppb = 0;
+static int64_t s_clock_set_us = 0;
+static host_ntp_stats_t s_stats;
+
+int __real_getaddrinfo(const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res);
+
+void host_ntp_set_clock(int64_t offset_us, int32_t drift_ppb)
+{
+    pthread_mutex_lock(&s_lock);
+    s_clock_offset_us = offset_us + s_stats.corrected_us;
+    s_clock_drift_ppb = drift_ppb;
+    s_clock_set_us = esp_timer_get_time();
+    pthread_mutex_unlock(&s_lock);
+}
+
+void host_ntp_get_stats(host_ntp_stats_t *out)
+{
+    pthread_mutex_lock(&s_lock);
+    *out = s_stats;
+    pthread_mutex_unlock(&s_lock);
+}
+
+// The device clock is the host clock. True time is ahead of it by the configured
+// offset, less what the drift built up since and the corrections applied.
+static int64_t true_time_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    pthread_mutex_lock(&s_lock);
+    const int64_t elapsed_us = esp_timer_get_time() - s_clock_set_us;
+    const int64_t offset_us =
+        s_clock_offset_us - (int64_t)s_clock_drift_ppb * elapsed_us / 1000000000 - s_stats.corrected_us;
+    pthread_mutex_unlock(&s_lock);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec + offset_us;
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void put_timestamp(uint8_t *p, int64_t unix_us)
+{
+    put_u32(p, (uint32_t)(unix_us / 1000000 + NTP_UNIX_OFFSET));
+    put_u32(p + 4, (uint32_t)(((uint64_t)(unix_us % 1000000) << 32) / 1000000));
+}
+
+static void *server_task(void *arg)
+{
+    server_t *server = arg;
+    const host_ntp_server_config_t *cfg = &server->config;
+    uint8_t packet[NTP_PACKET_SIZE];
+    struct sockaddr_in from;
+    while (true) {
+        socklen_t from_len = sizeof(from);
+        const ssize_t n = recvfrom(server->fd, packet, sizeof(packet), 0, (struct sockaddr *)&from, &from_len);
+        if (n < NTP_PACKET_SIZE) {
+            continue;
+        }
+        pthread_mutex_lock(&s_lock);
+        s_stats.requests++;
+        pthread_mutex_unlock(&s_lock);
+        if (cfg->fault == HOST_NTP_FAULT_SILENT) {
+            continue;
+        }
+
+        // The request "arrives" after its delay; the reply leaves after the other.
+        host_sleep_ms(cfg->request_delay_ms);
+        const int64_t receive_us = true_time_us() + cfg->error_us;
+        uint8_t reply[NTP_PACKET_SIZE] = {0};
+        const uint8_t leap = cfg->fault == HOST_NTP_FAULT_UNSYNCED ? 3 : 0;
+        reply[0] = (uint8_t)(leap << 6 | 4 << 3 | 4); // Version 4, server
+        reply[1] = cfg->fault == HOST_NTP_FAULT_KISS ? 0 : 2;
+        reply[2] = packet[2];
+        reply[3] = (uint8_t)-20;     // Precision: about a microsecond
+        put_u32(reply + 8, 65);      // Root dispersion: 1 ms in 16.16 seconds
+        memcpy(reply + 12, cfg->fault == HOST_NTP_FAULT_KISS ? "RATE" : "HOST", 4);
+        memcpy(reply + 24, packet + 40, 8); // Origin: the client's transmit time
+        put_timestamp(reply + 32, receive_us);
+        const int64_t transmit_us = true_time_us() + cfg->error_us;
+        put_timestamp(reply + 16, transmit_us);
+        put_timestamp(reply + 40, transmit_us);
+        host_sleep_ms(cfg->reply_delay_ms);
+        sendto(server->fd, reply, sizeof(reply), 0, (struct sockaddr *)&from, from_len);
+    }
+    return NULL;
+}
+
+// Called with s_lock held.
+static server_t *server_start(const char *name, const host_ntp_server_config_t *config)
+{
+    if (s_server_count >= MAX_SERVERS || strlen(name) >= MAX_NAME) {
+        ESP_LOGE(TAG, "cannot add server %s", name);
+        return NULL;
+    }
+    server_t *server = &s_servers[s_server_count];
+    server->fd = socket(AF_INET, SOCK_DGRAM, 0);
+    struct sockaddr_in addr = {.sin_family = AF_INET, .sin_addr.s_addr = htonl(INADDR_LOOPBACK)};
+    socklen_t addr_len = sizeof(addr);
+    if (server->fd < 0 || bind(server->fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        getsockname(server->fd, (struct sockaddr *)&addr, &addr_len) != 0) {
+        ESP_LOGE(TAG, "cannot open socket for %s", name);
+        if (server->fd >= 0) {
+            close(server->fd);
+        }
+        return NULL;
+    }
+    strcpy(server->name, name);
+    server->config = *config;
+    server->port = ntohs(addr.sin_port);
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, server_task, server) != 0) {
+        close(server->fd);
+        return NULL;
+    }
+    pthread_detach(thread);
+    s_server_count++;
+    return server;
+}
+
+uint16_t host_ntp_server_add(const char *name, const host_ntp_server_config_t *config)
+{
+    pthread_mutex_lock(&s_lock);
+    const server_t *server = server_start(name, config);
+    pthread_mutex_unlock(&s_lock);
+    return server ? server->port : 0;
+}
+
+// Linked in with -Wl,--wrap=getaddrinfo: names resolve to their stand-in.
+int __wrap_getaddrinfo(const char *node, const char *service, const struct addrinfo *hints, struct addrinfo **res)
+{
+    (void)service;
+    pthread_mutex_lock(&s_lock);
+    const server_t *server = NULL;
+    for (size_t i = 0; i < s_server_count && node; i++) {
+        if (strcmp(s_servers[i].name, node) == 0) {
+            server = &s_servers[i];
+        }
+    }
+    if (!server && node) {
+        const host_ntp_server_config_t good = {0};
+        server = server_start(node, &good);
+    }
+    const uint16_t port = server ? server->port : 0;
+    pthread_mutex_unlock(&s_lock);
+    if (!port) {
+        return EAI_NONAME;
+    }
+
+    char port_str[8];
+    snprintf(port_str, sizeof(port_str), "%u", port);
+    return __real_getaddrinfo("127.0.0.1", port_str, hints, res);
+}
+
+// Linked in with -Wl,--wrap=settimeofday,--wrap=adjtime: corrections move the
+// simulated device clock, never the host's.
+int __wrap_settimeofday(const struct timeval *tv, const void *tz)
+{
+    (void)tz;
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    pthread_mutex_lock(&s_lock);
+    s_stats.steps++;
+    s_stats.corrected_us += ((int64_t)tv->tv_sec - now.tv_sec) * 1000000 + (tv->tv_usec - now.tv_usec);
+    pthread_mutex_unlock(&s_lock);
+    return 0;
+}
+
+// Slews complete at once, so there is never an adjustment outstanding.
+int __wrap_adjtime(const struct timeval *delta, struct timeval *olddelta)
+{
+    pthread_mutex_lock(&s_lock);
+    if (delta) {
+        s_stats.slews++;
+        s_stats.corrected_us += (int64_t)delta->tv_sec * 1000000 + delta->tv_usec;
+    }
+    pthread_mutex_unlock(&s_lock);
+    if (olddelta) {
+        olddelta->tv_sec = 0;
+        olddelta->tv_usec = 0;
+    }
+    return 0;
+}
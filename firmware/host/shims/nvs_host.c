@@ -0,0 +1,253 @@
+#include "nvs.h"
+#include "nvs_flash.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_ENTRIES 64
+#define MAX_NAMESPACES 16
+#define NVS_KEY_NAME_MAX_SIZE 16
+
+typedef struct {
+    bool used;
+    uint8_t ns;
+    char key[NVS_KEY_NAME_MAX_SIZE];
+    void *value;
+    size_t length;
+} nvs_entry_t;
+
+typedef struct {
+    uint8_t ns;
+    bool writable;
+} nvs_open_handle_t;
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool s_initialised = false;
+static char s_namespaces[MAX_NAMESPACES][NVS_KEY_NAME_MAX_SIZE];
+static int s_namespace_count = 0;
+static nvs_entry_t s_entries[MAX_ENTRIES];
+
+// Handles encode the namespace index and the open mode so no table is needed.
+static nvs_handle_t make_handle(uint8_t ns, bool writable)
+{
+    return ((nvs_handle_t)ns + 1) | (writable ? 0x100u : 0u);
+}
+
+static bool decode_handle(nvs_handle_t handle, nvs_open_handle_t *out)
+{
+    uint32_t ns = (handle & 0xffu);
+    if (ns == 0 || ns > (uint32_t)s_namespace_count) {
+        return false;
+    }
+    out->ns = (uint8_t)(ns - 1);
+    out->writable = (handle & 0x100u) != 0;
+    return true;
+}
+
+static nvs_entry_t *find_entry(uint8_t ns, const char *key)
+{
+    for (int i = 0; i < MAX_ENTRIES; i++) {
+        if (s_entries[i].used && s_entries[i].ns == ns && strcmp(s_entries[i].key, key) == 0) {
+            return &s_entries[i];
+        }
+    }
+    return NULL;
+}
+
+esp_err_t nvs_flash_init(void)
+{
+    pthread_mutex_lock(&s_lock);
+    s_initialised = true;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t nvs_flash_erase(void)
+{
+    pthread_mutex_lock(&s_lock);
+    for (int i = 0; i < MAX_ENTRIES; i++) {
+        free(s_entries[i].value);
+    }
+    memset(s_entries, 0, sizeof(s_entries));
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle)
+{
+    if (!namespace_name || !out_handle || strlen(namespace_name) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (!s_initialised) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_NVS_NOT_INITIALIZED;
+    }
+
+    int ns = -1;
+    for (int i = 0; i < s_namespace_count; i++) {
+        if (strcmp(s_namespaces[i], namespace_name) == 0) {
+            ns = i;
+            break;
+        }
+    }
+
+    if (ns < 0) {
+        if (open_mode == NVS_READONLY) {
+            pthread_mutex_unlock(&s_lock);
+            return ESP_ERR_NVS_NOT_FOUND;
+        }
+        if (s_namespace_count >= MAX_NAMESPACES) {
+            pthread_mutex_unlock(&s_lock);
+            return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+        }
+        ns = s_namespace_count++;
+        strlcpy(s_namespaces[ns], namespace_name, NVS_KEY_NAME_MAX_SIZE);
+    }
+
+    *out_handle = make_handle((uint8_t)ns, open_mode == NVS_READWRITE);
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle)
+{
+    (void)handle;
+}
+
+esp_err_t nvs_commit(nvs_handle_t handle)
+{
+    (void)handle;
+    return ESP_OK;
+}
+
+static esp_err_t set_value(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    nvs_open_handle_t h;
+    if (!key || strlen(key) >= NVS_KEY_NAME_MAX_SIZE) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (!decode_handle(handle, &h)) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!h.writable) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_NVS_READ_ONLY;
+    }
+
+    nvs_entry_t *entry = find_entry(h.ns, key);
+    if (!entry) {
+        for (int i = 0; i < MAX_ENTRIES; i++) {
+            if (!s_entries[i].used) {
+                entry = &s_entries[i];
+                break;
+            }
+        }
+    }
+    if (!entry) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_NVS_NOT_ENOUGH_SPACE;
+    }
+
+    void *copy = malloc(length ? length : 1);
+    if (!copy) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_NO_MEM;
+    }
+    memcpy(copy, value, length);
+
+    free(entry->value);
+    entry->used = true;
+    entry->ns = h.ns;
+    strlcpy(entry->key, key, sizeof(entry->key));
+    entry->value = copy;
+    entry->length = length;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+static esp_err_t get_value(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    nvs_open_handle_t h;
+    if (!key || !length) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    pthread_mutex_lock(&s_lock);
+    if (!decode_handle(handle, &h)) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    nvs_entry_t *entry = find_entry(h.ns, key);
+    if (!entry) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+
+    if (!out_value) {
+        *length = entry->length;
+        pthread_mutex_unlock(&s_lock);
+        return ESP_OK;
+    }
+    if (*length < entry->length) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+
+    memcpy(out_value, entry->value, entry->length);
+    *length = entry->length;
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key)
+{
+    nvs_open_handle_t h;
+    pthread_mutex_lock(&s_lock);
+    if (!key || !decode_handle(handle, &h)) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_INVALID_ARG;
+    }
+    nvs_entry_t *entry = find_entry(h.ns, key);
+    if (!entry) {
+        pthread_mutex_unlock(&s_lock);
+        return ESP_ERR_NVS_NOT_FOUND;
+    }
+    free(entry->value);
+    memset(entry, 0, sizeof(*entry));
+    pthread_mutex_unlock(&s_lock);
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_str(nvs_handle_t handle, const char *key, const char *value)
+{
+    if (!value) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return set_value(handle, key, value, strlen(value) + 1);
+}
+
+esp_err_t nvs_get_str(nvs_handle_t handle, const char *key, char *out_value, size_t *length)
+{
+    return get_value(handle, key, out_value, length);
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length)
+{
+    if (!value && length > 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return set_value(handle, key, value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length)
+{
+    return get_value(handle, key, out_value, length);
+}
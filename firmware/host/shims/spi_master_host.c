@@ -0,0 +1,352 @@
+#include "driver/gpio.h"
+#include "driver/spi_master.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_timer.h"
+#include "host_internal.h"
+#include "host_sim.h"
+
+#define GPIO_COUNT 64
+#define PANEL_W 480
+#define PANEL_H 320
+#define SPI_QUEUE_MAX 16
+
+// ---- GPIO ------------------------------------------------------------------
+
+static volatile int s_gpio_level[GPIO_COUNT];
+
+esp_err_t gpio_config(const gpio_config_t *config)
+{
+    return config ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_COUNT) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_gpio_level[gpio_num] = level ? 1 : 0;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num)
+{
+    if (gpio_num < 0 || gpio_num >= GPIO_COUNT) {
+        return 0;
+    }
+    return s_gpio_level[gpio_num];
+}
+
+// ---- Panel model -----------------------------------------------------------
+
+static uint16_t s_panel_fb[PANEL_W * PANEL_H];
+
+static struct {
+    uint8_t cmd;
+    uint8_t params[4];
+    int param_count;
+    int xs, xe, ys, ye;
+    int x, y;
+    int pending_byte; // High byte of a pixel split across transactions, or -1
+} s_panel = {.xe = PANEL_W - 1, .ye = PANEL_H - 1, .pending_byte = -1};
+
+static void panel_put_pixel(uint16_t px)
+{
+    if (s_panel.x >= 0 && s_panel.x < PANEL_W && s_panel.y >= 0 && s_panel.y < PANEL_H) {
+        s_panel_fb[s_panel.y * PANEL_W + s_panel.x] = px;
+    }
+    if (++s_panel.x > s_panel.xe) {
+        s_panel.x = s_panel.xs;
+        if (++s_panel.y > s_panel.ye) {
+            s_panel.y = s_panel.ys;
+        }
+    }
+}
+
+static void panel_feed(bool dc_data, const uint8_t *bytes, size_t len)
+{
+    if (!dc_data) {
+        if (len == 0) {
+            return;
+        }
+        s_panel.cmd = bytes[0];
+        s_panel.param_count = 0;
+        s_panel.pending_byte = -1;
+        if (s_panel.cmd == 0x2C) {
+            s_panel.x = s_panel.xs;
+            s_panel.y = s_panel.ys;
+        }
+        return;
+    }
+
+    switch (s_panel.cmd) {
+    case 0x2A:
+    case 0x2B:
+        for (size_t i = 0; i < len && s_panel.param_count < 4; i++) {
+            s_panel.params[s_panel.param_count++] = bytes[i];
+        }
+        if (s_panel.param_count == 4) {
+            const int start = (s_panel.params[0] << 8) | s_panel.params[1];
+            const int end = (s_panel.params[2] << 8) | s_panel.params[3];
+            if (s_panel.cmd == 0x2A) {
+                s_panel.xs = start;
+                s_panel.xe = end;
+            } else {
+                s_panel.ys = start;
+                s_panel.ye = end;
+            }
+        }
+        break;
+    case 0x2C:
+        for (size_t i = 0; i < len; i++) {
+            if (s_panel.pending_byte < 0) {
+                s_panel.pending_byte = bytes[i];
+            } else {
+                panel_put_pixel((uint16_t)((s_panel.pending_byte << 8) | bytes[i]));
+                s_panel.pending_byte = -1;
+            }
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+uint16_t host_panel_get_pixel(int x, int y)
+{
+    if (x < 0 || x >= PANEL_W || y < 0 || y >= PANEL_H) {
+        return 0;
+    }
+    return s_panel_fb[y * PANEL_W + x];
+}
+
+// ---- SPI master ------------------------------------------------------------
+
+struct host_spi_device {
+    spi_device_interface_config_t cfg;
+    spi_transaction_t *queue[SPI_QUEUE_MAX];
+    int queue_head;
+    int queue_count;
+    spi_transaction_t *done[SPI_QUEUE_MAX];
+    int done_head;
+    int done_count;
+    bool busy;
+    pthread_t thread;
+};
+
+static pthread_mutex_t s_spi_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t s_spi_cond;
+static pthread_once_t s_spi_once = PTHREAD_ONCE_INIT;
+static host_spi_stats_t s_spi_stats;
+static int64_t s_bus_free_at_us = 0;
+
+static void spi_init_once(void)
+{
+    host_cond_init_monotonic(&s_spi_cond);
+}
+
+// Runs one transaction: callbacks, panel decode and the simulated wire time. The
+// sleep happens without the lock so the caller can queue more work meanwhile.
+static void spi_execute(struct host_spi_device *dev, spi_transaction_t *trans)
+{
+    if (dev->cfg.pre_cb) {
+        dev->cfg.pre_cb(trans);
+    }
+
+    const size_t len = trans->length / 8;
+    const uint8_t *tx = (trans->flags & SPI_TRANS_USE_TXDATA) ? trans->tx_data : (const uint8_t *)trans->tx_buffer;
+    if (tx) {
+        panel_feed(gpio_get_level(HOST_PANEL_DC_GPIO) != 0, tx, len);
+    }
+
+    const int64_t wire_us = dev->cfg.clock_speed_hz > 0
+                                ? (int64_t)trans->length * 1000000 / dev->cfg.clock_speed_hz
+                                : 0;
+    const int64_t now = esp_timer_get_time();
+    const int64_t start = s_bus_free_at_us > now ? s_bus_free_at_us : now;
+    s_bus_free_at_us = start + wire_us;
+    // Short command transfers are accumulated and paid off with the next long one.
+    if (s_bus_free_at_us - now >= 50) {
+        host_sleep_us((uint32_t)(s_bus_free_at_us - now));
+    }
+
+    pthread_mutex_lock(&s_spi_lock);
+    s_spi_stats.transactions++;
+    s_spi_stats.bytes += len;
+    s_spi_stats.busy_us += (uint64_t)wire_us;
+    pthread_mutex_unlock(&s_spi_lock);
+
+    if (dev->cfg.post_cb) {
+        dev->cfg.post_cb(trans);
+    }
+}
+
+static void *spi_bus_thread(void *arg)
+{
+    struct host_spi_device *dev = (struct host_spi_device *)arg;
+    for (;;) {
+        pthread_mutex_lock(&s_spi_lock);
+        while (dev->queue_count == 0) {
+            dev->busy = false;
+            pthread_cond_broadcast(&s_spi_cond);
+            pthread_cond_wait(&s_spi_cond, &s_spi_lock);
+        }
+        dev->busy = true;
+        spi_transaction_t *trans = dev->queue[dev->queue_head];
+        dev->queue_head = (dev->queue_head + 1) % SPI_QUEUE_MAX;
+        dev->queue_count--;
+        pthread_cond_broadcast(&s_spi_cond);
+        pthread_mutex_unlock(&s_spi_lock);
+
+        spi_execute(dev, trans);
+
+        pthread_mutex_lock(&s_spi_lock);
+        dev->done[(dev->done_head + dev->done_count) % SPI_QUEUE_MAX] = trans;
+        dev->done_count++;
+        pthread_cond_broadcast(&s_spi_cond);
+        pthread_mutex_unlock(&s_spi_lock);
+    }
+    return NULL;
+}
+
+static struct host_spi_device *s_devices[4];
+static int s_device_count = 0;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *bus_config, int dma_chan)
+{
+    (void)host;
+    (void)dma_chan;
+    if (!bus_config) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_once(&s_spi_once, spi_init_once);
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *dev_config,
+                             spi_device_handle_t *handle)
+{
+    (void)host;
+    if (!dev_config || !handle || dev_config->queue_size <= 0 || dev_config->queue_size > SPI_QUEUE_MAX ||
+        s_device_count >= 4) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_once(&s_spi_once, spi_init_once);
+
+    struct host_spi_device *dev = calloc(1, sizeof(*dev));
+    if (!dev) {
+        return ESP_ERR_NO_MEM;
+    }
+    dev->cfg = *dev_config;
+    if (pthread_create(&dev->thread, NULL, spi_bus_thread, dev) != 0) {
+        free(dev);
+        return ESP_FAIL;
+    }
+    pthread_detach(dev->thread);
+    s_devices[s_device_count++] = dev;
+    *handle = dev;
+    return ESP_OK;
+}
+
+static bool wait_locked(int64_t deadline_us, bool forever)
+{
+    if (forever) {
+        pthread_cond_wait(&s_spi_cond, &s_spi_lock);
+        return true;
+    }
+    struct timespec deadline;
+    host_deadline_from_esp_time(deadline_us, &deadline);
+    return pthread_cond_timedwait(&s_spi_cond, &s_spi_lock, &deadline) == 0;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t *trans, TickType_t ticks_to_wait)
+{
+    if (!handle || !trans) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const bool forever = ticks_to_wait == portMAX_DELAY;
+    const int64_t deadline_us = esp_timer_get_time() + (int64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000;
+
+    pthread_mutex_lock(&s_spi_lock);
+    // In-flight and unclaimed results share the device's queue_size slots, as on target.
+    while (handle->queue_count + handle->done_count + (handle->busy ? 1 : 0) >= handle->cfg.queue_size) {
+        if (!wait_locked(deadline_us, forever)) {
+            pthread_mutex_unlock(&s_spi_lock);
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+    handle->queue[(handle->queue_head + handle->queue_count) % SPI_QUEUE_MAX] = trans;
+    handle->queue_count++;
+    pthread_cond_broadcast(&s_spi_cond);
+    pthread_mutex_unlock(&s_spi_lock);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t **trans,
+                                      TickType_t ticks_to_wait)
+{
+    if (!handle || !trans) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    const bool forever = ticks_to_wait == portMAX_DELAY;
+    const int64_t deadline_us = esp_timer_get_time() + (int64_t)ticks_to_wait * portTICK_PERIOD_MS * 1000;
+
+    pthread_mutex_lock(&s_spi_lock);
+    while (handle->done_count == 0) {
+        if (ticks_to_wait == 0 || !wait_locked(deadline_us, forever)) {
+            pthread_mutex_unlock(&s_spi_lock);
+            return ESP_ERR_TIMEOUT;
+        }
+    }
+    *trans = handle->done[handle->done_head];
+    handle->done_head = (handle->done_head + 1) % SPI_QUEUE_MAX;
+    handle->done_count--;
+    pthread_cond_broadcast(&s_spi_cond);
+    pthread_mutex_unlock(&s_spi_lock);
+    return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t handle, spi_transaction_t *trans)
+{
+    if (!handle || !trans) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    pthread_mutex_lock(&s_spi_lock);
+    if (handle->queue_count > 0 || handle->busy) {
+        pthread_mutex_unlock(&s_spi_lock);
+        return ESP_ERR_INVALID_STATE;
+    }
+    pthread_mutex_unlock(&s_spi_lock);
+    spi_execute(handle, trans);
+    return ESP_OK;
+}
+
+void host_spi_get_stats(host_spi_stats_t *out)
+{
+    pthread_mutex_lock(&s_spi_lock);
+    *out = s_spi_stats;
+    pthread_mutex_unlock(&s_spi_lock);
+}
+
+void host_spi_reset_stats(void)
+{
+    pthread_mutex_lock(&s_spi_lock);
+    memset(&s_spi_stats, 0, sizeof(s_spi_stats));
+    pthread_mutex_unlock(&s_spi_lock);
+}
+
+void host_spi_wait_idle(void)
+{
+    pthread_once(&s_spi_once, spi_init_once);
+    pthread_mutex_lock(&s_spi_lock);
+    for (int i = 0; i < s_device_count; i++) {
+        while (s_devices[i]->queue_count > 0 || s_devices[i]->busy) {
+            pthread_cond_wait(&s_spi_cond, &s_spi_lock);
+        }
+    }
+    pthread_mutex_unlock(&s_spi_lock);
+}
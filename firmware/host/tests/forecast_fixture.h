@@ -0,0 +1,96 @@
+#pragma once
+
+// Open-Meteo /v1/forecast bodies shared by the parser test and benchmark: the
+// recorded one-day response served by the HTTP shim, a 7-day response with hourly
+// series that does not fit the old 4 KB response buffer, and a multi-location array.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char k_forecast_day[] =
+    "{\"latitude\":38.68,\"longitude\":-84.59,\"generationtime_ms\":0.0560283660888672,"
+    "\"utc_offset_seconds\":-18000,\"timezone\":\"America/New_York\",\"timezone_abbreviation\":\"EST\","
+    "\"elevation\":282.0,\"current_units\":{\"time\":\"iso8601\",\"interval\":\"seconds\","
+    "\"temperature_2m\":\"°F\",\"apparent_temperature\":\"°F\",\"weather_code\":\"wmo code\"},"
+    "\"current\":{\"time\":\"2026-01-04T14:30\",\"interval\":900,\"temperature_2m\":41.3,"
+    "\"apparent_temperature\":35.8,\"weather_code\":3},"
+    "\"daily_units\":{\"time\":\"iso8601\",\"temperature_2m_max\":\"°F\",\"temperature_2m_min\":\"°F\","
+    "\"sunrise\":\"iso8601\",\"sunset\":\"iso8601\"},"
+    "\"daily\":{\"time\":[\"2026-01-04\"],\"temperature_2m_max\":[44.6],\"temperature_2m_min\":[29.1],"
+    "\"sunrise\":[\"2026-01-04T07:56\"],\"sunset\":[\"2026-01-04T17:42\"]}}";
+
+static void fixture_append(char **buf, size_t *len, size_t *cap, const char *fmt, ...)
+    __attribute__((format(printf, 4, 5)));
+
+static void fixture_append(char **buf, size_t *len, size_t *cap, const char *fmt, ...)
+{
+    va_list args;
+    while (1) {
+        va_start(args, fmt);
+        int n = vsnprintf(*buf + *len, *cap - *len, fmt, args);
+        va_end(args);
+        if ((size_t)n < *cap - *len) {
+            *len += (size_t)n;
+            return;
+        }
+        *cap *= 2;
+        *buf = realloc(*buf, *cap);
+    }
+}
+
+// 7 days of hourly temperature/weather code ahead of the daily block, pretty-printed
+// like a proxy might. Caller frees. Not every test that includes this needs it.
+__attribute__((unused)) static char *fixture_forecast_week(size_t *out_len)
+{
+    size_t cap = 4096, len = 0;
+    char *buf = malloc(cap);
+    buf[0] = '\0';
+    fixture_append(&buf, &len, &cap,
+                   "{\n  \"latitude\": 38.68,\n  \"longitude\": -84.59,\n  \"timezone\": \"America/New_York\",\n"
+                   "  \"current_units\": {\"temperature_2m\": \"\\u00b0F\", \"weather_code\": \"wmo code\"},\n"
+                   "  \"current\": {\"time\": \"2026-01-04T14:30\", \"temperature_2m\": 41.3,\n"
+                   "    \"apparent_temperature\": 35.8, \"weather_code\": 3},\n"
+                   "  \"hourly\": {\n    \"time\": [");
+    for (int h = 0; h < 168; h++) {
+        fixture_append(&buf, &len, &cap, "%s\"2026-01-%02dT%02d:00\"", h ? ", " : "", 4 + h / 24, h % 24);
+    }
+    fixture_append(&buf, &len, &cap, "],\n    \"temperature_2m\": [");
+    for (int h = 0; h < 168; h++) {
+        fixture_append(&buf, &len, &cap, "%s%d.%d", h ? ", " : "", 28 + h % 17, h % 10);
+    }
+    fixture_append(&buf, &len, &cap, "],\n    \"weather_code\": [");
+    for (int h = 0; h < 168; h++) {
+        fixture_append(&buf, &len, &cap, "%s%d", h ? ", " : "", (h * 7) % 4);
+    }
+    fixture_append(&buf, &len, &cap,
+                   "]\n  },\n  \"daily\": {\n    \"time\": [\"2026-01-04\", \"2026-01-05\"],\n"
+                   "    \"temperature_2m_max\": [44.6, 47.0],\n    \"temperature_2m_min\": [29.1, 31.5],\n"
+                   "    \"sunrise\": [\"2026-01-04T07:56\", \"2026-01-05T07:56\"],\n"
+                   "    \"sunset\": [\"2026-01-04T17:42\", \"2026-01-05T17:43\"]\n  }\n}\n");
+    *out_len = len;
+    return buf;
+}
+
+// The one-day body once per location, as Open-Meteo answers a request with several
+// coordinates: a JSON array in request order. Location i reads (41 + 10 * i).3 F and
+// a high of (44 + 10 * i).6 F. Caller frees.
+__attribute__((unused)) static char *fixture_forecast_locations(size_t count, size_t *out_len)
+{
+    size_t cap = 4096, len = 0;
+    char *buf = malloc(cap);
+    buf[0] = '\0';
+    fixture_append(&buf, &len, &cap, "[");
+    for (size_t i = 0; i < count; i++) {
+        const size_t start = len;
+        fixture_append(&buf, &len, &cap, "%s%s", i ? "," : "", k_forecast_day);
+        char *temp = strstr(buf + start, "\"temperature_2m\":41.3");
+        char *high = strstr(buf + start, "\"temperature_2m_max\":[44.6]");
+        temp[sizeof("\"temperature_2m\":") - 1] = (char)('4' + i);
+        high[sizeof("\"temperature_2m_max\":[") - 1] = (char)('4' + i);
+    }
+    fixture_append(&buf, &len, &cap, "]");
+    *out_len = len;
+    return buf;
+}
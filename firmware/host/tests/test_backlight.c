@@ -0,0 +1,63 @@
+// Checks that dimming goes through the LEDC backlight channel with a hardware fade
+// and leaves the framebuffer alone: no invalidation, no redraw, no SPI traffic.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "backlight.h"
+#include "driver/ledc.h"
+#include "host_sim.h"
+#include "lvgl.h"
+#include "lvgl_port.h"
+#include "test_util.h"
+
+int main(void)
+{
+    CHECK(lvgl_port_init() == ESP_OK);
+    lv_refr_now();
+    host_spi_wait_idle();
+
+    // Display init switches the backlight fully on without a fade.
+    host_ledc_channel_stats_t ch;
+    CHECK(host_ledc_get_channel(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, &ch));
+    CHECK(ch.gpio_num == 27);
+    CHECK(ch.freq_hz == 5000);
+    CHECK(ch.duty == 1023);
+    CHECK(ch.duty_updates == 1 && ch.fades == 0);
+    CHECK(backlight_get_percent() == 100);
+
+    lv_refr_stats_t before;
+    lv_refr_get_stats(&before);
+    host_spi_reset_stats();
+
+    CHECK(backlight_set_percent(20, 400) == ESP_OK);
+    sleep_ms(200);
+    CHECK(host_ledc_get_channel(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, &ch));
+    printf("mid-fade duty=%u target=%u\n", ch.duty, ch.target_duty);
+    CHECK(ch.fades == 1 && ch.last_fade_ms == 400);
+    CHECK(ch.target_duty == 205);
+    CHECK(ch.duty < 1023 && ch.duty > 205);
+
+    sleep_ms(250);
+    CHECK(host_ledc_get_channel(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, &ch));
+    CHECK(ch.duty == 205);
+
+    // Same level again is a no-op; off is a fade to zero.
+    CHECK(backlight_set_percent(20, 400) == ESP_OK);
+    CHECK(backlight_set_percent(0, 400) == ESP_OK);
+    CHECK(host_ledc_get_channel(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, &ch));
+    CHECK(ch.fades == 2 && ch.target_duty == 0);
+
+    lv_refr_now();
+    host_spi_wait_idle();
+    lv_refr_stats_t after;
+    lv_refr_get_stats(&after);
+    host_spi_stats_t spi;
+    host_spi_get_stats(&spi);
+    CHECK(after.frames == before.frames);
+    CHECK(spi.bytes == 0);
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,88 @@
+// Checks the integer formatter used for the weather and clock strings: rounding of
+// deci-degrees, fixed-point coordinates, 12- and 24-hour times, and that output
+// which does not fit is cut off but always terminated.
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "fmt.h"
+#include "test_util.h"
+
+static char s_buf[64];
+
+static const char *deci(int32_t v)
+{
+    fmt_buf_t f;
+    fmt_init(&f, s_buf, sizeof(s_buf));
+    fmt_deci_round(&f, v);
+    return s_buf;
+}
+
+static const char *fixed(int32_t v, uint8_t decimals)
+{
+    fmt_buf_t f;
+    fmt_init(&f, s_buf, sizeof(s_buf));
+    fmt_fixed(&f, v, decimals);
+    return s_buf;
+}
+
+static const char *clock12(uint16_t minute)
+{
+    fmt_buf_t f;
+    fmt_init(&f, s_buf, sizeof(s_buf));
+    fmt_clock12(&f, minute);
+    return s_buf;
+}
+
+static const char *hhmm(uint16_t minute)
+{
+    fmt_buf_t f;
+    fmt_init(&f, s_buf, sizeof(s_buf));
+    fmt_hhmm(&f, minute);
+    return s_buf;
+}
+
+int main(void)
+{
+    CHECK(strcmp(deci(413), "41") == 0);
+    CHECK(strcmp(deci(446), "45") == 0);
+    CHECK(strcmp(deci(415), "42") == 0); // Half away from zero
+    CHECK(strcmp(deci(-415), "-42") == 0);
+    CHECK(strcmp(deci(-4), "0") == 0); // Never "-0"
+    CHECK(strcmp(deci(0), "0") == 0);
+    CHECK(strcmp(deci(-123), "-12") == 0);
+
+    CHECK(strcmp(fixed(386820, 4), "38.6820") == 0);
+    CHECK(strcmp(fixed(-845894, 4), "-84.5894") == 0);
+    CHECK(strcmp(fixed(-5000, 4), "-0.5000") == 0);
+    CHECK(strcmp(fixed(42, 0), "42") == 0);
+    CHECK(strcmp(fixed(INT32_MIN, 0), "-2147483648") == 0);
+
+    CHECK(strcmp(clock12(7 * 60 + 56), "7:56 AM") == 0);
+    CHECK(strcmp(clock12(17 * 60 + 42), "5:42 PM") == 0);
+    CHECK(strcmp(clock12(0), "12:00 AM") == 0);
+    CHECK(strcmp(clock12(12 * 60 + 5), "12:05 PM") == 0);
+    CHECK(strcmp(clock12(0xFFFF), "--:--") == 0);
+    CHECK(strcmp(hhmm(9 * 60 + 5), "09:05") == 0);
+    CHECK(strcmp(hhmm(23 * 60 + 59), "23:59") == 0);
+    CHECK(strcmp(hhmm(24 * 60), "--:--") == 0);
+
+    // Appends, and truncates at the buffer size.
+    char small[8];
+    fmt_buf_t f;
+    fmt_init(&f, small, sizeof(small));
+    fmt_str(&f, "H:");
+    fmt_deci_round(&f, 446);
+    fmt_str(&f, FMT_DEGREE);
+    CHECK(strcmp(small, "H:45\xC2\xB0") == 0);
+    fmt_str(&f, " L:29");
+    CHECK(f.len == sizeof(small) - 1);
+    CHECK(strlen(small) == sizeof(small) - 1);
+    fmt_init(&f, small, 0);
+    fmt_str(&f, "x"); // Zero-sized buffer: nothing written
+
+    printf("PASS fmt\n");
+    return 0;
+}
@@ -0,0 +1,128 @@
+// Checks the fixed-point forecast store: the parser fills the hourly and daily rings
+// from a 7-day body, "hour N"/"day N" lookups follow the clock (passed hours drop
+// out, local days follow the location's UTC offset), decimal temperatures round to
+// deci-degrees without floating point, and the store stays within its byte budget.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "forecast_fixture.h"
+#include "forecast_store.h"
+#include "test_util.h"
+#include "weather_parser.h"
+
+static const time_t k_jan4_utc = (time_t)20457 * 86400; // 2026-01-04T00:00Z
+
+static void parse(const char *body, size_t len, forecast_store_t *store)
+{
+    weather_data_t d;
+    weather_parser_t p;
+    weather_parser_init(&p, &d);
+    weather_parser_set_forecast(&p, store);
+    // Small pieces, so series elements straddle feed() calls.
+    for (size_t off = 0; off < len; off += 13) {
+        weather_parser_feed(&p, body + off, len - off < 13 ? len - off : 13);
+    }
+    CHECK(weather_parser_finish(&p) == ESP_OK);
+}
+
+static void check_week(void)
+{
+    size_t len;
+    char *body = fixture_forecast_week(&len);
+    forecast_store_t f;
+    parse(body, len, &f);
+    free(body);
+
+    // The body has 168 hours; the ring keeps the first FORECAST_HOURS.
+    CHECK(f.utc_offset_s == 0);
+    CHECK(f.first_hour == (uint32_t)(k_jan4_utc / 3600));
+    CHECK(f.hours == FORECAST_HOURS);
+    CHECK(f.days == 2);
+
+    forecast_hour_t h;
+    const time_t now = k_jan4_utc + 30 * 60;
+    CHECK(forecast_store_hour(&f, now, 0, &h));
+    CHECK(h.temp == 280 && h.code == 0); // "28.0", (0 * 7) % 4
+    CHECK(forecast_store_hour(&f, now, 5, &h));
+    CHECK(h.temp == 335 && h.code == 3); // "33.5", (5 * 7) % 4
+    CHECK(forecast_store_hour(&f, now, FORECAST_HOURS - 1, &h));
+    CHECK(h.temp == 280 + (FORECAST_HOURS - 1) % 17 * 10 + (FORECAST_HOURS - 1) % 10);
+    CHECK(!forecast_store_hour(&f, now, FORECAST_HOURS, &h));
+    CHECK(!forecast_store_hour(&f, k_jan4_utc - 1, 0, &h)); // Before the first hour
+
+    // Ten hours later "hour 0" is the eleventh stored hour; nothing moved in memory.
+    const time_t later = now + 10 * 3600;
+    CHECK(forecast_store_hour(&f, later, 0, &h));
+    CHECK(h.temp == 380 && h.code == 2); // "38.0", (10 * 7) % 4
+    CHECK(forecast_store_hour(&f, later, FORECAST_HOURS - 11, &h));
+    CHECK(!forecast_store_hour(&f, later, FORECAST_HOURS - 10, &h));
+
+    forecast_day_t d;
+    CHECK(forecast_store_day(&f, now, 0, &d));
+    CHECK(d.max == 446 && d.min == 291);
+    CHECK(forecast_store_day(&f, now, 1, &d));
+    CHECK(d.max == 470 && d.min == 315);
+    CHECK(!forecast_store_day(&f, now, 2, &d));
+    CHECK(forecast_store_day(&f, now + 86400, 0, &d));
+    CHECK(d.max == 470);
+}
+
+static void check_local_day(void)
+{
+    // utc_offset_seconds is -18000: the local day ends at 05:00Z.
+    forecast_store_t f;
+    parse(k_forecast_day, sizeof(k_forecast_day) - 1, &f);
+    CHECK(f.utc_offset_s == -18000);
+    CHECK(f.first_day == 20457);
+
+    forecast_day_t d;
+    CHECK(forecast_store_day(&f, k_jan4_utc + 86400 + 4 * 3600, 0, &d)); // Jan 4, 23:00 local
+    CHECK(d.max == 446 && d.code == 0);
+    CHECK(!forecast_store_day(&f, k_jan4_utc + 86400 + 6 * 3600, 0, &d)); // Jan 5, 01:00 local
+    CHECK(forecast_store_day(&f, k_jan4_utc, 1, &d)); // Jan 3, 19:00 local: tomorrow is Jan 4
+    CHECK(!forecast_store_day(&f, k_jan4_utc + 86400, 1, &d));
+}
+
+static void check_values(void)
+{
+    static const char body[] =
+        "{\"utc_offset_seconds\":3600,\"current\":{\"temperature_2m\":-2.25,\"apparent_temperature\":-7,"
+        "\"weather_code\":71},"
+        "\"hourly\":{\"time\":[\"2026-01-04T01:00\",\"2026-01-04T02:00\",\"2026-01-04T03:00\"],"
+        "\"temperature_2m\":[-2.25,0.04,null],\"weather_code\":[71,300,null]},"
+        "\"daily\":{\"time\":[\"2026-01-04\"],\"temperature_2m_max\":[1.95],\"temperature_2m_min\":[-12.349],"
+        "\"weather_code\":[73],\"sunrise\":[\"2026-01-04T08:17\"],\"sunset\":[null]}}";
+    forecast_store_t f;
+    parse(body, sizeof(body) - 1, &f);
+
+    // 01:00 local at UTC+1 is 00:00Z.
+    CHECK(f.first_hour == (uint32_t)(k_jan4_utc / 3600));
+    CHECK(f.hours == 3);
+    forecast_hour_t h;
+    CHECK(forecast_store_hour(&f, k_jan4_utc, 0, &h));
+    CHECK(h.temp == -23 && h.code == 71);
+    CHECK(forecast_store_hour(&f, k_jan4_utc, 1, &h));
+    CHECK(h.temp == 0 && h.code == 0); // Out-of-range code is dropped
+    CHECK(forecast_store_hour(&f, k_jan4_utc, 2, &h));
+    CHECK(h.temp == 0); // null leaves the slot cleared
+
+    forecast_day_t d;
+    CHECK(forecast_store_day(&f, k_jan4_utc, 0, &d));
+    CHECK(d.max == 20 && d.min == -123 && d.code == 73);
+    // Sun times in a response are not stored; weather_service_get_day() computes them.
+    CHECK(d.sunrise == FORECAST_MINUTE_NONE && d.sunset == FORECAST_MINUTE_NONE);
+}
+
+int main(void)
+{
+    check_week();
+    check_local_day();
+    check_values();
+
+    CHECK(sizeof(forecast_store_t) <= FORECAST_STORE_BUDGET_BYTES);
+    printf("PASS forecast_store bytes=%u budget=%u hours=%u days=%u\n", (unsigned)sizeof(forecast_store_t),
+           (unsigned)FORECAST_STORE_BUDGET_BYTES, (unsigned)FORECAST_HOURS, (unsigned)FORECAST_DAYS);
+    return 0;
+}
@@ -0,0 +1,74 @@
+// Checks the frame-timing histograms: a full-screen frame is timed until its last
+// band leaves the bus and counts as dropped, a small update lands in a low bucket,
+// and every lv_task_handler() call records its timer phase.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_sim.h"
+#include "lvgl.h"
+#include "lvgl_port.h"
+#include "test_util.h"
+
+static uint32_t hist_sum(const lv_frame_hist_t *hist)
+{
+    uint32_t sum = 0;
+    for (int i = 0; i < LV_FRAME_HIST_BUCKETS; i++) {
+        sum += hist->buckets[i];
+    }
+    return sum;
+}
+
+int main(void)
+{
+    CHECK(lvgl_port_init() == ESP_OK);
+    lv_obj_t *label = lv_label_create(lv_scr_act());
+    lv_label_set_text(label, "00");
+    lv_obj_center(label);
+
+    // Full screen: 480x320x2 bytes at 40 MHz is ~61 ms on the wire.
+    lv_frame_reset_stats();
+    lv_obj_invalidate(lv_scr_act());
+    lv_refr_now();
+    host_spi_wait_idle();
+    lv_frame_stats_t st;
+    lv_frame_get_stats(&st);
+    CHECK(st.frames == 1);
+    CHECK(st.worst.flush_us >= 55000);
+    CHECK(st.worst.total_us >= st.worst.flush_us);
+    CHECK(st.worst.total_us >= st.worst.render_us + st.worst.layout_us);
+    CHECK(st.dropped >= 1);
+    CHECK(st.total.buckets[LV_FRAME_HIST_BUCKETS - 1] + st.total.buckets[LV_FRAME_HIST_BUCKETS - 2] == 1);
+    CHECK(lv_frame_hist_percentile(&st.total, 95) == st.total.max_us ||
+          lv_frame_hist_percentile(&st.total, 95) == lv_frame_hist_bounds_us[LV_FRAME_HIST_BUCKETS - 2]);
+
+    // A two-glyph update is a small fraction of a refresh period.
+    lv_label_set_text(label, "01");
+    lv_refr_now();
+    host_spi_wait_idle();
+    lv_frame_get_stats(&st);
+    CHECK(st.frames == 2);
+    CHECK(st.dropped == st.worst.total_us / (LV_DISP_DEF_REFR_PERIOD * 1000));
+    CHECK(st.total.count == 2 && hist_sum(&st.total) == 2);
+    CHECK(hist_sum(&st.render) == 2 && hist_sum(&st.flush) == 2 && hist_sum(&st.layout) == 2);
+    CHECK(st.total.buckets[0] + st.total.buckets[1] + st.total.buckets[2] + st.total.buckets[3] +
+              st.total.buckets[4] ==
+          1);
+
+    // Each handler call records its timer phase, with or without a refresh.
+    uint32_t before = st.timer.count;
+    for (int i = 0; i < 5; i++) {
+        lv_task_handler();
+    }
+    lv_frame_get_stats(&st);
+    CHECK(st.timer.count == before + 5);
+    CHECK(lv_frame_hist_percentile(&st.timer, 50) <= lv_frame_hist_bounds_us[0]);
+
+    lv_frame_reset_stats();
+    lv_frame_get_stats(&st);
+    CHECK(st.frames == 0 && st.total.count == 0 && st.worst.total_us == 0);
+    CHECK(lv_frame_hist_percentile(&st.total, 95) == 0);
+
+    printf("PASS\n");
+    return 0;
+}
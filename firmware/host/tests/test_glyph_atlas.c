@@ -0,0 +1,93 @@
+// Times clock-face updates of a 48px "HH:MM" label with the rasterizer and then with
+// the digit atlas, and checks that the atlas path draws identical pixels without
+// running the rasterizer.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "host_sim.h"
+#include "lvgl.h"
+#include "lvgl_port.h"
+#include "test_util.h"
+
+#define UPDATES 60
+
+static uint16_t s_snapshot[LV_VER_RES][LV_HOR_RES];
+
+static void snapshot(void)
+{
+    for (int y = 0; y < LV_VER_RES; y++) {
+        for (int x = 0; x < LV_HOR_RES; x++) {
+            s_snapshot[y][x] = host_panel_get_pixel(x, y);
+        }
+    }
+}
+
+static bool matches_snapshot(void)
+{
+    for (int y = 0; y < LV_VER_RES; y++) {
+        for (int x = 0; x < LV_HOR_RES; x++) {
+            if (s_snapshot[y][x] != host_panel_get_pixel(x, y)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Sets a new time once per pass and returns the mean render time per update.
+static uint32_t run_updates(lv_obj_t *label, uint32_t *raster, uint32_t *cached)
+{
+    uint64_t total_us = 0;
+    *raster = 0;
+    *cached = 0;
+    for (int i = 0; i < UPDATES; i++) {
+        char buf[8];
+        snprintf(buf, sizeof(buf), "%02d:%02d", 10 + i / 60, i % 60);
+        lv_label_set_text(label, buf);
+        lv_refr_now();
+
+        lv_refr_stats_t refr;
+        lv_refr_get_stats(&refr);
+        total_us += refr.render_us;
+        *raster += refr.glyphs_raster;
+        *cached += refr.glyphs_cached;
+    }
+    host_spi_wait_idle();
+    return (uint32_t)(total_us / UPDATES);
+}
+
+int main(void)
+{
+    CHECK(lvgl_port_init() == ESP_OK);
+
+    lv_obj_t *screen = lv_scr_act();
+    lv_obj_set_style_bg_color(screen, lv_color_hex(0x0b1d3a), 0);
+    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, 0);
+
+    lv_obj_t *label = lv_label_create(screen);
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_48, 0);
+    lv_obj_set_style_text_color(label, lv_color_white(), 0);
+    lv_label_set_text(label, "00:00");
+    lv_obj_center(label);
+    lv_refr_now();
+
+    uint32_t raster, cached;
+    const uint32_t before_us = run_updates(label, &raster, &cached);
+    CHECK(cached == 0 && raster >= UPDATES);
+    snapshot();
+
+    CHECK(lv_font_cache_glyphs(&lv_font_montserrat_48, "0123456789:"));
+    lv_label_set_text(label, "88:88");
+    lv_refr_now();
+    const uint32_t after_us = run_updates(label, &raster, &cached);
+    CHECK(raster == 0 && cached >= UPDATES);
+
+    printf("time label update render: rasterizer %u us, atlas %u us\n", before_us, after_us);
+    CHECK(matches_snapshot());
+    CHECK(after_us < before_us);
+
+    printf("PASS\n");
+    return 0;
+}
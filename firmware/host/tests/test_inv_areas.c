@@ -0,0 +1,117 @@
+// Checks how invalidated areas are collected and merged before a refresh: contained
+// areas are dropped, overlapping ones (and whole chains of them) become one bounding
+// box, off-screen parts are clipped away, and the 33rd area falls back to a single
+// full-screen area.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_sim.h"
+#include "lvgl.h"
+#include "lvgl_port.h"
+#include "test_util.h"
+
+static uint32_t s_frames;
+
+static void inv(lv_coord_t x1, lv_coord_t y1, lv_coord_t x2, lv_coord_t y2)
+{
+    const lv_area_t area = {x1, y1, x2, y2};
+    lv_inv_area(&area);
+}
+
+// Runs a refresh and checks it drew `rects` areas covering `px` pixels for `requests`
+// on-screen invalidations.
+static void check_refresh(uint32_t requests, uint32_t rects, uint32_t px)
+{
+    lv_refr_now();
+    host_spi_wait_idle();
+    lv_refr_stats_t refr;
+    lv_refr_get_stats(&refr);
+    CHECK(refr.frames == ++s_frames);
+    CHECK(refr.inv_requests == requests);
+    CHECK(refr.dirty_rects == rects);
+    CHECK(refr.dirty_px == px);
+}
+
+static void check_nothing_pending(void)
+{
+    lv_refr_now();
+    host_spi_wait_idle();
+    lv_refr_stats_t refr;
+    lv_refr_get_stats(&refr);
+    CHECK(refr.frames == s_frames);
+}
+
+int main(void)
+{
+    CHECK(lvgl_port_init() == ESP_OK);
+    lv_refr_now();
+    host_spi_wait_idle();
+    lv_refr_stats_t refr;
+    lv_refr_get_stats(&refr);
+    s_frames = refr.frames;
+    const uint64_t total_before = refr.total_dirty_px;
+
+    // An area inside an earlier one is dropped when it is added.
+    inv(10, 10, 109, 109);
+    inv(20, 20, 49, 49);
+    check_refresh(2, 1, 100 * 100);
+
+    // The other way round it is kept, then swallowed by the join.
+    inv(20, 20, 49, 49);
+    inv(10, 10, 109, 109);
+    check_refresh(2, 1, 100 * 100);
+
+    // Two overlapping areas become their bounding box; disjoint ones stay apart.
+    inv(0, 0, 19, 19);
+    inv(10, 10, 29, 29);
+    inv(200, 200, 209, 209);
+    check_refresh(3, 2, 30 * 30 + 10 * 10);
+
+    // A chain: four disjoint strips, then a bridge over all of them. Joining the
+    // bridge into the first strip makes it overlap strips the scan already passed,
+    // and the chain must still end as one area.
+    inv(0, 0, 9, 9);
+    inv(20, 0, 29, 9);
+    inv(40, 0, 49, 9);
+    inv(60, 0, 69, 9);
+    inv(5, 0, 65, 9);
+    check_refresh(5, 1, 70 * 10);
+
+    // Entirely off screen: ignored, not even counted as a request.
+    inv(-50, -50, -1, -1);
+    inv(LV_HOR_RES, 0, LV_HOR_RES + 10, 10);
+    inv(0, LV_VER_RES, 10, LV_VER_RES + 10);
+    check_nothing_pending();
+
+    // Partly off screen: clipped to the screen.
+    inv(-10, -10, 9, 9);
+    inv(LV_HOR_RES - 5, LV_VER_RES - 5, LV_HOR_RES + 5, LV_VER_RES + 5);
+    inv(-50, -50, -1, -1);
+    check_refresh(2, 2, 10 * 10 + 5 * 5);
+
+    // LV_INV_BUF_SIZE disjoint areas fit; one more falls back to the full screen.
+    for (lv_coord_t i = 0; i < LV_INV_BUF_SIZE; i++) {
+        inv(i * 10, 0, i * 10, 0);
+    }
+    check_refresh(LV_INV_BUF_SIZE, LV_INV_BUF_SIZE, LV_INV_BUF_SIZE);
+    for (lv_coord_t i = 0; i <= LV_INV_BUF_SIZE; i++) {
+        inv(i * 10, 0, i * 10, 0);
+    }
+    check_refresh(LV_INV_BUF_SIZE + 1, 1, LV_HOR_RES * LV_VER_RES);
+
+    // Areas added after the fallback are inside it.
+    for (lv_coord_t i = 0; i <= LV_INV_BUF_SIZE; i++) {
+        inv(i * 10, 0, i * 10, 0);
+    }
+    inv(100, 100, 199, 199);
+    check_refresh(LV_INV_BUF_SIZE + 2, 1, LV_HOR_RES * LV_VER_RES);
+
+    const uint64_t total_px = 100 * 100 * 2 + 30 * 30 + 10 * 10 + 70 * 10 + 10 * 10 + 5 * 5 + LV_INV_BUF_SIZE +
+                              2 * (uint64_t)(LV_HOR_RES * LV_VER_RES);
+    lv_refr_get_stats(&refr);
+    CHECK(refr.total_dirty_px - total_before == total_px);
+
+    printf("PASS\n");
+    return 0;
+}
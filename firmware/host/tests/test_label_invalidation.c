@@ -0,0 +1,60 @@
+// Checks that lv_label_set_text() ignores unchanged text and invalidates only the
+// glyph cells that differ when the label keeps its size.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "host_sim.h"
+#include "lvgl.h"
+#include "lvgl_port.h"
+#include "test_util.h"
+
+static lv_refr_stats_t refresh(void)
+{
+    lv_refr_now();
+    host_spi_wait_idle();
+    lv_refr_stats_t refr;
+    lv_refr_get_stats(&refr);
+    return refr;
+}
+
+int main(void)
+{
+    CHECK(lvgl_port_init() == ESP_OK);
+
+    lv_obj_t *label = lv_label_create(lv_scr_act());
+    lv_obj_set_style_text_font(label, &lv_font_montserrat_48, 0);
+    lv_label_set_text(label, "12:58");
+    lv_obj_center(label);
+    lv_refr_stats_t refr = refresh();
+
+    const uint32_t cell_px = lv_font_montserrat_48.glyph_width * lv_font_montserrat_48.line_height;
+    uint32_t frames = refr.frames;
+
+    // Same text: nothing to redraw.
+    lv_label_set_text(label, "12:58");
+    refr = refresh();
+    CHECK(refr.frames == frames);
+
+    // One minute: one cell.
+    lv_label_set_text(label, "12:59");
+    refr = refresh();
+    CHECK(refr.frames == ++frames);
+    CHECK(refr.dirty_px == cell_px);
+
+    // Hour rollover: "2", "5" and "9" change, "1" and ":" stay.
+    lv_label_set_text_fmt(label, "%d:%02d", 13, 0);
+    refr = refresh();
+    CHECK(refr.frames == ++frames);
+    CHECK(refr.dirty_px == 3 * cell_px);
+
+    // A different length moves the centered label, so the whole old and new areas go.
+    const lv_area_t before = label->coords;
+    lv_label_set_text(label, "9:00");
+    refr = refresh();
+    CHECK(refr.frames == ++frames);
+    CHECK(refr.dirty_px == lv_area_get_size(&before));
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,178 @@
+// Checks local time against the C library's localtime_r() under the same POSIX TZ
+// strings: the second either side of every DST change over several decades, and
+// hours spread over the years between, in northern, southern, half-hour and no-DST
+// zones. Then the shared clock: one conversion per second, the period recomputed
+// only at a change or a clock step across one.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "civil_date.h"
+#include "local_time.h"
+#include "test_util.h"
+
+static const char *const k_zones[] = {
+    "EST5EDT,M3.2.0,M11.1.0",       // US Eastern
+    "PST8PDT,M4.1.0,M10.5.0",       // US rules before 2007
+    "CET-1CEST,M3.5.0,M10.5.0/3",   // Central Europe
+    "GMT0BST,M3.5.0/1,M10.5.0",     // UK
+    "AEST-10AEDT,M10.1.0,M4.1.0/3", // Sydney: DST across the new year
+    "<-03>3<-02>,M3.5.0/-2,M10.5.0/-1", // Greenland: negative rule times
+    "IST-2IDT,M3.4.4/26,M10.5.0",   // Israel: a change at 26:00
+    "<+0530>-5:30",                 // India: half hour, no DST
+    "NZST-12NZDT,J270/3,J96",       // Julian days (not New Zealand's real rules)
+    "UTC0",
+};
+
+static size_t s_compared = 0;
+
+static void compare(const char *tz, const local_time_zone_t *zone, time_t t)
+{
+    struct tm info;
+    localtime_r(&t, &info);
+    local_time_period_t period;
+    local_time_period(zone, t, &period);
+    CHECK(period.from <= t && t < period.until);
+    local_time_t lt;
+    local_time_convert(&period, t, &lt);
+    if (lt.year != info.tm_year + 1900 || lt.month != info.tm_mon + 1 || lt.mday != info.tm_mday ||
+        lt.hour != info.tm_hour || lt.minute != info.tm_min || lt.second != info.tm_sec || lt.wday != info.tm_wday ||
+        lt.yday != info.tm_yday || lt.dst != (info.tm_isdst > 0) || lt.utc_offset_s != info.tm_gmtoff) {
+        fprintf(stderr, "%s at %lld: %04d-%02d-%02d %02d:%02d:%02d dst=%d off=%d, libc %04d-%02d-%02d %02d:%02d:%02d "
+                        "dst=%d off=%ld\n",
+                tz, (long long)t, (int)lt.year, lt.month, lt.mday, lt.hour, lt.minute, lt.second, lt.dst,
+                (int)lt.utc_offset_s, info.tm_year + 1900, info.tm_mon + 1, info.tm_mday, info.tm_hour, info.tm_min,
+                info.tm_sec, info.tm_isdst, info.tm_gmtoff);
+        exit(1);
+    }
+    s_compared++;
+}
+
+static void check_zone(const char *tz)
+{
+    local_time_zone_t zone;
+    CHECK(local_time_parse_zone(tz, &zone));
+    setenv("TZ", tz, 1);
+    tzset();
+
+    // 1990 to 2060: walk from change to change, checking either side of each.
+    const time_t first = 631152000;
+    const time_t last = 2871763200;
+    size_t changes = 0;
+    local_time_period_t period;
+    for (time_t t = first; t < last; t = (time_t)period.until) {
+        local_time_period(&zone, t, &period);
+        compare(tz, &zone, t);
+        if (period.until >= last) {
+            break;
+        }
+        compare(tz, &zone, (time_t)period.until - 1);
+        changes++;
+    }
+    CHECK(zone.has_dst ? changes >= 2 * 69 : changes == 0);
+
+    // Hours in between, including ones that repeat or do not exist locally.
+    for (time_t t = first; t < last; t += 7 * 86400 + 3599) {
+        compare(tz, &zone, t);
+    }
+}
+
+static void check_parse(void)
+{
+    local_time_zone_t z;
+    CHECK(local_time_parse_zone("EST5EDT,M3.2.0,M11.1.0", &z));
+    CHECK(z.std_offset_s == -5 * 3600 && z.dst_offset_s == -4 * 3600 && z.has_dst);
+    CHECK(z.start.kind == 'M' && z.start.month == 3 && z.start.week == 2 && z.start.wday == 0);
+    CHECK(z.start.time_s == 7200);
+    CHECK(local_time_parse_zone("CET-1CEST,M3.5.0,M10.5.0/3", &z) && z.end.time_s == 3 * 3600);
+    // Without rules, the US ones. (Not compared with the C library, which would load
+    // the tz database's PST8PDT with its history.)
+    CHECK(local_time_parse_zone("PST8PDT", &z) && z.has_dst && z.start.month == 3 && z.end.month == 11);
+    CHECK(local_time_parse_zone("<+0530>-5:30", &z) && z.std_offset_s == 5 * 3600 + 1800 && !z.has_dst);
+    CHECK(local_time_parse_zone("XXX3YYY2,100,200/-1", &z) && z.dst_offset_s == -2 * 3600 && z.start.kind == 'D' &&
+          z.end.day == 200 && z.end.time_s == -3600);
+
+    CHECK(!local_time_parse_zone("", &z));
+    CHECK(!local_time_parse_zone(NULL, &z));
+    CHECK(!local_time_parse_zone("EST", &z));              // No offset
+    CHECK(!local_time_parse_zone("E5", &z));               // Name too short
+    CHECK(!local_time_parse_zone("EST5EDT,M3.2.0", &z));   // One rule
+    CHECK(!local_time_parse_zone("EST5EDT,M13.2.0,M11.1.0", &z));
+    CHECK(!local_time_parse_zone("EST5EDT,M3.6.0,M11.1.0", &z));
+    CHECK(!local_time_parse_zone("EST5EDT,J0,J100", &z));
+    CHECK(!local_time_parse_zone("EST25", &z));
+    CHECK(!local_time_parse_zone("EST5 ", &z));
+}
+
+static void check_shared(void)
+{
+    CHECK(local_time_init("EST5EDT,M3.2.0,M11.1.0") == ESP_OK);
+    // 2026-03-08 07:00:00 UTC is 03:00 EDT: the spring change.
+    const time_t change = 1772953200;
+    local_time_t a;
+    local_time_t b;
+
+    local_time_get(change - 2, &a);
+    local_time_get(change - 2, &b);
+    CHECK(a.hour == 1 && a.minute == 59 && a.second == 58 && !a.dst && b.utc == a.utc);
+    local_time_get(change - 1, &a);
+    CHECK(a.hour == 1 && a.second == 59);
+    local_time_get(change, &a);
+    CHECK(a.hour == 3 && a.minute == 0 && a.dst && a.utc_offset_s == -4 * 3600);
+    local_time_get(change, &b);
+    local_time_stats_t st;
+    local_time_get_stats(&st);
+    CHECK(st.calls == 5 && st.shared == 2 && st.conversions == 3 && st.transitions == 2);
+
+    // A day of seconds in the same period: no further transition lookups.
+    for (time_t t = change + 1; t < change + 86400; t++) {
+        local_time_get(t, &a);
+    }
+    local_time_get_stats(&st);
+    CHECK(st.transitions == 2 && a.hour == 2 && a.minute == 59 && a.second == 59);
+
+    // A clock stepped back across the change recomputes once.
+    local_time_get(change - 3600, &a);
+    local_time_get_stats(&st);
+    CHECK(st.transitions == 3 && a.hour == 1 && a.minute == 0 && !a.dst);
+
+    // A bad string leaves UTC.
+    CHECK(local_time_init("not a zone") == ESP_ERR_INVALID_ARG);
+    local_time_get(change, &a);
+    CHECK(a.hour == 7 && a.utc_offset_s == 0);
+}
+
+// civil_date.h against glibc's gmtime_r(), from 1 CE to beyond 2400.
+static void check_calendar(void)
+{
+    CHECK(civil_to_days(1970, 1, 1) == 0);
+    CHECK(civil_to_days(2000, 3, 1) == 11017);
+    CHECK(civil_to_days(2026, 1, 4) == 20457);
+    for (int32_t day = -719162; day < 160000; day += 13) {
+        const time_t t = (time_t)day * 86400;
+        struct tm tm;
+        CHECK(gmtime_r(&t, &tm));
+        int32_t y;
+        uint8_t m;
+        uint8_t d;
+        civil_from_days(day, &y, &m, &d);
+        CHECK(y == tm.tm_year + 1900 && m == tm.tm_mon + 1 && d == tm.tm_mday);
+        CHECK(civil_weekday(day) == tm.tm_wday);
+        CHECK(civil_to_days(y, m, d) == day);
+        CHECK(d <= civil_days_in_month(y, m));
+    }
+}
+
+int main(void)
+{
+    check_calendar();
+    check_parse();
+    for (size_t i = 0; i < sizeof(k_zones) / sizeof(k_zones[0]); i++) {
+        check_zone(k_zones[i]);
+    }
+    check_shared();
+    printf("PASS local_time zones=%zu compared=%zu\n", sizeof(k_zones) / sizeof(k_zones[0]), s_compared);
+    return 0;
+}
@@ -0,0 +1,147 @@
+// Checks the animation engine: Q16 easing endpoints and shape, playback and repeat
+// sequencing, time-based catch-up after a late pass, and pausing.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "lvgl.h"
+#include "lvgl_port.h"
+#include "test_util.h"
+
+static int32_t s_value;
+static int s_exec_calls;
+static int s_ready_calls;
+
+static void exec_cb(void *var, int32_t v)
+{
+    (void)var;
+    s_value = v;
+    s_exec_calls++;
+}
+
+static void ready_cb(lv_anim_t *a)
+{
+    (void)a;
+    s_ready_calls++;
+}
+
+static int32_t path_at(lv_anim_path_cb_t path, int32_t act_time)
+{
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_values(&a, 0, 1000);
+    lv_anim_set_time(&a, 1000);
+    a.act_time = act_time;
+    return path(&a);
+}
+
+// Runs lv_task_handler() for ms milliseconds of wall time.
+static void run_for(uint32_t ms)
+{
+    uint32_t start = lv_tick_get();
+    while (lv_tick_get() - start < ms) {
+        lv_task_handler();
+        sleep_ms(2);
+    }
+}
+
+int main(void)
+{
+    CHECK(lvgl_port_init() == ESP_OK);
+
+    // Easing curves hit their endpoints exactly and keep their shape.
+    lv_anim_path_cb_t paths[] = {lv_anim_path_linear, lv_anim_path_ease_in, lv_anim_path_ease_out,
+                                 lv_anim_path_ease_in_out};
+    for (size_t i = 0; i < sizeof(paths) / sizeof(paths[0]); i++) {
+        CHECK(path_at(paths[i], 0) == 0);
+        CHECK(path_at(paths[i], 1000) == 1000);
+        int32_t prev = 0;
+        for (int32_t t = 0; t <= 1000; t += 10) {
+            int32_t v = path_at(paths[i], t);
+            CHECK(v >= prev);
+            prev = v;
+        }
+    }
+    CHECK(path_at(lv_anim_path_linear, 250) == 250);
+    CHECK(path_at(lv_anim_path_ease_in, 250) < 100);
+    CHECK(path_at(lv_anim_path_ease_out, 250) > 300);
+    CHECK(path_at(lv_anim_path_ease_in_out, 500) == 500);
+    CHECK(path_at(lv_anim_path_step, 999) == 0);
+    CHECK(path_at(lv_anim_path_step, 1000) == 1000);
+
+    // Start value is applied immediately; the run ends exactly on the end value.
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, &s_value);
+    lv_anim_set_exec_cb(&a, exec_cb);
+    lv_anim_set_ready_cb(&a, ready_cb);
+    lv_anim_set_values(&a, 0, 100);
+    lv_anim_set_time(&a, 200);
+    lv_anim_start(&a);
+    CHECK(s_value == 0);
+    CHECK(lv_anim_count_running() == 1);
+    run_for(100);
+    CHECK(s_value > 0 && s_value < 100);
+    run_for(200);
+    CHECK(s_value == 100);
+    CHECK(s_ready_calls == 1);
+    CHECK(lv_anim_count_running() == 0);
+    CHECK(lv_task_handler() == LV_NO_TIMER_READY);
+
+    // Playback goes out and back; two repeats end on the start value.
+    s_ready_calls = 0;
+    lv_anim_set_time(&a, 100);
+    lv_anim_set_playback_time(&a, 100);
+    lv_anim_set_repeat_count(&a, 2);
+    lv_anim_start(&a);
+    int32_t peak = 0;
+    uint32_t start = lv_tick_get();
+    while (s_ready_calls == 0 && lv_tick_get() - start < 1000) {
+        lv_task_handler();
+        if (s_value > peak) {
+            peak = s_value;
+        }
+        sleep_ms(2);
+    }
+    CHECK(s_ready_calls == 1);
+    CHECK(peak == 100);
+    CHECK(s_value == 0);
+    uint32_t elapsed = lv_tick_get() - start;
+    CHECK(elapsed >= 400 && elapsed < 500);
+
+    // A late pass jumps straight to the current position and counts the dropped frames.
+    lv_anim_stats_t before;
+    lv_anim_get_stats(&before);
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, &s_value);
+    lv_anim_set_exec_cb(&a, exec_cb);
+    lv_anim_set_values(&a, 0, 1000);
+    lv_anim_set_time(&a, 1000);
+    lv_anim_start(&a);
+    sleep_ms(500);
+    s_exec_calls = 0;
+    lv_task_handler();
+    CHECK(s_exec_calls == 1);
+    CHECK(s_value >= 450 && s_value <= 600);
+    lv_anim_stats_t after;
+    lv_anim_get_stats(&after);
+    CHECK(after.dropped_frames - before.dropped_frames >= 10);
+
+    // Paused animations freeze and schedule nothing, then resume without a jump.
+    lv_anim_set_paused(true);
+    int32_t frozen = s_value;
+    CHECK(lv_task_handler() == LV_NO_TIMER_READY);
+    sleep_ms(300);
+    CHECK(lv_task_handler() == LV_NO_TIMER_READY);
+    CHECK(s_value == frozen);
+    lv_anim_set_paused(false);
+    run_for(60);
+    CHECK(s_value > frozen && s_value < frozen + 150);
+
+    CHECK(lv_anim_del(&s_value, exec_cb));
+    CHECK(lv_anim_count_running() == 0);
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,137 @@
+// Checks the LVGL slab pools: deleting a subtree returns every slot, exhaustion is
+// reported instead of touching the heap, and the high-water mark survives frees.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "lvgl.h"
+#include "lvgl_port.h"
+#include "test_util.h"
+
+static int s_anim_value;
+
+static void anim_exec(void *var, int32_t v)
+{
+    (void)var;
+    s_anim_value = v;
+}
+
+static void timer_cb(lv_timer_t *t)
+{
+    (void)t;
+}
+
+static lv_timer_t *s_victim;
+static int s_victim_runs;
+static int s_killer_runs;
+
+static void victim_cb(lv_timer_t *t)
+{
+    (void)t;
+    s_victim_runs++;
+}
+
+// Deletes itself and the timer linked after it.
+static void killer_cb(lv_timer_t *t)
+{
+    s_killer_runs++;
+    lv_timer_del(s_victim);
+    lv_timer_del(t);
+}
+
+int main(void)
+{
+    CHECK(lvgl_port_init() == ESP_OK);
+
+    lv_mem_stats_t mem;
+    lv_mem_get_stats(&mem);
+    const uint16_t base_obj = mem.obj.used;
+    const uint16_t base_anim = mem.anim.used;
+
+    // A three-level tree: panel -> 4 rows -> 3 labels each.
+    lv_obj_t *panel = lv_obj_create(lv_scr_act());
+    for (int r = 0; r < 4; r++) {
+        lv_obj_t *row = lv_obj_create(panel);
+        for (int c = 0; c < 3; c++) {
+            lv_obj_t *label = lv_label_create(row);
+            CHECK(label != NULL);
+            lv_anim_t a;
+            lv_anim_init(&a);
+            lv_anim_set_var(&a, label);
+            lv_anim_set_exec_cb(&a, anim_exec);
+            lv_anim_set_values(&a, 0, 100);
+            lv_anim_set_time(&a, 500);
+            lv_anim_start(&a);
+        }
+    }
+    lv_mem_get_stats(&mem);
+    CHECK(mem.obj.used == base_obj + 1 + 4 + 4 * 3);
+    CHECK(mem.anim.used == base_anim + 12);
+
+    // Deleting the root frees the whole subtree and the animations bound to it.
+    lv_obj_del(panel);
+    lv_mem_get_stats(&mem);
+    CHECK(mem.obj.used == base_obj);
+    CHECK(mem.anim.used == base_anim);
+    CHECK(mem.obj.high_water >= base_obj + 17);
+
+    // Restarting an animation on the same var/exec_cb replaces it.
+    lv_obj_t *obj = lv_obj_create(lv_scr_act());
+    lv_anim_t a;
+    lv_anim_init(&a);
+    lv_anim_set_var(&a, obj);
+    lv_anim_set_exec_cb(&a, anim_exec);
+    lv_anim_start(&a);
+    lv_anim_start(&a);
+    lv_mem_get_stats(&mem);
+    CHECK(mem.anim.used == base_anim + 1);
+    CHECK(lv_anim_del(obj, NULL));
+    CHECK(!lv_anim_del(obj, NULL));
+    lv_obj_del(obj);
+
+    // Exhaust the object pool: creation fails cleanly and is counted.
+    lv_mem_get_stats(&mem);
+    const uint16_t free_slots = mem.obj.capacity - mem.obj.used;
+    lv_obj_t *filler = lv_obj_create(lv_scr_act());
+    for (uint16_t i = 1; i < free_slots; i++) {
+        CHECK(lv_obj_create(filler) != NULL);
+    }
+    CHECK(lv_obj_create(filler) == NULL);
+    lv_mem_get_stats(&mem);
+    CHECK(mem.obj.used == mem.obj.capacity);
+    CHECK(mem.obj.failures == 1);
+    CHECK(mem.obj.high_water == mem.obj.capacity);
+
+    lv_obj_del(filler);
+    lv_mem_get_stats(&mem);
+    CHECK(mem.obj.used == base_obj);
+    CHECK(mem.obj.high_water == mem.obj.capacity);
+
+    // Timers come from their own pool and go back on delete.
+    lv_mem_get_stats(&mem);
+    const uint16_t base_timer = mem.timer.used;
+    lv_timer_t *t = lv_timer_create(timer_cb, 1000, NULL);
+    CHECK(t != NULL);
+    lv_mem_get_stats(&mem);
+    CHECK(mem.timer.used == base_timer + 1);
+    lv_timer_del(t);
+    lv_mem_get_stats(&mem);
+    CHECK(mem.timer.used == base_timer);
+
+    // A callback deleting timers mid-walk, its own included: the handler neither
+    // touches the freed slots nor runs the deleted ones, and the others still run.
+    CHECK(lvgl_port_lock(1000));
+    lv_timer_t *survivor = lv_timer_create(victim_cb, 0, NULL);
+    s_victim = lv_timer_create(victim_cb, 0, NULL);
+    lv_timer_create(killer_cb, 0, NULL); // Created last, so walked first
+    s_victim_runs = 0;
+    lv_timer_handler();
+    CHECK(s_killer_runs == 1 && s_victim_runs == 1);
+    lv_mem_get_stats(&mem);
+    CHECK(mem.timer.used == base_timer + 1);
+    lv_timer_del(survivor);
+    lvgl_port_unlock();
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+// Checks the NTP client: clock selection on synthetic samples, then one round against
+// stand-in servers on 127.0.0.1 with symmetric and asymmetric delays, one serving
+// the wrong time and the failure modes that must not count as replies, and a failing
+// select() that must end the round rather than spin until the timeout.
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/select.h>
+
+#include "esp_timer.h"
+#include "host_sim.h"
+#include "ntp_client.h"
+#include "test_util.h"
+
+static bool s_select_fails = false;
+static uint32_t s_select_calls = 0;
+
+int __real_select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout);
+
+int __wrap_select(int nfds, fd_set *readfds, fd_set *writefds, fd_set *exceptfds, struct timeval *timeout)
+{
+    s_select_calls++;
+    if (s_select_fails) {
+        errno = EBADF;
+        return -1;
+    }
+    return __real_select(nfds, readfds, writefds, exceptfds, timeout);
+}
+
+#define SAMPLE(offset, delay) {.valid = true, .offset_us = (offset), .delay_us = (delay), .distance_us = (delay) / 2}
+
+static void check_select(void)
+{
+    size_t falsetickers = 99;
+
+    // The one 2 s off is outvoted; of the rest, the shortest round trip wins even
+    // though its offset is not the median.
+    const ntp_sample_t a[] = {SAMPLE(1000, 8000), SAMPLE(2000000, 2000), SAMPLE(-1500, 4000), SAMPLE(500, 6000)};
+    CHECK(ntp_client_select(a, 4, &falsetickers) == 2 && falsetickers == 1);
+
+    // Invalid samples neither vote nor win.
+    ntp_sample_t b[] = {SAMPLE(0, 4000), SAMPLE(100, 4000), SAMPLE(0, 10)};
+    b[2].valid = false;
+    CHECK(ntp_client_select(b, 3, &falsetickers) == 0 && falsetickers == 0);
+
+    // Two that disagree: no majority, no time.
+    const ntp_sample_t c[] = {SAMPLE(0, 2000), SAMPLE(50000, 2000)};
+    CHECK(ntp_client_select(c, 2, &falsetickers) == -1 && falsetickers == 2);
+
+    // A single server is believed; none at all is not.
+    CHECK(ntp_client_select(c, 1, NULL) == 0);
+    CHECK(ntp_client_select(b + 2, 1, &falsetickers) == -1 && falsetickers == 0);
+
+    // Intervals that only touch still overlap: the point shared counts for both.
+    const ntp_sample_t d[] = {SAMPLE(0, 2000), SAMPLE(2000, 2000), SAMPLE(1000, 2000)};
+    CHECK(ntp_client_select(d, 3, &falsetickers) == 0 && falsetickers == 0);
+}
+
+int main(void)
+{
+    check_select();
+
+    // The device clock is 50 ms behind.
+    host_ntp_set_clock(50000, 0);
+    const host_ntp_server_config_t servers[] = {
+        {.request_delay_ms = 3, .reply_delay_ms = 3},    // Good, further away
+        {.request_delay_ms = 0, .reply_delay_ms = 0},    // Good, nearest
+        {.request_delay_ms = 40, .reply_delay_ms = 0},   // Asymmetric: reads 20 ms ahead
+        {.error_us = -2000000},                          // Falseticker
+        {.fault = HOST_NTP_FAULT_KISS},
+        {.fault = HOST_NTP_FAULT_UNSYNCED},
+        {.fault = HOST_NTP_FAULT_SILENT},
+    };
+    const char *const names[] = {"far.test", "near.test", "asym.test", "wrong.test",
+                                 "kiss.test", "unsynced.test", "silent.test"};
+    const size_t count = sizeof(names) / sizeof(names[0]);
+    for (size_t i = 0; i < count; i++) {
+        CHECK(host_ntp_server_add(names[i], &servers[i]) != 0);
+    }
+
+    ntp_sample_t samples[sizeof(names) / sizeof(names[0])];
+    const int64_t start_us = esp_timer_get_time();
+    const size_t answered = ntp_client_query(names, count, 300, samples);
+    const int64_t took_us = esp_timer_get_time() - start_us;
+    // All at once: the silent server costs the timeout once, not per server.
+    CHECK(took_us >= 300000 && took_us < 400000);
+    CHECK(answered == 4);
+    CHECK(samples[0].valid && samples[1].valid && samples[2].valid && samples[3].valid);
+    CHECK(!samples[4].valid && !samples[5].valid && !samples[6].valid);
+
+    CHECK(llabs(samples[0].offset_us - 50000) < 1000 && samples[0].delay_us >= 6000);
+    CHECK(llabs(samples[1].offset_us - 50000) < 1000 && samples[1].delay_us < 2000);
+    // Half the asymmetry shows up in the offset; half the delay bounds the error.
+    CHECK(llabs(samples[2].offset_us - 70000) < 2000 && samples[2].delay_us >= 40000);
+    CHECK(samples[2].distance_us >= samples[2].delay_us / 2);
+    CHECK(llabs(samples[3].offset_us + 1950000) < 1000);
+
+    size_t falsetickers = 0;
+    CHECK(ntp_client_select(samples, count, &falsetickers) == 1 && falsetickers == 1);
+
+    host_ntp_stats_t stats;
+    host_ntp_get_stats(&stats);
+    CHECK(stats.requests == count);
+
+    // A select() error ends the round at once, every server unanswered.
+    s_select_fails = true;
+    s_select_calls = 0;
+    const int64_t fail_start_us = esp_timer_get_time();
+    ntp_sample_t failed[sizeof(names) / sizeof(names[0])];
+    CHECK(ntp_client_query(names, count, 300, failed) == 0);
+    CHECK(esp_timer_get_time() - fail_start_us < 100000);
+    CHECK(s_select_calls == 1);
+    for (size_t i = 0; i < count; i++) {
+        CHECK(!failed[i].valid);
+    }
+    s_select_fails = false;
+
+    printf("PASS ntp_client answered=%zu took_ms=%lld offset_us=%lld rtt_us=%d\n", answered,
+           (long long)(took_us / 1000), (long long)samples[1].offset_us, samples[1].delay_us);
+    return 0;
+}
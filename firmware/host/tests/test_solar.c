@@ -0,0 +1,111 @@
+// Checks the fixed-point sunrise/sunset/twilight computation against reference times
+// from NOAA's full solar position algorithm (double precision, iterated at the event
+// time), across latitudes, hemispheres and seasons, and the days the sun does not
+// rise, set or leave civil twilight. Then the once-a-day cache.
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "civil_date.h"
+#include "forecast_store.h"
+#include "solar.h"
+#include "test_util.h"
+
+#define HM(h, m) ((h) * 60 + (m))
+#define NONE FORECAST_MINUTE_NONE
+#define TOLERANCE_MIN 2
+
+typedef struct {
+    const char *name;
+    int32_t lat_e4;
+    int32_t lon_e4;
+    int32_t y;
+    uint32_t m;
+    uint32_t d;
+    int32_t utc_offset_s;
+    uint16_t dawn, sunrise, sunset, dusk;
+} reference_t;
+
+static const reference_t k_reference[] = {
+    {"Dry Ridge, winter", 386820, -845894, 2026, 1, 4, -5 * 3600, HM(7, 27), HM(7, 57), HM(17, 30), HM(18, 0)},
+    {"Dry Ridge, summer", 386820, -845894, 2026, 7, 4, -4 * 3600, HM(5, 47), HM(6, 19), HM(21, 7), HM(21, 38)},
+    {"London, midsummer", 515074, -1278, 2026, 6, 21, 3600, HM(3, 55), HM(4, 43), HM(21, 22), HM(22, 9)},
+    {"London, midwinter", 515074, -1278, 2026, 12, 21, 0, HM(7, 23), HM(8, 4), HM(15, 53), HM(16, 34)},
+    {"Sydney, midsummer", -338688, 1512093, 2026, 12, 21, 11 * 3600, HM(5, 11), HM(5, 41), HM(20, 5), HM(20, 35)},
+    {"Quito, equinox", -1807, -784678, 2026, 3, 20, -5 * 3600, HM(5, 57), HM(6, 18), HM(18, 24), HM(18, 45)},
+    {"Tokyo, equinox", 356762, 1396503, 2026, 9, 23, 9 * 3600, HM(5, 4), HM(5, 30), HM(17, 38), HM(18, 3)},
+    {"Cape Town, midwinter", -339249, 184241, 2026, 6, 21, 2 * 3600, HM(7, 24), HM(7, 51), HM(17, 45), HM(18, 13)},
+    {"New York, leap day", 407128, -740060, 2028, 2, 29, -5 * 3600, HM(6, 3), HM(6, 31), HM(17, 47), HM(18, 14)},
+    // Sets after midnight, no civil dusk at all.
+    {"Reykjavik, midsummer", 641466, -219426, 2026, 6, 21, 0, NONE, HM(2, 55), HM(0, 4), NONE},
+    // Polar night: twilight only. Midnight sun: nothing.
+    {"Tromso, polar night", 696492, 189553, 2026, 12, 21, 3600, HM(9, 31), NONE, NONE, HM(13, 53)},
+    {"Tromso, midnight sun", 696492, 189553, 2026, 6, 21, 2 * 3600, NONE, NONE, NONE, NONE},
+};
+
+// Minutes apart on the clock face, across midnight too.
+static int distance(uint16_t a, uint16_t b)
+{
+    if (a == NONE || b == NONE) {
+        return a == b ? 0 : 24 * 60;
+    }
+    const int diff = abs((int)a - (int)b);
+    return diff < 12 * 60 ? diff : 24 * 60 - diff;
+}
+
+static void check_event(const char *name, const char *event, uint16_t got, uint16_t want, int *worst)
+{
+    const int off = distance(got, want);
+    if (off > TOLERANCE_MIN) {
+        fprintf(stderr, "%s %s: got %u want %u\n", name, event, got, want);
+    }
+    CHECK(off <= TOLERANCE_MIN);
+    if (off > *worst) {
+        *worst = off;
+    }
+}
+
+int main(void)
+{
+    int worst = 0;
+    for (size_t i = 0; i < sizeof(k_reference) / sizeof(k_reference[0]); i++) {
+        const reference_t *r = &k_reference[i];
+        solar_day_t sun;
+        solar_compute(r->lat_e4, r->lon_e4, civil_to_days(r->y, r->m, r->d), r->utc_offset_s, &sun);
+        check_event(r->name, "dawn", sun.dawn, r->dawn, &worst);
+        check_event(r->name, "sunrise", sun.sunrise, r->sunrise, &worst);
+        check_event(r->name, "sunset", sun.sunset, r->sunset, &worst);
+        check_event(r->name, "dusk", sun.dusk, r->dusk, &worst);
+    }
+
+    // Day length changes smoothly: no day of the year jumps by more than a few minutes.
+    const int32_t jan1 = civil_to_days(2026, 1, 1);
+    solar_day_t prev;
+    solar_compute(386820, -845894, jan1 - 1, -5 * 3600, &prev);
+    for (int32_t day = jan1; day < jan1 + 365; day++) {
+        solar_day_t sun;
+        solar_compute(386820, -845894, day, -5 * 3600, &sun);
+        CHECK(sun.sunrise < sun.sunset && sun.dawn < sun.sunrise && sun.sunset < sun.dusk);
+        CHECK(distance(sun.sunrise, prev.sunrise) <= 2 && distance(sun.sunset, prev.sunset) <= 2);
+        prev = sun;
+    }
+
+    // The cache answers for the rest of the local day and recomputes after midnight.
+    solar_cache_t cache = {0};
+    solar_day_t a, b;
+    const time_t jan4 = (time_t)civil_to_days(2026, 1, 4) * 86400;
+    const time_t local_noon = jan4 + 17 * 3600; // 12:00 EST
+    solar_today(&cache, 386820, -845894, -5 * 3600, local_noon, &a);
+    CHECK(cache.valid && cache.day == civil_to_days(2026, 1, 4));
+    CHECK(distance(a.sunrise, HM(7, 57)) <= TOLERANCE_MIN);
+    cache.times.sunrise = 1; // Served from the cache, not recomputed
+    solar_today(&cache, 386820, -845894, -5 * 3600, local_noon + 11 * 3600, &b);
+    CHECK(b.sunrise == 1);
+    solar_today(&cache, 386820, -845894, -5 * 3600, local_noon + 12 * 3600, &b);
+    CHECK(cache.day == civil_to_days(2026, 1, 5) && distance(b.sunrise, a.sunrise) <= 1);
+    solar_today(&cache, 515074, -1278, 0, local_noon + 12 * 3600, &b); // Other place
+    CHECK(distance(b.sunrise, HM(8, 5)) <= TOLERANCE_MIN);
+
+    printf("PASS solar cases=%zu worst_error_min=%d\n", sizeof(k_reference) / sizeof(k_reference[0]), worst);
+    return 0;
+}
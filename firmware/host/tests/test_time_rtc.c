@@ -0,0 +1,67 @@
+// Checks the deep-sleep clock state: restoring the wall clock from an anchor and the
+// RTC timer, refusing to after the timer restarted, and learning the timer's rate
+// from what the first sync after a wake finds.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "test_util.h"
+#include "time_rtc.h"
+
+#define SEC 1000000LL
+#define T0 (1760000000LL * SEC) // Some wall clock time in 2025
+
+int main(void)
+{
+    time_rtc_state_t st;
+    memset(&st, 0, sizeof(st));
+    int64_t unix_us = 0;
+
+    // Nothing saved yet (power-on): nothing to restore.
+    CHECK(!time_rtc_restore(&st, 5 * SEC, &unix_us));
+
+    // Garbage from before the first save is not trusted as a learned rate.
+    memset(&st, 0x5a, sizeof(st));
+    time_rtc_save(&st, T0, 10 * SEC, 1234, true);
+    CHECK(st.magic == TIME_RTC_MAGIC && st.rtc_drift_ppb == 0 && st.drift_ppb == 1234);
+    CHECK(st.last_sync_unix_us == T0);
+
+    // An hour asleep with a timer that keeps perfect time.
+    CHECK(time_rtc_restore(&st, 10 * SEC + 3600 * SEC, &unix_us));
+    CHECK(unix_us == T0 + 3600 * SEC);
+
+    // A save on the way to sleep moves the anchor but not the last sync.
+    time_rtc_save(&st, T0 + 60 * SEC, 70 * SEC, 1234, false);
+    CHECK(st.last_sync_unix_us == T0 && st.anchor_unix_us == T0 + 60 * SEC);
+    CHECK(time_rtc_restore(&st, 70 * SEC, &unix_us) && unix_us == T0 + 60 * SEC);
+
+    // The timer restarted (power loss): it reads less than at the anchor.
+    CHECK(!time_rtc_restore(&st, 69 * SEC, &unix_us));
+
+    // The RC timer runs fast: it counted 1000 s while 980 s passed, so the clock was
+    // restored 20 s ahead (offset -20 s). Learning that corrects the next sleep.
+    time_rtc_save(&st, T0, 0, 0, true);
+    CHECK(time_rtc_restore(&st, 1000 * SEC, &unix_us) && unix_us == T0 + 1000 * SEC);
+    time_rtc_learn(&st, 1000 * SEC, -20 * SEC);
+    CHECK(st.rtc_drift_ppb == 20000000);
+    CHECK(time_rtc_restore(&st, 1000 * SEC, &unix_us) && unix_us == T0 + 980 * SEC);
+    // A day-long sleep at that rate.
+    CHECK(time_rtc_restore(&st, 100000 * SEC, &unix_us) && unix_us == T0 + 98000 * SEC);
+
+    // The next wake finds a residual 10 ms behind over 1000 s: the estimate moves by
+    // that much (-10 ppm), it is not replaced.
+    time_rtc_learn(&st, 1000 * SEC, 10000);
+    CHECK(st.rtc_drift_ppb == 20000000 - 10000);
+
+    // Too short a sleep to tell drift from the offset's own noise: ignored.
+    time_rtc_learn(&st, 30 * SEC, 5 * SEC);
+    CHECK(st.rtc_drift_ppb == 20000000 - 10000);
+
+    // A nonsensical offset is clamped to what an RC oscillator can be off by.
+    time_rtc_learn(&st, 100 * SEC, -50 * SEC);
+    CHECK(st.rtc_drift_ppb == 50000000);
+
+    printf("PASS time_rtc rtc_drift_ppb=%d\n", st.rtc_drift_ppb);
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Checks the NTP clock discipline: the slew/step choice, the drift estimate and the
+// resync interval policy on synthetic samples, then the time service end to end
+// against stand-in servers, whose time the device clock drifts away from.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "config.h"
+#include "esp_timer.h"
+#include "host_sim.h"
+#include "test_util.h"
+#include "time_discipline.h"
+#include "time_service.h"
+
+#define SEC 1000000LL
+
+static volatile uint32_t s_callbacks = 0;
+
+static void on_sync(void *ctx)
+{
+    (void)ctx;
+    s_callbacks++;
+}
+
+static time_service_stats_t stats(void)
+{
+    time_service_stats_t st;
+    CHECK(time_service_get_stats(&st) == ESP_OK);
+    return st;
+}
+
+static void check_policy(void)
+{
+    time_discipline_t d;
+    time_discipline_init(&d);
+    CHECK(d.interval_s == TIME_SYNC_INTERVAL_MIN_SEC && time_discipline_last(&d) == NULL);
+
+    // An unset clock is stepped, however small the offset looks.
+    CHECK(time_discipline_add(&d, 0, 100, TIME_RTT_UNKNOWN, false) == TIME_CORRECTION_STEP);
+    CHECK(!time_discipline_last(&d)->has_drift && !d.drift_stable);
+
+    // 20 ppm fast: 20 us behind the server after each second. Steady after three
+    // intervals, then the interval doubles up to the cap.
+    for (int i = 1; i <= 3; i++) {
+        CHECK(time_discipline_add(&d, i * SEC, -20, TIME_RTT_UNKNOWN, true) == TIME_CORRECTION_SLEW);
+        CHECK(time_discipline_last(&d)->drift_ppb == 20000);
+        CHECK(d.drift_stable == (i == 3));
+    }
+    CHECK(d.drift_ppb == 20000 && d.interval_s == 2);
+    time_discipline_add(&d, 5 * SEC, -40, TIME_RTT_UNKNOWN, true);
+    CHECK(d.drift_stable && d.interval_s == TIME_SYNC_INTERVAL_MAX_SEC);
+
+    // A late reply: the median ignores it but the spread says the drift is not settled.
+    time_discipline_add(&d, 6 * SEC, -(20 + 2 * TIME_DRIFT_STABLE_PPM), TIME_RTT_UNKNOWN, true);
+    CHECK(d.drift_ppb == 20000 && !d.drift_stable && d.interval_s == 1);
+
+    // Past TIME_SLEW_MAX_MS the clock is stepped and the interval drops to the minimum.
+    CHECK(time_discipline_add(&d, 7 * SEC, -(TIME_SLEW_MAX_MS + 1) * 1000LL, TIME_RTT_UNKNOWN, true) ==
+          TIME_CORRECTION_STEP);
+    CHECK(!time_discipline_last(&d)->has_drift && d.interval_s == TIME_SYNC_INTERVAL_MIN_SEC);
+    CHECK(time_discipline_add(&d, 8 * SEC, (TIME_SLEW_MAX_MS - 1) * 1000LL, TIME_RTT_UNKNOWN, true) ==
+          TIME_CORRECTION_SLEW);
+
+    // The history is a ring of the most recent samples.
+    for (int i = 9; i < 30; i++) {
+        time_discipline_add(&d, i * SEC, -20, 1500, true);
+    }
+    CHECK(d.count == TIME_DISCIPLINE_SAMPLES && time_discipline_last(&d)->uptime_us == 29 * SEC);
+    CHECK(time_discipline_last(&d)->rtt_us == 1500 && d.drift_ppb == 20000 && d.drift_stable);
+
+    // A crystal that keeps time perfectly goes straight to the cap.
+    time_discipline_init(&d);
+    for (int i = 0; i <= 3; i++) {
+        time_discipline_add(&d, i * SEC, 0, TIME_RTT_UNKNOWN, true);
+    }
+    CHECK(d.drift_stable && d.drift_ppb == 0 && d.interval_s == 2);
+
+    // One so bad it drifts TIME_SYNC_MAX_ERROR_MS in a second stays at a second.
+    time_discipline_init(&d);
+    for (int i = 0; i <= 5; i++) {
+        time_discipline_add(&d, i * SEC, -TIME_SYNC_MAX_ERROR_MS * 1000LL, TIME_RTT_UNKNOWN, true);
+    }
+    CHECK(d.drift_stable && d.drift_ppb == TIME_SYNC_MAX_ERROR_MS * 1000000 && d.interval_s == 1);
+
+    // Failed rounds: on an unset clock the retry starts short and backs off to the
+    // minimum interval; a set clock waits the minimum straight away.
+    time_discipline_init(&d);
+    const uint32_t first = TIME_SYNC_RETRY_FIRST_SEC < TIME_SYNC_INTERVAL_MIN_SEC ? TIME_SYNC_RETRY_FIRST_SEC
+                                                                                  : TIME_SYNC_INTERVAL_MIN_SEC;
+    uint32_t expect = TIME_SYNC_RETRY_FIRST_SEC;
+    for (int i = 0; i < 12; i++) {
+        CHECK(time_discipline_failed(&d, false) == (expect < TIME_SYNC_INTERVAL_MIN_SEC ? expect
+                                                                                       : TIME_SYNC_INTERVAL_MIN_SEC));
+        expect *= 2;
+    }
+    CHECK(time_discipline_failed(&d, true) == TIME_SYNC_INTERVAL_MIN_SEC);
+    time_discipline_add(&d, 0, 0, TIME_RTT_UNKNOWN, false);
+    CHECK(d.retry_s == 0 && time_discipline_failed(&d, false) == first);
+}
+
+static bool wait_for(bool (*cond)(const time_service_stats_t *), uint32_t timeout_ms)
+{
+    for (uint32_t waited = 0; waited < timeout_ms; waited += 20) {
+        const time_service_stats_t st = stats();
+        if (cond(&st)) {
+            return true;
+        }
+        sleep_ms(20);
+    }
+    return false;
+}
+
+static bool settled(const time_service_stats_t *st)
+{
+    return st->drift_stable && st->interval_s == TIME_SYNC_INTERVAL_MAX_SEC;
+}
+
+static bool unsettled(const time_service_stats_t *st)
+{
+    return !st->drift_stable && st->interval_s == TIME_SYNC_INTERVAL_MIN_SEC;
+}
+
+int main(void)
+{
+    check_policy();
+
+    // True time is 200 ms ahead and the device runs 2000 ppm fast. Of three servers the
+    // one without delays is used; the one 3 s off is outvoted.
+    host_ntp_set_clock(200000, 2000000);
+    const host_ntp_server_config_t slow = {.request_delay_ms = 2, .reply_delay_ms = 2};
+    const host_ntp_server_config_t fast = {0};
+    const host_ntp_server_config_t wrong = {.error_us = 3 * SEC};
+    CHECK(host_ntp_server_add("slow.test", &slow) && host_ntp_server_add("fast.test", &fast) &&
+          host_ntp_server_add("wrong.test", &wrong));
+    static const char *const servers[] = {"slow.test", "fast.test", "wrong.test"};
+
+    time_service_config_t cfg = {.servers = servers, .server_count = 0, .sync_cb = on_sync};
+    CHECK(time_service_init(&cfg) == ESP_ERR_INVALID_ARG);
+    cfg.server_count = TIME_SERVER_MAX + 1;
+    CHECK(time_service_init(&cfg) == ESP_ERR_INVALID_ARG);
+    cfg.server_count = 3;
+    CHECK(time_service_init(&cfg) == ESP_OK);
+    sleep_ms(100); // Nothing is sent before the network is up
+    host_ntp_stats_t server;
+    host_ntp_get_stats(&server);
+    CHECK(server.requests == 0);
+    CHECK(stats().syncs == 0 && stats().next_sync_us == -1 && stats().last_rtt_us == TIME_RTT_UNKNOWN);
+    CHECK(time_service_start() == ESP_OK);
+
+    CHECK(wait_for(settled, 10000));
+    time_service_stats_t st = stats();
+    CHECK(st.syncs >= 4 && st.syncs == s_callbacks && st.failed == 0);
+    CHECK(st.last_server == 1 && st.last_answered == 3 && st.last_falsetickers == 1);
+    CHECK(st.last_rtt_us >= 0 && st.last_rtt_us < 2000);
+    // The host clock is already set, so even the first 200 ms are slewed.
+    CHECK(st.steps == 0 && st.slews == st.syncs);
+    CHECK(st.drift_ppb > 1800000 && st.drift_ppb < 2200000);
+    CHECK(st.last_offset_us < 0);
+    CHECK(st.next_sync_us > esp_timer_get_time());
+    host_ntp_get_stats(&server);
+    CHECK(server.requests >= 3 * st.syncs);
+    CHECK(server.slews == st.slews && server.steps == 0);
+    CHECK(server.corrected_us > 200000 - 30000 && server.corrected_us < 200000);
+
+    // The drift changes (the room warms up): back to syncing every second.
+    host_ntp_set_clock(0, 6000000);
+    CHECK(wait_for(unsettled, 5000));
+
+    printf("PASS time_service syncs=%u drift_ppb=%d rtt_us=%d corrected_us=%lld\n", st.syncs, st.drift_ppb,
+           st.last_rtt_us, (long long)server.corrected_us);
+    return 0;
+}
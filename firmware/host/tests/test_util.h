@@ -0,0 +1,74 @@
+#pragma once
+
+// Shared by the host tests and harnesses: CHECK, which fails the run with the source
+// line, a millisecond sleep, and a count of update callbacks that tests wait on. The
+// callbacks run on a service's own task, so whatever a test records with an update
+// is written under test_lock() together with the count.
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define CHECK(cond)                                                                      \
+    do {                                                                                 \
+        if (!(cond)) {                                                                   \
+            fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);    \
+            exit(1);                                                                     \
+        }                                                                                \
+    } while (0)
+
+static pthread_mutex_t s_test_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t s_test_updates = 0; // Guarded by s_test_lock
+
+static inline void sleep_ms(uint32_t ms)
+{
+    struct timespec ts = {.tv_sec = ms / 1000, .tv_nsec = (long)(ms % 1000) * 1000000L};
+    nanosleep(&ts, NULL);
+}
+
+static inline void test_lock(void)
+{
+    pthread_mutex_lock(&s_test_lock);
+}
+
+static inline void test_unlock(void)
+{
+    pthread_mutex_unlock(&s_test_lock);
+}
+
+/** Counts one update; call under test_lock(), after recording what it carried. */
+static inline void test_update_counted(void)
+{
+    s_test_updates++;
+}
+
+static inline uint32_t test_updates(void)
+{
+    test_lock();
+    const uint32_t n = s_test_updates;
+    test_unlock();
+    return n;
+}
+
+/** Waits until n updates have been counted; false if that takes over timeout_ms. */
+static inline bool test_wait_updates(uint32_t n, uint32_t timeout_ms)
+{
+    for (uint32_t waited = 0; waited < timeout_ms; waited++) {
+        if (test_updates() >= n) {
+            return true;
+        }
+        sleep_ms(1);
+    }
+    return test_updates() >= n;
+}
+
+/** Calls request() (e.g. weather_service_request_update) and waits for the update it brings. */
+static inline bool test_request_and_wait(void (*request)(void), uint32_t timeout_ms)
+{
+    const uint32_t want = test_updates() + 1;
+    request();
+    return test_wait_updates(want, timeout_ms);
+}
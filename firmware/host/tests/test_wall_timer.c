@@ -0,0 +1,136 @@
+// Checks the wall-clock timer against a device clock the test can move
+// (gettimeofday() is wrapped): runs land just past each boundary, a minute timer
+// wakes once per minute, an early run caused by a slewed clock waits out the
+// remainder without a callback, and a resync after a step redraws at once and
+// re-arms from the new time.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/time.h>
+#include <time.h>
+
+#include "esp_timer.h"
+#include "local_time.h"
+#include "lvgl.h"
+#include "lvgl_port.h"
+#include "test_util.h"
+#include "wall_timer.h"
+
+#define SEC 1000000LL
+
+// The device clock: the host's plus this.
+static int64_t s_clock_offset_us = 0;
+
+int __real_gettimeofday(struct timeval *tv, void *tz);
+int __wrap_gettimeofday(struct timeval *tv, void *tz)
+{
+    struct timeval real;
+    __real_gettimeofday(&real, tz);
+    const int64_t us = (int64_t)real.tv_sec * SEC + real.tv_usec + s_clock_offset_us;
+    tv->tv_sec = (time_t)(us / SEC);
+    tv->tv_usec = (suseconds_t)(us % SEC);
+    return 0;
+}
+
+static int64_t clock_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * SEC + tv.tv_usec;
+}
+
+// Moves the device clock so that it reads `before_us` short of a multiple of unit_s.
+static void clock_before_boundary(uint32_t unit_s, int64_t before_us)
+{
+    const int64_t unit_us = (int64_t)unit_s * SEC;
+    const int64_t now = clock_us();
+    s_clock_offset_us += (now / unit_us + 2) * unit_us - before_us - now;
+}
+
+// The UI task's loop: run due timers, sleep until the next.
+static void run_for_ms(uint32_t ms)
+{
+    const int64_t end = esp_timer_get_time() + (int64_t)ms * 1000;
+    for (int64_t now = esp_timer_get_time(); now < end; now = esp_timer_get_time()) {
+        uint32_t next = lv_timer_handler();
+        const uint32_t left = (uint32_t)((end - now + 999) / 1000);
+        sleep_ms(next < left ? next : left);
+    }
+}
+
+static uint32_t s_calls = 0;
+static local_time_t s_last;
+
+static void on_boundary(const local_time_t *now, void *ctx)
+{
+    (void)ctx;
+    s_calls++;
+    s_last = *now;
+}
+
+int main(void)
+{
+    // The next boundary, plus the slack for truncated ticks.
+    CHECK(wall_timer_delay_ms(0, 60) == 60001);
+    CHECK(wall_timer_delay_ms(59 * SEC + 999500, 60) == 2);
+    CHECK(wall_timer_delay_ms(-1, 1) == 2);
+    CHECK(wall_timer_delay_ms(-SEC, 60) == 1001);
+
+    CHECK(lvgl_port_init() == ESP_OK);
+    CHECK(local_time_init("<+0530>-5:30") == ESP_OK);
+
+    wall_timer_t t;
+    CHECK(wall_timer_start(&t, 7, on_boundary, NULL) == ESP_ERR_INVALID_ARG); // Does not divide a day
+
+    // Seconds: called at start, then once per boundary, each just after it.
+    clock_before_boundary(1, 200000);
+    CHECK(wall_timer_start(&t, 1, on_boundary, NULL) == ESP_OK);
+    CHECK(s_calls == 1 && t.stats.runs == 1);
+    run_for_ms(2500); // Boundaries 0.2, 1.2 and 2.2 s in
+    CHECK(s_calls == 4 && t.stats.changes == 4);
+    CHECK(t.stats.runs <= 5);
+    CHECK(t.stats.late_max_ms <= 20);
+    lv_timer_del(t.timer);
+
+    // Minutes, in a zone half an hour off UTC: one run per minute boundary of local
+    // time, none in between.
+    s_calls = 0;
+    clock_before_boundary(60, 300000);
+    CHECK(wall_timer_start(&t, 60, on_boundary, NULL) == ESP_OK);
+    const uint8_t minute = s_last.minute;
+    CHECK(s_last.second == 59);
+    run_for_ms(1000);
+    CHECK(s_calls == 2 && t.stats.runs == 2 && s_last.second == 0 && s_last.minute == (minute + 1) % 60);
+    CHECK(t.stats.late_max_ms <= 20);
+    CHECK(t.timer->period_ms >= 59000 && t.timer->period_ms <= 60001);
+
+    // Stepped forward 90 s: the resync redraws on the next pass instead of up to a
+    // minute later, and the next run is at the new time's boundary.
+    s_clock_offset_us += 90 * SEC;
+    wall_timer_resync(&t);
+    lv_timer_handler();
+    CHECK(s_calls == 3 && s_last.minute == (minute + 2) % 60 && s_last.second >= 30);
+    CHECK(t.timer->period_ms >= 29000 && t.timer->period_ms <= 30500);
+    CHECK(t.stats.resyncs == 1);
+    const uint32_t late_max = t.stats.late_max_ms;
+
+    // Stepped back a little within the minute: nothing visible changed, no callback.
+    s_clock_offset_us -= 5 * SEC;
+    wall_timer_resync(&t);
+    lv_timer_handler();
+    CHECK(s_calls == 3 && t.stats.runs == 4 && t.stats.late_max_ms == late_max);
+
+    // The clock fell 40 ms behind the tick while armed (a slew): the run comes early,
+    // finds the same minute and waits out the rest, then draws just after it.
+    clock_before_boundary(60, 300000);
+    wall_timer_resync(&t);
+    lv_timer_handler();
+    const uint32_t calls = s_calls;
+    const uint32_t runs = t.stats.runs;
+    s_clock_offset_us -= 40000;
+    run_for_ms(1000);
+    CHECK(s_calls == calls + 1 && t.stats.runs == runs + 2 && s_last.second == 0);
+
+    printf("PASS wall_timer runs=%u changes=%u late_max_ms=%u\n", t.stats.runs, t.stats.changes, t.stats.late_max_ms);
+    return 0;
+}
@@ -0,0 +1,165 @@
+// Checks the persistent weather cache: a stored result is shown by
+// weather_service_init() before any request, refreshes are conditional and a 304
+// keeps the cached data without parsing, fresh data answers refreshes without a
+// request, and a failed refresh falls back to the cache marked stale.
+// Built with WEATHER_CACHE_MAX_AGE_SEC=2 so the test does not wait minutes.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "host_sim.h"
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "test_util.h"
+#include "weather_cache.h"
+#include "weather_service.h"
+
+static weather_data_t s_last;
+
+static void on_update(const weather_data_t *data, void *ctx)
+{
+    (void)ctx;
+    test_lock();
+    s_last = *data;
+    test_update_counted();
+    test_unlock();
+}
+
+// The update count, and the last update when last is not NULL.
+static uint32_t updates(weather_data_t *last)
+{
+    test_lock();
+    if (last) {
+        *last = s_last;
+    }
+    test_unlock();
+    return test_updates();
+}
+
+// Requests a refresh and waits until the worker is idle again.
+static void refresh(weather_service_stats_t *st)
+{
+    weather_service_stats_t before;
+    CHECK(weather_service_get_stats(&before) == ESP_OK);
+    weather_service_request_update();
+    for (int i = 0; i < 500; i++) {
+        CHECK(weather_service_get_stats(st) == ESP_OK);
+        if (st->fetches + st->cache_hits > before.fetches + before.cache_hits) {
+            sleep_ms(5); // Let the update callback run
+            return;
+        }
+        sleep_ms(5);
+    }
+    CHECK(!"refresh timed out");
+}
+
+static void check_cache_layout(void)
+{
+    weather_cache_entry_t e = {0};
+    CHECK(weather_cache_load(0, &e) == ESP_ERR_NOT_FOUND);
+
+    // A blob from another layout is ignored.
+    nvs_handle_t h;
+    CHECK(nvs_open("weather", NVS_READWRITE, &h) == ESP_OK);
+    const char junk[16] = "old layout";
+    CHECK(nvs_set_blob(h, "cache0", junk, sizeof(junk)) == ESP_OK);
+    nvs_close(h);
+    CHECK(weather_cache_load(0, &e) == ESP_ERR_NOT_FOUND);
+
+    // An unset clock gives an unknown age rather than a bogus one.
+    e.data.updated_at = 0;
+    CHECK(weather_cache_age(&e, time(NULL)) == -1);
+    e.data.updated_at = time(NULL) - 60;
+    CHECK(weather_cache_age(&e, 1000) == -1);
+    CHECK(weather_cache_age(&e, time(NULL)) >= 60);
+}
+
+int main(void)
+{
+    CHECK(nvs_flash_init() == ESP_OK);
+    check_cache_layout();
+
+    // What a previous boot stored: half an hour old, past max-age but showable.
+    weather_cache_entry_t seed = {0};
+    seed.lat_e4 = WEATHER_COORD_E4(WEATHER_LAT);
+    seed.lon_e4 = WEATHER_COORD_E4(WEATHER_LON);
+    seed.data.temp_f10 = 550;
+    seed.data.weather_code = 1;
+    snprintf(seed.data.condition, sizeof(seed.data.condition), "Mostly Clear");
+    seed.data.sunrise = 7 * 60 + 1;
+    seed.data.sunset = 18 * 60 + 2;
+    seed.data.updated_at = time(NULL) - 1800;
+    snprintf(seed.etag, sizeof(seed.etag), "\"v1\"");
+    CHECK(weather_cache_store(0, &seed) == ESP_OK);
+
+    host_http_fixture_t fixture = {.chunk_size = 512, .etag = "\"v1\""};
+    host_http_set_fixture(&fixture);
+
+    // Shown at init, marked stale, before any request.
+    weather_data_t last;
+    weather_service_config_t cfg = {.update_cb = on_update};
+    CHECK(weather_service_init(&cfg) == ESP_OK);
+    CHECK(updates(&last) == 1);
+    CHECK(last.stale);
+    CHECK(last.temp_f10 == 550);
+    CHECK(strcmp(last.condition, "Mostly Clear") == 0);
+    // Sun times are today's, computed on the device, not the ones stored back then.
+    solar_day_t sun;
+    CHECK(weather_service_get_sun(0, &sun));
+    CHECK(last.sunset == sun.sunset && last.sunset != 18 * 60 + 2);
+
+    // Revalidation: 304, cached data delivered again as current and re-stamped.
+    weather_service_stats_t st;
+    host_http_stats_t http;
+    refresh(&st);
+    host_http_get_stats(&http);
+    CHECK(http.conditional == 1);
+    CHECK(http.not_modified == 1);
+    CHECK(st.not_modified == 1);
+    CHECK(updates(&last) == 2);
+    CHECK(!last.stale);
+    CHECK(last.temp_f10 == 550);
+    weather_cache_entry_t stored;
+    CHECK(weather_cache_load(0, &stored) == ESP_OK);
+    CHECK(weather_cache_age(&stored, time(NULL)) <= 1);
+
+    // Fresh: answered from the cache, nothing sent, nothing redrawn.
+    refresh(&st);
+    host_http_get_stats(&http);
+    CHECK(st.cache_hits == 1);
+    CHECK(http.requests == 1);
+    CHECK(updates(NULL) == 2);
+
+    // Past max-age with a new version on the server: full 200, new validator kept.
+    sleep_ms(2100);
+    fixture.etag = "\"v2\"";
+    host_http_set_fixture(&fixture);
+    refresh(&st);
+    host_http_get_stats(&http);
+    CHECK(http.requests == 2);
+    CHECK(http.not_modified == 1);
+    CHECK(updates(&last) == 3);
+    CHECK(!last.stale);
+    CHECK(last.temp_f10 == 413); // The built-in sample body
+    CHECK(weather_cache_load(0, &stored) == ESP_OK);
+    CHECK(strcmp(stored.etag, "\"v2\"") == 0);
+    CHECK(stored.data.temp_f10 == last.temp_f10);
+
+    // Server error past max-age: the cached result is shown, marked stale.
+    sleep_ms(2100);
+    fixture.status_code = 500;
+    host_http_set_fixture(&fixture);
+    refresh(&st);
+    CHECK(st.failures == 1);
+    CHECK(st.served_stale == 1);
+    CHECK(updates(&last) == 4);
+    CHECK(last.stale);
+    CHECK(strcmp(last.condition, "Overcast") == 0);
+
+    printf("PASS weather_cache fetches=%u not_modified=%u cache_hits=%u served_stale=%u\n", st.fetches,
+           st.not_modified, st.cache_hits, st.served_stale);
+    return 0;
+}
@@ -0,0 +1,87 @@
+// Checks that weather fetches share one HTTPS client: back-to-back fetches reuse the
+// open connection without a handshake, and once the stand-in server has dropped the
+// idle connection the next fetch reconnects with a resumed TLS session, which is
+// cheaper than the first full handshake. Built with WEATHER_CACHE_MAX_AGE_SEC=0 so
+// every request goes to the network.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "host_sim.h"
+#include "test_util.h"
+#include "weather_service.h"
+
+#define HANDSHAKE_MS 120
+#define RESUME_MS 20
+#define IDLE_CLOSE_MS 150
+
+static bool s_offline = false;
+
+static void on_update(const weather_data_t *data, void *ctx)
+{
+    (void)ctx;
+    test_lock();
+    s_offline |= strcmp(data->condition, "Offline") == 0;
+    test_update_counted();
+    test_unlock();
+}
+
+static void fetch_once(void)
+{
+    CHECK(test_request_and_wait(weather_service_request_update, 2500));
+}
+
+int main(void)
+{
+    host_http_fixture_t fixture = {
+        .chunk_size = 512,
+        .tls_handshake_ms = HANDSHAKE_MS,
+        .tls_resume_ms = RESUME_MS,
+        .idle_close_ms = IDLE_CLOSE_MS,
+    };
+    host_http_set_fixture(&fixture);
+    weather_service_config_t cfg = {.update_cb = on_update};
+    CHECK(weather_service_init(&cfg) == ESP_OK);
+
+    weather_service_stats_t st;
+    host_http_stats_t http;
+
+    // First fetch: full handshake.
+    fetch_once();
+    CHECK(weather_service_get_stats(&st) == ESP_OK);
+    CHECK(st.handshakes == 1);
+    CHECK(st.reused == 0);
+    CHECK(st.last_handshake_us >= HANDSHAKE_MS * 1000);
+    const uint32_t full_us = st.last_handshake_us;
+
+    // Within the idle window: same connection, no handshake.
+    fetch_once();
+    fetch_once();
+    CHECK(weather_service_get_stats(&st) == ESP_OK);
+    CHECK(st.handshakes == 1);
+    CHECK(st.reused == 2);
+    CHECK(st.reconnects == 0);
+
+    // The server drops the idle connection; the next fetch notices and resumes.
+    sleep_ms(IDLE_CLOSE_MS * 2);
+    fetch_once();
+    CHECK(weather_service_get_stats(&st) == ESP_OK);
+    CHECK(st.handshakes == 2);
+    CHECK(st.reconnects == 1);
+    CHECK(st.last_handshake_us >= RESUME_MS * 1000);
+    CHECK(st.last_handshake_us < full_us);
+    CHECK(st.failures == 0);
+
+    host_http_get_stats(&http);
+    CHECK(http.handshakes == 2);
+    CHECK(http.resumed == 1);
+    CHECK(http.dropped == 1);
+    CHECK(http.requests == 5); // Four fetches plus the request that found the socket closed
+    CHECK(!s_offline);
+
+    printf("PASS weather_connection fetches=%u handshakes=%u resumed=%u full_us=%u resumed_us=%u\n", st.fetches,
+           st.handshakes, http.resumed, full_us, st.last_handshake_us);
+    return 0;
+}
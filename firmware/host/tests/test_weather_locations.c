@@ -0,0 +1,102 @@
+// Checks several weather locations fetched together: one request with the
+// coordinates comma-joined, one update per location routed by index, a cache slot
+// per location, sun times computed per location, and a cache stored for another
+// location list ignored.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "forecast_fixture.h"
+#include "host_sim.h"
+#include "nvs_flash.h"
+#include "test_util.h"
+#include "weather_cache.h"
+#include "weather_service.h"
+
+static const weather_location_t k_locations[] = {
+    WEATHER_LOCATION(38.6820, -84.5894, "Dry Ridge"),
+    WEATHER_LOCATION(51.5074, -0.1278, "London"),
+    WEATHER_LOCATION(-33.8688, 151.2093, "Sydney"),
+};
+#define LOCATIONS (sizeof(k_locations) / sizeof(k_locations[0]))
+
+static weather_data_t s_last[WEATHER_MAX_LOCATIONS];
+
+static void on_update(const weather_data_t *data, void *ctx)
+{
+    (void)ctx;
+    test_lock();
+    if (data->location < WEATHER_MAX_LOCATIONS) {
+        s_last[data->location] = *data;
+    }
+    test_update_counted();
+    test_unlock();
+}
+
+int main(void)
+{
+    CHECK(nvs_flash_init() == ESP_OK);
+
+    // A cache from when only the default location was configured.
+    weather_cache_entry_t seed = {0};
+    seed.lat_e4 = WEATHER_COORD_E4(WEATHER_LAT);
+    seed.lon_e4 = WEATHER_COORD_E4(WEATHER_LON);
+    seed.data.temp_f10 = 550;
+    seed.data.updated_at = time(NULL) - 60;
+    CHECK(weather_cache_store(0, &seed) == ESP_OK);
+    seed.lat_e4 = 0;
+    CHECK(weather_cache_store(1, &seed) == ESP_OK);
+
+    size_t body_len;
+    char *body = fixture_forecast_locations(LOCATIONS, &body_len);
+    host_http_fixture_t fixture = {.body = body, .body_len = body_len, .chunk_size = 512};
+    host_http_set_fixture(&fixture);
+
+    // The old cache does not match the new list, so nothing is shown from it.
+    weather_service_config_t cfg = {.update_cb = on_update, .locations = k_locations, .location_count = LOCATIONS};
+    CHECK(weather_service_init(&cfg) == ESP_OK);
+    CHECK(test_updates() == 0);
+    CHECK(weather_service_location_count() == LOCATIONS);
+    CHECK(strcmp(weather_service_get_location(2)->name, "Sydney") == 0);
+    CHECK(weather_service_get_location(LOCATIONS) == NULL);
+
+    // One request covers every location.
+    weather_service_request_update();
+    CHECK(test_wait_updates(LOCATIONS, 2500));
+    CHECK(test_updates() == LOCATIONS);
+    host_http_stats_t http;
+    host_http_get_stats(&http);
+    CHECK(http.requests == 1);
+    char url[512];
+    host_http_get_last_url(url, sizeof(url));
+    CHECK(strstr(url, "latitude=38.6820,51.5074,-33.8688&longitude=-84.5894,-0.1278,151.2093"));
+    CHECK(!strstr(url, "sunrise")); // Computed on the device
+
+    for (size_t i = 0; i < LOCATIONS; i++) {
+        test_lock();
+        const weather_data_t d = s_last[i];
+        test_unlock();
+        CHECK(d.location == i && !d.stale);
+        CHECK(d.temp_f10 == 413 + 100 * (int)i);
+
+        weather_cache_entry_t stored;
+        CHECK(weather_cache_load(i, &stored) == ESP_OK);
+        CHECK(stored.lat_e4 == k_locations[i].lat_e4 && stored.lon_e4 == k_locations[i].lon_e4);
+        CHECK(stored.data.temp_f10 == d.temp_f10);
+        CHECK(stored.data.high_f10 == 446 + 100 * (int)i);
+
+        // Sun times in the zone each location's forecast reported.
+        solar_day_t sun;
+        CHECK(weather_service_get_sun(i, &sun));
+        CHECK(d.sunrise == sun.sunrise && d.sunset == sun.sunset && sun.sunrise != FORECAST_MINUTE_NONE);
+    }
+    forecast_day_t day;
+    CHECK(!weather_service_get_day(LOCATIONS, 0, &day));
+    free(body);
+
+    printf("PASS weather_locations locations=%zu requests=%u\n", LOCATIONS, http.requests);
+    return 0;
+}
@@ -0,0 +1,154 @@
+// Checks the streaming Open-Meteo parser: identical results for every way the body
+// can be split into HTTP_EVENT_ON_DATA pieces, bodies far larger than the old 4 KB
+// buffer, escapes and whitespace, and the error paths.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "forecast_fixture.h"
+#include "json_stream.h"
+#include "test_util.h"
+#include "weather_parser.h"
+
+static esp_err_t parse_chunked(const char *body, size_t len, size_t chunk, weather_data_t *out)
+{
+    weather_parser_t p;
+    weather_parser_init(&p, out);
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t n = len - off < chunk ? len - off : chunk;
+        weather_parser_feed(&p, body + off, n);
+    }
+    return weather_parser_finish(&p);
+}
+
+static void check_day(const weather_data_t *d)
+{
+    CHECK(d->temp_f10 == 413);
+    CHECK(d->feels_like_f10 == 358);
+    CHECK(d->weather_code == 3);
+    CHECK(d->high_f10 == 446);
+    CHECK(d->low_f10 == 291);
+    // The fixtures still carry daily sunrise/sunset; they are not requested any more
+    // (solar.c computes them) and are skipped.
+    CHECK(d->sunrise == FORECAST_MINUTE_NONE);
+    CHECK(d->sunset == FORECAST_MINUTE_NONE);
+}
+
+typedef struct {
+    char log[512];
+} event_log_t;
+
+static void log_event(json_stream_t *s, const json_event_t *ev, void *ctx)
+{
+    static const char *names[] = {"{", "}", "[", "]", "s", "n", "l"};
+    event_log_t *log = ctx;
+    size_t len = strlen(log->log);
+    snprintf(log->log + len, sizeof(log->log) - len, "%s%u%s%s%s%s ", names[ev->type], ev->depth,
+             ev->key ? ":" : "", ev->key ? ev->key : "", ev->value ? "=" : "", ev->value ? ev->value : "");
+    (void)s;
+}
+
+int main(void)
+{
+    weather_data_t d;
+    const size_t day_len = sizeof(k_forecast_day) - 1;
+
+    // Every chunk size, down to one byte per event.
+    for (size_t chunk = 1; chunk <= day_len; chunk++) {
+        CHECK(parse_chunked(k_forecast_day, day_len, chunk, &d) == ESP_OK);
+        check_day(&d);
+    }
+
+    // The model-update interval the refresh scheduler aligns to.
+    weather_parser_t p;
+    weather_parser_init(&p, &d);
+    weather_parser_feed(&p, k_forecast_day, day_len);
+    CHECK(weather_parser_finish(&p) == ESP_OK);
+    CHECK(p.interval_s == 900);
+
+    // Several locations in one body: an array of location objects, routed by index.
+    size_t multi_len;
+    char *multi = fixture_forecast_locations(3, &multi_len);
+    for (size_t chunk = 1; chunk <= multi_len; chunk += 97) {
+        weather_data_t m[3];
+        forecast_store_t f[3];
+        weather_parser_init_locations(&p, m, 3);
+        weather_parser_set_forecast(&p, f);
+        for (size_t off = 0; off < multi_len; off += chunk) {
+            weather_parser_feed(&p, multi + off, multi_len - off < chunk ? multi_len - off : chunk);
+        }
+        CHECK(weather_parser_finish(&p) == ESP_OK);
+        for (int i = 0; i < 3; i++) {
+            CHECK(m[i].location == i);
+            CHECK(m[i].temp_f10 == 413 + 100 * i);
+            CHECK(m[i].high_f10 == 446 + 100 * i);
+            CHECK(m[i].low_f10 == 291);
+            CHECK(f[i].utc_offset_s == -18000 && f[i].days == 1);
+            CHECK(f[i].day_max[forecast_day_slot(f[i].first_day)] == m[i].high_f10);
+        }
+    }
+    // Fewer locations than asked for, or a single object, is missing data.
+    free(multi);
+    weather_data_t m[3];
+    multi = fixture_forecast_locations(2, &multi_len);
+    weather_parser_init_locations(&p, m, 3);
+    weather_parser_feed(&p, multi, multi_len);
+    CHECK(weather_parser_finish(&p) == ESP_ERR_NOT_FOUND);
+    free(multi);
+    weather_parser_init_locations(&p, m, 2);
+    weather_parser_feed(&p, k_forecast_day, day_len);
+    CHECK(weather_parser_finish(&p) == ESP_ERR_NOT_FOUND);
+
+    // 7-day hourly body, pretty-printed and larger than the old 4 KB buffer.
+    size_t week_len;
+    char *week = fixture_forecast_week(&week_len);
+    CHECK(week_len > 4096);
+    CHECK(parse_chunked(week, week_len, 512, &d) == ESP_OK);
+    check_day(&d);
+    CHECK(parse_chunked(week, week_len, 3, &d) == ESP_OK);
+    check_day(&d);
+
+    // Truncated and malformed bodies are reported, not half-parsed silently.
+    CHECK(parse_chunked(week, week_len / 2, 512, &d) == ESP_ERR_INVALID_SIZE);
+    free(week);
+    CHECK(parse_chunked("{\"current\":{\"temperature_2m\":41.3,}}", 36, 8, &d) == ESP_ERR_INVALID_RESPONSE);
+    CHECK(parse_chunked("{\"current\":[1,2}", 16, 8, &d) == ESP_ERR_INVALID_RESPONSE);
+    CHECK(parse_chunked("{} x", 4, 8, &d) == ESP_ERR_INVALID_RESPONSE);
+    const char *no_current = "{\"daily\":{\"temperature_2m_max\":[44.6]}}";
+    CHECK(parse_chunked(no_current, strlen(no_current), 5, &d) == ESP_ERR_NOT_FOUND);
+    CHECK(d.high_f10 == 446);
+
+    // Temperatures are int16 tenths: the extremes parse, anything past them, rounding
+    // included, is rejected rather than wrapped.
+    static const struct {
+        const char *value;
+        int16_t tenths;
+    } k_deci[] = {{"3276.7", 32767}, {"-3276.7", -32767}, {"3276.74", 32767},
+                  {"3276.75", 0},    {"3276.8", 0},       {"3277", 0},
+                  {"99999", 0},      {"-0.05", -1},       {"12", 120}};
+    for (size_t i = 0; i < sizeof(k_deci) / sizeof(k_deci[0]); i++) {
+        char body[64];
+        const int len = snprintf(body, sizeof(body), "{\"current\":{\"temperature_2m\":%s}}", k_deci[i].value);
+        parse_chunked(body, (size_t)len, 7, &d);
+        CHECK(d.temp_f10 == k_deci[i].tenths);
+    }
+
+    // Tokenizer events: depth, keys, array indices, escapes and literals.
+    event_log_t log = {0};
+    json_stream_t s;
+    json_stream_init(&s, log_event, &log);
+    const char *doc = "{\"a\\\"b\":[1,-2.5e3,\"x\\u00b0\\n\"],\"c\":{\"d\":true,\"e\":null}}";
+    for (const char *c = doc; *c; c++) {
+        CHECK(json_stream_feed(&s, c, 1) == ESP_OK);
+    }
+    CHECK(json_stream_finish(&s) == ESP_OK);
+    CHECK(strcmp(log.log, "{0 [1:a\"b n2=1 n2=-2.5e3 s2=x\xC2\xB0\n ]1:a\"b {1:c l2:d=true l2:e=null }1:c }0 ") == 0);
+
+    // Deeper nesting than the fixed state allows is an error, not an overflow.
+    json_stream_init(&s, log_event, &log);
+    CHECK(json_stream_feed(&s, "[[[[[[[[[[", 10) == ESP_ERR_INVALID_RESPONSE);
+
+    printf("PASS\n");
+    return 0;
+}
@@ -0,0 +1,158 @@
+// Checks the weather refresh schedule: the timing policy (slots aligned to the
+// provider's model updates, capped exponential backoff with jitter), then the worker
+// running it. Scheduled fetches wait for the network, pause while the display is off,
+// catch up at once on wake and on reconnect, and back off while the server fails.
+// Built with a 1 s refresh interval and 1-2 s retries so it runs in seconds.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "esp_timer.h"
+#include "forecast_fixture.h"
+#include "host_sim.h"
+#include "test_util.h"
+#include "weather_schedule.h"
+#include "weather_service.h"
+
+static const time_t k_jan4_utc = (time_t)20457 * 86400; // 2026-01-04T00:00Z
+
+static void on_update(const weather_data_t *data, void *ctx)
+{
+    (void)data;
+    (void)ctx;
+}
+
+static weather_service_stats_t stats(void)
+{
+    weather_service_stats_t st;
+    CHECK(weather_service_get_stats(&st) == ESP_OK);
+    return st;
+}
+
+// Waits for the worker to finish fetches, up to timeout_ms.
+static bool wait_fetches(uint32_t n, uint32_t timeout_ms)
+{
+    for (uint32_t waited = 0; waited < timeout_ms; waited += 10) {
+        if (stats().fetches >= n) {
+            return true;
+        }
+        sleep_ms(10);
+    }
+    return false;
+}
+
+static void check_policy(void)
+{
+    // 900 s model updates, fetched 60 s after each: at 14:30:40 the 14:31 fetch is
+    // 20 s ahead; from 14:31 on the next one is at 14:46.
+    const time_t t1430 = k_jan4_utc + 14 * 3600 + 30 * 60;
+    CHECK(weather_schedule_aligned_delay(t1430 + 40, 900, 60, 0, 0) == 20);
+    CHECK(weather_schedule_aligned_delay(t1430 + 60, 900, 60, 0, 0) == 900);
+    CHECK(weather_schedule_aligned_delay(t1430 + 120, 900, 60, 0, 0) == 840);
+    CHECK(weather_schedule_aligned_delay(t1430, 900, 0, 0, 0) == 900); // Never zero
+    // Jitter adds 0..jitter_s.
+    CHECK(weather_schedule_aligned_delay(t1430 + 120, 900, 60, 30, 31) == 840);
+    CHECK(weather_schedule_aligned_delay(t1430 + 120, 900, 60, 30, 30) == 870);
+    // An unset clock (1970) gives no alignment, just the interval.
+    CHECK(weather_schedule_aligned_delay(1234, 900, 60, 0, 0) == 900);
+
+    // Backoff doubles from WEATHER_RETRY_MIN_SEC (1 s here) to WEATHER_RETRY_MAX_SEC
+    // (2 s) and stays in the upper half.
+    CHECK(weather_schedule_backoff(0, 7) == 0);
+    CHECK(weather_schedule_backoff(1, 0) == 1);
+    CHECK(weather_schedule_backoff(2, 0) == 2);
+    CHECK(weather_schedule_backoff(2, 1) == 1);
+    CHECK(weather_schedule_backoff(100, 0) == 2);
+    for (uint32_t r = 0; r < 1000; r++) {
+        const uint32_t d = weather_schedule_backoff(3, r * 2654435761u);
+        CHECK(d >= 1 && d <= 2);
+    }
+}
+
+int main(void)
+{
+    check_policy();
+
+    // The recorded body reports 900 s model updates; this one reports 1 s.
+    static char body[sizeof(k_forecast_day)];
+    memcpy(body, k_forecast_day, sizeof(body));
+    char *interval = strstr(body, "\"interval\":900");
+    CHECK(interval);
+    memcpy(interval, "\"interval\":1  ", 14);
+    host_http_fixture_t fixture = {.body = body, .body_len = sizeof(body) - 1, .chunk_size = 512};
+    host_http_set_fixture(&fixture);
+
+    weather_service_config_t cfg = {.update_cb = on_update};
+    CHECK(weather_service_init(&cfg) == ESP_OK);
+
+    // Offline at boot: the first fetch is due, but waits for the network.
+    sleep_ms(1500);
+    weather_service_stats_t st = stats();
+    CHECK(st.fetches == 0 && st.next_fetch_us == -1);
+
+    // Connecting runs it at once, then one fetch per slot. No slot was missed, so it
+    // is neither a catch-up nor a skip.
+    weather_service_set_network(true);
+    CHECK(wait_fetches(1, 500));
+    st = stats();
+    CHECK(st.scheduled == 1 && st.catch_ups == 0 && st.paused_skips == 0 && st.failures == 0);
+    CHECK(st.next_fetch_us > esp_timer_get_time());
+    CHECK(st.next_fetch_us <= esp_timer_get_time() + 1000000);
+    CHECK(wait_fetches(3, 2500));
+    CHECK(stats().catch_ups == 0);
+
+    // Display off: no fetches, however long.
+    weather_service_set_display_on(false);
+    sleep_ms(200);
+    const uint32_t before_off = stats().fetches;
+    sleep_ms(2500);
+    st = stats();
+    CHECK(st.fetches == before_off && st.next_fetch_us == -1);
+
+    // Wake: one catch-up fetch for the two slots or so that passed.
+    weather_service_set_display_on(true);
+    CHECK(wait_fetches(before_off + 1, 300));
+    st = stats();
+    CHECK(st.catch_ups == 1 && st.paused_skips >= 2);
+
+    // A failing server backs off: 1 s, then 1-2 s, capped at 2 s.
+    fixture.status_code = 500;
+    host_http_set_fixture(&fixture);
+    const uint32_t before_fail = stats().failures;
+    for (int i = 0; i < 60 && stats().retry_level < 3; i++) {
+        sleep_ms(100);
+    }
+    st = stats();
+    CHECK(st.retry_level >= 3 && st.failures - before_fail >= 3);
+    CHECK(st.next_fetch_us - esp_timer_get_time() <= 2000000);
+
+    // Reconnecting retries at once, on a fresh backoff. The retry was pulled forward,
+    // not missed, so it is no catch-up.
+    fixture.status_code = 0;
+    host_http_set_fixture(&fixture);
+    weather_service_set_network(false);
+    const uint32_t before_up = stats().fetches;
+    weather_service_set_network(true);
+    CHECK(wait_fetches(before_up + 1, 300));
+    st = stats();
+    CHECK(st.retry_level == 0 && st.catch_ups == 1);
+
+    // A response reporting 900 s model updates stretches the schedule to that grid.
+    host_http_fixture_t slow = {.body = k_forecast_day, .body_len = sizeof(k_forecast_day) - 1, .chunk_size = 512};
+    host_http_set_fixture(&slow);
+    const uint32_t before_slow = stats().fetches;
+    weather_service_request_update();
+    CHECK(wait_fetches(before_slow + 1, 500));
+    st = stats();
+    const int64_t ahead_us = st.next_fetch_us - esp_timer_get_time();
+    CHECK(ahead_us > 0 && ahead_us <= 900 * 1000000LL);
+    const time_t due = time(NULL) + (time_t)(ahead_us / 1000000);
+    CHECK(due % 900 >= 890 || due % 900 <= 1);
+
+    printf("PASS weather_schedule fetches=%u scheduled=%u catch_ups=%u paused_skips=%u failures=%u\n", st.fetches,
+           st.scheduled, st.catch_ups, st.paused_skips, st.failures);
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Checks the weather worker task: request_update() returns without waiting for the
+// network, a burst of requests while a fetch is queued or running shares that one
+// fetch, and results reach the update callback on the worker rather than the caller.
+// Built with WEATHER_CACHE_MAX_AGE_SEC=0 so every request goes to the network.
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "esp_timer.h"
+#include "host_sim.h"
+#include "test_util.h"
+#include "weather_service.h"
+
+#define LATENCY_MS 200
+
+static bool s_on_caller = false;
+static pthread_t s_caller;
+static weather_data_t s_last;
+
+static void on_update(const weather_data_t *data, void *ctx)
+{
+    (void)ctx;
+    test_lock();
+    s_on_caller |= pthread_equal(pthread_self(), s_caller);
+    s_last = *data;
+    test_update_counted();
+    test_unlock();
+}
+
+int main(void)
+{
+    s_caller = pthread_self();
+    host_http_fixture_t fixture = {.chunk_size = 512, .latency_ms = LATENCY_MS};
+    host_http_set_fixture(&fixture);
+
+    weather_service_stats_t st;
+    CHECK(weather_service_get_stats(&st) == ESP_ERR_INVALID_STATE);
+    CHECK(weather_service_init(NULL) == ESP_ERR_INVALID_ARG);
+    weather_service_config_t cfg = {.update_cb = on_update};
+    CHECK(weather_service_init(&cfg) == ESP_OK);
+    CHECK(weather_service_init(&cfg) == ESP_ERR_INVALID_STATE);
+
+    // A burst of triggers: the first starts a fetch, the rest join it.
+    int64_t start = esp_timer_get_time();
+    for (int i = 0; i < 10; i++) {
+        weather_service_request_update();
+    }
+    int64_t burst_us = esp_timer_get_time() - start;
+    CHECK(burst_us < LATENCY_MS * 1000 / 4);
+    CHECK(test_updates() == 0);
+
+    CHECK(test_wait_updates(1, 5000));
+    sleep_ms(LATENCY_MS * 2); // A second fetch would have landed by now
+    CHECK(test_updates() == 1);
+    CHECK(weather_service_get_stats(&st) == ESP_OK);
+    CHECK(st.requests == 10);
+    CHECK(st.coalesced == 9);
+    CHECK(st.fetches == 1);
+    CHECK(st.failures == 0);
+    CHECK(st.last_fetch_us >= LATENCY_MS * 1000);
+    CHECK(st.max_fetch_us == st.last_fetch_us);
+    CHECK(st.caller_max_us < LATENCY_MS * 1000 / 4);
+    CHECK(!s_on_caller);
+    CHECK(strcmp(s_last.condition, "Offline") != 0);
+
+    // Once the fetch has finished, a new request starts a new one.
+    weather_service_request_update();
+    CHECK(test_wait_updates(2, 5000));
+    CHECK(weather_service_get_stats(&st) == ESP_OK);
+    CHECK(st.requests == 11);
+    CHECK(st.coalesced == 9);
+    CHECK(st.fetches == 2);
+    CHECK(st.total_fetch_us >= 2ull * LATENCY_MS * 1000);
+
+    // A failed fetch still answers the request, with the last result marked stale.
+    fixture.status_code = 500;
+    host_http_set_fixture(&fixture);
+    weather_service_request_update();
+    CHECK(test_wait_updates(3, 5000));
+    CHECK(weather_service_get_stats(&st) == ESP_OK);
+    CHECK(st.failures == 1);
+    CHECK(st.served_stale == 1);
+    CHECK(s_last.stale);
+    CHECK(strcmp(s_last.condition, "Offline") != 0);
+
+    printf("PASS weather_service requests=%u coalesced=%u fetch_mean_us=%llu caller_max_us=%u\n", st.requests,
+           st.coalesced, (unsigned long long)(st.total_fetch_us / st.fetches), st.caller_max_us);
+    return 0;
+}
@@ -0,0 +1,217 @@
+// Compares the UI's weather and clock formatting before and after the switch to
+// integer values: the previous code kept temperatures as doubles and formatted them
+// with snprintf("%.0f") and the clock with strftime(); the current code formats
+// deci-degrees and minutes of the day with fmt.c. One update is the four strings the
+// clock screen redraws (temperature, high/low/feels, sunrise/sunset, HH:MM + weekday).
+// Prints one BENCH line per implementation; cycles come from the TSC on x86.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#endif
+
+#include "fmt.h"
+#include "weather_service.h"
+
+typedef struct {
+    char temp[64];
+    char details[64];
+    char sun[64];
+    char clock[8];
+    char sub[32];
+} ui_strings_t;
+
+// ---- Previous implementation (ui_shell.c before integer formatting) --------------
+
+typedef struct {
+    double temp_f;
+    double feels_like_f;
+    double high_f;
+    double low_f;
+    char condition[32];
+    char sunrise[8];
+    char sunset[8];
+    bool stale;
+} legacy_weather_t;
+
+static void legacy_format(const legacy_weather_t *d, const struct tm *info, ui_strings_t *out)
+{
+    snprintf(out->temp, sizeof(out->temp), "%.0f" FMT_DEGREE "F • %s", d->temp_f, d->condition);
+    snprintf(out->details, sizeof(out->details), "H:%.0f" FMT_DEGREE " L:%.0f" FMT_DEGREE " • Feels %.0f" FMT_DEGREE "%s",
+             d->high_f, d->low_f, d->feels_like_f, d->stale ? " • cached" : "");
+    snprintf(out->sun, sizeof(out->sun), "Rise: %s\nSet: %s", d->sunrise, d->sunset);
+    strftime(out->clock, sizeof(out->clock), "%H:%M", info);
+    strftime(out->sub, sizeof(out->sub), "%a", info);
+    strncat(out->sub, " • Dry Ridge", sizeof(out->sub) - strlen(out->sub) - 1);
+}
+
+// ---- Integer implementation (the code in ui_shell.c) ------------------------------
+
+static void int_format(const weather_data_t *d, const struct tm *info, ui_strings_t *out)
+{
+    static const char *const k_weekdays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
+    fmt_buf_t f;
+    fmt_init(&f, out->temp, sizeof(out->temp));
+    fmt_deci_round(&f, d->temp_f10);
+    fmt_str(&f, FMT_DEGREE "F • ");
+    fmt_str(&f, d->condition);
+
+    fmt_init(&f, out->details, sizeof(out->details));
+    fmt_str(&f, "H:");
+    fmt_deci_round(&f, d->high_f10);
+    fmt_str(&f, FMT_DEGREE " L:");
+    fmt_deci_round(&f, d->low_f10);
+    fmt_str(&f, FMT_DEGREE " • Feels ");
+    fmt_deci_round(&f, d->feels_like_f10);
+    fmt_str(&f, d->stale ? FMT_DEGREE " • cached" : FMT_DEGREE);
+
+    fmt_init(&f, out->sun, sizeof(out->sun));
+    fmt_str(&f, "Rise: ");
+    fmt_clock12(&f, d->sunrise);
+    fmt_str(&f, "\nSet: ");
+    fmt_clock12(&f, d->sunset);
+
+    fmt_init(&f, out->clock, sizeof(out->clock));
+    fmt_hhmm(&f, (uint16_t)(info->tm_hour * 60 + info->tm_min));
+    fmt_init(&f, out->sub, sizeof(out->sub));
+    fmt_str(&f, k_weekdays[info->tm_wday % 7]);
+    fmt_str(&f, " • Dry Ridge");
+}
+
+// ---- Harness ----------------------------------------------------------------------
+
+#define SAMPLES 64
+
+static legacy_weather_t s_legacy[SAMPLES];
+static weather_data_t s_int[SAMPLES];
+static struct tm s_tm[SAMPLES];
+
+// The same readings in both representations. Tenths ending in 5 are skipped: "%.0f"
+// rounds exact ties to even, fmt_deci_round() away from zero.
+static int16_t untie(int v)
+{
+    return (int16_t)(v % 10 == 5 || v % 10 == -5 ? v + 1 : v);
+}
+
+static void make_samples(void)
+{
+    for (int i = 0; i < SAMPLES; i++) {
+        const int16_t t = untie(-203 + i * 37 % 1300);
+        const int16_t hi = untie(t + 84);
+        const int16_t lo = untie(t - 121);
+        const int16_t feels = untie(t - 46);
+        const uint16_t rise = (uint16_t)(5 * 60 + i * 7 % 180);
+        const uint16_t set = (uint16_t)(17 * 60 + i * 11 % 240);
+
+        weather_data_t *d = &s_int[i];
+        memset(d, 0, sizeof(*d));
+        d->temp_f10 = t;
+        d->high_f10 = hi;
+        d->low_f10 = lo;
+        d->feels_like_f10 = feels;
+        d->sunrise = rise;
+        d->sunset = set;
+        d->stale = i % 5 == 0;
+        snprintf(d->condition, sizeof(d->condition), "%s", i % 2 ? "Overcast" : "Partly Cloudy");
+
+        legacy_weather_t *l = &s_legacy[i];
+        l->temp_f = t / 10.0;
+        l->high_f = hi / 10.0;
+        l->low_f = lo / 10.0;
+        l->feels_like_f = feels / 10.0;
+        l->stale = d->stale;
+        snprintf(l->condition, sizeof(l->condition), "%s", d->condition);
+        fmt_buf_t f;
+        fmt_init(&f, l->sunrise, sizeof(l->sunrise));
+        fmt_clock12(&f, rise);
+        fmt_init(&f, l->sunset, sizeof(l->sunset));
+        fmt_clock12(&f, set);
+
+        struct tm *tm = &s_tm[i];
+        memset(tm, 0, sizeof(*tm));
+        tm->tm_hour = i * 5 % 24;
+        tm->tm_min = i * 13 % 60;
+        tm->tm_wday = i % 7;
+    }
+}
+
+// Both implementations must draw identical strings, apart from "-0".
+static bool identical(void)
+{
+    for (int i = 0; i < SAMPLES; i++) {
+        ui_strings_t a;
+        ui_strings_t b;
+        legacy_format(&s_legacy[i], &s_tm[i], &a);
+        int_format(&s_int[i], &s_tm[i], &b);
+        if (strstr(a.temp, "-0" FMT_DEGREE) || strstr(a.details, "-0" FMT_DEGREE)) {
+            continue;
+        }
+        if (strcmp(a.temp, b.temp) || strcmp(a.details, b.details) || strcmp(a.sun, b.sun) ||
+            strcmp(a.clock, b.clock) || strcmp(a.sub, b.sub)) {
+            fprintf(stderr, "mismatch %d:\n  %s | %s | %s\n  %s | %s | %s\n", i, a.temp, a.details, a.clock, b.temp,
+                    b.details, b.clock);
+            return false;
+        }
+    }
+    return true;
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static uint64_t cycles(void)
+{
+#ifdef HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+static volatile size_t s_sink;
+
+static void run(const char *impl, bool legacy, int iterations)
+{
+    ui_strings_t out;
+    const uint64_t start_ns = now_ns();
+    const uint64_t start_cyc = cycles();
+    for (int i = 0; i < iterations; i++) {
+        const int k = i % SAMPLES;
+        if (legacy) {
+            legacy_format(&s_legacy[k], &s_tm[k], &out);
+        } else {
+            int_format(&s_int[k], &s_tm[k], &out);
+        }
+        s_sink += strlen(out.details);
+    }
+    const uint64_t cyc = cycles() - start_cyc;
+    const uint64_t ns = now_ns() - start_ns;
+    printf("BENCH ui_format impl=%s updates=%d ns_per_update=%.1f cycles_per_update=%.0f\n", impl, iterations,
+           (double)ns / iterations, (double)cyc / iterations);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 200000;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0) {
+            iterations = atoi(argv[i + 1]);
+        }
+    }
+
+    make_samples();
+    if (!identical()) {
+        return 1;
+    }
+    run("legacy", true, iterations);
+    run("fixed", false, iterations);
+    return 0;
+}
@@ -0,0 +1,274 @@
+// Weather load harness: runs weather_service.c (the real worker task, client and
+// parser) in a loop against the HTTP stand-in in esp_http_client_host.c, one
+// scenario at a time. Each scenario replays a recorded Open-Meteo body through a
+// link or server fault — latency, bandwidth caps, chunked framing, oversized bodies,
+// truncation, resets, stalls and timeouts — and prints one BENCH line with fetch
+// latency percentiles, parse throughput and memory high-water marks.
+//
+// Every request must be answered: a good fetch with the body's values, a failed one
+// with the previous result marked stale. Exits non-zero otherwise.
+// Built with WEATHER_CACHE_MAX_AGE_SEC=0 and a short WEATHER_HTTP_TIMEOUT_MS.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "config.h"
+#include "forecast_fixture.h"
+#include "host_sim.h"
+#include "test_util.h"
+#include "weather_parser.h"
+#include "weather_service.h"
+
+#define MAX_FETCHES 1000
+#define BIG_EXTRA_POINTS 6000
+
+typedef enum {
+    BODY_DAY = 0, // The recorded one-day response (or --body FILE)
+    BODY_WEEK,    // 7 days of hourly data, pretty-printed
+    BODY_BIG,     // The week body behind a large series the parser must skip
+} body_kind_t;
+
+typedef struct {
+    const char *name;
+    body_kind_t body;
+    host_http_fixture_t fixture;
+    bool faults; // Failures are expected; without faults every fetch must succeed
+} scenario_t;
+
+static const scenario_t k_scenarios[] = {
+    {"baseline", BODY_DAY, {.chunk_size = 512, .latency_ms = 20}, false},
+    {"chunked_drip", BODY_DAY, {.chunk_size = 7, .chunked = true, .bandwidth_bps = 20000}, false},
+    {"slow_link", BODY_DAY, {.chunk_size = 256, .latency_ms = 40, .bandwidth_bps = 8000}, false},
+    {"week", BODY_WEEK, {.chunk_size = 1460}, false},
+    {"oversized", BODY_BIG, {.chunk_size = 1460, .chunked = true}, false},
+    {"slow_stall", BODY_DAY, {.chunk_size = 128, .fault = HOST_HTTP_FAULT_STALL, .fault_at = 256, .stall_ms = 50}, false},
+    {"truncated", BODY_WEEK,
+     {.chunk_size = 512, .fault = HOST_HTTP_FAULT_TRUNCATE, .fault_at = 2000, .fault_every = 2}, true},
+    {"reset", BODY_DAY, {.chunk_size = 128, .fault = HOST_HTTP_FAULT_RESET, .fault_at = 300, .fault_every = 3}, true},
+    {"no_response", BODY_DAY, {.chunk_size = 512, .fault = HOST_HTTP_FAULT_NO_RESPONSE, .fault_every = 2}, true},
+    {"stall_timeout", BODY_DAY,
+     {.chunk_size = 128, .fault = HOST_HTTP_FAULT_STALL, .fault_at = 200, .stall_ms = WEATHER_HTTP_TIMEOUT_MS + 50,
+      .fault_every = 2},
+     true},
+};
+
+static weather_data_t s_last;
+
+static void on_update(const weather_data_t *data, void *ctx)
+{
+    (void)ctx;
+    test_lock();
+    s_last = *data;
+    test_update_counted();
+    test_unlock();
+}
+
+static bool fetch_once(weather_data_t *out)
+{
+    const bool done = test_request_and_wait(weather_service_request_update, 6000);
+    test_lock();
+    *out = s_last;
+    test_unlock();
+    return done;
+}
+
+static char *read_file(const char *path, size_t *len)
+{
+    FILE *f = fopen(path, "rb");
+    if (!f) {
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    const long size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char *buf = malloc((size_t)size + 1);
+    if (buf && fread(buf, 1, (size_t)size, f) != (size_t)size) {
+        free(buf);
+        buf = NULL;
+    }
+    fclose(f);
+    *len = (size_t)size;
+    return buf;
+}
+
+// A "minutely_15" series far larger than anything the service asks for, ahead of the
+// week body's members: the parser has to stream past it in fixed memory.
+static char *make_big_body(size_t *out_len)
+{
+    size_t week_len;
+    char *week = fixture_forecast_week(&week_len);
+    size_t cap = week_len + BIG_EXTRA_POINTS * 16, len = 0;
+    char *buf = malloc(cap);
+    buf[0] = '\0';
+    fixture_append(&buf, &len, &cap, "{\"minutely_15\":{\"temperature_2m\":[");
+    for (int i = 0; i < BIG_EXTRA_POINTS; i++) {
+        fixture_append(&buf, &len, &cap, "%s%d.%d", i ? "," : "", 20 + i % 40, i % 10);
+    }
+    fixture_append(&buf, &len, &cap, "]},");
+    const char *rest = strchr(week, '{') + 1;
+    const size_t rest_len = week_len - (size_t)(rest - week);
+    buf = realloc(buf, len + rest_len + 1);
+    memcpy(buf + len, rest, rest_len + 1);
+    *out_len = len + rest_len;
+    free(week);
+    return buf;
+}
+
+static int cmp_u32(const void *a, const void *b)
+{
+    const uint32_t x = *(const uint32_t *)a;
+    const uint32_t y = *(const uint32_t *)b;
+    return x < y ? -1 : x > y;
+}
+
+// Nearest-rank percentile of sorted samples.
+static uint32_t percentile(const uint32_t *sorted, int n, int p)
+{
+    int rank = (p * n + 99) / 100;
+    return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+static int16_t expected_temp(const char *body, size_t len)
+{
+    weather_data_t d;
+    weather_parser_t p;
+    weather_parser_init(&p, &d);
+    weather_parser_feed(&p, body, len);
+    return weather_parser_finish(&p) == ESP_OK ? d.temp_f10 : INT16_MIN;
+}
+
+static bool run(const scenario_t *sc, const char *body, size_t body_len, int fetches)
+{
+    host_http_fixture_t fixture = sc->fixture;
+    fixture.body = body;
+    fixture.body_len = body_len;
+    const int16_t want_temp = expected_temp(body, body_len);
+
+    weather_service_stats_t before;
+    weather_service_get_stats(&before);
+    host_http_reset_stats();
+    host_http_set_fixture(&fixture);
+
+    static uint32_t latency[MAX_FETCHES];
+    int ok = 0;
+    int stale = 0;
+    bool pass = want_temp != INT16_MIN;
+    for (int i = 0; i < fetches; i++) {
+        weather_data_t d;
+        if (!fetch_once(&d)) {
+            fprintf(stderr, "%s: fetch %d was never answered\n", sc->name, i);
+            return false;
+        }
+        weather_service_stats_t st;
+        weather_service_get_stats(&st);
+        latency[i] = st.last_fetch_us;
+        if (d.stale) {
+            stale++;
+        } else if (d.temp_f10 == want_temp) {
+            ok++;
+        } else {
+            fprintf(stderr, "%s: fetch %d showed %d, want %d\n", sc->name, i, d.temp_f10, want_temp);
+            pass = false;
+        }
+    }
+
+    weather_service_stats_t after;
+    weather_service_get_stats(&after);
+    host_http_stats_t http;
+    host_http_get_stats(&http);
+    qsort(latency, (size_t)fetches, sizeof(latency[0]), cmp_u32);
+    const uint64_t bytes = after.body_bytes - before.body_bytes;
+    const uint64_t parse_us = after.parse_us - before.parse_us;
+    const uint32_t failures = after.failures - before.failures;
+
+    printf("BENCH weather_load scenario=%s fetches=%d ok=%d stale=%d requests=%u faults=%u timeouts=%u "
+           "p50_us=%u p90_us=%u p99_us=%u max_us=%u body_bytes=%llu parse_bytes_per_s=%.0f "
+           "stack_peak=%zu heap_peak=%zu\n",
+           sc->name, fetches, ok, stale, http.requests, http.faults, http.timeouts, percentile(latency, fetches, 50),
+           percentile(latency, fetches, 90), percentile(latency, fetches, 99), latency[fetches - 1],
+           (unsigned long long)bytes, parse_us ? bytes * 1e6 / (double)parse_us : 0.0,
+           host_task_stack_peak("weather"), http.heap_peak);
+
+    if (!sc->faults && (failures != 0 || stale != 0)) {
+        fprintf(stderr, "%s: %u failed fetches without an injected fault\n", sc->name, failures);
+        pass = false;
+    }
+    if (failures > http.faults) {
+        fprintf(stderr, "%s: %u failures from %u faults\n", sc->name, failures, http.faults);
+        pass = false;
+    }
+    if (sc->faults && fetches >= (int)(sc->fixture.fault_every ? sc->fixture.fault_every : 1) && http.faults == 0) {
+        fprintf(stderr, "%s: the fault was never injected\n", sc->name);
+        pass = false;
+    }
+    return pass;
+}
+
+int main(int argc, char **argv)
+{
+    int fetches = 20;
+    const char *only = NULL;
+    const char *body_path = NULL;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--fetches") == 0) {
+            fetches = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--scenario") == 0) {
+            only = argv[++i];
+        } else if (strcmp(argv[i], "--body") == 0) {
+            body_path = argv[++i];
+        }
+    }
+    if (fetches < 1 || fetches > MAX_FETCHES) {
+        fprintf(stderr, "--fetches must be 1..%d\n", MAX_FETCHES);
+        return 2;
+    }
+
+    size_t day_len = sizeof(k_forecast_day) - 1;
+    const char *day = k_forecast_day;
+    char *recorded = NULL;
+    if (body_path) {
+        recorded = read_file(body_path, &day_len);
+        if (!recorded) {
+            fprintf(stderr, "cannot read %s\n", body_path);
+            return 2;
+        }
+        day = recorded;
+    }
+    size_t week_len;
+    char *week = fixture_forecast_week(&week_len);
+    size_t big_len;
+    char *big = make_big_body(&big_len);
+
+    weather_service_config_t cfg = {.update_cb = on_update};
+    if (weather_service_init(&cfg) != ESP_OK) {
+        return 1;
+    }
+
+    bool pass = true;
+    int ran = 0;
+    for (size_t i = 0; i < sizeof(k_scenarios) / sizeof(k_scenarios[0]); i++) {
+        const scenario_t *sc = &k_scenarios[i];
+        if (only && strcmp(only, sc->name) != 0) {
+            continue;
+        }
+        if (only && sc->faults) {
+            // Failures fall back to the cache; give the scenario one to fall back to.
+            run(&k_scenarios[0], day, day_len, 1);
+        }
+        const char *body = sc->body == BODY_WEEK ? week : sc->body == BODY_BIG ? big : day;
+        const size_t len = sc->body == BODY_WEEK ? week_len : sc->body == BODY_BIG ? big_len : day_len;
+        pass &= run(sc, body, len, fetches);
+        ran++;
+    }
+
+    free(big);
+    free(week);
+    free(recorded);
+    if (ran == 0) {
+        fprintf(stderr, "no scenario named %s\n", only);
+        return 2;
+    }
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,205 @@
+// Compares the streaming weather parser with the previous implementation, which copied
+// the body into a fixed 4 KB buffer (dropping chunked bodies) and then ran one strstr
+// scan per field. Bodies are delivered in HTTP_EVENT_ON_DATA-sized pieces, as the
+// HTTP client would. Prints one BENCH line per body and implementation.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "forecast_fixture.h"
+#include "weather_parser.h"
+
+// ---- Previous implementation (weather_service.c before the streaming parser) ----
+
+// weather_data_t as it was then: doubles and preformatted sunrise/sunset.
+typedef struct {
+    double temp_f;
+    double feels_like_f;
+    double high_f;
+    double low_f;
+    int weather_code;
+    char sunrise[8];
+    char sunset[8];
+} legacy_weather_t;
+
+#define LEGACY_BUFFER_SIZE 4096
+static char s_legacy_buffer[LEGACY_BUFFER_SIZE];
+static int s_legacy_len;
+
+static void legacy_on_data(const char *data, int len, bool chunked)
+{
+    if (!chunked) {
+        if (s_legacy_len + len < LEGACY_BUFFER_SIZE - 1) {
+            memcpy(s_legacy_buffer + s_legacy_len, data, len);
+            s_legacy_len += len;
+            s_legacy_buffer[s_legacy_len] = '\0';
+        }
+    }
+}
+
+static double legacy_double(const char *json, const char *key, size_t start_pos)
+{
+    char search[64];
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    const char *pos = strstr(json + start_pos, search);
+    if (pos != NULL) {
+        pos += strlen(search);
+        while (*pos == ' ' || *pos == '\t') pos++;
+        if (*pos == '[') pos++;
+        return atof(pos);
+    }
+    return 0.0;
+}
+
+static int legacy_int(const char *json, const char *key, size_t start_pos)
+{
+    char search[64];
+    snprintf(search, sizeof(search), "\"%s\":", key);
+    const char *pos = strstr(json + start_pos, search);
+    if (pos != NULL) {
+        pos += strlen(search);
+        while (*pos == ' ' || *pos == '\t') pos++;
+        if (*pos == '[') pos++;
+        return atoi(pos);
+    }
+    return 0;
+}
+
+static void legacy_sun_time(const char *json, const char *key, char *out, size_t out_size)
+{
+    char search[64];
+    snprintf(search, sizeof(search), "\"%s\":[\"", key);
+    const char *pos = strstr(json, search);
+    if (pos != NULL) {
+        pos += strlen(search);
+        const char *tpos = strchr(pos, 'T');
+        if (tpos != NULL && (tpos - pos) < 20) {
+            int hour = atoi(tpos + 1);
+            int min = 0;
+            const char *colon_pos = strchr(tpos, ':');
+            if (colon_pos != NULL) min = atoi(colon_pos + 1);
+            const char *ampm = (hour >= 12) ? "PM" : "AM";
+            if (hour > 12) hour -= 12;
+            if (hour == 0) hour = 12;
+            snprintf(out, out_size, "%d:%02d %s", hour, min, ampm);
+            return;
+        }
+    }
+    snprintf(out, out_size, "--:--");
+}
+
+static legacy_weather_t s_legacy_data;
+
+static bool legacy_parse(const char *body, size_t len, size_t chunk, bool chunked, weather_data_t *out)
+{
+    (void)out;
+    legacy_weather_t *data = &s_legacy_data;
+    memset(data, 0, sizeof(*data));
+    s_legacy_len = 0;
+    memset(s_legacy_buffer, 0, sizeof(s_legacy_buffer));
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t n = len - off < chunk ? len - off : chunk;
+        legacy_on_data(body + off, (int)n, chunked);
+    }
+    if (s_legacy_len == 0) {
+        return false;
+    }
+    const char *current_pos = strstr(s_legacy_buffer, "\"current\":{");
+    if (!current_pos) {
+        return false;
+    }
+    size_t offset = current_pos - s_legacy_buffer;
+    data->temp_f = legacy_double(s_legacy_buffer, "temperature_2m", offset);
+    data->feels_like_f = legacy_double(s_legacy_buffer, "apparent_temperature", offset);
+    data->weather_code = legacy_int(s_legacy_buffer, "weather_code", offset);
+    const char *daily_pos = strstr(s_legacy_buffer, "\"daily\":{");
+    if (daily_pos) {
+        size_t daily_offset = daily_pos - s_legacy_buffer;
+        data->high_f = legacy_double(s_legacy_buffer, "temperature_2m_max", daily_offset);
+        data->low_f = legacy_double(s_legacy_buffer, "temperature_2m_min", daily_offset);
+        legacy_sun_time(s_legacy_buffer, "sunrise", data->sunrise, sizeof(data->sunrise));
+        legacy_sun_time(s_legacy_buffer, "sunset", data->sunset, sizeof(data->sunset));
+    }
+    return true;
+}
+
+// ---- Streaming parser -------------------------------------------------------------
+
+static bool stream_parse(const char *body, size_t len, size_t chunk, bool chunked, weather_data_t *data)
+{
+    (void)chunked; // The client hands over de-chunked bytes either way
+    weather_parser_t p;
+    weather_parser_init(&p, data);
+    for (size_t off = 0; off < len; off += chunk) {
+        size_t n = len - off < chunk ? len - off : chunk;
+        weather_parser_feed(&p, body + off, n);
+    }
+    return weather_parser_finish(&p) == ESP_OK;
+}
+
+// ---- Harness ----------------------------------------------------------------------
+
+typedef bool (*parse_fn_t)(const char *body, size_t len, size_t chunk, bool chunked, weather_data_t *data);
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// A result is complete when today's high and its last daily field made it through
+// (the legacy parser still formats sunset; the streaming one skips it).
+static bool complete(parse_fn_t fn, bool ok, const weather_data_t *d)
+{
+    if (fn == legacy_parse) {
+        const legacy_weather_t *l = &s_legacy_data;
+        return ok && l->weather_code == 3 && l->high_f > 44.0 && strcmp(l->sunset, "5:42 PM") == 0;
+    }
+    return ok && d->weather_code == 3 && d->high_f10 == 446 && d->low_f10 == 291;
+}
+
+static void run(const char *body_name, const char *impl, parse_fn_t fn, size_t ram_bytes, const char *body,
+                size_t len, bool chunked, int iterations)
+{
+    weather_data_t d;
+    bool ok = fn(body, len, 512, chunked, &d);
+    double start = now_s();
+    for (int i = 0; i < iterations; i++) {
+        fn(body, len, 512, chunked, &d);
+    }
+    double elapsed = now_s() - start;
+    printf("BENCH json_parse body=%s impl=%s bytes=%zu bytes_per_s=%.0f ram_bytes=%zu complete=%d\n", body_name,
+           impl, len, len * (double)iterations / elapsed, ram_bytes, complete(fn, ok, &d) ? 1 : 0);
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 20000;
+    for (int i = 1; i + 1 < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0) {
+            iterations = atoi(argv[i + 1]);
+        }
+    }
+
+    // Working memory per fetch: the legacy response buffer plus its key search buffer,
+    // against the parser state that replaces both. Neither allocates from the heap.
+    const size_t legacy_ram = sizeof(s_legacy_buffer) + 64;
+    const size_t stream_ram = sizeof(weather_parser_t);
+
+    size_t week_len;
+    char *week = fixture_forecast_week(&week_len);
+    const size_t day_len = sizeof(k_forecast_day) - 1;
+
+    run("day", "legacy", legacy_parse, legacy_ram, k_forecast_day, day_len, false, iterations);
+    run("day", "stream", stream_parse, stream_ram, k_forecast_day, day_len, false, iterations);
+    run("day_chunked", "legacy", legacy_parse, legacy_ram, k_forecast_day, day_len, true, iterations);
+    run("day_chunked", "stream", stream_parse, stream_ram, k_forecast_day, day_len, true, iterations);
+    run("week", "legacy", legacy_parse, legacy_ram, week, week_len, false, iterations / 8);
+    run("week", "stream", stream_parse, stream_ram, week, week_len, false, iterations / 8);
+
+    free(week);
+    return 0;
+}
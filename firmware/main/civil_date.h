@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Proleptic Gregorian calendar on day numbers (days since 1970-01-01), in integer
+// arithmetic only: Howard Hinnant's days_from_civil and civil_from_days. Shared by
+// the forecast store, the parser, solar times and local time.
+
+static inline bool civil_is_leap(int32_t y)
+{
+    return (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+}
+
+/** m is 1..12. */
+static inline uint8_t civil_days_in_month(int32_t y, uint32_t m)
+{
+    static const uint8_t k_days[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    return (uint8_t)(m == 2 && civil_is_leap(y) ? 29 : k_days[m - 1]);
+}
+
+/** 0 (Sunday)..6. */
+static inline uint8_t civil_weekday(int32_t day)
+{
+    return (uint8_t)(((day + 4) % 7 + 7) % 7); // 1970-01-01 was a Thursday
+}
+
+/** Day number of y-m-d. */
+static inline int32_t civil_to_days(int32_t y, uint32_t m, uint32_t d)
+{
+    y -= m <= 2;
+    const int32_t era = (y >= 0 ? y : y - 399) / 400;
+    const uint32_t yoe = (uint32_t)(y - era * 400);
+    const uint32_t doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+    const uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + (int32_t)doe - 719468;
+}
+
+/** Date of a day number; the inverse of civil_to_days(). */
+static inline void civil_from_days(int32_t day, int32_t *y, uint8_t *m, uint8_t *d)
+{
+    day += 719468;
+    const int32_t era = (day >= 0 ? day : day - 146096) / 146097;
+    const uint32_t doe = (uint32_t)(day - era * 146097);
+    const uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const uint32_t mp = (5 * doy + 2) / 153;
+    *d = (uint8_t)(doy - (153 * mp + 2) / 5 + 1);
+    *m = (uint8_t)(mp < 10 ? mp + 3 : mp - 9);
+    *y = (int32_t)yoe + era * 400 + (*m <= 2);
+}
+
+#ifdef __cplusplus
+}
+#endif
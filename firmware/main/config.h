@@ -38,6 +38,81 @@ extern "C" {
 #define LOCATION_NAME "Dry Ridge"
 #endif
 
+/**
+ * Locations to show weather for, fetched together in a single request
+ * Up to WEATHER_MAX_LOCATIONS entries; the clock screen cycles through them
+ * Example: WEATHER_LOCATION(WEATHER_LAT, WEATHER_LON, LOCATION_NAME),
+ *          WEATHER_LOCATION(38.2527, -85.7585, "Louisville")
+ */
+#ifndef WEATHER_LOCATIONS
+#define WEATHER_LOCATIONS WEATHER_LOCATION(WEATHER_LAT, WEATHER_LON, LOCATION_NAME)
+#endif
+
+/**
+ * Weather worker task
+ * Fetches run on their own task so the UI and event loop never block on HTTP
+ */
+#ifndef WEATHER_TASK_STACK_SIZE
+#define WEATHER_TASK_STACK_SIZE 8192
+#endif
+
+#ifndef WEATHER_TASK_PRIORITY
+#define WEATHER_TASK_PRIORITY 4
+#endif
+
+/**
+ * Weather HTTP timeout (milliseconds)
+ * How long a request may wait for the response to start or for more body bytes
+ */
+#ifndef WEATHER_HTTP_TIMEOUT_MS
+#define WEATHER_HTTP_TIMEOUT_MS 10000
+#endif
+
+/**
+ * Weather cache freshness (seconds)
+ * The last good result is kept in NVS. Younger than MAX_AGE it answers refreshes
+ * without a request; after that it is shown marked stale while a conditional
+ * request revalidates it, for up to STALE_SEC more
+ */
+#ifndef WEATHER_CACHE_MAX_AGE_SEC
+#define WEATHER_CACHE_MAX_AGE_SEC 300
+#endif
+
+#ifndef WEATHER_CACHE_STALE_SEC
+#define WEATHER_CACHE_STALE_SEC 21600
+#endif
+
+/**
+ * Weather refresh schedule (seconds)
+ * Scheduled refreshes follow the provider's model updates: every INTERVAL, or the
+ * longer interval a response reports ("current.interval"), LAG after each update so
+ * the new run is published, plus up to JITTER so clocks do not all ask at once
+ */
+#ifndef WEATHER_REFRESH_INTERVAL_SEC
+#define WEATHER_REFRESH_INTERVAL_SEC 900
+#endif
+
+#ifndef WEATHER_REFRESH_LAG_SEC
+#define WEATHER_REFRESH_LAG_SEC 60
+#endif
+
+#ifndef WEATHER_REFRESH_JITTER_SEC
+#define WEATHER_REFRESH_JITTER_SEC 60
+#endif
+
+/**
+ * Weather retry backoff (seconds)
+ * After a failed refresh the next one waits MIN, doubling per consecutive failure up
+ * to MAX, with the wait drawn from the upper half of that range
+ */
+#ifndef WEATHER_RETRY_MIN_SEC
+#define WEATHER_RETRY_MIN_SEC 30
+#endif
+
+#ifndef WEATHER_RETRY_MAX_SEC
+#define WEATHER_RETRY_MAX_SEC 1800
+#endif
+
 // ===== POWER MANAGEMENT =====
 
 /**
@@ -76,6 +151,49 @@ extern "C" {
 #define NIGHT_MODE_END_HOUR 6     // 6 AM
 #endif
 
+/**
+ * Night mode from the sun
+ * 1: night runs from civil dusk to dawn at WEATHER_LAT/WEATHER_LON, computed on
+ * the device, instead of the fixed hours above
+ */
+#ifndef NIGHT_MODE_FROM_SUN
+#define NIGHT_MODE_FROM_SUN 0
+#endif
+
+/**
+ * Backlight levels (percent PWM duty) per display state
+ * and the hardware fade time between them
+ */
+#ifndef BACKLIGHT_ACTIVE_PERCENT
+#define BACKLIGHT_ACTIVE_PERCENT 100
+#endif
+
+#ifndef BACKLIGHT_DIMMED_PERCENT
+#define BACKLIGHT_DIMMED_PERCENT 20
+#endif
+
+#ifndef BACKLIGHT_OFF_PERCENT
+#define BACKLIGHT_OFF_PERCENT 0
+#endif
+
+#ifndef BACKLIGHT_FADE_MS
+#define BACKLIGHT_FADE_MS 400
+#endif
+
+/**
+ * Interval of the compact frame-timing log line (0 disables it)
+ */
+#ifndef UI_FRAME_STATS_LOG_SEC
+#define UI_FRAME_STATS_LOG_SEC 60
+#endif
+
+/**
+ * Seconds each location's weather stays on the clock screen when there are several
+ */
+#ifndef UI_WEATHER_CYCLE_SEC
+#define UI_WEATHER_CYCLE_SEC 10
+#endif
+
 // ===== NETWORK CONFIGURATION =====
 
 /**
@@ -92,6 +210,14 @@ extern "C" {
 
 // ===== TIME CONFIGURATION =====
 
+/**
+ * Earliest wall-clock time taken as real (2020-01-01). Anything before it is an
+ * unset RTC (cold boot before SNTP), not a timestamp
+ */
+#ifndef CLOCK_VALID_AFTER
+#define CLOCK_VALID_AFTER 1577836800
+#endif
+
 /**
  * NTP server for time synchronization
  */
@@ -99,6 +225,81 @@ extern "C" {
 #define NTP_SERVER "pool.ntp.org"
 #endif
 
+/**
+ * NTP servers queried together on every sync (comma-separated string literals, at
+ * most TIME_SERVER_MAX). Of the replies that agree, the one with the shortest round
+ * trip sets the clock, so use at least three: with two, one bad server stops syncs
+ */
+#ifndef NTP_SERVERS
+#define NTP_SERVERS NTP_SERVER, "1.pool.ntp.org", "2.pool.ntp.org", "3.pool.ntp.org"
+#endif
+
+#ifndef TIME_SERVER_MAX
+#define TIME_SERVER_MAX 4
+#endif
+
+/**
+ * How long a sync waits for the servers' replies (milliseconds)
+ */
+#ifndef TIME_NTP_TIMEOUT_MS
+#define TIME_NTP_TIMEOUT_MS 2000
+#endif
+
+/**
+ * Time sync worker task
+ * NTP rounds run on their own task, between waits of the resync interval
+ */
+#ifndef TIME_TASK_STACK_SIZE
+#define TIME_TASK_STACK_SIZE 4096
+#endif
+
+#ifndef TIME_TASK_PRIORITY
+#define TIME_TASK_PRIORITY 3
+#endif
+
+/**
+ * NTP resync interval (seconds)
+ * Starts at MIN; doubles, up to MAX, while the measured drift is steady and would
+ * keep the clock within TIME_SYNC_MAX_ERROR_MS until the next sync, and halves
+ * when it is not. Pool servers send kiss-o'-death to clients polling much faster
+ * than every 64 s; a failed sync of a set clock is retried after MIN
+ */
+#ifndef TIME_SYNC_INTERVAL_MIN_SEC
+#define TIME_SYNC_INTERVAL_MIN_SEC 900
+#endif
+
+#ifndef TIME_SYNC_INTERVAL_MAX_SEC
+#define TIME_SYNC_INTERVAL_MAX_SEC 43200
+#endif
+
+#ifndef TIME_SYNC_MAX_ERROR_MS
+#define TIME_SYNC_MAX_ERROR_MS 100
+#endif
+
+/**
+ * First NTP retry while the clock is still unset (seconds)
+ * A cold boot has no time to show until a sync succeeds, so failed rounds are
+ * retried after this, doubling up to TIME_SYNC_INTERVAL_MIN_SEC
+ */
+#ifndef TIME_SYNC_RETRY_FIRST_SEC
+#define TIME_SYNC_RETRY_FIRST_SEC 4
+#endif
+
+/**
+ * Clock corrections up to this (milliseconds) are slewed with adjtime() so the
+ * displayed seconds never jump; larger ones, and setting an unset clock, step it
+ */
+#ifndef TIME_SLEW_MAX_MS
+#define TIME_SLEW_MAX_MS 500
+#endif
+
+/**
+ * Drift is steady when recent sync intervals agree within this (ppm)
+ */
+#ifndef TIME_DRIFT_STABLE_PPM
+#define TIME_DRIFT_STABLE_PPM 5
+#endif
+
 /**
  * Timezone string (POSIX format)
  * Examples:
@@ -0,0 +1,114 @@
+#include "fmt.h"
+
+#define MINUTES_PER_DAY (24 * 60)
+
+static void put(fmt_buf_t *f, char c)
+{
+    if (f->len + 1 < f->size) {
+        f->buf[f->len++] = c;
+        f->buf[f->len] = '\0';
+    }
+}
+
+static void put_2digits(fmt_buf_t *f, uint32_t v)
+{
+    put(f, (char)('0' + v / 10));
+    put(f, (char)('0' + v % 10));
+}
+
+static void put_uint(fmt_buf_t *f, uint32_t u)
+{
+    char digits[10];
+    int n = 0;
+    do {
+        digits[n++] = (char)('0' + u % 10);
+        u /= 10;
+    } while (u);
+    while (n) {
+        put(f, digits[--n]);
+    }
+}
+
+// Magnitude as unsigned so INT32_MIN does not overflow.
+static uint32_t magnitude(int32_t v)
+{
+    return v < 0 ? 0u - (uint32_t)v : (uint32_t)v;
+}
+
+void fmt_init(fmt_buf_t *f, char *buf, size_t size)
+{
+    f->buf = buf;
+    f->size = size;
+    f->len = 0;
+    if (size > 0) {
+        buf[0] = '\0';
+    }
+}
+
+void fmt_str(fmt_buf_t *f, const char *s)
+{
+    while (*s) {
+        put(f, *s++);
+    }
+}
+
+void fmt_int(fmt_buf_t *f, int32_t v)
+{
+    if (v < 0) {
+        put(f, '-');
+    }
+    put_uint(f, magnitude(v));
+}
+
+void fmt_fixed(fmt_buf_t *f, int32_t v, uint8_t decimals)
+{
+    const uint32_t u = magnitude(v);
+    uint32_t scale = 1;
+    for (uint8_t i = 0; i < decimals && i < 9; i++) {
+        scale *= 10;
+    }
+    if (v < 0) {
+        put(f, '-');
+    }
+    put_uint(f, u / scale);
+    if (scale == 1) {
+        return;
+    }
+    put(f, '.');
+    uint32_t frac = u % scale;
+    for (scale /= 10; scale; scale /= 10) {
+        put(f, (char)('0' + frac / scale));
+        frac %= scale;
+    }
+}
+
+void fmt_deci_round(fmt_buf_t *f, int32_t deci)
+{
+    // C division truncates toward zero, so bias away from zero first. -0.4 shows 0.
+    fmt_int(f, (deci < 0 ? deci - 5 : deci + 5) / 10);
+}
+
+void fmt_clock12(fmt_buf_t *f, uint16_t minute)
+{
+    if (minute >= MINUTES_PER_DAY) {
+        fmt_str(f, "--:--");
+        return;
+    }
+    const uint32_t hour = minute / 60;
+    const uint32_t h12 = hour % 12 == 0 ? 12 : hour % 12;
+    put_uint(f, h12);
+    put(f, ':');
+    put_2digits(f, minute % 60);
+    fmt_str(f, hour >= 12 ? " PM" : " AM");
+}
+
+void fmt_hhmm(fmt_buf_t *f, uint16_t minute)
+{
+    if (minute >= MINUTES_PER_DAY) {
+        fmt_str(f, "--:--");
+        return;
+    }
+    put_2digits(f, minute / 60);
+    put(f, ':');
+    put_2digits(f, minute % 60);
+}
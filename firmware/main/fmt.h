@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Integer-only text formatting for the UI and logs. Appends into a caller-owned
+// buffer, never allocates and always leaves it NUL-terminated; output that does not
+// fit is cut off. Replaces snprintf("%.0f"), which on the ESP32 means software
+// double math plus newlib's float printf.
+
+#define FMT_DEGREE "\xC2\xB0" // UTF-8 degree sign
+
+typedef struct {
+    char *buf;
+    size_t size;
+    size_t len;
+} fmt_buf_t;
+
+void fmt_init(fmt_buf_t *f, char *buf, size_t size);
+void fmt_str(fmt_buf_t *f, const char *s);
+void fmt_int(fmt_buf_t *f, int32_t v);
+/** v / 10^decimals with all decimals shown: (386820, 4) -> "38.6820". */
+void fmt_fixed(fmt_buf_t *f, int32_t v, uint8_t decimals);
+/** Deci-degrees as whole degrees, rounded half away from zero: 413 -> "41". */
+void fmt_deci_round(fmt_buf_t *f, int32_t deci);
+/** Minute of the day as a 12-hour time: 476 -> "7:56 AM"; out of range -> "--:--". */
+void fmt_clock12(fmt_buf_t *f, uint16_t minute);
+/** Minute of the day as a 24-hour time: 545 -> "09:05"; out of range -> "--:--". */
+void fmt_hhmm(fmt_buf_t *f, uint16_t minute);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,46 @@
+#include "forecast_store.h"
+
+#include <string.h>
+
+_Static_assert(sizeof(forecast_store_t) <= FORECAST_STORE_BUDGET_BYTES,
+               "forecast_store_t is over its byte budget; shrink FORECAST_HOURS/DAYS or raise the budget");
+_Static_assert(FORECAST_HOURS <= UINT8_MAX && FORECAST_DAYS <= UINT8_MAX, "counts are uint8_t");
+
+void forecast_store_clear(forecast_store_t *s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+bool forecast_store_hour(const forecast_store_t *s, time_t now, uint32_t n, forecast_hour_t *out)
+{
+    if (now < 0) {
+        return false;
+    }
+    const uint32_t hour = (uint32_t)(now / 3600) + n;
+    if (hour < s->first_hour || hour - s->first_hour >= s->hours) {
+        return false;
+    }
+    const uint32_t slot = forecast_hour_slot(hour);
+    out->temp = s->hour_temp[slot];
+    out->code = s->hour_code[slot];
+    return true;
+}
+
+bool forecast_store_day(const forecast_store_t *s, time_t now, uint32_t n, forecast_day_t *out)
+{
+    const int64_t local = (int64_t)now + s->utc_offset_s;
+    if (local < 0) {
+        return false;
+    }
+    const int32_t day = (int32_t)(local / 86400) + (int32_t)n;
+    if (day < s->first_day || day - s->first_day >= s->days) {
+        return false;
+    }
+    const uint32_t slot = forecast_day_slot(day);
+    out->max = s->day_max[slot];
+    out->min = s->day_min[slot];
+    out->code = s->day_code[slot];
+    out->sunrise = FORECAST_MINUTE_NONE;
+    out->sunset = FORECAST_MINUTE_NONE;
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hourly and daily forecast in fixed-size struct-of-arrays rings. Hours are slotted
+// by absolute hour (Unix time / 3600) and days by local day number, both modulo the
+// capacity, so a lookup is one index computation and hours that have passed simply
+// stop being returned. All values are integers: the ESP32 has no double FPU.
+
+#ifndef FORECAST_HOURS
+#define FORECAST_HOURS 48
+#endif
+
+#ifndef FORECAST_DAYS
+#define FORECAST_DAYS 7
+#endif
+
+/** sizeof(forecast_store_t) must stay within this; checked at compile time. */
+#define FORECAST_STORE_BUDGET_BYTES 256
+
+#define FORECAST_MINUTE_NONE 0xFFFFu // Sunrise/sunset unknown (or none, near the poles)
+
+typedef struct {
+    int32_t utc_offset_s; // Of the forecast location
+    uint32_t first_hour;  // Unix hour of the oldest hour held
+    int32_t first_day;    // Local days since 1970-01-01 of the oldest day held
+    uint8_t hours;        // Consecutive hours held from first_hour
+    uint8_t days;         // Consecutive days held from first_day
+
+    int16_t hour_temp[FORECAST_HOURS]; // Deci-degrees (tenths of the requested unit)
+    uint8_t hour_code[FORECAST_HOURS]; // WMO weather code
+
+    int16_t day_max[FORECAST_DAYS];
+    int16_t day_min[FORECAST_DAYS];
+    uint8_t day_code[FORECAST_DAYS];
+} forecast_store_t;
+
+typedef struct {
+    int16_t temp;
+    uint8_t code;
+} forecast_hour_t;
+
+typedef struct {
+    int16_t max;
+    int16_t min;
+    uint8_t code;
+    uint16_t sunrise; // Not fetched: FORECAST_MINUTE_NONE here, computed by weather_service_get_day()
+    uint16_t sunset;
+} forecast_day_t;
+
+void forecast_store_clear(forecast_store_t *s);
+
+/** Hour n counted from the hour containing now (0 = this hour). False if not held. */
+bool forecast_store_hour(const forecast_store_t *s, time_t now, uint32_t n, forecast_hour_t *out);
+/** Day n counted from the location's local today (0 = today). False if not held. */
+bool forecast_store_day(const forecast_store_t *s, time_t now, uint32_t n, forecast_day_t *out);
+
+// Ring slots, for the parser filling the store index by index.
+static inline uint32_t forecast_hour_slot(uint32_t unix_hour)
+{
+    return unix_hour % FORECAST_HOURS;
+}
+
+static inline uint32_t forecast_day_slot(int32_t day)
+{
+    return (uint32_t)day % FORECAST_DAYS;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,341 @@
+#include "json_stream.h"
+
+#include <string.h>
+
+enum {
+    ST_VALUE = 0,      // Expecting a value
+    ST_VALUE_OR_END,   // After '[': a value or ']'
+    ST_KEY_OR_END,     // After '{': a member name or '}'
+    ST_KEY,            // After ',' in an object: a member name
+    ST_COLON,
+    ST_AFTER_VALUE,    // ',' or the closing bracket of the container
+    ST_STRING,
+    ST_STRING_ESC,
+    ST_STRING_UNICODE,
+    ST_NUMBER,
+    ST_LITERAL,
+    ST_DONE,
+    ST_ERROR,
+};
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+static bool in_array(const json_stream_t *s)
+{
+    return (s->array_mask >> s->depth) & 1u;
+}
+
+static void token_put(json_stream_t *s, char c)
+{
+    if (s->token_len < JSON_STREAM_TOKEN_LEN - 1) {
+        s->token[s->token_len++] = c;
+    } else {
+        s->token_truncated = true;
+    }
+}
+
+static void token_put_utf8(json_stream_t *s, uint32_t cp)
+{
+    if (cp < 0x80) {
+        token_put(s, (char)cp);
+    } else if (cp < 0x800) {
+        token_put(s, (char)(0xC0 | (cp >> 6)));
+        token_put(s, (char)(0x80 | (cp & 0x3F)));
+    } else {
+        token_put(s, (char)(0xE0 | (cp >> 12)));
+        token_put(s, (char)(0x80 | ((cp >> 6) & 0x3F)));
+        token_put(s, (char)(0x80 | (cp & 0x3F)));
+    }
+}
+
+static void emit(json_stream_t *s, json_event_type_t type, const char *value)
+{
+    json_event_t ev = {
+        .type = type,
+        .depth = s->depth,
+        .key = s->depth > 0 && !in_array(s) ? s->keys[s->depth] : NULL,
+        .index = in_array(s) ? s->index[s->depth] : 0,
+        .value = value,
+        .value_len = value ? s->token_len : 0,
+        .truncated = value ? s->token_truncated : false,
+    };
+    s->cb(s, &ev, s->ctx);
+}
+
+static void emit_scalar(json_stream_t *s, json_event_type_t type)
+{
+    s->token[s->token_len] = '\0';
+    emit(s, type, s->token);
+    s->state = s->depth == 0 ? ST_DONE : ST_AFTER_VALUE;
+}
+
+static bool open_container(json_stream_t *s, bool array)
+{
+    if (s->depth >= JSON_STREAM_MAX_DEPTH) {
+        return false;
+    }
+    emit(s, array ? JSON_EV_ARRAY_START : JSON_EV_OBJECT_START, NULL);
+    s->depth++;
+    s->index[s->depth] = 0;
+    s->keys[s->depth][0] = '\0';
+    if (array) {
+        s->array_mask |= 1u << s->depth;
+    } else {
+        s->array_mask &= ~(1u << s->depth);
+    }
+    s->state = array ? ST_VALUE_OR_END : ST_KEY_OR_END;
+    return true;
+}
+
+static bool close_container(json_stream_t *s, bool array)
+{
+    if (s->depth == 0 || in_array(s) != array) {
+        return false;
+    }
+    s->depth--;
+    emit(s, array ? JSON_EV_ARRAY_END : JSON_EV_OBJECT_END, NULL);
+    s->state = s->depth == 0 ? ST_DONE : ST_AFTER_VALUE;
+    return true;
+}
+
+static void begin_token(json_stream_t *s, uint8_t state)
+{
+    s->token_len = 0;
+    s->token_truncated = false;
+    s->state = state;
+}
+
+// Starts the value beginning with c. Returns false when c cannot start one.
+static bool begin_value(json_stream_t *s, char c)
+{
+    if (c == '{' || c == '[') {
+        return open_container(s, c == '[');
+    }
+    if (c == '"') {
+        s->in_key = false;
+        begin_token(s, ST_STRING);
+        return true;
+    }
+    if (c == '-' || (c >= '0' && c <= '9')) {
+        begin_token(s, ST_NUMBER);
+        token_put(s, c);
+        return true;
+    }
+    if (c == 't' || c == 'f' || c == 'n') {
+        begin_token(s, ST_LITERAL);
+        token_put(s, c);
+        return true;
+    }
+    return false;
+}
+
+static bool end_literal(json_stream_t *s)
+{
+    s->token[s->token_len] = '\0';
+    if (strcmp(s->token, "true") != 0 && strcmp(s->token, "false") != 0 && strcmp(s->token, "null") != 0) {
+        return false;
+    }
+    emit_scalar(s, JSON_EV_LITERAL);
+    return true;
+}
+
+static void end_string(json_stream_t *s)
+{
+    if (s->in_key) {
+        size_t n = s->token_len < JSON_STREAM_KEY_LEN - 1 ? s->token_len : JSON_STREAM_KEY_LEN - 1;
+        memcpy(s->keys[s->depth], s->token, n);
+        s->keys[s->depth][n] = '\0';
+        s->state = ST_COLON;
+    } else {
+        emit_scalar(s, JSON_EV_STRING);
+    }
+}
+
+// Consumes one byte. Returns false on a syntax error.
+static bool step(json_stream_t *s, char c)
+{
+    switch (s->state) {
+    case ST_STRING:
+        if (c == '"') {
+            end_string(s);
+        } else if (c == '\\') {
+            s->state = ST_STRING_ESC;
+        } else if ((unsigned char)c < 0x20) {
+            return false;
+        } else {
+            token_put(s, c);
+        }
+        return true;
+
+    case ST_STRING_ESC:
+        s->state = ST_STRING;
+        switch (c) {
+        case '"':
+        case '\\':
+        case '/':
+            token_put(s, c);
+            return true;
+        case 'b':
+            token_put(s, '\b');
+            return true;
+        case 'f':
+            token_put(s, '\f');
+            return true;
+        case 'n':
+            token_put(s, '\n');
+            return true;
+        case 'r':
+            token_put(s, '\r');
+            return true;
+        case 't':
+            token_put(s, '\t');
+            return true;
+        case 'u':
+            s->esc_digits = 0;
+            s->esc_code = 0;
+            s->state = ST_STRING_UNICODE;
+            return true;
+        default:
+            return false;
+        }
+
+    case ST_STRING_UNICODE: {
+        uint32_t digit;
+        if (c >= '0' && c <= '9') {
+            digit = (uint32_t)(c - '0');
+        } else if (c >= 'a' && c <= 'f') {
+            digit = (uint32_t)(c - 'a' + 10);
+        } else if (c >= 'A' && c <= 'F') {
+            digit = (uint32_t)(c - 'A' + 10);
+        } else {
+            return false;
+        }
+        s->esc_code = (s->esc_code << 4) | digit;
+        if (++s->esc_digits == 4) {
+            token_put_utf8(s, s->esc_code);
+            s->state = ST_STRING;
+        }
+        return true;
+    }
+
+    case ST_NUMBER:
+        if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+            token_put(s, c);
+            return true;
+        }
+        emit_scalar(s, JSON_EV_NUMBER);
+        return step(s, c); // The delimiter belongs to the enclosing container
+
+    case ST_LITERAL:
+        if (c >= 'a' && c <= 'z') {
+            token_put(s, c);
+            return true;
+        }
+        return end_literal(s) && step(s, c);
+
+    default:
+        break;
+    }
+
+    if (is_space(c)) {
+        return true;
+    }
+
+    switch (s->state) {
+    case ST_VALUE:
+        return begin_value(s, c);
+    case ST_VALUE_OR_END:
+        return c == ']' ? close_container(s, true) : begin_value(s, c);
+    case ST_KEY_OR_END:
+        if (c == '}') {
+            return close_container(s, false);
+        }
+        // fall through
+    case ST_KEY:
+        if (c != '"') {
+            return false;
+        }
+        s->in_key = true;
+        begin_token(s, ST_STRING);
+        return true;
+    case ST_COLON:
+        if (c != ':') {
+            return false;
+        }
+        s->state = ST_VALUE;
+        return true;
+    case ST_AFTER_VALUE:
+        if (c == ',') {
+            if (in_array(s)) {
+                s->index[s->depth]++;
+                s->state = ST_VALUE;
+            } else {
+                s->state = ST_KEY;
+            }
+            return true;
+        }
+        if (c == ']' || c == '}') {
+            return close_container(s, c == ']');
+        }
+        return false;
+    default:
+        return false; // ST_DONE: trailing data, or ST_ERROR
+    }
+}
+
+void json_stream_init(json_stream_t *s, json_event_cb_t cb, void *ctx)
+{
+    memset(s, 0, sizeof(*s));
+    s->cb = cb;
+    s->ctx = ctx;
+    s->state = ST_VALUE;
+}
+
+esp_err_t json_stream_feed(json_stream_t *s, const char *data, size_t len)
+{
+    if (s->state == ST_ERROR) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    for (size_t i = 0; i < len; i++) {
+        // Fast path for string contents, which make up most of a typical body.
+        if (s->state == ST_STRING) {
+            while (i < len && data[i] != '"' && data[i] != '\\' && (unsigned char)data[i] >= 0x20) {
+                token_put(s, data[i++]);
+            }
+            if (i == len) {
+                break;
+            }
+        }
+        if (!step(s, data[i])) {
+            s->state = ST_ERROR;
+            return ESP_ERR_INVALID_RESPONSE;
+        }
+    }
+    s->bytes += len;
+    return ESP_OK;
+}
+
+esp_err_t json_stream_finish(json_stream_t *s)
+{
+    // A top-level number or literal has no delimiter after it.
+    if (s->depth == 0 && s->state == ST_NUMBER) {
+        emit_scalar(s, JSON_EV_NUMBER);
+    } else if (s->depth == 0 && s->state == ST_LITERAL && !end_literal(s)) {
+        s->state = ST_ERROR;
+    }
+    if (s->state == ST_ERROR) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+    return s->state == ST_DONE ? ESP_OK : ESP_ERR_INVALID_SIZE;
+}
+
+const char *json_stream_key_at(const json_stream_t *s, uint8_t depth)
+{
+    if (depth == 0 || depth > s->depth) {
+        return "";
+    }
+    return s->keys[depth];
+}
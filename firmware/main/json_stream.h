@@ -0,0 +1,71 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Incremental SAX-style JSON tokenizer. Bytes can be fed in pieces of any size, e.g.
+// straight from HTTP_EVENT_ON_DATA; each scalar and container boundary is reported
+// through a callback as soon as it is complete. Memory use is the fixed-size state
+// below, independent of the document size.
+
+#define JSON_STREAM_MAX_DEPTH 8
+#define JSON_STREAM_KEY_LEN 24   // Longer member names are truncated
+#define JSON_STREAM_TOKEN_LEN 48 // Longer string values are truncated
+
+typedef enum {
+    JSON_EV_OBJECT_START = 0,
+    JSON_EV_OBJECT_END,
+    JSON_EV_ARRAY_START,
+    JSON_EV_ARRAY_END,
+    JSON_EV_STRING,
+    JSON_EV_NUMBER,
+    JSON_EV_LITERAL, // true, false or null
+} json_event_type_t;
+
+typedef struct {
+    json_event_type_t type;
+    uint8_t depth;     // Containers enclosing the value; root members are at depth 1
+    const char *key;   // Member name inside an object, NULL inside an array
+    uint16_t index;    // Element index inside an array
+    const char *value; // NUL-terminated token text for scalars, NULL otherwise
+    size_t value_len;
+    bool truncated;    // value did not fit JSON_STREAM_TOKEN_LEN
+} json_event_t;
+
+typedef struct json_stream json_stream_t;
+typedef void (*json_event_cb_t)(json_stream_t *s, const json_event_t *ev, void *ctx);
+
+struct json_stream {
+    json_event_cb_t cb;
+    void *ctx;
+    uint8_t state;
+    uint8_t depth;
+    uint32_t array_mask; // Bit d set when the container at depth d is an array
+    uint16_t index[JSON_STREAM_MAX_DEPTH + 1];
+    char keys[JSON_STREAM_MAX_DEPTH + 1][JSON_STREAM_KEY_LEN];
+    char token[JSON_STREAM_TOKEN_LEN];
+    size_t token_len;
+    bool token_truncated;
+    bool in_key;
+    uint8_t esc_digits;
+    uint32_t esc_code;
+    size_t bytes;
+};
+
+void json_stream_init(json_stream_t *s, json_event_cb_t cb, void *ctx);
+/** Returns ESP_ERR_INVALID_RESPONSE once the input is not valid JSON. */
+esp_err_t json_stream_feed(json_stream_t *s, const char *data, size_t len);
+/** ESP_OK when exactly one complete value was fed, ESP_ERR_INVALID_SIZE if truncated. */
+esp_err_t json_stream_finish(json_stream_t *s);
+/** Name of the member holding the container at the given depth (1 = root member). */
+const char *json_stream_key_at(const json_stream_t *s, uint8_t depth);
+
+#ifdef __cplusplus
+}
+#endif
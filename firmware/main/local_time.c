@@ -0,0 +1,329 @@
+#include "local_time.h"
+#include "civil_date.h"
+
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "local_time";
+
+// POSIX allows rule times up to 167 hours (a change "at" 24:00 or later lands on a
+// following day); offsets are bounded by 24 hours.
+#define RULE_TIME_MAX_HOURS 167
+#define OFFSET_MAX_HOURS 24
+#define DEFAULT_RULE_TIME_S (2 * 3600)
+
+static SemaphoreHandle_t s_lock = NULL; // Guards everything below
+static local_time_zone_t s_zone = {0};  // UTC until local_time_init()
+static local_time_period_t s_period;
+static bool s_period_valid = false;
+static local_time_t s_last; // Shared by every caller within the same second
+static bool s_last_valid = false;
+static local_time_stats_t s_stats = {0};
+
+// ---- TZ string ---------------------------------------------------------------
+
+// "EST" or "<+0530>".
+static const char *parse_name(const char *p)
+{
+    if (*p == '<') {
+        const char *end = strchr(p, '>');
+        return end && end > p + 1 ? end + 1 : NULL;
+    }
+    const char *start = p;
+    while (isalpha((unsigned char)*p)) {
+        p++;
+    }
+    return p - start >= 3 ? p : NULL;
+}
+
+static const char *parse_uint(const char *p, uint32_t max, uint32_t *out)
+{
+    if (!isdigit((unsigned char)*p)) {
+        return NULL;
+    }
+    uint32_t v = 0;
+    while (isdigit((unsigned char)*p)) {
+        v = v * 10 + (uint32_t)(*p++ - '0');
+        if (v > max) {
+            return NULL;
+        }
+    }
+    *out = v;
+    return p;
+}
+
+// [+|-]hh[:mm[:ss]]
+static const char *parse_hms(const char *p, uint32_t max_hours, int32_t *out)
+{
+    int32_t sign = 1;
+    if (*p == '+' || *p == '-') {
+        sign = *p++ == '-' ? -1 : 1;
+    }
+    uint32_t h = 0;
+    uint32_t m = 0;
+    uint32_t s = 0;
+    p = parse_uint(p, max_hours, &h);
+    if (p && *p == ':') {
+        p = parse_uint(p + 1, 59, &m);
+        if (p && *p == ':') {
+            p = parse_uint(p + 1, 59, &s);
+        }
+    }
+    if (p) {
+        *out = sign * (int32_t)(h * 3600 + m * 60 + s);
+    }
+    return p;
+}
+
+// Mm.w.d, Jn or n, then an optional /time.
+static const char *parse_rule(const char *p, local_time_rule_t *r)
+{
+    memset(r, 0, sizeof(*r));
+    r->time_s = DEFAULT_RULE_TIME_S;
+    uint32_t a = 0;
+    uint32_t b = 0;
+    uint32_t c = 0;
+    if (*p == 'M') {
+        p = parse_uint(p + 1, 12, &a);
+        p = p && *p == '.' ? parse_uint(p + 1, 5, &b) : NULL;
+        p = p && *p == '.' ? parse_uint(p + 1, 6, &c) : NULL;
+        if (!p || a == 0 || b == 0) {
+            return NULL;
+        }
+        r->kind = 'M';
+        r->month = (uint8_t)a;
+        r->week = (uint8_t)b;
+        r->wday = (uint8_t)c;
+    } else if (*p == 'J') {
+        p = parse_uint(p + 1, 365, &a);
+        if (!p || a == 0) {
+            return NULL;
+        }
+        r->kind = 'J';
+        r->day = (uint16_t)a;
+    } else {
+        p = parse_uint(p, 365, &a);
+        if (!p) {
+            return NULL;
+        }
+        r->kind = 'D';
+        r->day = (uint16_t)a;
+    }
+    if (*p == '/') {
+        p = parse_hms(p + 1, RULE_TIME_MAX_HOURS, &r->time_s);
+    }
+    return p;
+}
+
+bool local_time_parse_zone(const char *tz, local_time_zone_t *out)
+{
+    local_time_zone_t z = {0};
+    int32_t west = 0;
+    const char *p = tz ? parse_name(tz) : NULL;
+    p = p ? parse_hms(p, OFFSET_MAX_HOURS, &west) : NULL;
+    if (!p) {
+        return false;
+    }
+    z.std_offset_s = -west;
+    z.dst_offset_s = z.std_offset_s;
+    if (*p) {
+        p = parse_name(p);
+        if (!p) {
+            return false;
+        }
+        z.has_dst = true;
+        z.dst_offset_s = z.std_offset_s + 3600;
+        if (*p && *p != ',') {
+            p = parse_hms(p, OFFSET_MAX_HOURS, &west);
+            if (!p) {
+                return false;
+            }
+            z.dst_offset_s = -west;
+        }
+        if (*p == ',') {
+            p = parse_rule(p + 1, &z.start);
+            p = p && *p == ',' ? parse_rule(p + 1, &z.end) : NULL;
+            if (!p) {
+                return false;
+            }
+        } else {
+            parse_rule("M3.2.0", &z.start);
+            parse_rule("M11.1.0", &z.end);
+        }
+    }
+    if (*p) {
+        return false;
+    }
+    *out = z;
+    return true;
+}
+
+// ---- Calendar ------------------------------------------------------------------
+
+static int32_t floor_div(int64_t a, int32_t b)
+{
+    return (int32_t)(a >= 0 ? a / b : -((-a + b - 1) / b));
+}
+
+// Local day (days since 1970-01-01) a rule falls on in year.
+static int32_t rule_day(const local_time_rule_t *r, int32_t year)
+{
+    const int32_t jan1 = civil_to_days(year, 1, 1);
+    if (r->kind == 'J') {
+        return jan1 + r->day - 1 + (civil_is_leap(year) && r->day >= 60 ? 1 : 0);
+    }
+    if (r->kind == 'D') {
+        return jan1 + r->day;
+    }
+    const int32_t first = civil_to_days(year, r->month, 1);
+    int32_t offset = (r->wday - civil_weekday(first) + 7) % 7 + (r->week - 1) * 7;
+    while (offset >= civil_days_in_month(year, r->month)) {
+        offset -= 7; // Week 5: the last one
+    }
+    return first + offset;
+}
+
+// The rule's moment in UTC; its time of day is in the offset in effect before it.
+static int64_t rule_utc(const local_time_rule_t *r, int32_t year, int32_t offset_before_s)
+{
+    return (int64_t)rule_day(r, year) * 86400 + r->time_s - offset_before_s;
+}
+
+void local_time_period(const local_time_zone_t *zone, int64_t utc, local_time_period_t *out)
+{
+    out->utc_offset_s = zone->std_offset_s;
+    out->dst = false;
+    out->from = INT64_MIN;
+    out->until = INT64_MAX;
+    if (!zone->has_dst) {
+        return;
+    }
+
+    // The changes of the years either side, in order: the last one at or before utc
+    // says which offset holds, the one after it when that ends. Southern zones, whose
+    // DST spans the new year, need no special case.
+    int32_t year;
+    uint8_t m;
+    uint8_t d;
+    civil_from_days(floor_div(utc + zone->std_offset_s, 86400), &year, &m, &d);
+    int64_t at[6];
+    bool into_dst[6];
+    size_t n = 0;
+    for (int32_t y = year - 1; y <= year + 1; y++) {
+        const int64_t t[2] = {rule_utc(&zone->start, y, zone->std_offset_s),
+                              rule_utc(&zone->end, y, zone->dst_offset_s)};
+        for (size_t k = 0; k < 2; k++) {
+            size_t j = n++;
+            for (; j > 0 && at[j - 1] > t[k]; j--) {
+                at[j] = at[j - 1];
+                into_dst[j] = into_dst[j - 1];
+            }
+            at[j] = t[k];
+            into_dst[j] = k == 0;
+        }
+    }
+    for (size_t i = n; i-- > 0;) {
+        if (at[i] <= utc) {
+            out->dst = into_dst[i];
+            out->utc_offset_s = into_dst[i] ? zone->dst_offset_s : zone->std_offset_s;
+            out->from = at[i];
+            out->until = i + 1 < n ? at[i + 1] : INT64_MAX;
+            return;
+        }
+    }
+}
+
+void local_time_convert(const local_time_period_t *period, int64_t utc, local_time_t *out)
+{
+    const int64_t local = utc + period->utc_offset_s;
+    const int32_t day = floor_div(local, 86400);
+    const int32_t sec = (int32_t)(local - (int64_t)day * 86400);
+    out->utc = utc;
+    out->utc_offset_s = period->utc_offset_s;
+    out->dst = period->dst;
+    out->day = day;
+    civil_from_days(day, &out->year, &out->month, &out->mday);
+    out->yday = (uint16_t)(day - civil_to_days(out->year, 1, 1));
+    out->wday = civil_weekday(day);
+    out->hour = (uint8_t)(sec / 3600);
+    out->minute = (uint8_t)(sec / 60 % 60);
+    out->second = (uint8_t)(sec % 60);
+}
+
+// ---- Shared clock --------------------------------------------------------------
+
+esp_err_t local_time_init(const char *tz)
+{
+    if (!s_lock) {
+        s_lock = xSemaphoreCreateMutex();
+        if (!s_lock) {
+            ESP_LOGE(TAG, "mutex alloc failed");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    local_time_zone_t zone = {0};
+    const bool ok = local_time_parse_zone(tz, &zone);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_zone = zone;
+    s_period_valid = false;
+    s_last_valid = false;
+    memset(&s_stats, 0, sizeof(s_stats));
+    xSemaphoreGive(s_lock);
+    if (!ok) {
+        ESP_LOGE(TAG, "cannot parse TZ \"%s\", using UTC", tz ? tz : "");
+        return ESP_ERR_INVALID_ARG;
+    }
+    // For anything still going through the C library.
+    setenv("TZ", tz, 1);
+    tzset();
+    ESP_LOGI(TAG, "zone %s", tz);
+    return ESP_OK;
+}
+
+void local_time_get(time_t utc, local_time_t *out)
+{
+    if (!s_lock) {
+        local_time_period_t period;
+        local_time_period(&s_zone, utc, &period);
+        local_time_convert(&period, utc, out);
+        return;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_stats.calls++;
+    if (s_last_valid && s_last.utc == (int64_t)utc) {
+        s_stats.shared++;
+    } else {
+        if (!s_period_valid || utc < s_period.from || utc >= s_period.until) {
+            local_time_period(&s_zone, utc, &s_period);
+            s_period_valid = true;
+            s_stats.transitions++;
+        }
+        local_time_convert(&s_period, utc, &s_last);
+        s_last_valid = true;
+        s_stats.conversions++;
+    }
+    *out = s_last;
+    xSemaphoreGive(s_lock);
+}
+
+void local_time_now(local_time_t *out)
+{
+    local_time_get(time(NULL), out);
+}
+
+void local_time_get_stats(local_time_stats_t *out)
+{
+    if (!s_lock) {
+        memset(out, 0, sizeof(*out));
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    *out = s_stats;
+    xSemaphoreGive(s_lock);
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Local time for the whole firmware. The POSIX TZ rule (TIMEZONE_STRING) is parsed
+// once; the UTC offset then holds until the next DST transition, so each conversion
+// is integer arithmetic on days and seconds rather than localtime_r() re-evaluating
+// the rule. Consumers asking within the same second share one result.
+
+/** When DST starts or ends in a year: one rule of the TZ string, e.g. "M3.2.0/2". */
+typedef struct {
+    char kind;       // 'M' month/week/weekday, 'J' day 1..365 without Feb 29, 'D' day 0..365
+    uint8_t month;   // 'M': 1..12
+    uint8_t week;    // 'M': 1..5, 5 being the last such weekday of the month
+    uint8_t wday;    // 'M': 0 (Sunday)..6
+    uint16_t day;    // 'J' and 'D'
+    int32_t time_s;  // Local time of day of the change, in the offset before it
+} local_time_rule_t;
+
+typedef struct {
+    int32_t std_offset_s; // Seconds east of UTC outside DST
+    int32_t dst_offset_s; // Seconds east of UTC during DST
+    bool has_dst;
+    local_time_rule_t start; // Into DST
+    local_time_rule_t end;   // Back to standard time
+} local_time_zone_t;
+
+/** The stretch of time one offset holds for. */
+typedef struct {
+    int64_t from;         // First second (UTC) it holds, INT64_MIN without DST
+    int64_t until;        // First second it no longer holds, INT64_MAX without DST
+    int32_t utc_offset_s;
+    bool dst;
+} local_time_period_t;
+
+/** Broken-down local time; the fields of struct tm that the firmware uses. */
+typedef struct {
+    int64_t utc;          // Seconds since the epoch
+    int32_t utc_offset_s; // Seconds east of UTC in effect
+    int32_t day;          // Local days since 1970-01-01
+    int32_t year;
+    uint16_t yday;        // 0..365
+    uint8_t month;        // 1..12
+    uint8_t mday;         // 1..31
+    uint8_t hour;
+    uint8_t minute;
+    uint8_t second;
+    uint8_t wday;         // 0 (Sunday)..6
+    bool dst;
+} local_time_t;
+
+/** Counts since local_time_init(). */
+typedef struct {
+    uint32_t calls;       // local_time_get()/local_time_now()
+    uint32_t shared;      // Answered from the result already made for that second
+    uint32_t conversions; // Broken down from the cached period
+    uint32_t transitions; // Period recomputed: first call, a DST change, or a clock step across one
+} local_time_stats_t;
+
+/**
+ * Parses a POSIX TZ string ("EST5EDT,M3.2.0,M11.1.0", "CET-1CEST,M3.5.0,M10.5.0/3",
+ * "<+0530>-5:30"). A DST name without rules gets the US rules, as in glibc. False
+ * on anything else.
+ */
+bool local_time_parse_zone(const char *tz, local_time_zone_t *out);
+/** The offset in effect at utc, and from when until when it holds. */
+void local_time_period(const local_time_zone_t *zone, int64_t utc, local_time_period_t *out);
+/** Breaks utc down under period, which must hold at utc. */
+void local_time_convert(const local_time_period_t *period, int64_t utc, local_time_t *out);
+
+/**
+ * Sets the zone for local_time_get()/local_time_now() and the C library's TZ.
+ * ESP_ERR_INVALID_ARG for a string that does not parse; local time is then UTC.
+ */
+esp_err_t local_time_init(const char *tz);
+/** Local time at utc. Before local_time_init(), UTC and uncached. */
+void local_time_get(time_t utc, local_time_t *out);
+/** Local time now. */
+void local_time_now(local_time_t *out);
+void local_time_get_stats(local_time_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
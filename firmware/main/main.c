@@ -4,6 +4,8 @@
 #include "nvs_flash.h"
 #include <string.h>
 
+#include "config.h"
+#include "local_time.h"
 #include "provisioning_manager.h"
 #include "power_manager.h"
 #include "time_service.h"
@@ -26,6 +28,7 @@ static void on_time_synced(void *ctx)
 {
     (void)ctx;
     ESP_LOGI(TAG, "Time sync callback fired");
+    ui_shell_resync_clock();
     power_manager_handle_rtc_alarm();
 }
 
@@ -37,26 +40,21 @@ static void on_weather_updated(const weather_data_t *data, void *ctx)
     }
 }
 
-static void on_weather_requested(void *ctx)
-{
-    (void)ctx;
-    power_manager_mark_activity();
-    weather_service_request_update();
-}
-
 static void on_network_event(network_state_t state, void *ctx)
 {
     (void)ctx;
     if (state == NETWORK_STATE_CONNECTED) {
-        ESP_LOGI(TAG, "Network connected, starting SNTP");
+        ESP_LOGI(TAG, "Network connected, starting NTP");
         ESP_ERROR_CHECK(time_service_start());
-        weather_service_request_update();
     }
+    weather_service_set_network(state == NETWORK_STATE_CONNECTED);
 }
 
 static void on_display_power_state(power_display_state_t state, void *ctx)
 {
     (void)ctx;
+    // Nobody sees the weather with the display off; the radio can stay idle.
+    weather_service_set_display_on(state != POWER_DISPLAY_OFF);
     switch (state) {
         case POWER_DISPLAY_ACTIVE:
             ui_shell_set_brightness_state(UI_BRIGHTNESS_ACTIVE);
@@ -89,14 +87,15 @@ static void on_settings_toggle(const char *toggle_id, bool enabled, void *ctx)
 void app_main(void)
 {
     ESP_LOGI(TAG, "booting SmartClockOS");
+    // Before the clock screen exists, so its first frame shows the time.
+    time_service_restore();
+    local_time_init(TIMEZONE_STRING);
 
     ESP_ERROR_CHECK(app_init_nvs());
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
 
     ui_shell_config_t ui_cfg = {
-        .weather_request_cb = on_weather_requested,
-        .weather_request_ctx = NULL,
         .settings_toggle_cb = on_settings_toggle,
         .settings_toggle_ctx = NULL,
     };
@@ -104,8 +103,10 @@ void app_main(void)
     ESP_ERROR_CHECK(ui_shell_init(&ui_cfg));
     ui_shell_update_boot_status("display", 10);
 
+    static const char *const ntp_servers[] = {NTP_SERVERS};
     time_service_config_t time_cfg = {
-        .server = "pool.ntp.org",
+        .servers = ntp_servers,
+        .server_count = sizeof(ntp_servers) / sizeof(ntp_servers[0]),
         .sync_cb = on_time_synced,
         .cb_ctx = NULL,
     };
@@ -127,6 +128,9 @@ void app_main(void)
         .deep_sleep_timeout_ms = 600000,
         .night_start_hour = 22,
         .night_end_hour = 6,
+        .night_from_sun = NIGHT_MODE_FROM_SUN,
+        .lat_e4 = WEATHER_COORD_E4(WEATHER_LAT),
+        .lon_e4 = WEATHER_COORD_E4(WEATHER_LON),
         .auto_dim_enabled = true,
         .deep_sleep_enabled = true,
         .display_cb = on_display_power_state,
@@ -0,0 +1,251 @@
+#include "ntp_client.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "lwip/netdb.h"
+#include "lwip/sockets.h"
+#include <errno.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+static const char *TAG = "ntp_client";
+
+#define NTP_PORT "123"
+#define NTP_PACKET_SIZE 48
+#define NTP_UNIX_OFFSET 2208988800LL // 1900-01-01 to 1970-01-01, seconds
+#define NTP_MODE_SERVER 4
+#define NTP_LEAP_UNSYNCED 3
+#define NTP_STRATUM_MAX 15
+// Floor on a sample's distance: timestamp resolution and scheduling jitter on our
+// side, so two good servers on a fast network still overlap.
+#define NTP_MIN_DISTANCE_US 1000
+#define NTP_MAX_SERVERS 8
+
+static int64_t now_us(void)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    return (int64_t)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+static uint32_t get_u32(const uint8_t *p)
+{
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static void put_u32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void put_timestamp(uint8_t *p, int64_t unix_us)
+{
+    put_u32(p, (uint32_t)(unix_us / 1000000 + NTP_UNIX_OFFSET));
+    put_u32(p + 4, (uint32_t)(((uint64_t)(unix_us % 1000000) << 32) / 1000000));
+}
+
+// Seconds with the top bit clear are era 1 (from 2036-02-07), per RFC 4330.
+static int64_t get_timestamp(const uint8_t *p)
+{
+    int64_t sec = get_u32(p);
+    if (sec < 0x80000000LL) {
+        sec += 0x100000000LL;
+    }
+    return (sec - NTP_UNIX_OFFSET) * 1000000 + (int64_t)(((uint64_t)get_u32(p + 4) * 1000000) >> 32);
+}
+
+// 16.16 fixed-point seconds to microseconds.
+static int32_t short_us(const uint8_t *p)
+{
+    return (int32_t)(((uint64_t)get_u32(p) * 1000000) >> 16);
+}
+
+static bool parse_reply(const char *server, const uint8_t *reply, size_t len, const uint8_t *origin, int64_t t1,
+                        int64_t t4, ntp_sample_t *out)
+{
+    if (len < NTP_PACKET_SIZE || (reply[0] & 0x07) != NTP_MODE_SERVER || memcmp(reply + 24, origin, 8) != 0) {
+        ESP_LOGW(TAG, "%s: not a reply to our request", server);
+        return false;
+    }
+    const uint8_t stratum = reply[1];
+    if (stratum == 0) {
+        ESP_LOGW(TAG, "%s: kiss-o'-death %.4s", server, (const char *)reply + 12);
+        return false;
+    }
+    if (reply[0] >> 6 == NTP_LEAP_UNSYNCED || stratum > NTP_STRATUM_MAX) {
+        ESP_LOGW(TAG, "%s: server not synchronised", server);
+        return false;
+    }
+
+    const int64_t t2 = get_timestamp(reply + 32);
+    const int64_t t3 = get_timestamp(reply + 40);
+    int64_t delay = (t4 - t1) - (t3 - t2);
+    if (delay < 0) {
+        delay = 0;
+    }
+    const int64_t distance = delay / 2 + short_us(reply + 4) / 2 + short_us(reply + 8);
+    out->offset_us = ((t2 - t1) + (t3 - t4)) / 2;
+    out->delay_us = delay > INT32_MAX ? INT32_MAX : (int32_t)delay;
+    out->distance_us = distance < NTP_MIN_DISTANCE_US ? NTP_MIN_DISTANCE_US
+                       : distance > INT32_MAX          ? INT32_MAX
+                                                       : (int32_t)distance;
+    out->valid = true;
+    return true;
+}
+
+// Connected UDP socket to server, or -1.
+static int open_server(const char *server)
+{
+    const struct addrinfo hints = {.ai_family = AF_INET, .ai_socktype = SOCK_DGRAM};
+    struct addrinfo *res = NULL;
+    if (getaddrinfo(server, NTP_PORT, &hints, &res) != 0 || !res) {
+        ESP_LOGW(TAG, "%s: lookup failed", server);
+        return -1;
+    }
+    int fd = socket(res->ai_family, res->ai_socktype, res->ai_protocol);
+    if (fd >= 0 && connect(fd, res->ai_addr, res->ai_addrlen) != 0) {
+        close(fd);
+        fd = -1;
+    }
+    freeaddrinfo(res);
+    if (fd < 0) {
+        ESP_LOGW(TAG, "%s: socket failed", server);
+    }
+    return fd;
+}
+
+size_t ntp_client_query(const char *const *servers, size_t count, uint32_t timeout_ms, ntp_sample_t *samples)
+{
+    int fds[NTP_MAX_SERVERS];
+    int64_t sent_us[NTP_MAX_SERVERS];
+    uint8_t origin[NTP_MAX_SERVERS][8];
+    if (count > NTP_MAX_SERVERS) {
+        count = NTP_MAX_SERVERS;
+    }
+
+    // Lookups first, so a slow resolver does not count against anyone's round trip.
+    for (size_t i = 0; i < count; i++) {
+        memset(&samples[i], 0, sizeof(samples[i]));
+        fds[i] = open_server(servers[i]);
+    }
+    size_t waiting = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (fds[i] < 0) {
+            continue;
+        }
+        uint8_t request[NTP_PACKET_SIZE] = {0};
+        request[0] = 4 << 3 | 3; // Version 4, client
+        sent_us[i] = now_us();
+        put_timestamp(request + 40, sent_us[i]);
+        memcpy(origin[i], request + 40, 8);
+        if (send(fds[i], request, sizeof(request), 0) != (ssize_t)sizeof(request)) {
+            ESP_LOGW(TAG, "%s: send failed", servers[i]);
+            close(fds[i]);
+            fds[i] = -1;
+            continue;
+        }
+        waiting++;
+    }
+
+    size_t answered = 0;
+    bool select_failed = false;
+    const int64_t deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+    while (waiting > 0) {
+        const int64_t left_us = deadline_us - esp_timer_get_time();
+        if (left_us <= 0) {
+            break;
+        }
+        fd_set readable;
+        FD_ZERO(&readable);
+        int max_fd = -1;
+        for (size_t i = 0; i < count; i++) {
+            if (fds[i] >= 0) {
+                FD_SET(fds[i], &readable);
+                max_fd = fds[i] > max_fd ? fds[i] : max_fd;
+            }
+        }
+        struct timeval tv = {.tv_sec = (time_t)(left_us / 1000000), .tv_usec = (suseconds_t)(left_us % 1000000)};
+        const int ready = select(max_fd + 1, &readable, NULL, NULL, &tv);
+        if (ready < 0) {
+            // Retrying would spin until the deadline; whoever has not answered yet won't.
+            ESP_LOGW(TAG, "select failed: errno %d", errno);
+            select_failed = true;
+            break;
+        }
+        if (ready == 0) {
+            continue;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (fds[i] < 0 || !FD_ISSET(fds[i], &readable)) {
+                continue;
+            }
+            uint8_t reply[NTP_PACKET_SIZE + 20];
+            const ssize_t len = recv(fds[i], reply, sizeof(reply), 0);
+            const int64_t received_us = now_us();
+            if (len > 0 && parse_reply(servers[i], reply, (size_t)len, origin[i], sent_us[i], received_us,
+                                       &samples[i])) {
+                answered++;
+            }
+            close(fds[i]);
+            fds[i] = -1;
+            waiting--;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (fds[i] >= 0) {
+            if (!select_failed) {
+                ESP_LOGW(TAG, "%s: no reply in %u ms", servers[i], (unsigned)timeout_ms);
+            }
+            close(fds[i]);
+        }
+    }
+    return answered;
+}
+
+static bool contains(const ntp_sample_t *s, int64_t offset_us)
+{
+    return s->valid && offset_us >= s->offset_us - s->distance_us && offset_us <= s->offset_us + s->distance_us;
+}
+
+int ntp_client_select(const ntp_sample_t *samples, size_t count, size_t *falsetickers)
+{
+    // The intervals' overlap is deepest at one of their lower ends; with a handful of
+    // servers, trying each is simpler than sorting endpoints.
+    size_t valid = 0;
+    size_t best_votes = 0;
+    int64_t best_point = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (!samples[i].valid) {
+            continue;
+        }
+        valid++;
+        const int64_t point = samples[i].offset_us - samples[i].distance_us;
+        size_t votes = 0;
+        for (size_t j = 0; j < count; j++) {
+            votes += contains(&samples[j], point) ? 1 : 0;
+        }
+        if (votes > best_votes) {
+            best_votes = votes;
+            best_point = point;
+        }
+    }
+    const bool majority = best_votes * 2 > valid;
+    if (falsetickers) {
+        *falsetickers = majority ? valid - best_votes : valid;
+    }
+    if (!majority) {
+        return -1;
+    }
+
+    int best = -1;
+    for (size_t i = 0; i < count; i++) {
+        if (contains(&samples[i], best_point) && (best < 0 || samples[i].delay_us < samples[best].delay_us)) {
+            best = (int)i;
+        }
+    }
+    return best;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Minimal (S)NTP client: one request per server per round, all in flight at once,
+// and the clock selection that picks which reply to believe.
+
+typedef struct {
+    bool valid;          // A usable reply arrived in time
+    int64_t offset_us;   // Server time minus the local clock
+    int32_t delay_us;    // Round trip, less the time the server held the request
+    int32_t distance_us; // The true offset is within this of offset_us: half the
+                         // delay plus the server's own distance from its reference
+} ntp_sample_t;
+
+/**
+ * Resolves every server, sends each one request and collects replies until all have
+ * answered or timeout_ms has passed. samples[i] is servers[i]'s reply; returns the
+ * number of valid ones. Kiss-o'-death and unsynchronised replies are not valid.
+ */
+size_t ntp_client_query(const char *const *servers, size_t count, uint32_t timeout_ms, ntp_sample_t *samples);
+
+/**
+ * Clock selection over one round (Marzullo's algorithm): each valid sample says the
+ * true offset lies within offset_us +/- distance_us. Samples that share the point
+ * most of them agree on are truechimers, the rest falsetickers; of the truechimers,
+ * the one with the shortest round trip wins. Returns its index, or -1 when no
+ * majority agrees. falsetickers, when not NULL, receives how many valid samples were
+ * rejected: all of them when there is no majority.
+ */
+int ntp_client_select(const ntp_sample_t *samples, size_t count, size_t *falsetickers);
+
+#ifdef __cplusplus
+}
+#endif
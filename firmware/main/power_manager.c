@@ -1,4 +1,7 @@
 #include "power_manager.h"
+#include "forecast_store.h"
+#include "local_time.h"
+#include "solar.h"
 
 #include "esp_log.h"
 #include "esp_sleep.h"
@@ -15,25 +18,44 @@ typedef struct {
     power_display_state_t display_state;
     bool auto_dim_enabled;
     bool deep_sleep_enabled;
+    solar_cache_t sun;
 } power_manager_ctx_t;
 
 static power_manager_ctx_t s_ctx = {0};
 
+// Dusk to dawn, computed locally once a day. False when the sun gives no answer:
+// with no civil twilight that day (far north or south) the fixed hours apply.
+static bool sun_night(const local_time_t *now, bool *night)
+{
+    solar_day_t sun;
+    solar_today(&s_ctx.sun, s_ctx.config.lat_e4, s_ctx.config.lon_e4, now->utc_offset_s, (time_t)now->utc, &sun);
+    if (sun.dawn == FORECAST_MINUTE_NONE || sun.dusk == FORECAST_MINUTE_NONE) {
+        return false;
+    }
+    const int minute = now->hour * 60 + now->minute;
+    *night = sun.dawn < sun.dusk ? minute < sun.dawn || minute >= sun.dusk : minute >= sun.dusk && minute < sun.dawn;
+    return true;
+}
+
 static bool is_night_time(int start_hour, int end_hour)
 {
-    time_t now = time(NULL);
-    struct tm info = {0};
-    localtime_r(&now, &info);
+    local_time_t now;
+    local_time_now(&now);
+
+    bool night;
+    if (s_ctx.config.night_from_sun && sun_night(&now, &night)) {
+        return night;
+    }
 
     if (start_hour == end_hour) {
         return false;
     }
 
     if (start_hour < end_hour) {
-        return info.tm_hour >= start_hour && info.tm_hour < end_hour;
+        return now.hour >= start_hour && now.hour < end_hour;
     }
 
-    return info.tm_hour >= start_hour || info.tm_hour < end_hour;
+    return now.hour >= start_hour || now.hour < end_hour;
 }
 
 static void update_display_state(power_display_state_t next_state)
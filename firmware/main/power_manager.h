@@ -2,6 +2,7 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,6 +22,9 @@ typedef struct {
     uint32_t deep_sleep_timeout_ms;
     int night_start_hour;
     int night_end_hour;
+    bool night_from_sun; // Night runs from civil dusk to dawn at lat/lon instead of the hours above
+    int32_t lat_e4;      // Ten-thousandths of a degree
+    int32_t lon_e4;
     bool auto_dim_enabled;
     bool deep_sleep_enabled;
     power_display_cb_t display_cb;
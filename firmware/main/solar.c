@@ -0,0 +1,180 @@
+#include "solar.h"
+#include "civil_date.h"
+#include "forecast_store.h"
+
+// Angles are binary: a full turn is 2^32, so they wrap for free. Sines and cosines
+// are Q30. Real constants are folded to integers at compile time.
+#define Q30_ONE (1 << 30)
+#define Q30(x) ((int32_t)((x) * 1073741824.0 + ((x) < 0 ? -0.5 : 0.5)))
+#define QUARTER_TURN (1u << 30)
+#define HALF_TURN (1u << 31)
+
+// Zenith angles of the events: sunrise/sunset allow for refraction and the solar
+// disc, civil twilight is 6 degrees below the horizon.
+#define SUNRISE_ZENITH_E4 908330
+#define CIVIL_ZENITH_E4 960000
+
+static int32_t q30_mul(int32_t a, int32_t b)
+{
+    return (int32_t)(((int64_t)a * b) / Q30_ONE);
+}
+
+// Ten-thousandths of a degree to a binary angle.
+static uint32_t angle_from_e4(int32_t deg_e4)
+{
+    return (uint32_t)(((int64_t)deg_e4 * 4294967296LL) / 3600000);
+}
+
+// Taylor series on [0, pi/4] (x in Q30 radians); the error there is below 1e-6.
+static int32_t poly_sin(int32_t x)
+{
+    const int32_t x2 = q30_mul(x, x);
+    int32_t t = Q30_ONE - x2 / 42;
+    t = Q30_ONE - q30_mul(x2, t) / 20;
+    t = Q30_ONE - q30_mul(x2, t) / 6;
+    return q30_mul(x, t);
+}
+
+static int32_t poly_cos(int32_t x)
+{
+    const int32_t x2 = q30_mul(x, x);
+    int32_t t = Q30_ONE - x2 / 56;
+    t = Q30_ONE - q30_mul(x2, t) / 30;
+    t = Q30_ONE - q30_mul(x2, t) / 12;
+    return Q30_ONE - q30_mul(x2, t) / 2;
+}
+
+// Sine over a quarter turn, a in [0, QUARTER_TURN]; the upper half folds onto cosine.
+static int32_t sin_quarter(uint32_t a)
+{
+    if (a <= QUARTER_TURN / 2) {
+        return poly_sin(q30_mul((int32_t)a, Q30(1.5707963267948966)));
+    }
+    return poly_cos(q30_mul((int32_t)(QUARTER_TURN - a), Q30(1.5707963267948966)));
+}
+
+static int32_t sin_q30(uint32_t a)
+{
+    const uint32_t f = a & (QUARTER_TURN - 1);
+    switch (a >> 30) {
+    case 0:
+        return sin_quarter(f);
+    case 1:
+        return sin_quarter(QUARTER_TURN - f);
+    case 2:
+        return -sin_quarter(f);
+    default:
+        return -sin_quarter(QUARTER_TURN - f);
+    }
+}
+
+static int32_t cos_q30(uint32_t a)
+{
+    return sin_q30(a + QUARTER_TURN);
+}
+
+// Angle in [0, HALF_TURN] whose cosine is c, by bisection: cosine falls over that
+// range. Runs once per event per day, so speed does not matter.
+static uint32_t acos_q30(int32_t c)
+{
+    uint32_t lo = 0;
+    uint32_t hi = HALF_TURN;
+    while (hi - lo > 256) {
+        const uint32_t mid = lo + (hi - lo) / 2;
+        if (cos_q30(mid) > c) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo + (hi - lo) / 2;
+}
+
+static int32_t floor_div(int64_t a, int32_t b)
+{
+    return (int32_t)(a >= 0 ? a / b : -((-a + b - 1) / b));
+}
+
+// Seconds after local midnight, rounded to the minute and wrapped into the day.
+static uint16_t local_minute(int64_t local_s)
+{
+    const int32_t minute = floor_div(local_s + 30, 60) % 1440;
+    return (uint16_t)(minute < 0 ? minute + 1440 : minute);
+}
+
+// Half the time the sun spends above the zenith angle, in seconds; -1 when it stays
+// on one side of it all day.
+static int32_t half_arc_s(int32_t cos_zenith, int32_t sin_lat, int32_t cos_lat, int32_t sin_decl, int32_t cos_decl)
+{
+    const int32_t num = cos_zenith - q30_mul(sin_lat, sin_decl);
+    const int32_t den = q30_mul(cos_lat, cos_decl);
+    if (den <= 0 || num >= den || num <= -den) {
+        return -1;
+    }
+    const uint32_t ha = acos_q30((int32_t)(((int64_t)num * Q30_ONE) / den));
+    return (int32_t)(((uint64_t)ha * 86400) >> 32);
+}
+
+void solar_compute(int32_t lat_e4, int32_t lon_e4, int32_t day, int32_t utc_offset_s, solar_day_t *out)
+{
+    out->dawn = FORECAST_MINUTE_NONE;
+    out->sunrise = FORECAST_MINUTE_NONE;
+    out->sunset = FORECAST_MINUTE_NONE;
+    out->dusk = FORECAST_MINUTE_NONE;
+
+    // Fractional year at the location's solar noon.
+    int32_t year;
+    uint8_t month;
+    uint8_t mday;
+    civil_from_days(day, &year, &month, &mday);
+    const int32_t jan1 = civil_to_days(year, 1, 1);
+    const int32_t days_in_year = civil_is_leap(year) ? 366 : 365;
+    const int64_t frac_e4 = (int64_t)(day - jan1) * 3600000 - lon_e4;
+    const uint32_t g = (uint32_t)((frac_e4 * 4294967296LL) / ((int64_t)days_in_year * 3600000));
+    const int32_t s1 = sin_q30(g), c1 = cos_q30(g);
+    const int32_t s2 = sin_q30(2 * g), c2 = cos_q30(2 * g);
+    const int32_t s3 = sin_q30(3 * g), c3 = cos_q30(3 * g);
+
+    // Equation of time in seconds and declination in radians (Q30).
+    const int32_t eq = Q30(0.000075) + q30_mul(Q30(0.001868), c1) - q30_mul(Q30(0.032077), s1) -
+                       q30_mul(Q30(0.014615), c2) - q30_mul(Q30(0.040849), s2);
+    const int32_t eq_s = (int32_t)(((int64_t)eq * 137508) / (10LL * Q30_ONE)); // 229.18 min
+    const int32_t decl = Q30(0.006918) - q30_mul(Q30(0.399912), c1) + q30_mul(Q30(0.070257), s1) -
+                         q30_mul(Q30(0.006758), c2) + q30_mul(Q30(0.000907), s2) -
+                         q30_mul(Q30(0.002697), c3) + q30_mul(Q30(0.00148), s3);
+    const uint32_t decl_angle = (uint32_t)q30_mul(decl, Q30(0.6366197723675814)); // 2^32 / 2pi
+
+    const uint32_t lat = angle_from_e4(lat_e4);
+    const int32_t sin_lat = sin_q30(lat), cos_lat = cos_q30(lat);
+    const int32_t sin_decl = sin_q30(decl_angle), cos_decl = cos_q30(decl_angle);
+
+    // Local solar noon, seconds after local midnight: 4 minutes per degree west.
+    const int64_t noon_s = 43200 - ((int64_t)lon_e4 * 3) / 125 - eq_s + utc_offset_s;
+
+    const int32_t rise = half_arc_s(cos_q30(angle_from_e4(SUNRISE_ZENITH_E4)), sin_lat, cos_lat, sin_decl, cos_decl);
+    if (rise >= 0) {
+        out->sunrise = local_minute(noon_s - rise);
+        out->sunset = local_minute(noon_s + rise);
+    }
+    const int32_t civil = half_arc_s(cos_q30(angle_from_e4(CIVIL_ZENITH_E4)), sin_lat, cos_lat, sin_decl, cos_decl);
+    if (civil >= 0) {
+        out->dawn = local_minute(noon_s - civil);
+        out->dusk = local_minute(noon_s + civil);
+    }
+}
+
+void solar_today(solar_cache_t *cache, int32_t lat_e4, int32_t lon_e4, int32_t utc_offset_s, time_t now,
+                 solar_day_t *out)
+{
+    const int32_t day = floor_div((int64_t)now + utc_offset_s, 86400);
+    if (!cache->valid || cache->day != day || cache->utc_offset_s != utc_offset_s || cache->lat_e4 != lat_e4 ||
+        cache->lon_e4 != lon_e4) {
+        solar_compute(lat_e4, lon_e4, day, utc_offset_s, &cache->times);
+        cache->valid = true;
+        cache->day = day;
+        cache->utc_offset_s = utc_offset_s;
+        cache->lat_e4 = lat_e4;
+        cache->lon_e4 = lon_e4;
+    }
+    *out = cache->times;
+}
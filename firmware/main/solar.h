@@ -0,0 +1,46 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sunrise, sunset and civil twilight from coordinates and the date, so they need no
+// network. NOAA's low-precision solar position (Fourier series for the equation of
+// time and declination) in integer fixed point: the ESP32 has no double FPU. Within
+// a minute or two of the full algorithm outside the polar circles.
+
+/** Times of one local day, as local minutes of the day; FORECAST_MINUTE_NONE when
+ *  the event does not happen that day (polar night, midnight sun, white nights). */
+typedef struct {
+    uint16_t dawn; // Civil twilight begins: sun 6 degrees below the horizon
+    uint16_t sunrise;
+    uint16_t sunset;
+    uint16_t dusk; // Civil twilight ends
+} solar_day_t;
+
+/** Last result of solar_today(), recomputed when the local day or inputs change. */
+typedef struct {
+    bool valid;
+    int32_t day;
+    int32_t utc_offset_s;
+    int32_t lat_e4;
+    int32_t lon_e4;
+    solar_day_t times;
+} solar_cache_t;
+
+/**
+ * Times at lat_e4/lon_e4 (ten-thousandths of a degree, east positive) on local day
+ * `day` (days since 1970-01-01), in a zone utc_offset_s seconds east of UTC.
+ */
+void solar_compute(int32_t lat_e4, int32_t lon_e4, int32_t day, int32_t utc_offset_s, solar_day_t *out);
+/** Today's times at now, computed at most once per local day per cache. */
+void solar_today(solar_cache_t *cache, int32_t lat_e4, int32_t lon_e4, int32_t utc_offset_s, time_t now,
+                 solar_day_t *out);
+
+#ifdef __cplusplus
+}
+#endif
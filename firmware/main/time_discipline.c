@@ -0,0 +1,119 @@
+#include "time_discipline.h"
+#include "config.h"
+
+#include <string.h>
+
+// Drift intervals that must agree before the resync interval is stretched.
+#define STABLE_MIN_INTERVALS 3
+
+static int64_t abs64(int64_t v)
+{
+    return v < 0 ? -v : v;
+}
+
+void time_discipline_init(time_discipline_t *d)
+{
+    memset(d, 0, sizeof(*d));
+    d->interval_s = TIME_SYNC_INTERVAL_MIN_SEC;
+}
+
+const time_sample_t *time_discipline_last(const time_discipline_t *d)
+{
+    if (d->count == 0) {
+        return NULL;
+    }
+    return &d->samples[(d->head + TIME_DISCIPLINE_SAMPLES - 1) % TIME_DISCIPLINE_SAMPLES];
+}
+
+// Median of the drift intervals held, and how far the furthest one is from it. The
+// median shrugs off one bad sample (a delayed reply) where a mean would not.
+static uint8_t drift_median(const time_discipline_t *d, int32_t *median, int32_t *spread)
+{
+    int32_t v[TIME_DISCIPLINE_SAMPLES];
+    uint8_t n = 0;
+    for (uint8_t i = 0; i < d->count; i++) {
+        if (!d->samples[i].has_drift) {
+            continue;
+        }
+        int32_t x = d->samples[i].drift_ppb;
+        uint8_t j = n++;
+        for (; j > 0 && v[j - 1] > x; j--) {
+            v[j] = v[j - 1];
+        }
+        v[j] = x;
+    }
+    if (n == 0) {
+        return 0;
+    }
+    *median = n % 2 ? v[n / 2] : (int32_t)(((int64_t)v[n / 2 - 1] + v[n / 2]) / 2);
+    *spread = 0;
+    for (uint8_t i = 0; i < n; i++) {
+        const int32_t dev = (int32_t)abs64((int64_t)v[i] - *median);
+        if (dev > *spread) {
+            *spread = dev;
+        }
+    }
+    return n;
+}
+
+time_correction_t time_discipline_add(time_discipline_t *d, int64_t uptime_us, int64_t offset_us, int32_t rtt_us,
+                                      bool clock_valid)
+{
+    const time_sample_t *prev = time_discipline_last(d);
+    const bool step = !clock_valid || abs64(offset_us) > (int64_t)TIME_SLEW_MAX_MS * 1000;
+
+    time_sample_t s = {.uptime_us = uptime_us, .offset_us = offset_us, .rtt_us = rtt_us};
+    // The previous sync left the clock right, so what it is off by now built up since.
+    const int64_t elapsed_us = prev ? uptime_us - prev->uptime_us : 0;
+    if (!step && elapsed_us >= 1000000) {
+        s.drift_ppb = (int32_t)(-offset_us * 1000000000 / elapsed_us);
+        s.has_drift = true;
+    }
+    d->samples[d->head] = s;
+    d->head = (uint8_t)((d->head + 1) % TIME_DISCIPLINE_SAMPLES);
+    if (d->count < TIME_DISCIPLINE_SAMPLES) {
+        d->count++;
+    }
+
+    int32_t median = 0;
+    int32_t spread = 0;
+    const uint8_t n = drift_median(d, &median, &spread);
+    d->drift_ppb = median;
+    d->drift_stable = !step && n >= STABLE_MIN_INTERVALS && spread <= (int32_t)TIME_DRIFT_STABLE_PPM * 1000;
+
+    uint64_t next;
+    if (d->drift_stable) {
+        // Long enough for the drift to build up TIME_SYNC_MAX_ERROR_MS, but at most
+        // twice the last interval so one lucky run of samples cannot jump to the cap.
+        const uint64_t rate = (uint64_t)abs64(median);
+        next = rate ? (uint64_t)TIME_SYNC_MAX_ERROR_MS * 1000000 / rate : TIME_SYNC_INTERVAL_MAX_SEC;
+        if (next > 2ull * d->interval_s) {
+            next = 2ull * d->interval_s;
+        }
+    } else {
+        next = step ? 0 : d->interval_s / 2;
+    }
+    if (next > TIME_SYNC_INTERVAL_MAX_SEC) {
+        next = TIME_SYNC_INTERVAL_MAX_SEC;
+    }
+    if (next < TIME_SYNC_INTERVAL_MIN_SEC) {
+        next = TIME_SYNC_INTERVAL_MIN_SEC;
+    }
+    d->interval_s = (uint32_t)next;
+    d->retry_s = 0;
+    return step ? TIME_CORRECTION_STEP : TIME_CORRECTION_SLEW;
+}
+
+uint32_t time_discipline_failed(time_discipline_t *d, bool clock_valid)
+{
+    if (clock_valid) {
+        return TIME_SYNC_INTERVAL_MIN_SEC;
+    }
+    // Nothing to show until the first sync: try again soon, backing off so a network
+    // that is not up yet is not polled every few seconds for long.
+    d->retry_s = d->retry_s ? d->retry_s * 2 : TIME_SYNC_RETRY_FIRST_SEC;
+    if (d->retry_s > TIME_SYNC_INTERVAL_MIN_SEC) {
+        d->retry_s = TIME_SYNC_INTERVAL_MIN_SEC;
+    }
+    return d->retry_s;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Clock discipline for the time service: keeps the offset history of recent SNTP
+// syncs, estimates the crystal's drift from it, chooses between slewing and stepping
+// each correction, and stretches the resync interval while the drift holds steady.
+// Pure bookkeeping on the caller's samples, so the policy can be checked on the host.
+
+#define TIME_DISCIPLINE_SAMPLES 8
+#define TIME_RTT_UNKNOWN (-1)
+
+typedef struct {
+    int64_t uptime_us; // esp_timer time of the sync
+    int64_t offset_us; // Server time minus the local clock, before the correction
+    int32_t rtt_us;    // Round trip less the server's hold time, TIME_RTT_UNKNOWN if not measured
+    int32_t drift_ppb; // Drift since the previous sample
+    bool has_drift;    // False for the first sample and after a step
+} time_sample_t;
+
+typedef enum {
+    TIME_CORRECTION_SLEW = 0, // adjtime(): the clock runs slightly fast or slow until corrected
+    TIME_CORRECTION_STEP,     // settimeofday(): the clock jumps
+} time_correction_t;
+
+typedef struct {
+    time_sample_t samples[TIME_DISCIPLINE_SAMPLES]; // Ring, oldest overwritten
+    uint8_t count;
+    uint8_t head;        // Next slot to write
+    int32_t drift_ppb;   // Estimate, positive when the local clock runs fast
+    bool drift_stable;   // Recent intervals agree on the drift
+    uint32_t interval_s; // Until the next sync
+    uint32_t retry_s;    // Last backoff while the clock is unset, 0 once a sync succeeds
+} time_discipline_t;
+
+void time_discipline_init(time_discipline_t *d);
+/**
+ * Records a sync and returns how to apply it. offset_us must already exclude any
+ * slew still outstanding from the previous correction. The first sync and offsets
+ * over TIME_SLEW_MAX_MS step the clock and start a fresh drift interval.
+ */
+time_correction_t time_discipline_add(time_discipline_t *d, int64_t uptime_us, int64_t offset_us, int32_t rtt_us,
+                                      bool clock_valid);
+/**
+ * Records a round that produced no sample and returns the seconds until the next.
+ * While the clock is unset that starts at TIME_SYNC_RETRY_FIRST_SEC and doubles up
+ * to TIME_SYNC_INTERVAL_MIN_SEC; with a valid clock it is TIME_SYNC_INTERVAL_MIN_SEC.
+ */
+uint32_t time_discipline_failed(time_discipline_t *d, bool clock_valid);
+/** Most recent sample, NULL before the first. */
+const time_sample_t *time_discipline_last(const time_discipline_t *d);
+
+#ifdef __cplusplus
+}
+#endif
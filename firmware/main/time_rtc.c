@@ -0,0 +1,46 @@
+#include "time_rtc.h"
+
+// Shorter sleeps measure the RTC rate no better than the NTP offset's own noise.
+#define LEARN_MIN_ELAPSED_US (60LL * 1000000)
+// The RC slow clock is calibrated to a few percent; anything beyond is a bad sample.
+#define RTC_DRIFT_MAX_PPB 50000000
+
+void time_rtc_save(time_rtc_state_t *st, int64_t unix_us, uint64_t rtc_us, int32_t drift_ppb, bool synced)
+{
+    if (st->magic != TIME_RTC_MAGIC) {
+        st->rtc_drift_ppb = 0;
+        st->last_sync_unix_us = 0;
+    }
+    st->anchor_unix_us = unix_us;
+    st->anchor_rtc_us = rtc_us;
+    st->drift_ppb = drift_ppb;
+    if (synced) {
+        st->last_sync_unix_us = unix_us;
+    }
+    st->magic = TIME_RTC_MAGIC;
+}
+
+bool time_rtc_restore(const time_rtc_state_t *st, uint64_t rtc_us, int64_t *unix_us)
+{
+    if (st->magic != TIME_RTC_MAGIC || rtc_us < st->anchor_rtc_us) {
+        return false;
+    }
+    const int64_t elapsed_us = (int64_t)(rtc_us - st->anchor_rtc_us);
+    *unix_us = st->anchor_unix_us + elapsed_us - elapsed_us / 1000 * st->rtc_drift_ppb / 1000000;
+    return true;
+}
+
+void time_rtc_learn(time_rtc_state_t *st, uint64_t rtc_elapsed_us, int64_t offset_us)
+{
+    if (st->magic != TIME_RTC_MAGIC || rtc_elapsed_us < (uint64_t)LEARN_MIN_ELAPSED_US) {
+        return;
+    }
+    // Behind the server means the ticks counted too few: the timer runs slow.
+    int64_t drift = st->rtc_drift_ppb - offset_us * 1000000 / (int64_t)(rtc_elapsed_us / 1000);
+    if (drift > RTC_DRIFT_MAX_PPB) {
+        drift = RTC_DRIFT_MAX_PPB;
+    } else if (drift < -RTC_DRIFT_MAX_PPB) {
+        drift = -RTC_DRIFT_MAX_PPB;
+    }
+    st->rtc_drift_ppb = (int32_t)drift;
+}
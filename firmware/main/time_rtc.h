@@ -0,0 +1,45 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// What the time service keeps in RTC slow memory so a wake from deep sleep can put
+// the wall clock right before anything is drawn: the wall clock at one moment (an
+// anchor) with the RTC timer reading at that moment, and how fast the RTC timer
+// runs. The RTC timer keeps counting through deep sleep, so the anchor plus the
+// ticks since, less their drift, is the time now. Pure bookkeeping; the caller
+// reads the clocks and places the state.
+
+#define TIME_RTC_MAGIC 0x54494d45u // "TIME"
+
+typedef struct {
+    uint32_t magic;           // TIME_RTC_MAGIC once an anchor was saved
+    int64_t anchor_unix_us;   // Wall clock at the anchor
+    uint64_t anchor_rtc_us;   // RTC timer at the anchor
+    int64_t last_sync_unix_us; // Wall clock of the last NTP sync
+    int32_t drift_ppb;        // Crystal drift from the discipline, while awake
+    int32_t rtc_drift_ppb;    // RTC timer rate error, positive when fast; learned
+                              // from the error found by the first sync after a wake
+} time_rtc_state_t;
+
+/** Records an anchor; synced marks it as an NTP sync rather than a save at sleep. */
+void time_rtc_save(time_rtc_state_t *st, int64_t unix_us, uint64_t rtc_us, int32_t drift_ppb, bool synced);
+/**
+ * Wall clock now, from the anchor and the RTC timer's rtc_us. False without an
+ * anchor, or when the RTC timer restarted since (power loss).
+ */
+bool time_rtc_restore(const time_rtc_state_t *st, uint64_t rtc_us, int64_t *unix_us);
+/**
+ * The first sync after a restore found the restored clock offset_us behind the
+ * server after rtc_elapsed_us of RTC time since the anchor: folds the rate error
+ * into rtc_drift_ppb. Ignored for spans too short to tell drift from noise.
+ */
+void time_rtc_learn(time_rtc_state_t *st, uint64_t rtc_elapsed_us, int64_t offset_us);
+
+#ifdef __cplusplus
+}
+#endif
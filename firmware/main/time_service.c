@@ -1,51 +1,275 @@
 #include "time_service.h"
+#include "config.h"
+#include "fmt.h"
+#include "ntp_client.h"
+#include "time_discipline.h"
+#include "time_rtc.h"
 
+#include "esp_attr.h"
+#include "esp_check.h"
 #include "esp_log.h"
-#include "esp_netif_sntp.h"
-#include "esp_sntp.h"
+#include "esp_private/esp_clk.h"
+#include "esp_sleep.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include <stdbool.h>
 #include <sys/time.h>
 
 static const char *TAG = "time_service";
 
 static time_service_config_t s_config = {0};
+static const char *s_servers[TIME_SERVER_MAX];
 static bool s_started = false;
+static TaskHandle_t s_task = NULL;
+static SemaphoreHandle_t s_lock = NULL; // Guards s_stats
+static time_discipline_t s_discipline;
+static time_service_stats_t s_stats = {0};
+// Survives deep sleep (not power loss); anchored at every sync and on entering sleep.
+static RTC_DATA_ATTR time_rtc_state_t s_rtc;
+static bool s_clock_trusted = false;  // Synced or restored since boot: worth anchoring
+static uint64_t s_restored_rtc_us = 0; // RTC timer when the clock was restored, 0 if it was not
 
-static void time_sync_notification(struct timeval *tv)
+static int64_t timeval_us(const struct timeval *tv)
 {
-    (void)tv;
-    ESP_LOGI(TAG, "Time synchronized");
+    return (int64_t)tv->tv_sec * 1000000 + tv->tv_usec;
+}
+
+static struct timeval timeval_from_us(int64_t us)
+{
+    struct timeval tv = {.tv_sec = (time_t)(us / 1000000), .tv_usec = (suseconds_t)(us % 1000000)};
+    return tv;
+}
+
+// "offset -1.234 ms (slewed) from pool.ntp.org, rtt 23.456 ms, drift 12.345 ppm
+// steady, next sync in 1800 s"
+static void log_sync(const time_service_stats_t *st, time_correction_t how)
+{
+    char line[160];
+    fmt_buf_t f;
+    fmt_init(&f, line, sizeof(line));
+    const int64_t offset_us = st->last_offset_us;
+    fmt_str(&f, "offset ");
+    fmt_fixed(&f, offset_us > INT32_MAX ? INT32_MAX : offset_us < -INT32_MAX ? -INT32_MAX : (int32_t)offset_us, 3);
+    fmt_str(&f, how == TIME_CORRECTION_STEP ? " ms (stepped) from " : " ms (slewed) from ");
+    fmt_str(&f, s_servers[st->last_server]);
+    fmt_str(&f, ", rtt ");
+    fmt_fixed(&f, st->last_rtt_us, 3);
+    fmt_str(&f, " ms, drift ");
+    fmt_fixed(&f, st->drift_ppb, 3);
+    fmt_str(&f, st->drift_stable ? " ppm steady, next sync in " : " ppm settling, next sync in ");
+    fmt_int(&f, (int32_t)st->interval_s);
+    fmt_str(&f, " s");
+    ESP_LOGI(TAG, "Time synchronized: %s", line);
+}
+
+// Applies the chosen reply. delta_us is how far the clock is behind the server; a slew
+// still running from the last correction would have moved it part of the way.
+static uint32_t apply_sample(const ntp_sample_t *sample, size_t server, size_t answered, size_t falsetickers)
+{
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    const bool clock_valid = now.tv_sec >= CLOCK_VALID_AFTER;
+    struct timeval pending = {0};
+    adjtime(NULL, &pending);
+    const int64_t delta_us = sample->offset_us;
+    const int64_t offset_us = delta_us - timeval_us(&pending);
+
+    const int64_t uptime_us = esp_timer_get_time();
+    time_correction_t how = time_discipline_add(&s_discipline, uptime_us, offset_us, sample->delay_us, clock_valid);
+    if (how == TIME_CORRECTION_SLEW) {
+        // Replaces any slew still running: delta_us includes what it had left.
+        const struct timeval slew = timeval_from_us(delta_us);
+        if (adjtime(&slew, NULL) != 0) {
+            how = TIME_CORRECTION_STEP;
+        }
+    }
+    if (how == TIME_CORRECTION_STEP) {
+        const struct timeval set = timeval_from_us(timeval_us(&now) + delta_us);
+        settimeofday(&set, NULL);
+    }
+
+    const uint64_t rtc_us = esp_clk_rtc_time();
+    const bool first_after_restore = s_restored_rtc_us != 0 && s_stats.syncs == 0;
+    if (first_after_restore) {
+        // What the restore got wrong came from the RTC timer's rate over the sleep.
+        time_rtc_learn(&s_rtc, s_restored_rtc_us - s_rtc.anchor_rtc_us, offset_us);
+    }
+    time_rtc_save(&s_rtc, timeval_us(&now) + delta_us, rtc_us, s_discipline.drift_ppb, true);
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (first_after_restore) {
+        s_stats.restore_error_us = offset_us;
+    }
+    if (s_stats.time_to_correct_us < 0) {
+        s_stats.time_to_correct_us = uptime_us;
+    }
+    s_stats.syncs++;
+    s_stats.slews += how == TIME_CORRECTION_SLEW ? 1 : 0;
+    s_stats.steps += how == TIME_CORRECTION_STEP ? 1 : 0;
+    s_stats.last_server = (uint8_t)server;
+    s_stats.last_answered = (uint8_t)answered;
+    s_stats.last_falsetickers = (uint8_t)falsetickers;
+    s_stats.last_offset_us = offset_us;
+    s_stats.last_rtt_us = sample->delay_us;
+    s_stats.drift_ppb = s_discipline.drift_ppb;
+    s_stats.drift_stable = s_discipline.drift_stable;
+    s_stats.interval_s = s_discipline.interval_s;
+    s_stats.next_sync_us = uptime_us + (int64_t)s_discipline.interval_s * 1000000;
+    const time_service_stats_t st = s_stats;
+    xSemaphoreGive(s_lock);
+    s_clock_trusted = true;
+
+    if (clock_valid) {
+        log_sync(&st, how);
+    } else {
+        ESP_LOGI(TAG, "Clock set from %s, next sync in %u s", s_servers[server], (unsigned)st.interval_s);
+    }
     if (s_config.sync_cb) {
         s_config.sync_cb(s_config.cb_ctx);
     }
+    return st.interval_s;
+}
+
+// One round: every server at once, then the reply the majority agrees with that
+// came back fastest. Returns the seconds until the next round.
+static uint32_t sync_round(void)
+{
+    ntp_sample_t samples[TIME_SERVER_MAX];
+    const size_t answered = ntp_client_query(s_servers, s_config.server_count, TIME_NTP_TIMEOUT_MS, samples);
+    size_t falsetickers = 0;
+    const int best = ntp_client_select(samples, s_config.server_count, &falsetickers);
+    if (best >= 0) {
+        return apply_sample(&samples[best], (size_t)best, answered, falsetickers);
+    }
+
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    const uint32_t retry_s = time_discipline_failed(&s_discipline, now.tv_sec >= CLOCK_VALID_AFTER);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_stats.failed++;
+    s_stats.last_answered = (uint8_t)answered;
+    s_stats.last_falsetickers = (uint8_t)falsetickers;
+    s_stats.next_sync_us = esp_timer_get_time() + (int64_t)retry_s * 1000000;
+    xSemaphoreGive(s_lock);
+    ESP_LOGW(TAG, "No time from %u servers (%u answered, %u disagreed), retrying in %u s",
+             (unsigned)s_config.server_count, (unsigned)answered, (unsigned)falsetickers, (unsigned)retry_s);
+    return retry_s;
+}
+
+// Runs on the way into deep sleep: anchors the clock as it is now, so the wake need
+// not trust an anchor from hours of awake drift ago. Includes the slew still pending,
+// which the sleep would otherwise lose.
+static void save_before_sleep(void)
+{
+    if (!s_clock_trusted) {
+        return;
+    }
+    struct timeval now;
+    gettimeofday(&now, NULL);
+    struct timeval pending = {0};
+    adjtime(NULL, &pending);
+    time_rtc_save(&s_rtc, timeval_us(&now) + timeval_us(&pending), esp_clk_rtc_time(), s_discipline.drift_ppb,
+                  false);
+}
+
+// Waits for time_service_start(), then syncs every interval.
+static void time_task(void *arg)
+{
+    (void)arg;
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (true) {
+        const uint32_t interval_s = sync_round();
+        // In seconds: pdMS_TO_TICKS would overflow a 12 h interval.
+        vTaskDelay((TickType_t)interval_s * configTICK_RATE_HZ);
+    }
 }
 
 esp_err_t time_service_init(const time_service_config_t *config)
 {
-    if (!config || !config->server) {
+    if (!config || !config->servers || config->server_count == 0 || config->server_count > TIME_SERVER_MAX) {
         return ESP_ERR_INVALID_ARG;
     }
 
     s_config = *config;
+    for (size_t i = 0; i < config->server_count; i++) {
+        s_servers[i] = config->servers[i];
+    }
+    s_config.servers = s_servers;
+    s_lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(s_lock, ESP_ERR_NO_MEM, TAG, "mutex alloc failed");
+    time_discipline_init(&s_discipline);
+    s_stats.last_rtt_us = TIME_RTT_UNKNOWN;
+    s_stats.interval_s = s_discipline.interval_s;
+    s_stats.next_sync_us = -1;
+    if (!s_stats.restored) {
+        s_stats.time_to_correct_us = -1;
+    }
+    esp_err_t err = esp_deep_sleep_register_hook(save_before_sleep);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "no deep sleep hook (%s), the wake restores from the last sync", esp_err_to_name(err));
+    }
 
-    esp_sntp_config_t sntp_config = ESP_NETIF_SNTP_DEFAULT_CONFIG(config->server);
-    sntp_config.sync_cb = &time_sync_notification;
-    esp_netif_sntp_init(&sntp_config);
+    if (xTaskCreate(time_task, "time", TIME_TASK_STACK_SIZE, NULL, TIME_TASK_PRIORITY, &s_task) != pdPASS) {
+        vSemaphoreDelete(s_lock);
+        s_lock = NULL;
+        ESP_LOGE(TAG, "task create failed");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+esp_err_t time_service_restore(void)
+{
+    if (esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_UNDEFINED) {
+        return ESP_ERR_NOT_FOUND; // Power-on or reset: RTC memory holds nothing
+    }
+    const uint64_t rtc_us = esp_clk_rtc_time();
+    int64_t unix_us = 0;
+    if (!time_rtc_restore(&s_rtc, rtc_us, &unix_us)) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    const struct timeval tv = timeval_from_us(unix_us);
+    ESP_RETURN_ON_FALSE(settimeofday(&tv, NULL) == 0, ESP_FAIL, TAG, "settimeofday failed");
+    s_restored_rtc_us = rtc_us;
+    s_clock_trusted = true;
+    // Before init: nothing else reads the stats yet.
+    s_stats.restored = true;
+    s_stats.time_to_correct_us = esp_timer_get_time();
+    s_stats.drift_ppb = s_rtc.drift_ppb;
 
+    char line[96];
+    fmt_buf_t f;
+    fmt_init(&f, line, sizeof(line));
+    fmt_str(&f, "after ");
+    fmt_int(&f, (int32_t)((rtc_us - s_rtc.anchor_rtc_us) / 1000000));
+    fmt_str(&f, " s asleep, RTC drift ");
+    fmt_fixed(&f, s_rtc.rtc_drift_ppb, 3);
+    fmt_str(&f, " ppm");
+    ESP_LOGI(TAG, "Clock restored %s", line);
     return ESP_OK;
 }
 
 esp_err_t time_service_start(void)
 {
+    ESP_RETURN_ON_FALSE(s_task, ESP_ERR_INVALID_STATE, TAG, "not initialized");
     if (s_started) {
         return ESP_OK;
     }
 
-    esp_err_t err = esp_netif_sntp_start();
-    if (err == ESP_OK) {
-        s_started = true;
-        ESP_LOGI(TAG, "SNTP started");
-    }
-    return err;
+    s_started = true;
+    xTaskNotifyGive(s_task);
+    ESP_LOGI(TAG, "NTP started with %u servers", (unsigned)s_config.server_count);
+    return ESP_OK;
 }
 
+esp_err_t time_service_get_stats(time_service_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats, ESP_ERR_INVALID_ARG, TAG, "stats is NULL");
+    ESP_RETURN_ON_FALSE(s_lock, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    *stats = s_stats;
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
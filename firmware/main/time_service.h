@@ -1,6 +1,9 @@
 #pragma once
 
 #include "esp_err.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -9,15 +12,44 @@ extern "C" {
 typedef void (*time_sync_cb_t)(void *ctx);
 
 typedef struct {
-    const char *server;
+    // Queried together on every sync; at most TIME_SERVER_MAX. The strings must
+    // outlive the service.
+    const char *const *servers;
+    size_t server_count;
     time_sync_cb_t sync_cb;
     void *cb_ctx;
 } time_service_config_t;
 
+typedef struct {
+    uint32_t syncs;            // NTP rounds applied
+    uint32_t slews;            // Of those, corrected gradually with adjtime()
+    uint32_t steps;            // Corrected by setting the clock
+    uint32_t failed;           // Rounds with no usable reply, or no majority agreeing
+    uint8_t last_server;       // Index of the server whose reply was used last
+    uint8_t last_answered;     // Valid replies in the last round
+    uint8_t last_falsetickers; // Of those, rejected for disagreeing with the rest
+    int64_t last_offset_us;    // Server time minus the local clock at the last sync, before correcting
+    int32_t last_rtt_us;       // Round trip of the reply used, -1 before the first sync
+    int32_t drift_ppb;         // Estimated crystal drift, parts per billion, positive when running fast
+    bool drift_stable;         // Recent syncs agree on the drift; the interval stretches while they do
+    uint32_t interval_s;       // Current resync interval
+    int64_t next_sync_us;      // esp_timer time of the next sync, -1 before the first
+    bool restored;             // The clock was restored from RTC memory on waking from deep sleep
+    int64_t time_to_correct_us; // esp_timer time the clock was first right (restored or synced), -1 until then
+    int64_t restore_error_us;  // Offset the first sync found after a restore
+} time_service_stats_t;
+
+/**
+ * On a wake from deep sleep, sets the clock from the anchor kept in RTC memory and
+ * the RTC timer's count since, so it is right before the network is up. Call first
+ * in app_main, before anything reads the time, and before time_service_init().
+ * ESP_ERR_NOT_FOUND after a power-on or reset, or without a saved anchor.
+ */
+esp_err_t time_service_restore(void);
 esp_err_t time_service_init(const time_service_config_t *config);
 esp_err_t time_service_start(void);
+esp_err_t time_service_get_stats(time_service_stats_t *stats);
 
 #ifdef __cplusplus
 }
 #endif
-
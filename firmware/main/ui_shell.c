@@ -1,17 +1,18 @@
 #include "ui_shell.h"
 #include "config.h"
 
+#include "backlight.h"
 #include "esp_log.h"
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
+#include "fmt.h"
+#include "local_time.h"
 #include "lvgl.h"
 #include "lvgl_port.h"
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
-#include <time.h>
 #include "version.h"
+#include "wall_timer.h"
 #include "weather_service.h"
 
 static const char *TAG = "ui_shell";
@@ -76,108 +77,99 @@ typedef struct {
     lv_obj_t *status_box;
     lv_obj_t *status_title;
     lv_obj_t *status_subtitle;
-    lv_obj_t *brightness_overlay;
     lv_obj_t *settings_panel;
     lv_obj_t *auto_dim_switch;
     lv_obj_t *deep_sleep_switch;
     bool updating_toggles;
-    int weather_ticks;
+    weather_data_t weather_msg[WEATHER_MAX_LOCATIONS]; // Latest results posted by the weather task
+    uint8_t weather_msg_pending;                        // Bit per location posted since the last apply
+    bool weather_msg_queued;
+    weather_data_t weather[WEATHER_MAX_LOCATIONS];     // Applied results, UI task only
+    uint8_t weather_known;                              // Bit per location with a result
+    uint8_t weather_shown;                              // Location on the weather card
+    lv_timer_t *weather_cycle_timer;                    // Created once a second location has a result
+    wall_timer_t clock_timer;
+    local_time_t clock_now; // As of the minute on the face
     bool clock_ready;
     ui_shell_config_t config;
 } ui_shell_ctx_t;
 
 static ui_shell_ctx_t s_ctx = {0};
 
-static void ui_shell_lvgl_tick(void *arg)
+// Dimming is done by the backlight PWM, so no pixels change and nothing is redrawn.
+static void ui_shell_apply_brightness(ui_brightness_state_t state)
 {
-    (void)arg;
-    const TickType_t delay = pdMS_TO_TICKS(1);
-    while (true) {
-        lv_tick_inc(1);
-        vTaskDelay(delay);
-    }
-}
-
-static void ui_shell_lvgl_loop(void *arg)
-{
-    (void)arg;
-    const TickType_t delay = pdMS_TO_TICKS(5);
-    while (true) {
-        lv_task_handler();
-        vTaskDelay(delay);
-    }
-}
-
-static void ui_shell_apply_brightness(ui_shell_ctx_t *ctx, ui_brightness_state_t state)
-{
-    if (!ctx->brightness_overlay) {
-        return;
-    }
-
-    lv_opa_t overlay_opa = LV_OPA_TRANSP;
-    lv_opa_t text_opa = LV_OPA_COVER;
-
+    uint8_t percent = BACKLIGHT_ACTIVE_PERCENT;
     switch (state) {
         case UI_BRIGHTNESS_ACTIVE:
-            overlay_opa = LV_OPA_TRANSP;
-            text_opa = LV_OPA_COVER;
+            percent = BACKLIGHT_ACTIVE_PERCENT;
             break;
         case UI_BRIGHTNESS_DIMMED:
-            overlay_opa = LV_OPA_50;
-            text_opa = LV_OPA_80;
+            percent = BACKLIGHT_DIMMED_PERCENT;
             break;
         case UI_BRIGHTNESS_OFF:
-            overlay_opa = LV_OPA_80;
-            text_opa = LV_OPA_60;
+            percent = BACKLIGHT_OFF_PERCENT;
             break;
         default:
             break;
     }
 
-    lv_obj_set_style_bg_opa(ctx->brightness_overlay, overlay_opa, 0);
-
-    lv_obj_set_style_text_opa(ctx->time_label, text_opa, 0);
-    lv_obj_set_style_text_opa(ctx->sub_label, text_opa, 0);
-    lv_obj_set_style_text_opa(ctx->weather_label, text_opa, 0);
-    if (ctx->weather_icon_label) {
-        lv_obj_set_style_text_opa(ctx->weather_icon_label, text_opa, 0);
-    }
-    if (ctx->weather_details_label) {
-        lv_obj_set_style_text_opa(ctx->weather_details_label, text_opa, 0);
+    esp_err_t err = backlight_set_percent(percent, BACKLIGHT_FADE_MS);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Backlight update failed: %s", esp_err_to_name(err));
     }
-    if (ctx->sun_label) {
-        lv_obj_set_style_text_opa(ctx->sun_label, text_opa, 0);
-    }
-    lv_obj_set_style_text_opa(ctx->brand_label, text_opa, 0);
-    lv_obj_set_style_text_opa(ctx->version_label, text_opa, 0);
-    lv_obj_set_style_text_opa(ctx->status_title, text_opa, 0);
-    lv_obj_set_style_text_opa(ctx->status_subtitle, text_opa, 0);
 }
 
-static void ui_shell_update_clock(lv_timer_t *timer)
-{
-    ui_shell_ctx_t *ctx = (ui_shell_ctx_t *)timer->user_data;
+static void ui_shell_draw_weather(const weather_data_t *data);
 
-    time_t now = time(NULL);
-    struct tm info = {0};
-    localtime_r(&now, &info);
-
-    char time_buf[8];
-    strftime(time_buf, sizeof(time_buf), "%H:%M", &info);
-    lv_label_set_text(ctx->time_label, time_buf);
+// The face shows HH:MM: the clock wakes on minute boundaries only.
+#define UI_CLOCK_UNIT_SEC 60
 
+// "Mon • Dry Ridge": the weekday, and the location on the weather card.
+static void ui_shell_draw_sub(ui_shell_ctx_t *ctx)
+{
+    static const char *const k_weekdays[] = {"Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat"};
     char sub_buf[32];
-    strftime(sub_buf, sizeof(sub_buf), "%a", &info);
-    strlcat(sub_buf, " • " LOCATION_NAME, sizeof(sub_buf));
+    fmt_buf_t f;
+    fmt_init(&f, sub_buf, sizeof(sub_buf));
+    const weather_location_t *location = weather_service_get_location(ctx->weather_shown);
+    fmt_str(&f, k_weekdays[ctx->clock_now.wday % 7]);
+    fmt_str(&f, " • ");
+    fmt_str(&f, location && location->name ? location->name : LOCATION_NAME);
     lv_label_set_text(ctx->sub_label, sub_buf);
+}
 
-    ctx->weather_ticks++;
-    if (ctx->weather_ticks >= 300 && ctx->config.weather_request_cb) {
-        ctx->config.weather_request_cb(ctx->config.weather_request_ctx);
-        ctx->weather_ticks = 0;
+// With several locations the card rotates through the ones that have a result, from
+// memory: switching never asks the weather service for anything.
+static void ui_shell_cycle_weather(lv_timer_t *timer)
+{
+    ui_shell_ctx_t *ctx = (ui_shell_ctx_t *)timer->user_data;
+    for (uint8_t step = 1; step < WEATHER_MAX_LOCATIONS; step++) {
+        const uint8_t next = (uint8_t)((ctx->weather_shown + step) % WEATHER_MAX_LOCATIONS);
+        if (ctx->weather_known & (1u << next)) {
+            ctx->weather_shown = next;
+            ui_shell_draw_weather(&ctx->weather[next]);
+            if (ctx->clock_ready) {
+                ui_shell_draw_sub(ctx);
+            }
+            return;
+        }
     }
 }
 
+static void ui_shell_update_clock(const local_time_t *now, void *user_data)
+{
+    ui_shell_ctx_t *ctx = (ui_shell_ctx_t *)user_data;
+    ctx->clock_now = *now;
+
+    fmt_buf_t f;
+    char time_buf[8];
+    fmt_init(&f, time_buf, sizeof(time_buf));
+    fmt_hhmm(&f, (uint16_t)(now->hour * 60 + now->minute));
+    lv_label_set_text(ctx->time_label, time_buf);
+    ui_shell_draw_sub(ctx);
+}
+
 static void settings_switch_handler(lv_event_t *e)
 {
     ui_shell_ctx_t *ctx = (ui_shell_ctx_t *)lv_event_get_user_data(e);
@@ -331,23 +323,17 @@ static void ui_shell_create_clock_ui(ui_shell_ctx_t *ctx)
     lv_label_set_text_fmt(version_label, "Version %s", SMARTCLOCK_OS_VERSION);
     lv_obj_align_to(version_label, brand_label, LV_ALIGN_OUT_BOTTOM_LEFT, 0, 2);
 
-    // Time label
+    // Time label. Its only glyphs are digits and the colon, so they are rasterized
+    // once into an atlas and every minute update just blends cached cells.
+    if (!lv_font_cache_glyphs(&lv_font_montserrat_48, "0123456789:")) {
+        ESP_LOGW(TAG, "Clock glyph atlas unavailable, using the rasterizer");
+    }
     lv_obj_t *time_label = lv_label_create(screen);
     lv_obj_set_style_text_font(time_label, &lv_font_montserrat_48, 0);
     lv_obj_set_style_text_color(time_label, lv_color_white(), 0);
     lv_label_set_text(time_label, "00:00");
     lv_obj_center(time_label);
 
-    // Seconds animation: subtle scale pulse
-    lv_anim_t anim;
-    lv_anim_init(&anim);
-    lv_anim_set_var(&anim, time_label);
-    lv_anim_set_values(&anim, 100, 103);
-    lv_anim_set_exec_cb(&anim, (lv_anim_exec_xcb_t)lv_obj_set_style_transform_zoom);
-    lv_anim_set_time(&anim, 1000);
-    lv_anim_set_repeat_count(&anim, LV_ANIM_REPEAT_INFINITE);
-    lv_anim_start(&anim);
-
     // Subtitle for date/location
     lv_obj_t *sub_label = lv_label_create(screen);
     lv_obj_set_style_text_font(sub_label, &lv_font_montserrat_18, 0);
@@ -414,14 +400,6 @@ static void ui_shell_create_clock_ui(ui_shell_ctx_t *ctx)
     lv_label_set_text(status_subtitle, "Preparing network");
     lv_obj_align(status_subtitle, LV_ALIGN_BOTTOM_MID, 0, -6);
 
-    lv_obj_t *overlay = lv_obj_create(screen);
-    lv_obj_set_size(overlay, LV_HOR_RES, LV_VER_RES);
-    lv_obj_set_style_bg_color(overlay, lv_color_black(), 0);
-    lv_obj_set_style_bg_opa(overlay, LV_OPA_TRANSP, 0);
-    lv_obj_clear_flag(overlay, LV_OBJ_FLAG_SCROLLABLE);
-    lv_obj_add_flag(overlay, LV_OBJ_FLAG_EVENT_BUBBLE);
-    lv_obj_clear_flag(overlay, LV_OBJ_FLAG_CLICKABLE);
-
     ui_shell_create_settings_panel(ctx);
 
     ctx->time_label = time_label;
@@ -435,13 +413,52 @@ static void ui_shell_create_clock_ui(ui_shell_ctx_t *ctx)
     ctx->status_box = status_box;
     ctx->status_title = status_title;
     ctx->status_subtitle = status_subtitle;
-    ctx->brightness_overlay = overlay;
-    ctx->weather_ticks = 300; // force immediate first refresh
     ctx->clock_ready = true;
 
-    ui_shell_apply_brightness(ctx, UI_BRIGHTNESS_ACTIVE);
+    // Drawn now, then on each minute boundary: after a deep sleep the clock was
+    // restored before the UI existed, so the first frame can show the time.
+    if (wall_timer_start(&ctx->clock_timer, UI_CLOCK_UNIT_SEC, ui_shell_update_clock, ctx) != ESP_OK) {
+        ESP_LOGE(TAG, "clock timer failed");
+    }
+}
+
+// One line per interval: frame count and rate, missed refresh periods, the worst
+// frame split into timer/layout/render/flush, p95 bucket bounds per phase, and the UI
+// task's stack high-water mark.
+static void ui_shell_log_frame_stats(lv_timer_t *timer)
+{
+    static uint32_t last_frames;
+    lv_frame_stats_t st;
+    lv_frame_get_stats(&st);
+    lv_refr_stats_t refr;
+    lv_refr_get_stats(&refr);
+
+    uint32_t fps_x10 = (st.frames - last_frames) * 10 / UI_FRAME_STATS_LOG_SEC;
+    last_frames = st.frames;
+    ESP_LOGI(TAG,
+             "frames %lu (%lu.%lu fps) drop %lu worst %lu us [t %lu l %lu r %lu f %lu] p95 us: t %lu l %lu r %lu "
+             "f %lu, stack free %lu",
+             (unsigned long)st.frames, (unsigned long)(fps_x10 / 10), (unsigned long)(fps_x10 % 10),
+             (unsigned long)st.dropped, (unsigned long)st.worst.total_us, (unsigned long)st.worst.timer_us,
+             (unsigned long)st.worst.layout_us, (unsigned long)st.worst.render_us, (unsigned long)st.worst.flush_us,
+             (unsigned long)lv_frame_hist_percentile(&st.timer, 95),
+             (unsigned long)lv_frame_hist_percentile(&st.layout, 95),
+             (unsigned long)lv_frame_hist_percentile(&st.render, 95),
+             (unsigned long)lv_frame_hist_percentile(&st.flush, 95), (unsigned long)refr.stack_free_min);
+    (void)timer;
+}
 
-    lv_timer_create(ui_shell_update_clock, 1000, ctx);
+esp_err_t ui_shell_get_frame_stats(lv_frame_stats_t *stats)
+{
+    if (!stats) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (!lvgl_port_lock(0)) {
+        return ESP_ERR_TIMEOUT;
+    }
+    lv_frame_get_stats(stats);
+    lvgl_port_unlock();
+    return ESP_OK;
 }
 
 esp_err_t ui_shell_init(const ui_shell_config_t *config)
@@ -454,10 +471,14 @@ esp_err_t ui_shell_init(const ui_shell_config_t *config)
 
     ESP_ERROR_CHECK(lvgl_port_init());
 
-    xTaskCreate(ui_shell_lvgl_tick, "lv_tick", 2048, NULL, 5, NULL);
-    xTaskCreate(ui_shell_lvgl_loop, "lv_loop", 4096, NULL, 5, NULL);
+    ESP_ERROR_CHECK(lvgl_port_start_task(5));
 
+    lvgl_port_lock(0);
     ui_shell_create_loading_ui(&s_ctx);
+    if (UI_FRAME_STATS_LOG_SEC > 0) {
+        lv_timer_create(ui_shell_log_frame_stats, UI_FRAME_STATS_LOG_SEC * 1000, NULL);
+    }
+    lvgl_port_unlock();
 
     ESP_LOGI(TAG, "UI shell initialized");
     return ESP_OK;
@@ -465,7 +486,11 @@ esp_err_t ui_shell_init(const ui_shell_config_t *config)
 
 void ui_shell_update_boot_status(const char *module_name, uint8_t percent)
 {
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
     if (!s_ctx.loading_status || !s_ctx.loading_bar) {
+        lvgl_port_unlock();
         return;
     }
 
@@ -484,26 +509,29 @@ void ui_shell_update_boot_status(const char *module_name, uint8_t percent)
         s_ctx.clock_ready = true;
         ui_shell_create_clock_ui(&s_ctx);
     }
+    lvgl_port_unlock();
 }
 
 void ui_shell_update_weather(const char *text)
 {
-    if (!text || !s_ctx.weather_label) {
+    if (!text || !s_ctx.weather_label || !lvgl_port_lock(0)) {
         return;
     }
     lv_label_set_text(s_ctx.weather_label, text);
+    lvgl_port_unlock();
 }
 
-void ui_shell_update_weather_data(const weather_data_t *data)
+static void ui_shell_draw_weather(const weather_data_t *data)
 {
-    if (!data) {
-        return;
-    }
+    fmt_buf_t f;
 
     // Update main weather label (temp + condition)
     if (s_ctx.weather_label) {
         char buf[64];
-        snprintf(buf, sizeof(buf), "%.0f\xC2\xB0F • %s", data->temp_f, data->condition);
+        fmt_init(&f, buf, sizeof(buf));
+        fmt_deci_round(&f, data->temp_f10);
+        fmt_str(&f, FMT_DEGREE "F • ");
+        fmt_str(&f, data->condition);
         lv_label_set_text(s_ctx.weather_label, buf);
     }
 
@@ -515,22 +543,85 @@ void ui_shell_update_weather_data(const weather_data_t *data)
     // Update weather details (high/low/feels like)
     if (s_ctx.weather_details_label) {
         char details[64];
-        snprintf(details, sizeof(details), "H:%.0f\xC2\xB0 L:%.0f\xC2\xB0 • Feels %.0f\xC2\xB0",
-                 data->high_f, data->low_f, data->feels_like_f);
+        fmt_init(&f, details, sizeof(details));
+        fmt_str(&f, "H:");
+        fmt_deci_round(&f, data->high_f10);
+        fmt_str(&f, FMT_DEGREE " L:");
+        fmt_deci_round(&f, data->low_f10);
+        fmt_str(&f, FMT_DEGREE " • Feels ");
+        fmt_deci_round(&f, data->feels_like_f10);
+        fmt_str(&f, data->stale ? FMT_DEGREE " • cached" : FMT_DEGREE);
         lv_label_set_text(s_ctx.weather_details_label, details);
     }
 
     // Update sunrise/sunset
     if (s_ctx.sun_label) {
         char sun[64];
-        snprintf(sun, sizeof(sun), "Rise: %s\nSet: %s", data->sunrise, data->sunset);
+        fmt_init(&f, sun, sizeof(sun));
+        fmt_str(&f, "Rise: ");
+        fmt_clock12(&f, data->sunrise);
+        fmt_str(&f, "\nSet: ");
+        fmt_clock12(&f, data->sunset);
         lv_label_set_text(s_ctx.sun_label, sun);
     }
 }
 
+// Runs on the UI task, so the labels are updated without another task holding the
+// LVGL lock for the formatting and relayout. Only the location on the card is drawn.
+static void ui_shell_apply_weather_msg(void *user_data)
+{
+    (void)user_data;
+    s_ctx.weather_msg_queued = false;
+    for (uint8_t i = 0; i < WEATHER_MAX_LOCATIONS; i++) {
+        if (!(s_ctx.weather_msg_pending & (1u << i))) {
+            continue;
+        }
+        s_ctx.weather[i] = s_ctx.weather_msg[i];
+        if (!(s_ctx.weather_known & (1u << s_ctx.weather_shown))) {
+            s_ctx.weather_shown = i;
+        }
+        s_ctx.weather_known |= (uint8_t)(1u << i);
+        if (i == s_ctx.weather_shown) {
+            ui_shell_draw_weather(&s_ctx.weather[i]);
+        }
+    }
+    s_ctx.weather_msg_pending = 0;
+    // A single location has nothing to rotate: no timer until there is a second.
+    const bool several = (s_ctx.weather_known & (s_ctx.weather_known - 1)) != 0;
+    if (several && !s_ctx.weather_cycle_timer) {
+        s_ctx.weather_cycle_timer = lv_timer_create(ui_shell_cycle_weather, UI_WEATHER_CYCLE_SEC * 1000, &s_ctx);
+    }
+}
+
+void ui_shell_update_weather_data(const weather_data_t *data)
+{
+    if (!data || data->location >= WEATHER_MAX_LOCATIONS || !lvgl_port_lock(0)) {
+        return;
+    }
+    // Post the result as a message; a newer one for the same location replaces any
+    // not yet applied.
+    s_ctx.weather_msg[data->location] = *data;
+    s_ctx.weather_msg_pending |= (uint8_t)(1u << data->location);
+    if (!s_ctx.weather_msg_queued) {
+        s_ctx.weather_msg_queued = lv_async_call(ui_shell_apply_weather_msg, NULL);
+    }
+    lvgl_port_unlock();
+}
+
+void ui_shell_resync_clock(void)
+{
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    if (s_ctx.clock_ready) {
+        wall_timer_resync(&s_ctx.clock_timer);
+    }
+    lvgl_port_unlock();
+}
+
 void ui_shell_show_onboarding(const char *primary, const char *secondary)
 {
-    if (!s_ctx.status_box) {
+    if (!s_ctx.status_box || !lvgl_port_lock(0)) {
         return;
     }
 
@@ -541,16 +632,28 @@ void ui_shell_show_onboarding(const char *primary, const char *secondary)
     if (secondary) {
         lv_label_set_text(s_ctx.status_subtitle, secondary);
     }
+
+    lvgl_port_unlock();
 }
 
 void ui_shell_set_brightness_state(ui_brightness_state_t state)
 {
-    ui_shell_apply_brightness(&s_ctx, state);
+    ui_shell_apply_brightness(state);
+
+    // Nothing is visible with the backlight off: let invalidations pile up and draw
+    // them once when the screen comes back.
+    if (!lvgl_port_lock(0)) {
+        return;
+    }
+    lv_refr_set_paused(state == UI_BRIGHTNESS_OFF);
+    // Motion is not worth the wakeups on a dimmed or dark screen.
+    lv_anim_set_paused(state != UI_BRIGHTNESS_ACTIVE);
+    lvgl_port_unlock();
 }
 
 void ui_shell_update_power_quick_toggles(bool auto_dim_enabled, bool deep_sleep_enabled)
 {
-    if (!s_ctx.auto_dim_switch || !s_ctx.deep_sleep_switch) {
+    if (!s_ctx.auto_dim_switch || !s_ctx.deep_sleep_switch || !lvgl_port_lock(0)) {
         return;
     }
 
@@ -569,5 +672,6 @@ void ui_shell_update_power_quick_toggles(bool auto_dim_enabled, bool deep_sleep_
     }
 
     s_ctx.updating_toggles = false;
+    lvgl_port_unlock();
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "esp_err.h"
+#include "lvgl.h"
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -12,7 +13,6 @@ extern "C" {
 // Forward declaration
 typedef struct weather_data_t weather_data_t;
 
-typedef void (*ui_weather_request_cb_t)(void *ctx);
 typedef void (*ui_settings_toggle_cb_t)(const char *toggle_id, bool enabled, void *ctx);
 
 typedef enum {
@@ -22,19 +22,26 @@ typedef enum {
 } ui_brightness_state_t;
 
 typedef struct {
-    ui_weather_request_cb_t weather_request_cb;
-    void *weather_request_ctx;
     ui_settings_toggle_cb_t settings_toggle_cb;
     void *settings_toggle_ctx;
 } ui_shell_config_t;
 
 esp_err_t ui_shell_init(const ui_shell_config_t *config);
 void ui_shell_update_weather(const char *text);
+/**
+ * Callable from any task: the data is copied and applied to the labels on the UI task.
+ * The latest result per data->location is kept; with several, the weather card cycles
+ * through them every UI_WEATHER_CYCLE_SEC.
+ */
 void ui_shell_update_weather_data(const weather_data_t *data);
+/** The wall clock was corrected: re-aligns the clock's minute timer to it now. */
+void ui_shell_resync_clock(void);
 void ui_shell_show_onboarding(const char *primary, const char *secondary);
 void ui_shell_set_brightness_state(ui_brightness_state_t state);
 void ui_shell_update_power_quick_toggles(bool auto_dim_enabled, bool deep_sleep_enabled);
 void ui_shell_update_boot_status(const char *module_name, uint8_t percent);
+/** Snapshot of the UI pipeline's frame-timing histograms since boot. */
+esp_err_t ui_shell_get_frame_stats(lv_frame_stats_t *stats);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,74 @@
+#include "wall_timer.h"
+
+#include "esp_check.h"
+#include <sys/time.h>
+
+static const char *TAG = "wall_timer";
+
+// lv ticks are whole milliseconds, truncated: a period can end up to 1 ms short of
+// the time it asked for, which would land just before the boundary.
+#define WALL_TIMER_SLACK_MS 1
+
+static int64_t floor_div64(int64_t a, int64_t b)
+{
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+uint32_t wall_timer_delay_ms(int64_t local_us, uint32_t unit_s)
+{
+    const int64_t unit_us = (int64_t)unit_s * 1000000;
+    const int64_t next_us = (floor_div64(local_us, unit_us) + 1) * unit_us;
+    return (uint32_t)((next_us - local_us + 999) / 1000) + WALL_TIMER_SLACK_MS;
+}
+
+static void wall_timer_run(wall_timer_t *t)
+{
+    struct timeval tv;
+    gettimeofday(&tv, NULL);
+    local_time_t now;
+    local_time_get(tv.tv_sec, &now);
+    const int64_t local_us = ((int64_t)tv.tv_sec + now.utc_offset_s) * 1000000 + tv.tv_usec;
+    const int64_t unit_us = (int64_t)t->unit_s * 1000000;
+    const int64_t index = floor_div64(local_us, unit_us);
+
+    t->stats.runs++;
+    if (index != t->shown) {
+        if (!t->resynced) {
+            const uint32_t late_ms = (uint32_t)((local_us - index * unit_us) / 1000);
+            if (late_ms > t->stats.late_max_ms) {
+                t->stats.late_max_ms = late_ms;
+            }
+        }
+        t->shown = index;
+        t->stats.changes++;
+        t->cb(&now, t->ctx);
+    }
+    t->resynced = false;
+    // From the time read now, not the period: an early run (the clock slewed ahead of
+    // the tick) just waits out the remainder.
+    lv_timer_set_period(t->timer, wall_timer_delay_ms(local_us, t->unit_s));
+}
+
+static void wall_timer_cb(lv_timer_t *timer)
+{
+    wall_timer_run((wall_timer_t *)timer->user_data);
+}
+
+esp_err_t wall_timer_start(wall_timer_t *t, uint32_t unit_s, wall_timer_cb_t cb, void *ctx)
+{
+    ESP_RETURN_ON_FALSE(t && cb && unit_s > 0 && 86400 % unit_s == 0, ESP_ERR_INVALID_ARG, TAG, "bad timer");
+    *t = (wall_timer_t){.unit_s = unit_s, .shown = INT64_MIN, .resynced = true, .cb = cb, .ctx = ctx};
+    t->timer = lv_timer_create(wall_timer_cb, 0, t);
+    ESP_RETURN_ON_FALSE(t->timer, ESP_ERR_NO_MEM, TAG, "no timer");
+    wall_timer_run(t);
+    return ESP_OK;
+}
+
+void wall_timer_resync(wall_timer_t *t)
+{
+    if (t && t->timer) {
+        t->resynced = true;
+        t->stats.resyncs++;
+        lv_timer_ready(t->timer);
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "esp_err.h"
+#include "local_time.h"
+#include "lvgl.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// A UI timer that fires on boundaries of local wall time (every minute at :00, or
+// every second) instead of every N ms from whenever it was started. Each run re-arms
+// for the next boundary from the clock read then, so it neither drifts against the
+// wall clock nor carries an early or late run forward; the callback only runs when
+// the boundary index it would show has changed. Runs on the UI task (an lv_timer).
+
+typedef void (*wall_timer_cb_t)(const local_time_t *now, void *ctx);
+
+typedef struct {
+    uint32_t runs;        // lv_timer runs, including ones that found nothing changed
+    uint32_t changes;     // Callbacks: a new boundary was reached
+    uint32_t resyncs;     // wall_timer_resync() calls
+    uint32_t late_max_ms; // Furthest past a boundary a scheduled callback ran
+} wall_timer_stats_t;
+
+typedef struct {
+    lv_timer_t *timer;
+    uint32_t unit_s;
+    int64_t shown; // Boundary index last passed to the callback
+    bool resynced; // The next run was not scheduled for a boundary: not counted as late
+    wall_timer_cb_t cb;
+    void *ctx;
+    wall_timer_stats_t stats;
+} wall_timer_t;
+
+/** ms from local_us (local wall time, microseconds) to just past the next multiple of unit_s. */
+uint32_t wall_timer_delay_ms(int64_t local_us, uint32_t unit_s);
+
+/**
+ * Calls cb now, then at every unit_s boundary of local time. unit_s must divide a
+ * day. Call with the LVGL lock held; t must outlive the timer.
+ */
+esp_err_t wall_timer_start(wall_timer_t *t, uint32_t unit_s, wall_timer_cb_t cb, void *ctx);
+/**
+ * The wall clock was stepped: runs the timer on the next LVGL pass, which calls cb if
+ * the boundary shown changed and re-arms from the new time. Call with the LVGL lock held.
+ */
+void wall_timer_resync(wall_timer_t *t);
+
+#ifdef __cplusplus
+}
+#endif
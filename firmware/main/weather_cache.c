@@ -0,0 +1,75 @@
+#include "weather_cache.h"
+#include "config.h"
+
+#include "esp_log.h"
+#include "nvs.h"
+#include <string.h>
+
+#define WEATHER_NAMESPACE "weather"
+#define WEATHER_KEY_CACHE "cache" // Followed by the slot digit
+
+static const char *TAG = "weather_cache";
+
+static void slot_key(size_t slot, char key[8])
+{
+    memcpy(key, WEATHER_KEY_CACHE, sizeof(WEATHER_KEY_CACHE) - 1);
+    key[sizeof(WEATHER_KEY_CACHE) - 1] = (char)('0' + slot % 10);
+    key[sizeof(WEATHER_KEY_CACHE)] = '\0';
+}
+
+esp_err_t weather_cache_load(size_t slot, weather_cache_entry_t *out)
+{
+    char key[8];
+    slot_key(slot, key);
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(WEATHER_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        return ESP_ERR_NOT_FOUND;
+    }
+    size_t len = sizeof(*out);
+    err = nvs_get_blob(handle, key, out, &len);
+    nvs_close(handle);
+    if (err != ESP_OK || len != sizeof(*out) || out->version != WEATHER_CACHE_VERSION) {
+        if (err == ESP_OK || err == ESP_ERR_NVS_INVALID_LENGTH) {
+            ESP_LOGW(TAG, "Ignoring cache entry from another firmware layout");
+        }
+        return ESP_ERR_NOT_FOUND;
+    }
+    // Strings come from flash; never trust their terminators.
+    out->etag[sizeof(out->etag) - 1] = '\0';
+    out->last_modified[sizeof(out->last_modified) - 1] = '\0';
+    out->data.condition[sizeof(out->data.condition) - 1] = '\0';
+    return ESP_OK;
+}
+
+esp_err_t weather_cache_store(size_t slot, const weather_cache_entry_t *entry)
+{
+    char key[8];
+    slot_key(slot, key);
+    weather_cache_entry_t copy = *entry;
+    copy.version = WEATHER_CACHE_VERSION;
+    copy.data.stale = false;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(WEATHER_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        return err;
+    }
+    err = nvs_set_blob(handle, key, &copy, sizeof(copy));
+    if (err == ESP_OK) {
+        err = nvs_commit(handle);
+    }
+    nvs_close(handle);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Could not store weather cache: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+int64_t weather_cache_age(const weather_cache_entry_t *entry, time_t now)
+{
+    if (entry->data.updated_at < CLOCK_VALID_AFTER || now < CLOCK_VALID_AFTER || now < entry->data.updated_at) {
+        return -1;
+    }
+    return (int64_t)(now - entry->data.updated_at);
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "esp_err.h"
+#include "forecast_store.h"
+#include "weather_service.h"
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Last good weather result and its HTTP validators, kept in NVS so the weather card
+// can be drawn at boot before the network is up and refreshes can be conditional.
+// One entry per configured location (slot); all locations share one request, so the
+// validators are those of the whole response.
+
+#define WEATHER_CACHE_VERSION 5 // Bump when weather_data_t or this struct changes
+
+typedef struct {
+    uint16_t version;
+    int32_t lat_e4; // The location the entry was fetched for
+    int32_t lon_e4;
+    weather_data_t data; // data.updated_at is the time of the last 200 or 304
+    forecast_store_t forecast;
+    char etag[64];
+    char last_modified[40];
+} weather_cache_entry_t;
+
+/** ESP_ERR_NOT_FOUND when nothing is stored or it was written by another layout. */
+esp_err_t weather_cache_load(size_t slot, weather_cache_entry_t *out);
+esp_err_t weather_cache_store(size_t slot, const weather_cache_entry_t *entry);
+/** Seconds since data.updated_at, or -1 when unknown because the clock was not set. */
+int64_t weather_cache_age(const weather_cache_entry_t *entry, time_t now);
+
+#ifdef __cplusplus
+}
+#endif
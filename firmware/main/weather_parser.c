@@ -0,0 +1,254 @@
+#include "weather_parser.h"
+#include "civil_date.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#define WEATHER_FIELD_TEMP (1u << 0)
+#define WEATHER_FIELD_FEELS_LIKE (1u << 1)
+#define WEATHER_FIELD_CODE (1u << 2)
+#define WEATHER_FIELD_HIGH (1u << 3)
+#define WEATHER_FIELD_LOW (1u << 4)
+#define WEATHER_FIELDS_CURRENT (WEATHER_FIELD_TEMP | WEATHER_FIELD_FEELS_LIKE | WEATHER_FIELD_CODE)
+
+static bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+// "41.35" -> 414: tenths, rounded half away from zero, without floating point. False
+// when the tenths do not fit an int16_t, rounding included.
+static bool parse_deci(const char *v, int16_t *out)
+{
+    const bool neg = *v == '-';
+    v += neg;
+    if (!is_digit(*v)) {
+        return false;
+    }
+    int32_t val = 0;
+    while (is_digit(*v)) {
+        const int32_t digit = *v++ - '0';
+        if (val > (INT16_MAX - digit) / 10) {
+            return false;
+        }
+        val = val * 10 + digit;
+    }
+    val *= 10;
+    if (*v == '.' && is_digit(v[1])) {
+        val += v[1] - '0';
+        val += is_digit(v[2]) && v[2] >= '5';
+    }
+    if (val > INT16_MAX) {
+        return false;
+    }
+    *out = (int16_t)(neg ? -val : val);
+    return true;
+}
+
+static int32_t parse_uint(const char *v, int digits)
+{
+    int32_t val = 0;
+    for (int i = 0; i < digits; i++) {
+        if (!is_digit(v[i])) {
+            return -1;
+        }
+        val = val * 10 + (v[i] - '0');
+    }
+    return val;
+}
+
+// "2026-01-04" or "2026-01-04T07:56" (local time) -> day number and minute of day.
+static bool parse_iso(const char *v, int32_t *day, uint16_t *minute)
+{
+    const size_t len = strlen(v);
+    if (len < 10 || v[4] != '-' || v[7] != '-') {
+        return false;
+    }
+    const int32_t y = parse_uint(v, 4);
+    const int32_t m = parse_uint(v + 5, 2);
+    const int32_t d = parse_uint(v + 8, 2);
+    if (y < 0 || m < 1 || m > 12 || d < 1 || d > 31) {
+        return false;
+    }
+    uint16_t min = 0;
+    if (len >= 16 && v[10] == 'T') {
+        const int32_t hh = parse_uint(v + 11, 2);
+        const int32_t mm = v[13] == ':' ? parse_uint(v + 14, 2) : -1;
+        if (hh < 0 || hh > 23 || mm < 0 || mm > 59) {
+            return false;
+        }
+        min = (uint16_t)(hh * 60 + mm);
+    }
+    *day = civil_to_days(y, (uint32_t)m, (uint32_t)d);
+    *minute = min;
+    return true;
+}
+
+// Elements of "hourly" and "daily" arrays at depth 3 of a location. The "time" array
+// comes first in Open-Meteo bodies and anchors the ring; later series are slotted by
+// index.
+static void on_forecast_event(weather_parser_t *p, forecast_store_t *f, json_stream_t *s, const json_event_t *ev)
+{
+    const bool hourly = strcmp(json_stream_key_at(s, 1 + p->base), "hourly") == 0;
+    const char *key = json_stream_key_at(s, 2 + p->base);
+    const uint32_t cap = hourly ? FORECAST_HOURS : FORECAST_DAYS;
+    if (ev->index >= cap) {
+        return;
+    }
+
+    if (strcmp(key, "time") == 0) {
+        int32_t day;
+        uint16_t minute;
+        if (ev->type != JSON_EV_STRING || !parse_iso(ev->value, &day, &minute)) {
+            return;
+        }
+        if (hourly) {
+            if (ev->index == 0) {
+                const int64_t t = (int64_t)day * 86400 + minute * 60 - f->utc_offset_s;
+                f->first_hour = t > 0 ? (uint32_t)(t / 3600) : 0;
+            }
+            f->hours = (uint8_t)(ev->index + 1);
+        } else {
+            if (ev->index == 0) {
+                f->first_day = day;
+            }
+            f->days = (uint8_t)(ev->index + 1);
+        }
+        return;
+    }
+
+    const uint32_t slot = hourly ? forecast_hour_slot(f->first_hour + ev->index)
+                                 : forecast_day_slot(f->first_day + (int32_t)ev->index);
+    if (ev->type == JSON_EV_NUMBER) {
+        int16_t deci;
+        if (strcmp(key, "weather_code") == 0) {
+            const long code = strtol(ev->value, NULL, 10);
+            (hourly ? f->hour_code : f->day_code)[slot] = (uint8_t)(code >= 0 && code <= 255 ? code : 0);
+        } else if (!parse_deci(ev->value, &deci)) {
+            return;
+        } else if (hourly && strcmp(key, "temperature_2m") == 0) {
+            f->hour_temp[slot] = deci;
+        } else if (!hourly && strcmp(key, "temperature_2m_max") == 0) {
+            f->day_max[slot] = deci;
+        } else if (!hourly && strcmp(key, "temperature_2m_min") == 0) {
+            f->day_min[slot] = deci;
+        }
+    }
+}
+
+// A location's members of "current" sit at depth 2; today's entries of the "daily"
+// arrays are element 0 at depth 3. With a forecast store attached, every "hourly"
+// and "daily" element goes there too. Everything else ("*_units", ...) is skipped.
+// When the body is an array of locations, all of that is one level deeper and the
+// root array index picks the location.
+static void on_json_event(json_stream_t *s, const json_event_t *ev, void *ctx)
+{
+    weather_parser_t *p = ctx;
+    if (ev->depth == 0) {
+        p->base = ev->type == JSON_EV_ARRAY_START ? 1 : 0;
+        return;
+    }
+    const uint8_t base = p->base;
+    const size_t loc = base ? s->index[1] : 0;
+    if (ev->depth <= base || loc >= p->count) {
+        return;
+    }
+    const uint8_t depth = (uint8_t)(ev->depth - base);
+    weather_data_t *d = &p->out[loc];
+
+    if (p->forecast) {
+        forecast_store_t *f = &p->forecast[loc];
+        if (depth == 1 && ev->key && ev->type == JSON_EV_NUMBER && strcmp(ev->key, "utc_offset_seconds") == 0) {
+            f->utc_offset_s = (int32_t)strtol(ev->value, NULL, 10);
+        } else if (depth == 3 && ev->value) {
+            const char *series = json_stream_key_at(s, 1 + base);
+            if (strcmp(series, "hourly") == 0 || strcmp(series, "daily") == 0) {
+                on_forecast_event(p, f, s, ev);
+            }
+        }
+    }
+
+    if (depth == 2 && ev->key && ev->type == JSON_EV_NUMBER && strcmp(json_stream_key_at(s, 1 + base), "current") == 0) {
+        if (strcmp(ev->key, "temperature_2m") == 0) {
+            if (parse_deci(ev->value, &d->temp_f10)) {
+                p->found[loc] |= WEATHER_FIELD_TEMP;
+            }
+        } else if (strcmp(ev->key, "apparent_temperature") == 0) {
+            if (parse_deci(ev->value, &d->feels_like_f10)) {
+                p->found[loc] |= WEATHER_FIELD_FEELS_LIKE;
+            }
+        } else if (strcmp(ev->key, "weather_code") == 0) {
+            d->weather_code = (int)strtol(ev->value, NULL, 10);
+            p->found[loc] |= WEATHER_FIELD_CODE;
+        } else if (strcmp(ev->key, "interval") == 0) {
+            const long interval = strtol(ev->value, NULL, 10);
+            p->interval_s = interval > 0 ? (uint32_t)interval : 0;
+        }
+        return;
+    }
+
+    if (depth == 3 && ev->index == 0 && strcmp(json_stream_key_at(s, 1 + base), "daily") == 0) {
+        const char *key = json_stream_key_at(s, 2 + base);
+        if (ev->type == JSON_EV_NUMBER && strcmp(key, "temperature_2m_max") == 0) {
+            if (parse_deci(ev->value, &d->high_f10)) {
+                p->found[loc] |= WEATHER_FIELD_HIGH;
+            }
+        } else if (ev->type == JSON_EV_NUMBER && strcmp(key, "temperature_2m_min") == 0) {
+            if (parse_deci(ev->value, &d->low_f10)) {
+                p->found[loc] |= WEATHER_FIELD_LOW;
+            }
+        }
+    }
+}
+
+void weather_parser_init(weather_parser_t *p, weather_data_t *out)
+{
+    weather_parser_init_locations(p, out, 1);
+}
+
+void weather_parser_init_locations(weather_parser_t *p, weather_data_t *out, size_t count)
+{
+    if (count > WEATHER_MAX_LOCATIONS) {
+        count = WEATHER_MAX_LOCATIONS;
+    }
+    for (size_t i = 0; i < count; i++) {
+        memset(&out[i], 0, sizeof(out[i]));
+        out[i].location = (uint8_t)i;
+        out[i].sunrise = FORECAST_MINUTE_NONE;
+        out[i].sunset = FORECAST_MINUTE_NONE;
+    }
+    p->out = out;
+    p->forecast = NULL;
+    p->count = (uint8_t)count;
+    p->base = 0;
+    memset(p->found, 0, sizeof(p->found));
+    p->interval_s = 0;
+    json_stream_init(&p->json, on_json_event, p);
+}
+
+void weather_parser_set_forecast(weather_parser_t *p, forecast_store_t *store)
+{
+    p->forecast = store;
+    for (size_t i = 0; store && i < p->count; i++) {
+        forecast_store_clear(&store[i]);
+    }
+}
+
+esp_err_t weather_parser_feed(weather_parser_t *p, const char *data, size_t len)
+{
+    return json_stream_feed(&p->json, data, len);
+}
+
+esp_err_t weather_parser_finish(weather_parser_t *p)
+{
+    esp_err_t err = json_stream_finish(&p->json);
+    if (err != ESP_OK) {
+        return err;
+    }
+    for (size_t i = 0; i < p->count; i++) {
+        if ((p->found[i] & WEATHER_FIELDS_CURRENT) != WEATHER_FIELDS_CURRENT) {
+            return ESP_ERR_NOT_FOUND;
+        }
+    }
+    return ESP_OK;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "esp_err.h"
+#include "forecast_store.h"
+#include "json_stream.h"
+#include "weather_service.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fills weather_data_t from an Open-Meteo /v1/forecast body in a single pass as the
+// bytes arrive, without buffering the response. A request for several coordinates
+// is answered with an array holding one such object per location, in request order.
+
+typedef struct {
+    json_stream_t json;
+    weather_data_t *out;        // One per location
+    forecast_store_t *forecast; // Optional, see weather_parser_set_forecast()
+    uint8_t count;              // Locations expected
+    uint8_t base;               // 1 when the body is an array of locations
+    uint8_t found[WEATHER_MAX_LOCATIONS]; // WEATHER_FIELD_* bits seen so far, per location
+    uint32_t interval_s;        // "current.interval": seconds between model updates, 0 if absent
+} weather_parser_t;
+
+void weather_parser_init(weather_parser_t *p, weather_data_t *out);
+/** Parses a body for out[0..count), count at most WEATHER_MAX_LOCATIONS. */
+void weather_parser_init_locations(weather_parser_t *p, weather_data_t *out, size_t count);
+/** Also fill the "hourly" and "daily" series into store[0..count), cleared first. */
+void weather_parser_set_forecast(weather_parser_t *p, forecast_store_t *store);
+esp_err_t weather_parser_feed(weather_parser_t *p, const char *data, size_t len);
+/**
+ * Returns ESP_OK when the body was complete JSON carrying the current conditions of
+ * every location, ESP_ERR_NOT_FOUND when they were missing, or the tokenizer's error.
+ */
+esp_err_t weather_parser_finish(weather_parser_t *p);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,34 @@
+#include "weather_schedule.h"
+#include "config.h"
+
+// Past this the doubling has long reached any sensible WEATHER_RETRY_MAX_SEC.
+#define BACKOFF_MAX_DOUBLINGS 16
+
+uint32_t weather_schedule_aligned_delay(time_t now, uint32_t interval_s, uint32_t lag_s, uint32_t jitter_s,
+                                        uint32_t random)
+{
+    const uint32_t jitter = random % (jitter_s + 1);
+    if (interval_s == 0 || now < CLOCK_VALID_AFTER) {
+        return interval_s + jitter;
+    }
+    // Seconds since the last update, then until lag_s past the next one; lag_s past the
+    // last one counts when that moment is still ahead.
+    const uint32_t since = (uint32_t)((uint64_t)now % interval_s);
+    const uint32_t delay = since < lag_s ? lag_s - since : interval_s - since + lag_s;
+    return delay + jitter;
+}
+
+uint32_t weather_schedule_backoff(uint32_t failures, uint32_t random)
+{
+    if (failures == 0) {
+        return 0;
+    }
+    const uint32_t doublings = failures - 1 < BACKOFF_MAX_DOUBLINGS ? failures - 1 : BACKOFF_MAX_DOUBLINGS;
+    uint64_t cap = (uint64_t)WEATHER_RETRY_MIN_SEC << doublings;
+    if (cap > WEATHER_RETRY_MAX_SEC) {
+        cap = WEATHER_RETRY_MAX_SEC;
+    }
+    // Equal jitter: never sooner than half the cap, so retries still back off.
+    const uint32_t half = (uint32_t)cap / 2;
+    return (uint32_t)cap - random % (half + 1);
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Refresh timing for the weather worker: when the next scheduled fetch is due after a
+// good result and after a failed one. Pure functions of their inputs so the policy
+// can be checked on the host; the caller supplies the randomness.
+
+/**
+ * Seconds from now until lag_s past the provider's next model update, with updates
+ * every interval_s on wall-clock boundaries, plus random % (jitter_s + 1). When the
+ * clock is not set yet the wait is interval_s plus the jitter.
+ */
+uint32_t weather_schedule_aligned_delay(time_t now, uint32_t interval_s, uint32_t lag_s, uint32_t jitter_s,
+                                        uint32_t random);
+/**
+ * Seconds to wait after `failures` consecutive failed fetches: WEATHER_RETRY_MIN_SEC,
+ * doubling per failure up to WEATHER_RETRY_MAX_SEC, drawn from the upper half.
+ */
+uint32_t weather_schedule_backoff(uint32_t failures, uint32_t random);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,22 +1,62 @@
 #include "weather_service.h"
 #include "config.h"
+#include "fmt.h"
+#include "local_time.h"
+#include "solar.h"
+#include "weather_cache.h"
+#include "weather_parser.h"
+#include "weather_schedule.h"
 
+#include "esp_check.h"
 #include "esp_log.h"
 #include "esp_http_client.h"
 #include "esp_crt_bundle.h"
+#include "esp_random.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
+#include "sdkconfig.h"
 #include <stdio.h>
 #include <string.h>
-#include <stdlib.h>
-#include <math.h>
+#include <strings.h>
+#include <time.h>
 
 static const char *TAG = "weather_service";
 
+static const weather_location_t k_default_locations[] = {WEATHER_LOCATIONS};
+
 static weather_service_config_t s_config = {0};
+static weather_location_t s_locations[WEATHER_MAX_LOCATIONS];
+static size_t s_location_count = 0;
+static TaskHandle_t s_task = NULL;
+static esp_http_client_handle_t s_client = NULL;
+static bool s_conn_open = false; // s_client holds an open connection
+static SemaphoreHandle_t s_lock = NULL; // Guards s_busy and s_stats
+static bool s_busy = false;             // A fetch is queued or running
+static weather_service_stats_t s_stats = {0};
+// Last good result per location; worker task only after init. All locations come
+// from one response, so the entries are valid, and age, together.
+static weather_cache_entry_t s_cache[WEATHER_MAX_LOCATIONS];
+static bool s_cache_valid = false;
+static forecast_store_t s_forecast[WEATHER_MAX_LOCATIONS]; // Published copies, under s_lock
+static solar_cache_t s_sun[WEATHER_MAX_LOCATIONS];         // Today's sun times, under s_lock
+
+// Refresh schedule, under s_lock. Scheduled fetches pause while the display is off
+// or the network is down; requests from request_update() always run.
+static int64_t s_next_fetch_us = 0;     // esp_timer time the next scheduled fetch is due
+static uint32_t s_interval_s = WEATHER_REFRESH_INTERVAL_SEC;
+static uint32_t s_failures = 0;         // Consecutive failed fetches, sets the backoff
+static bool s_display_on = true;
+static bool s_online = false;
+static bool s_catch_up = false;         // The next scheduled fetch makes up for a pause
+static bool s_slot_scheduled = false;   // s_next_fetch_us is a slot from schedule_next(), not "now"
 
-// HTTP response buffer
-#define HTTP_BUFFER_SIZE 4096
-static char http_response_buffer[HTTP_BUFFER_SIZE];
-static int http_response_len = 0;
+typedef enum {
+    FETCH_FAILED = 0,
+    FETCH_UPDATED,      // 200 with a parsed body
+    FETCH_NOT_MODIFIED, // 304: the cached data is still current
+} fetch_result_t;
 
 // Weather code to description mapping (WMO codes)
 static const char *get_weather_description(int code)
@@ -70,174 +110,438 @@ static const char *get_weather_description(int code)
     }
 }
 
-// Helper function to parse a double value from JSON after a key
-// Handles both direct values ("key":123) and arrays ("key":[123])
-static double parse_json_double(const char *json, const char *key, size_t start_pos)
-{
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-
-    const char *pos = strstr(json + start_pos, search);
-    if (pos != NULL) {
-        pos += strlen(search);
-        // Skip whitespace
-        while (*pos == ' ' || *pos == '\t') pos++;
-        // Check if it's an array
-        if (*pos == '[') {
-            pos++; // Skip '['
-        }
-        return atof(pos);
-    }
-    return 0.0;
-}
+typedef struct {
+    weather_parser_t parser;
+    forecast_store_t forecast[WEATHER_MAX_LOCATIONS];
+    int64_t start_us;
+    int64_t parse_us;
+    bool connected; // This request opened a new connection
+    bool responded; // Headers or body arrived; the request reached the server
+    char etag[sizeof(((weather_cache_entry_t *)0)->etag)];
+    char last_modified[sizeof(((weather_cache_entry_t *)0)->last_modified)];
+} weather_fetch_t;
 
-// Helper function to parse an int value from JSON after a key
-static int parse_json_int(const char *json, const char *key, size_t start_pos)
-{
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":", key);
-
-    const char *pos = strstr(json + start_pos, search);
-    if (pos != NULL) {
-        pos += strlen(search);
-        // Skip whitespace
-        while (*pos == ' ' || *pos == '\t') pos++;
-        // Check if it's an array
-        if (*pos == '[') {
-            pos++; // Skip '['
-        }
-        return atoi(pos);
-    }
-    return 0;
-}
+// Worker task only; static so the forecasts stay off the task stack.
+static weather_fetch_t s_fetch;
 
-// Helper to parse time string from ISO format arrays
-// sunrise/sunset come as arrays: "sunrise":["2026-01-04T07:56"],"sunset":["2026-01-04T17:42"]
-static void parse_sun_time(const char *json, const char *key, char *out, size_t out_size)
-{
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":[\"", key);
-
-    const char *pos = strstr(json, search);
-    if (pos != NULL) {
-        pos += strlen(search);
-        // Find the 'T' separator and get time part
-        const char *tpos = strchr(pos, 'T');
-        if (tpos != NULL && (tpos - pos) < 20) {
-            int hour = atoi(tpos + 1);
-            int min = 0;
-            const char *colon_pos = strchr(tpos, ':');
-            if (colon_pos != NULL) {
-                min = atoi(colon_pos + 1);
-            }
-            const char *ampm = (hour >= 12) ? "PM" : "AM";
-            if (hour > 12) hour -= 12;
-            if (hour == 0) hour = 12;
-            snprintf(out, out_size, "%d:%02d %s", hour, min, ampm);
-            return;
-        }
-    }
-    snprintf(out, out_size, "--:--");
-}
-
-// HTTP event handler
+// HTTP event handler: the body is parsed as it arrives, whether it was sent with a
+// Content-Length or chunked (esp_http_client strips the chunk framing).
+// ON_CONNECTED only fires when a new connection (TCP + TLS) was opened.
 static esp_err_t http_event_handler(esp_http_client_event_t *evt)
 {
+    weather_fetch_t *fetch = evt->user_data;
     switch (evt->event_id) {
+    case HTTP_EVENT_ON_CONNECTED: {
+        const uint32_t handshake_us = (uint32_t)(esp_timer_get_time() - fetch->start_us);
+        fetch->connected = true;
+        s_conn_open = true;
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        s_stats.handshakes++;
+        s_stats.last_handshake_us = handshake_us;
+        s_stats.total_handshake_us += handshake_us;
+        xSemaphoreGive(s_lock);
+        break;
+    }
+    case HTTP_EVENT_ON_HEADER:
+        fetch->responded = true;
+        if (strcasecmp(evt->header_key, "ETag") == 0) {
+            snprintf(fetch->etag, sizeof(fetch->etag), "%s", evt->header_value);
+        } else if (strcasecmp(evt->header_key, "Last-Modified") == 0) {
+            snprintf(fetch->last_modified, sizeof(fetch->last_modified), "%s", evt->header_value);
+        }
+        break;
     case HTTP_EVENT_ON_DATA:
-        if (!esp_http_client_is_chunked_response(evt->client)) {
-            if (http_response_len + evt->data_len < HTTP_BUFFER_SIZE - 1) {
-                memcpy(http_response_buffer + http_response_len, evt->data, evt->data_len);
-                http_response_len += evt->data_len;
-                http_response_buffer[http_response_len] = '\0';
-            }
+        fetch->responded = true;
+        // Only a 200 carries a forecast; error pages and 304s are not parsed.
+        if (esp_http_client_get_status_code(evt->client) == 200) {
+            const int64_t start = esp_timer_get_time();
+            weather_parser_feed(&fetch->parser, evt->data, evt->data_len);
+            fetch->parse_us += esp_timer_get_time() - start;
         }
         break;
+    case HTTP_EVENT_DISCONNECTED:
+        s_conn_open = false;
+        break;
     default:
         break;
     }
     return ESP_OK;
 }
 
-// Fetch real weather from Open-Meteo API (no API key required)
-static bool fetch_real_weather(weather_data_t *data)
+// The client lives as long as the service. esp_http_client keeps the connection open
+// between requests, and with a saved TLS session a dropped connection is reopened
+// with an abbreviated handshake instead of a full one.
+static esp_http_client_handle_t weather_client(void)
 {
-    bool success = false;
-    memset(data, 0, sizeof(weather_data_t));
-    http_response_len = 0;
-    memset(http_response_buffer, 0, sizeof(http_response_buffer));
+    if (s_client) {
+        return s_client;
+    }
+
+    // Open-Meteo takes comma-separated coordinate lists and answers with one object
+    // per location, so every location shares the request.
+    char lat[WEATHER_MAX_LOCATIONS * 12];
+    char lon[WEATHER_MAX_LOCATIONS * 12];
+    fmt_buf_t flat;
+    fmt_buf_t flon;
+    fmt_init(&flat, lat, sizeof(lat));
+    fmt_init(&flon, lon, sizeof(lon));
+    for (size_t i = 0; i < s_location_count; i++) {
+        if (i > 0) {
+            fmt_str(&flat, ",");
+            fmt_str(&flon, ",");
+        }
+        fmt_fixed(&flat, s_locations[i].lat_e4, 4);
+        fmt_fixed(&flon, s_locations[i].lon_e4, 4);
+    }
 
-    // Build URL
     char url[512];
     snprintf(url, sizeof(url),
              "https://api.open-meteo.com/v1/forecast?"
-             "latitude=%.4f&longitude=%.4f"
+             "latitude=%s&longitude=%s"
              "&current=temperature_2m,apparent_temperature,weather_code"
-             "&daily=temperature_2m_max,temperature_2m_min,sunrise,sunset"
-             "&temperature_unit=fahrenheit&timezone=auto&forecast_days=1",
-             WEATHER_LAT, WEATHER_LON);
-
-    ESP_LOGI(TAG, "Fetching weather from: %s", url);
+             "&hourly=temperature_2m,weather_code"
+             "&daily=temperature_2m_max,temperature_2m_min,weather_code"
+             "&temperature_unit=fahrenheit&timezone=auto&forecast_days=%d&forecast_hours=%d",
+             lat, lon, FORECAST_DAYS, FORECAST_HOURS);
+    ESP_LOGI(TAG, "Weather URL: %s", url);
 
     esp_http_client_config_t config = {
         .url = url,
         .event_handler = http_event_handler,
         .crt_bundle_attach = esp_crt_bundle_attach,
-        .timeout_ms = 10000,
+        .timeout_ms = WEATHER_HTTP_TIMEOUT_MS,
+        .keep_alive_enable = true,
+        .keep_alive_idle = 5,
+        .keep_alive_interval = 5,
+        .keep_alive_count = 3,
+#if CONFIG_ESP_TLS_CLIENT_SESSION_TICKETS
+        .save_client_session = true,
+#endif
     };
+    s_client = esp_http_client_init(&config);
+    if (s_client == NULL) {
+        ESP_LOGE(TAG, "Failed to initialize HTTP client");
+    }
+    return s_client;
+}
+
+static esp_err_t perform(esp_http_client_handle_t client, weather_fetch_t *fetch, weather_data_t *data)
+{
+    weather_parser_init_locations(&fetch->parser, data, s_location_count);
+    weather_parser_set_forecast(&fetch->parser, fetch->forecast);
+    fetch->start_us = esp_timer_get_time();
+    fetch->parse_us = 0;
+    fetch->connected = false;
+    fetch->responded = false;
+    fetch->etag[0] = '\0';
+    fetch->last_modified[0] = '\0';
+    esp_http_client_set_user_data(client, fetch);
 
-    esp_http_client_handle_t client = esp_http_client_init(&config);
+    // Revalidate the cached result instead of downloading it again when unchanged.
+    const bool have = s_cache_valid;
+    if (have && s_cache[0].etag[0]) {
+        esp_http_client_set_header(client, "If-None-Match", s_cache[0].etag);
+    } else {
+        esp_http_client_delete_header(client, "If-None-Match");
+    }
+    if (have && s_cache[0].last_modified[0]) {
+        esp_http_client_set_header(client, "If-Modified-Since", s_cache[0].last_modified);
+    } else {
+        esp_http_client_delete_header(client, "If-Modified-Since");
+    }
+    return esp_http_client_perform(client);
+}
+
+// "Fetched Dry Ridge: 41F (feels 36F), Hi:45 Lo:29, Overcast"
+static void log_weather(const weather_data_t *data)
+{
+    char line[96];
+    fmt_buf_t f;
+    fmt_init(&f, line, sizeof(line));
+    fmt_deci_round(&f, data->temp_f10);
+    fmt_str(&f, "F (feels ");
+    fmt_deci_round(&f, data->feels_like_f10);
+    fmt_str(&f, "F), Hi:");
+    fmt_deci_round(&f, data->high_f10);
+    fmt_str(&f, " Lo:");
+    fmt_deci_round(&f, data->low_f10);
+    fmt_str(&f, ", ");
+    fmt_str(&f, data->condition);
+    ESP_LOGI(TAG, "Fetched %s: %s", s_locations[data->location].name, line);
+}
+
+// Fetch real weather from Open-Meteo API (no API key required) for every location,
+// data[0..s_location_count). A 200 replaces the cached data and validators; a 304
+// returns the cached data.
+static fetch_result_t fetch_real_weather(weather_data_t *data)
+{
+    esp_http_client_handle_t client = weather_client();
     if (client == NULL) {
-        ESP_LOGE(TAG, "Failed to initialize HTTP client");
+        return FETCH_FAILED;
+    }
+
+    weather_fetch_t *fetch = &s_fetch;
+    const bool kept = s_conn_open;
+    esp_err_t err = perform(client, fetch, data);
+    if (err != ESP_OK && kept && !fetch->connected && !fetch->responded) {
+        // The server closed the kept connection while it sat idle; reconnect once.
+        // A request that got part of a response is not retried.
+        ESP_LOGI(TAG, "Kept connection lost (%s), reconnecting", esp_err_to_name(err));
+        esp_http_client_close(client);
+        err = perform(client, fetch, data);
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        s_stats.reconnects++;
+        xSemaphoreGive(s_lock);
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_stats.body_bytes += fetch->parser.json.bytes;
+    s_stats.parse_us += (uint64_t)fetch->parse_us;
+    xSemaphoreGive(s_lock);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
+        esp_http_client_close(client);
+        return FETCH_FAILED;
+    }
+    if (!fetch->connected) {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        s_stats.reused++;
+        xSemaphoreGive(s_lock);
+    }
+
+    fetch_result_t result = FETCH_FAILED;
+    int status_code = esp_http_client_get_status_code(client);
+    ESP_LOGI(TAG, "HTTP Status = %d, %s body of %u bytes on a %s connection", status_code,
+             esp_http_client_is_chunked_response(client) ? "chunked" : "sized", (unsigned)fetch->parser.json.bytes,
+             fetch->connected ? "new" : "kept");
+
+    if (status_code == 304 && s_cache_valid) {
+        ESP_LOGI(TAG, "Not modified, keeping cached weather");
+        for (size_t i = 0; i < s_location_count; i++) {
+            data[i] = s_cache[i].data;
+        }
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        s_stats.not_modified++;
+        xSemaphoreGive(s_lock);
+        return FETCH_NOT_MODIFIED;
+    }
+
+    esp_err_t parse_err = weather_parser_finish(&fetch->parser);
+    if (status_code != 200) {
+        ESP_LOGW(TAG, "HTTP request failed with status %d", status_code);
+    } else if (parse_err != ESP_OK) {
+        ESP_LOGW(TAG, "Could not parse current conditions: %s", esp_err_to_name(parse_err));
+    } else {
+        result = FETCH_UPDATED;
+        for (size_t i = 0; i < s_location_count; i++) {
+            weather_cache_entry_t *entry = &s_cache[i];
+            const char *desc = get_weather_description(data[i].weather_code);
+            snprintf(data[i].condition, sizeof(data[i].condition), "%s", desc);
+            entry->lat_e4 = s_locations[i].lat_e4;
+            entry->lon_e4 = s_locations[i].lon_e4;
+            entry->data = data[i];
+            entry->forecast = fetch->forecast[i];
+            memcpy(entry->etag, fetch->etag, sizeof(entry->etag));
+            memcpy(entry->last_modified, fetch->last_modified, sizeof(entry->last_modified));
+            log_weather(&data[i]);
+        }
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        memcpy(s_forecast, fetch->forecast, sizeof(s_forecast[0]) * s_location_count);
+        s_interval_s = fetch->parser.interval_s > WEATHER_REFRESH_INTERVAL_SEC ? fetch->parser.interval_s
+                                                                               : WEATHER_REFRESH_INTERVAL_SEC;
+        xSemaphoreGive(s_lock);
+        s_cache_valid = true;
+    }
+    return result;
+}
+
+// A location's zone: the offset its last forecast reported, else the device's own
+// (right for the home location, a guess for others until their first fetch). Call
+// with s_lock held.
+static int32_t location_utc_offset(size_t location, time_t now)
+{
+    const forecast_store_t *f = &s_forecast[location];
+    if (f->days > 0) {
+        return f->utc_offset_s;
+    }
+    local_time_t local;
+    local_time_get(now, &local);
+    return local.utc_offset_s;
+}
+
+static void sun_today_locked(size_t location, time_t now, solar_day_t *out)
+{
+    const weather_location_t *loc = &s_locations[location];
+    solar_today(&s_sun[location], loc->lat_e4, loc->lon_e4, location_utc_offset(location, now), now, out);
+}
+
+// Sunrise and sunset are computed, not fetched, so fresh, cached and offline data
+// all carry today's. Call with s_lock held.
+static void fill_sun_locked(weather_data_t *data, time_t now)
+{
+    solar_day_t sun;
+    sun_today_locked(data->location, now, &sun);
+    data->sunrise = sun.sunrise;
+    data->sunset = sun.sunset;
+}
+
+static void fill_offline(weather_data_t *data)
+{
+    memset(data, 0, sizeof(*data));
+    snprintf(data->condition, sizeof(data->condition), "Offline");
+    data->sunrise = FORECAST_MINUTE_NONE;
+    data->sunset = FORECAST_MINUTE_NONE;
+}
+
+// Stale-while-revalidate: cached data past its max-age is still shown, marked
+// stale, until it is older than the stale window. An unknown age counts as stale.
+static bool cache_fresh(time_t now)
+{
+    const int64_t age = weather_cache_age(&s_cache[0], now);
+    return s_cache_valid && age >= 0 && age < WEATHER_CACHE_MAX_AGE_SEC;
+}
+
+static bool cache_showable(time_t now)
+{
+    const int64_t age = weather_cache_age(&s_cache[0], now);
+    return s_cache_valid && age < (int64_t)WEATHER_CACHE_MAX_AGE_SEC + WEATHER_CACHE_STALE_SEC;
+}
+
+static bool schedule_paused(void)
+{
+    return !s_display_on || !s_online;
+}
+
+// Ticks until the next scheduled fetch; forever while paused, since resuming wakes
+// the task. One tick longer than the deadline so the wait never ends just short of it.
+static TickType_t schedule_wait(int64_t now_us)
+{
+    if (schedule_paused()) {
+        return portMAX_DELAY;
+    }
+    if (s_next_fetch_us <= now_us) {
+        return 0;
+    }
+    return pdMS_TO_TICKS((s_next_fetch_us - now_us + 999) / 1000) + 1;
+}
+
+// After a good result the next fetch follows the provider's next model update; after
+// a failure it backs off.
+static void schedule_next(bool ok)
+{
+    s_failures = ok ? 0 : s_failures + 1;
+    const uint32_t delay_s =
+        ok ? weather_schedule_aligned_delay(time(NULL), s_interval_s, WEATHER_REFRESH_LAG_SEC,
+                                            WEATHER_REFRESH_JITTER_SEC, esp_random())
+           : weather_schedule_backoff(s_failures, esp_random());
+    s_next_fetch_us = esp_timer_get_time() + (int64_t)delay_s * 1000000;
+    s_slot_scheduled = true;
+    if (!ok) {
+        ESP_LOGI(TAG, "Retrying in %u s after %u failed fetches", (unsigned)delay_s, (unsigned)s_failures);
+    }
+}
+
+// Called after the display or network state changed. A refresh that fell due while
+// paused runs as soon as nothing pauses it, one fetch for every slot missed; returns
+// true when the task has to be woken for it. A deadline that was only ever "now" (the
+// first fetch after boot, a retry on reconnect) missed no slot and is not counted.
+static bool schedule_resume(bool was_paused)
+{
+    const int64_t now_us = esp_timer_get_time();
+    if (!was_paused || schedule_paused() || now_us < s_next_fetch_us) {
         return false;
     }
+    if (s_slot_scheduled) {
+        const int64_t interval_us = (int64_t)s_interval_s * 1000000;
+        s_stats.paused_skips += 1 + (uint32_t)((now_us - s_next_fetch_us) / interval_us);
+        s_catch_up = true;
+    }
+    return true;
+}
+
+// One fetch per wakeup; the notification count is cleared, so triggers that
+// arrived while the previous fetch ran do not queue up behind it. Between requests
+// the task sleeps until the next scheduled fetch.
+static void weather_task(void *arg)
+{
+    (void)arg;
+    while (true) {
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        const TickType_t wait = schedule_wait(esp_timer_get_time());
+        xSemaphoreGive(s_lock);
+        ulTaskNotifyTake(pdTRUE, wait);
 
-    esp_err_t err = esp_http_client_perform(client);
-    if (err == ESP_OK) {
-        int status_code = esp_http_client_get_status_code(client);
-        ESP_LOGI(TAG, "HTTP Status = %d, content_length = %d",
-                 status_code, http_response_len);
-
-        if (status_code == 200 && http_response_len > 0) {
-            // Parse current section
-            const char *current_pos = strstr(http_response_buffer, "\"current\":{");
-            if (current_pos != NULL) {
-                size_t offset = current_pos - http_response_buffer;
-
-                data->temp_f = parse_json_double(http_response_buffer, "temperature_2m", offset);
-                data->feels_like_f = parse_json_double(http_response_buffer, "apparent_temperature", offset);
-                data->weather_code = parse_json_int(http_response_buffer, "weather_code", offset);
-
-                const char *desc = get_weather_description(data->weather_code);
-                snprintf(data->condition, sizeof(data->condition), "%s", desc);
-
-                // Parse daily section for high/low and sun times
-                const char *daily_pos = strstr(http_response_buffer, "\"daily\":{");
-                if (daily_pos != NULL) {
-                    size_t daily_offset = daily_pos - http_response_buffer;
-                    data->high_f = parse_json_double(http_response_buffer, "temperature_2m_max", daily_offset);
-                    data->low_f = parse_json_double(http_response_buffer, "temperature_2m_min", daily_offset);
-                    parse_sun_time(http_response_buffer, "sunrise", data->sunrise, sizeof(data->sunrise));
-                    parse_sun_time(http_response_buffer, "sunset", data->sunset, sizeof(data->sunset));
-                }
-
-                success = true;
-                ESP_LOGI(TAG, "Fetched: %.0fF (feels %.0fF), Hi:%.0f Lo:%.0f, %s",
-                         data->temp_f, data->feels_like_f, data->high_f, data->low_f,
-                         data->condition);
-                ESP_LOGI(TAG, "Sunrise: %s, Sunset: %s", data->sunrise, data->sunset);
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        const bool requested = s_busy;
+        const bool scheduled = !requested && !schedule_paused() && esp_timer_get_time() >= s_next_fetch_us;
+        if (scheduled) {
+            s_busy = true;
+            s_stats.scheduled++;
+            s_stats.catch_ups += s_catch_up ? 1 : 0;
+        }
+        s_catch_up = false;
+        xSemaphoreGive(s_lock);
+        if (!requested && !scheduled) {
+            continue;
+        }
+
+        // Scheduled fetches go out even when the cache is fresh: they are timed for a
+        // new model run, and a 304 costs little when there is none.
+        if (requested && cache_fresh(time(NULL))) {
+            ESP_LOGI(TAG, "Cached weather is still fresh, not refreshing");
+            xSemaphoreTake(s_lock, portMAX_DELAY);
+            s_busy = false;
+            s_stats.cache_hits++;
+            schedule_next(true);
+            xSemaphoreGive(s_lock);
+            continue;
+        }
+
+        ESP_LOGI(TAG, "Fetching weather data...");
+        const int64_t start_us = esp_timer_get_time();
+        weather_data_t data[WEATHER_MAX_LOCATIONS];
+        const bool ok = fetch_real_weather(data) != FETCH_FAILED;
+        const bool served_stale = !ok && cache_showable(time(NULL));
+        if (!ok) {
+            ESP_LOGW(TAG, "Failed to fetch weather, %s", served_stale ? "showing cached data" : "sending offline data");
+        }
+        for (size_t i = 0; i < s_location_count; i++) {
+            if (ok) {
+                data[i].updated_at = (int64_t)time(NULL);
+                data[i].stale = false;
+                s_cache[i].data.updated_at = data[i].updated_at;
+                weather_cache_store(i, &s_cache[i]);
+            } else if (served_stale) {
+                data[i] = s_cache[i].data;
+                data[i].stale = true;
             } else {
-                ESP_LOGW(TAG, "Could not find 'current' section in response");
+                fill_offline(&data[i]);
+                data[i].location = (uint8_t)i;
             }
-        } else {
-            ESP_LOGW(TAG, "HTTP request failed with status %d", status_code);
         }
-    } else {
-        ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
-    }
+        const uint32_t fetch_us = (uint32_t)(esp_timer_get_time() - start_us);
+        const uint32_t stack_free = (uint32_t)uxTaskGetStackHighWaterMark(NULL);
 
-    esp_http_client_cleanup(client);
-    return success;
+        xSemaphoreTake(s_lock, portMAX_DELAY);
+        s_busy = false;
+        s_stats.fetches++;
+        s_stats.failures += ok ? 0 : 1;
+        s_stats.served_stale += served_stale ? 1 : 0;
+        s_stats.last_fetch_us = fetch_us;
+        s_stats.total_fetch_us += fetch_us;
+        if (fetch_us > s_stats.max_fetch_us) {
+            s_stats.max_fetch_us = fetch_us;
+        }
+        s_stats.stack_free_min = stack_free; // Already the minimum over the task's life
+        schedule_next(ok);
+        for (size_t i = 0; i < s_location_count; i++) {
+            fill_sun_locked(&data[i], time(NULL));
+        }
+        xSemaphoreGive(s_lock);
+
+        for (size_t i = 0; i < s_location_count; i++) {
+            s_config.update_cb(&data[i], s_config.cb_ctx);
+        }
+    }
 }
 
 esp_err_t weather_service_init(const weather_service_config_t *config)
@@ -245,31 +549,200 @@ esp_err_t weather_service_init(const weather_service_config_t *config)
     if (!config || !config->update_cb) {
         return ESP_ERR_INVALID_ARG;
     }
+    const weather_location_t *locations = config->locations ? config->locations : k_default_locations;
+    const size_t count = config->locations ? config->location_count
+                                           : sizeof(k_default_locations) / sizeof(k_default_locations[0]);
+    ESP_RETURN_ON_FALSE(count > 0 && count <= WEATHER_MAX_LOCATIONS, ESP_ERR_INVALID_ARG, TAG,
+                        "need 1..%d locations", WEATHER_MAX_LOCATIONS);
+    ESP_RETURN_ON_FALSE(!s_task, ESP_ERR_INVALID_STATE, TAG, "already initialized");
 
     s_config = *config;
+    memcpy(s_locations, locations, sizeof(s_locations[0]) * count);
+    s_location_count = count;
+
+    // An entry fetched for other coordinates (the list changed) invalidates them all:
+    // the next request would not match its validators.
+    s_cache_valid = true;
+    for (size_t i = 0; i < count; i++) {
+        if (weather_cache_load(i, &s_cache[i]) != ESP_OK || s_cache[i].lat_e4 != locations[i].lat_e4 ||
+            s_cache[i].lon_e4 != locations[i].lon_e4) {
+            s_cache_valid = false;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (s_cache_valid) {
+            s_forecast[i] = s_cache[i].forecast;
+        } else {
+            forecast_store_clear(&s_forecast[i]);
+        }
+    }
+    s_lock = xSemaphoreCreateMutex();
+    ESP_RETURN_ON_FALSE(s_lock, ESP_ERR_NO_MEM, TAG, "mutex alloc failed");
+    if (s_cache_valid && cache_showable(time(NULL))) {
+        // Draw the last result right away; the first refresh revalidates it.
+        const bool stale = !cache_fresh(time(NULL));
+        ESP_LOGI(TAG, "Showing cached weather (%s)", stale ? "stale" : "fresh");
+        for (size_t i = 0; i < count; i++) {
+            weather_data_t data = s_cache[i].data;
+            data.location = (uint8_t)i;
+            data.stale = stale;
+            xSemaphoreTake(s_lock, portMAX_DELAY);
+            fill_sun_locked(&data, time(NULL));
+            xSemaphoreGive(s_lock);
+            s_config.update_cb(&data, s_config.cb_ctx);
+        }
+    }
+
+    // Without fresh data the first scheduled fetch is due at once: it runs when the
+    // network comes up.
+    s_slot_scheduled = false;
+    if (cache_fresh(time(NULL))) {
+        schedule_next(true);
+    } else {
+        s_next_fetch_us = esp_timer_get_time();
+    }
+    if (xTaskCreate(weather_task, "weather", WEATHER_TASK_STACK_SIZE, NULL, WEATHER_TASK_PRIORITY, &s_task) !=
+        pdPASS) {
+        vSemaphoreDelete(s_lock);
+        s_lock = NULL;
+        ESP_LOGE(TAG, "task create failed");
+        return ESP_ERR_NO_MEM;
+    }
     ESP_LOGI(TAG, "Weather service initialized (using Open-Meteo API)");
     return ESP_OK;
 }
 
 void weather_service_request_update(void)
 {
-    ESP_LOGI(TAG, "Fetching weather data...");
+    if (!s_task) {
+        ESP_LOGW(TAG, "Update requested before init");
+        return;
+    }
+    const int64_t start_us = esp_timer_get_time();
 
-    weather_data_t data;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool start = !s_busy;
+    s_busy = true;
+    s_stats.requests++;
+    s_stats.coalesced += start ? 0 : 1;
+    xSemaphoreGive(s_lock);
 
-    if (fetch_real_weather(&data)) {
-        if (s_config.update_cb) {
-            s_config.update_cb(&data, s_config.cb_ctx);
-        }
-    } else {
-        ESP_LOGW(TAG, "Failed to fetch weather, sending offline data");
-        // Send offline data
-        memset(&data, 0, sizeof(data));
-        snprintf(data.condition, sizeof(data.condition), "Offline");
-        snprintf(data.sunrise, sizeof(data.sunrise), "--:--");
-        snprintf(data.sunset, sizeof(data.sunset), "--:--");
-        if (s_config.update_cb) {
-            s_config.update_cb(&data, s_config.cb_ctx);
+    if (start) {
+        xTaskNotifyGive(s_task);
+    }
+
+    const uint32_t caller_us = (uint32_t)(esp_timer_get_time() - start_us);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    s_stats.caller_total_us += caller_us;
+    if (caller_us > s_stats.caller_max_us) {
+        s_stats.caller_max_us = caller_us;
+    }
+    xSemaphoreGive(s_lock);
+}
+
+void weather_service_set_display_on(bool on)
+{
+    if (!s_task) {
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool was_paused = schedule_paused();
+    s_display_on = on;
+    const bool wake = schedule_resume(was_paused);
+    xSemaphoreGive(s_lock);
+    if (wake) {
+        ESP_LOGI(TAG, "Display on, catching up on the weather");
+        xTaskNotifyGive(s_task);
+    }
+}
+
+void weather_service_set_network(bool connected)
+{
+    if (!s_task) {
+        return;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool was_paused = schedule_paused();
+    if (connected && !s_online && s_failures > 0) {
+        // Those failures were most likely the outage: retry now, on a fresh backoff.
+        s_failures = 0;
+        const int64_t now_us = esp_timer_get_time();
+        if (s_next_fetch_us > now_us) {
+            s_next_fetch_us = now_us;
+            s_slot_scheduled = false;
         }
     }
+    s_online = connected;
+    const bool wake = schedule_resume(was_paused);
+    xSemaphoreGive(s_lock);
+    if (wake) {
+        ESP_LOGI(TAG, "Network up, catching up on the weather");
+        xTaskNotifyGive(s_task);
+    }
+}
+
+esp_err_t weather_service_get_stats(weather_service_stats_t *stats)
+{
+    ESP_RETURN_ON_FALSE(stats, ESP_ERR_INVALID_ARG, TAG, "stats is NULL");
+    ESP_RETURN_ON_FALSE(s_lock, ESP_ERR_INVALID_STATE, TAG, "not initialized");
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    *stats = s_stats;
+    stats->retry_level = s_failures;
+    stats->next_fetch_us = schedule_paused() ? -1 : s_next_fetch_us;
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
+
+size_t weather_service_location_count(void)
+{
+    return s_location_count;
+}
+
+const weather_location_t *weather_service_get_location(size_t location)
+{
+    return location < s_location_count ? &s_locations[location] : NULL;
+}
+
+bool weather_service_get_hour(size_t location, uint32_t n, forecast_hour_t *out)
+{
+    if (!s_lock || !out || location >= s_location_count) {
+        return false;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool ok = forecast_store_hour(&s_forecast[location], time(NULL), n, out);
+    xSemaphoreGive(s_lock);
+    return ok;
+}
+
+bool weather_service_get_day(size_t location, uint32_t n, forecast_day_t *out)
+{
+    if (!s_lock || !out || location >= s_location_count) {
+        return false;
+    }
+    const time_t now = time(NULL);
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    const bool ok = forecast_store_day(&s_forecast[location], now, n, out);
+    const int32_t utc_offset_s = s_forecast[location].utc_offset_s;
+    xSemaphoreGive(s_lock);
+    if (ok) {
+        // Not fetched: computed for that day, in the zone the forecast reported.
+        const weather_location_t *loc = &s_locations[location];
+        solar_day_t sun;
+        solar_compute(loc->lat_e4, loc->lon_e4, (int32_t)((now + utc_offset_s) / 86400) + (int32_t)n, utc_offset_s,
+                      &sun);
+        out->sunrise = sun.sunrise;
+        out->sunset = sun.sunset;
+    }
+    return ok;
+}
+
+bool weather_service_get_sun(size_t location, solar_day_t *out)
+{
+    if (!s_lock || !out || location >= s_location_count) {
+        return false;
+    }
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    sun_today_locked(location, time(NULL), out);
+    xSemaphoreGive(s_lock);
+    return true;
 }
@@ -1,21 +1,42 @@
 #pragma once
 
 #include "esp_err.h"
+#include "forecast_store.h"
+#include "solar.h"
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define WEATHER_MAX_LOCATIONS 4
+
+// Decimal degrees as ten-thousandths, folded at compile time so URLs are built
+// without double math or float printf.
+#define WEATHER_COORD_E4(deg) ((int32_t)((deg) * 10000.0 + ((deg) < 0 ? -0.5 : 0.5)))
+/** Initializer for a weather_location_t, as used by WEATHER_LOCATIONS in config.h. */
+#define WEATHER_LOCATION(lat, lon, name) {WEATHER_COORD_E4(lat), WEATHER_COORD_E4(lon), (name)}
+
+typedef struct {
+    int32_t lat_e4; // Latitude, ten-thousandths of a degree
+    int32_t lon_e4;
+    const char *name;
+} weather_location_t;
+
 typedef struct weather_data_t {
-    double temp_f;       // Current temperature in Fahrenheit
-    double feels_like_f; // Apparent temperature
-    double high_f;       // Today's high
-    double low_f;        // Today's low
-    int weather_code;    // WMO weather code
-    char condition[32];  // Weather description
-    char sunrise[8];     // e.g., "7:15 AM"
-    char sunset[8];      // e.g., "5:42 PM"
+    uint8_t location;       // Index into the service's location list
+    int16_t temp_f10;       // Current temperature, tenths of a degree Fahrenheit
+    int16_t feels_like_f10; // Apparent temperature, tenths
+    int16_t high_f10;       // Today's high, tenths
+    int16_t low_f10;        // Today's low, tenths
+    int weather_code;       // WMO weather code
+    char condition[32];     // Weather description
+    uint16_t sunrise;       // Local minute of the day, computed on the device; FORECAST_MINUTE_NONE if none
+    uint16_t sunset;
+    int64_t updated_at;     // Unix time the server last confirmed this data, 0 if unknown
+    bool stale;             // Older than WEATHER_CACHE_MAX_AGE_SEC, shown until revalidated
 } weather_data_t;
 
 typedef void (*weather_update_cb_t)(const weather_data_t *data, void *ctx);
@@ -23,10 +44,72 @@ typedef void (*weather_update_cb_t)(const weather_data_t *data, void *ctx);
 typedef struct {
     weather_update_cb_t update_cb;
     void *cb_ctx;
+    // Fetched together in one request. NULL: WEATHER_LOCATIONS from config.h.
+    const weather_location_t *locations;
+    size_t location_count; // At most WEATHER_MAX_LOCATIONS
 } weather_service_config_t;
 
+typedef struct {
+    uint32_t requests;        // weather_service_request_update() calls
+    uint32_t coalesced;       // Requests absorbed by a fetch already queued or running
+    uint32_t fetches;         // Fetches completed by the worker task
+    uint32_t failures;        // Fetches that ended in offline data
+    uint32_t last_fetch_us;
+    uint32_t max_fetch_us;
+    uint64_t total_fetch_us;
+    uint32_t caller_max_us;   // Longest a caller spent inside request_update()
+    uint64_t caller_total_us;
+    uint32_t handshakes;      // Connections opened (TCP + TLS, full or resumed)
+    uint32_t reused;          // Fetches served on a kept connection
+    uint32_t reconnects;      // Kept connections found closed by the server
+    uint32_t last_handshake_us;
+    uint64_t total_handshake_us;
+    uint32_t not_modified;    // 304 responses: the cached data was still current
+    uint32_t cache_hits;      // Requests answered by fresh cached data, no request sent
+    uint32_t served_stale;    // Failed fetches answered with stale cached data
+    uint64_t body_bytes;      // Response bytes fed to the parser
+    uint64_t parse_us;        // Time spent parsing them
+    uint32_t stack_free_min;  // Worker task stack high-water mark, bytes never used
+    uint32_t scheduled;       // Fetches started by the refresh schedule, catch-ups included
+    uint32_t catch_ups;       // Of those, run at once on wake or reconnect for a slot missed while paused
+    uint32_t paused_skips;    // Scheduled refreshes that fell due while paused
+    uint32_t retry_level;     // Consecutive failed fetches the current backoff is based on
+    int64_t next_fetch_us;    // esp_timer time of the next scheduled fetch, -1 while paused
+} weather_service_stats_t;
+
+/**
+ * Starts the worker task; update_cb is called from it after every fetch, once per
+ * location. Cached data from NVS young enough to show is passed to update_cb before
+ * this returns.
+ */
 esp_err_t weather_service_init(const weather_service_config_t *config);
+/**
+ * Asks the worker task for a fetch and returns without waiting for it. Requests
+ * made while a fetch is queued or running share that fetch's result.
+ */
 void weather_service_request_update(void);
+/**
+ * Scheduled refreshes pause while the display is off or the network is down (the
+ * network starts down). Turning either back on runs a refresh that fell due in the
+ * meantime right away; a reconnect also retries a failing refresh at once.
+ */
+void weather_service_set_display_on(bool on);
+void weather_service_set_network(bool connected);
+esp_err_t weather_service_get_stats(weather_service_stats_t *stats);
+
+size_t weather_service_location_count(void);
+/** NULL when location is out of range. */
+const weather_location_t *weather_service_get_location(size_t location);
+/** Hour n from the current hour of the location's last forecast; false when not held. */
+bool weather_service_get_hour(size_t location, uint32_t n, forecast_hour_t *out);
+/** Day n from the location's local today of its last forecast; false when not held. */
+bool weather_service_get_day(size_t location, uint32_t n, forecast_day_t *out);
+/**
+ * Today's sunrise, sunset and civil twilight at a location, computed from its
+ * coordinates once per day: available offline and before the first fetch. Until a
+ * forecast reports the location's zone, times are in the device's own zone.
+ */
+bool weather_service_get_sun(size_t location, solar_day_t *out);
 
 #ifdef __cplusplus
 }